@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Background DDR traffic generated by the U54 harts 2 to 4. See ddr_load.h.
+ */
+
+#include <stdint.h>
+#include "ddr_load.h"
+#include "mpfs_hal/mss_hal.h"
+
+static volatile uint32_t load_hart_mask = 0u;
+static volatile uint32_t harts_woken = 0u;
+static volatile uint64_t load_bytes[DDR_LOAD_LAST_HART + 1u];
+
+void
+ddr_load_start(uint32_t hart_mask)
+{
+    uint32_t hart_id;
+
+    for (hart_id = DDR_LOAD_FIRST_HART; hart_id <= DDR_LOAD_LAST_HART; hart_id++)
+    {
+        load_bytes[hart_id] = 0u;
+    }
+
+    mb();
+    load_hart_mask = hart_mask;
+    mb();
+
+    /* Harts 2 to 4 wait in WFI until the first load is started */
+    if (0u == harts_woken)
+    {
+        harts_woken = 1u;
+
+        for (hart_id = DDR_LOAD_FIRST_HART; hart_id <= DDR_LOAD_LAST_HART; hart_id++)
+        {
+            raise_soft_interrupt(hart_id);
+        }
+    }
+}
+
+void
+ddr_load_stop(void)
+{
+    load_hart_mask = 0u;
+    mb();
+}
+
+uint64_t
+ddr_load_bytes(uint32_t hart_id)
+{
+    if ((hart_id < DDR_LOAD_FIRST_HART) || (hart_id > DDR_LOAD_LAST_HART))
+    {
+        return 0u;
+    }
+
+    return load_bytes[hart_id];
+}
+
+void
+ddr_load_run(void)
+{
+    uint32_t hart_id = (uint32_t)read_csr(mhartid);
+    volatile uint64_t *block;
+    uint32_t index;
+
+    if ((hart_id < DDR_LOAD_FIRST_HART) || (hart_id > DDR_LOAD_LAST_HART))
+    {
+        return;
+    }
+
+    block = (volatile uint64_t *)(uintptr_t)(DDR_LOAD_BASE_ADDRESS +
+                                             ((hart_id - DDR_LOAD_FIRST_HART) *
+                                              DDR_LOAD_SIZE_BYTES));
+
+    while (load_hart_mask & (1u << hart_id))
+    {
+        for (index = 0u; index < (DDR_LOAD_SIZE_BYTES / sizeof(uint64_t)); index++)
+        {
+            block[index] = block[index] + 1u;
+        }
+
+        load_bytes[hart_id] += (2u * DDR_LOAD_SIZE_BYTES);
+    }
+}
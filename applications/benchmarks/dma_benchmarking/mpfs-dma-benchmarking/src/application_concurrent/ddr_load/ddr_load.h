@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Background DDR traffic generated by the U54 harts 2 to 4.
+ *
+ * Each loaded hart repeatedly reads and writes back its own DDR_LOAD_SIZE_BYTES
+ * block of cached DDR. The block is larger than the L2 cache, so the traffic
+ * reaches DDR through the CPU ports of the AXI switch. Harts 2 to 4 call
+ * ddr_load_run() from their main loop; hart 1 starts and stops the load.
+ */
+
+#ifndef DDR_LOAD_H_
+#define DDR_LOAD_H_
+
+#include <stdint.h>
+
+#ifndef DDR_LOAD_BASE_ADDRESS
+#define DDR_LOAD_BASE_ADDRESS (0x90000000u)
+#endif
+
+#ifndef DDR_LOAD_SIZE_BYTES
+#define DDR_LOAD_SIZE_BYTES   (0x400000u)
+#endif
+
+#define DDR_LOAD_FIRST_HART   (2u)
+#define DDR_LOAD_LAST_HART    (4u)
+
+/* Wakes harts 2 to 4 if needed and sets the harts in hart_mask (bit n for hart
+ * n) generating DDR traffic. */
+void ddr_load_start(uint32_t hart_mask);
+
+/* Stops all harts generating DDR traffic */
+void ddr_load_stop(void);
+
+/* Returns the number of bytes read and written by hart_id since it was last
+ * started */
+uint64_t ddr_load_bytes(uint32_t hart_id);
+
+/* Generates DDR traffic while the calling hart is enabled. Returns when it is
+ * not. */
+void ddr_load_run(void);
+
+#endif /* DDR_LOAD_H_ */
@@ -0,0 +1,336 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Common interface over the MSS Platform DMA (P-DMA) and the
+ * CoreAXI4DMAController (F-DMA). See dma_engine.h.
+ */
+
+#include <stdint.h>
+#include "dma_engine.h"
+#include "mpfs_hal/mss_hal.h"
+
+/* Memory map used to classify transfer addresses */
+#define L2_LIM_START            (0x08000000u)
+#define L2_LIM_END              (0x08200000u)
+#define SCRATCHPAD_START        (0x0A000000u)
+#define SCRATCHPAD_END          (0x0C000000u)
+#define FIC3_START              (0x40000000u)
+#define FIC0_END                (0x80000000u)
+#define CACHED_DDR_START        (0x80000000u)
+#define CACHED_DDR_END          (0xC0000000u)
+#define NON_CACHED_DDR_START    (0xC0000000u)
+#define NON_CACHED_DDR_END      (0xE0000000u)
+#define FIC1_START              (0xE0000000u)
+#define CACHED_DDR_64_START     (0x1000000000ull)
+#define NON_CACHED_DDR_64_START (0x1400000000ull)
+#define NON_CACHED_DDR_64_END   (0x1C00000000ull)
+
+/* The F-DMA descriptors hold 32 bit addresses */
+#define FDMA_MAX_ADDRESS        (0xFFFFFFFFu)
+
+static const uint32_t size_class_bytes[DMA_ENGINE_SIZE_CLASS_COUNT] =
+    {1024u, 4096u, 16384u, 65536u, 262144u, 1048576u};
+
+/* Measured transfer time in mcycles. Zero means not calibrated. */
+static uint64_t calibrated_cycles[DMA_REGION_COUNT][DMA_REGION_COUNT][DMA_ENGINE_SIZE_CLASS_COUNT]
+                                 [DMA_ENGINE_COUNT];
+
+static axi4dma_instance_t *fdma_instance = NULL;
+static mss_pdma_request_t pdma_request;
+static dma_engine_transfer_t *volatile active_transfer[DMA_ENGINE_COUNT] = {NULL, NULL};
+
+static void
+complete_transfer(dma_engine_id_t engine, dma_engine_status_t status)
+{
+    dma_engine_transfer_t *transfer = active_transfer[engine];
+
+    active_transfer[engine] = NULL;
+    transfer->status = status;
+
+    if (NULL != transfer->handler)
+    {
+        transfer->handler(transfer);
+    }
+}
+
+static void
+pdma_request_done(mss_pdma_request_t *request)
+{
+    if (MSS_PDMA_REQUEST_DONE == request->status)
+    {
+        complete_transfer(DMA_ENGINE_PDMA, DMA_ENGINE_OK);
+    }
+    else
+    {
+        complete_transfer(DMA_ENGINE_PDMA, DMA_ENGINE_TRANSFER_ERROR);
+    }
+}
+
+static uint32_t
+size_class(uint32_t num_bytes)
+{
+    uint32_t index = 0u;
+
+    while (((index + 1u) < DMA_ENGINE_SIZE_CLASS_COUNT) &&
+           (num_bytes >= size_class_bytes[index + 1u]))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+void
+dma_engine_init(axi4dma_instance_t *fdma)
+{
+    fdma_instance = fdma;
+    active_transfer[DMA_ENGINE_PDMA] = NULL;
+    active_transfer[DMA_ENGINE_FDMA] = NULL;
+}
+
+dma_region_t
+dma_engine_region(uint64_t address)
+{
+    if ((address >= L2_LIM_START) && (address < L2_LIM_END))
+    {
+        return DMA_REGION_L2_LIM;
+    }
+
+    if ((address >= SCRATCHPAD_START) && (address < SCRATCHPAD_END))
+    {
+        return DMA_REGION_SCRATCHPAD;
+    }
+
+    if (((address >= CACHED_DDR_START) && (address < CACHED_DDR_END)) ||
+        ((address >= CACHED_DDR_64_START) && (address < NON_CACHED_DDR_64_START)))
+    {
+        return DMA_REGION_CACHED_DDR;
+    }
+
+    if (((address >= NON_CACHED_DDR_START) && (address < NON_CACHED_DDR_END)) ||
+        ((address >= NON_CACHED_DDR_64_START) && (address < NON_CACHED_DDR_64_END)))
+    {
+        return DMA_REGION_NON_CACHED_DDR;
+    }
+
+    if (((address >= FIC3_START) && (address < FIC0_END)) ||
+        ((address >= FIC1_START) && (address <= FDMA_MAX_ADDRESS)))
+    {
+        return DMA_REGION_FABRIC;
+    }
+
+    return DMA_REGION_OTHER;
+}
+
+dma_engine_id_t
+dma_engine_select(uint64_t src_addr, uint64_t dest_addr, uint32_t num_bytes)
+{
+    dma_region_t src_region = dma_engine_region(src_addr);
+    dma_region_t dest_region = dma_engine_region(dest_addr);
+    uint32_t class_index = size_class(num_bytes);
+    uint64_t pdma_cycles;
+    uint64_t fdma_cycles;
+
+    if ((NULL == fdma_instance) || ((src_addr + num_bytes) > FDMA_MAX_ADDRESS) ||
+        ((dest_addr + num_bytes) > FDMA_MAX_ADDRESS))
+    {
+        return DMA_ENGINE_PDMA;
+    }
+
+    pdma_cycles = calibrated_cycles[src_region][dest_region][class_index][DMA_ENGINE_PDMA];
+    fdma_cycles = calibrated_cycles[src_region][dest_region][class_index][DMA_ENGINE_FDMA];
+
+    if ((0u != pdma_cycles) && (0u != fdma_cycles) && (fdma_cycles < pdma_cycles))
+    {
+        return DMA_ENGINE_FDMA;
+    }
+
+    return DMA_ENGINE_PDMA;
+}
+
+dma_engine_status_t
+dma_engine_submit(dma_engine_transfer_t *transfer)
+{
+    dma_engine_id_t engine = transfer->engine;
+
+    if ((0u == transfer->num_bytes) || (0u == transfer->src_addr) || (0u == transfer->dest_addr))
+    {
+        return DMA_ENGINE_INVALID_TRANSFER;
+    }
+
+    if (DMA_ENGINE_AUTO == engine)
+    {
+        engine = dma_engine_select(transfer->src_addr, transfer->dest_addr, transfer->num_bytes);
+
+        /* Use the other engine rather than wait for the faster one */
+        if ((NULL != active_transfer[engine]) && (NULL != fdma_instance) &&
+            ((transfer->src_addr + transfer->num_bytes) <= FDMA_MAX_ADDRESS) &&
+            ((transfer->dest_addr + transfer->num_bytes) <= FDMA_MAX_ADDRESS))
+        {
+            engine = (DMA_ENGINE_PDMA == engine) ? DMA_ENGINE_FDMA : DMA_ENGINE_PDMA;
+        }
+    }
+
+    if ((DMA_ENGINE_FDMA == engine) &&
+        ((NULL == fdma_instance) || ((transfer->src_addr + transfer->num_bytes) > FDMA_MAX_ADDRESS) ||
+         ((transfer->dest_addr + transfer->num_bytes) > FDMA_MAX_ADDRESS)))
+    {
+        return DMA_ENGINE_INVALID_TRANSFER;
+    }
+
+    if (NULL != active_transfer[engine])
+    {
+        return DMA_ENGINE_BUSY;
+    }
+
+    transfer->engine = engine;
+    transfer->status = DMA_ENGINE_IN_PROGRESS;
+    active_transfer[engine] = transfer;
+
+    if (DMA_ENGINE_PDMA == engine)
+    {
+        pdma_request.src_addr = transfer->src_addr;
+        pdma_request.dest_addr = transfer->dest_addr;
+        pdma_request.num_bytes = transfer->num_bytes;
+        pdma_request.force_order = 0u;
+        pdma_request.handler = pdma_request_done;
+        pdma_request.context = transfer;
+
+        if (MSS_PDMA_OK != MSS_PDMA_submit_request(DMA_ENGINE_PDMA_CHANNEL, &pdma_request))
+        {
+            active_transfer[engine] = NULL;
+            transfer->status = DMA_ENGINE_TRANSFER_ERROR;
+            return DMA_ENGINE_TRANSFER_ERROR;
+        }
+    }
+    else
+    {
+        if (0 != AXI4DMA_configure(fdma_instance,
+                                   DMA_ENGINE_FDMA_DESCRIPTOR,
+                                   OP_INC_ADDR,
+                                   OP_INC_ADDR,
+                                   transfer->num_bytes,
+                                   (uint32_t)transfer->src_addr,
+                                   (uint32_t)transfer->dest_addr))
+        {
+            active_transfer[engine] = NULL;
+            transfer->status = DMA_ENGINE_TRANSFER_ERROR;
+            return DMA_ENGINE_TRANSFER_ERROR;
+        }
+
+        AXI4DMA_start_transfer(fdma_instance, DMA_ENGINE_FDMA_DESCRIPTOR);
+    }
+
+    return DMA_ENGINE_OK;
+}
+
+void
+dma_engine_wait(dma_engine_transfer_t *transfer)
+{
+    while (DMA_ENGINE_IN_PROGRESS == transfer->status)
+    {
+        ;
+    }
+}
+
+void
+dma_engine_calibrate(uint64_t src_addr, uint64_t dest_addr, uint32_t max_bytes)
+{
+    dma_region_t src_region = dma_engine_region(src_addr);
+    dma_region_t dest_region = dma_engine_region(dest_addr);
+    dma_engine_transfer_t transfer;
+    uint64_t start_mcycle;
+    uint32_t class_index;
+    uint32_t engine;
+
+    transfer.src_addr = src_addr;
+    transfer.dest_addr = dest_addr;
+    transfer.handler = NULL;
+    transfer.context = NULL;
+
+    for (class_index = 0u; class_index < DMA_ENGINE_SIZE_CLASS_COUNT; class_index++)
+    {
+        if (size_class_bytes[class_index] > max_bytes)
+        {
+            break;
+        }
+
+        transfer.num_bytes = size_class_bytes[class_index];
+
+        for (engine = 0u; engine < DMA_ENGINE_COUNT; engine++)
+        {
+            transfer.engine = (dma_engine_id_t)engine;
+
+            start_mcycle = readmcycle();
+
+            if (DMA_ENGINE_OK != dma_engine_submit(&transfer))
+            {
+                calibrated_cycles[src_region][dest_region][class_index][engine] = 0u;
+                continue;
+            }
+
+            dma_engine_wait(&transfer);
+
+            if (DMA_ENGINE_OK == transfer.status)
+            {
+                calibrated_cycles[src_region][dest_region][class_index][engine] =
+                    readmcycle() - start_mcycle;
+            }
+            else
+            {
+                calibrated_cycles[src_region][dest_region][class_index][engine] = 0u;
+            }
+        }
+    }
+}
+
+uint64_t
+dma_engine_calibrated_cycles(dma_region_t src_region,
+                             dma_region_t dest_region,
+                             uint32_t size_class_index,
+                             dma_engine_id_t engine)
+{
+    if ((src_region >= DMA_REGION_COUNT) || (dest_region >= DMA_REGION_COUNT) ||
+        (size_class_index >= DMA_ENGINE_SIZE_CLASS_COUNT) || (engine >= DMA_ENGINE_COUNT))
+    {
+        return 0u;
+    }
+
+    return calibrated_cycles[src_region][dest_region][size_class_index][engine];
+}
+
+uint32_t
+dma_engine_size_class_bytes(uint32_t size_class_index)
+{
+    if (size_class_index >= DMA_ENGINE_SIZE_CLASS_COUNT)
+    {
+        return 0u;
+    }
+
+    return size_class_bytes[size_class_index];
+}
+
+uint8_t
+dma_engine_fdma_complete(uint32_t irq_status)
+{
+    uint32_t transaction_status = irq_status & 0xFu;
+    uint32_t descriptor = (irq_status >> 4u) & 0x3Fu;
+
+    if ((DMA_ENGINE_FDMA_DESCRIPTOR != descriptor) || (NULL == active_transfer[DMA_ENGINE_FDMA]))
+    {
+        return 0u;
+    }
+
+    if (AXI4DMA_OP_COMPLETE_INTR_MASK == transaction_status)
+    {
+        complete_transfer(DMA_ENGINE_FDMA, DMA_ENGINE_OK);
+    }
+    else
+    {
+        complete_transfer(DMA_ENGINE_FDMA, DMA_ENGINE_TRANSFER_ERROR);
+    }
+
+    return 1u;
+}
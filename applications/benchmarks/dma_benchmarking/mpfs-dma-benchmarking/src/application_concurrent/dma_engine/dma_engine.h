@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Common interface over the MSS Platform DMA (P-DMA) and the
+ * CoreAXI4DMAController (F-DMA).
+ *
+ * A copy is submitted with dma_engine_submit(). When DMA_ENGINE_AUTO is
+ * requested, the engine is chosen from a table of transfer times indexed by
+ * source memory region, destination memory region and transfer size. The
+ * table is filled in on the target by dma_engine_calibrate(), so the routing
+ * follows the throughput actually measured on the running bitstream. Region
+ * pairs that have not been calibrated are routed to the P-DMA.
+ *
+ * The P-DMA side uses the request queue of DMA_ENGINE_PDMA_CHANNEL, whose PLIC
+ * done and error interrupts must be enabled by the application. The F-DMA side
+ * uses internal descriptor DMA_ENGINE_FDMA_DESCRIPTOR; the application's
+ * CoreAXI4DMAController interrupt handler must pass the interrupt status to
+ * dma_engine_fdma_complete().
+ */
+
+#ifndef DMA_ENGINE_H_
+#define DMA_ENGINE_H_
+
+#include <stdint.h>
+#include "drivers/fpga_ip/CoreAXI4DMAController/core_axi4dmacontroller.h"
+#include "drivers/mss/mss_pdma/mss_pdma.h"
+
+/* P-DMA channel and F-DMA descriptor reserved for the engine layer */
+#ifndef DMA_ENGINE_PDMA_CHANNEL
+#define DMA_ENGINE_PDMA_CHANNEL     (MSS_PDMA_CHANNEL_1)
+#endif
+
+#ifndef DMA_ENGINE_FDMA_DESCRIPTOR
+#define DMA_ENGINE_FDMA_DESCRIPTOR  (INTRN_DESC_1)
+#endif
+
+/* Transfer sizes at which the engines are calibrated */
+#define DMA_ENGINE_SIZE_CLASS_COUNT (6u)
+
+typedef enum
+{
+    DMA_ENGINE_PDMA,
+    DMA_ENGINE_FDMA,
+    DMA_ENGINE_COUNT,
+    DMA_ENGINE_AUTO = DMA_ENGINE_COUNT
+} dma_engine_id_t;
+
+typedef enum
+{
+    DMA_REGION_L2_LIM,
+    DMA_REGION_SCRATCHPAD,
+    DMA_REGION_CACHED_DDR,
+    DMA_REGION_NON_CACHED_DDR,
+    DMA_REGION_FABRIC,
+    DMA_REGION_OTHER,
+    DMA_REGION_COUNT
+} dma_region_t;
+
+typedef enum
+{
+    DMA_ENGINE_OK,
+    DMA_ENGINE_IN_PROGRESS,
+    DMA_ENGINE_BUSY,
+    DMA_ENGINE_INVALID_TRANSFER,
+    DMA_ENGINE_TRANSFER_ERROR
+} dma_engine_status_t;
+
+struct dma_engine_transfer_;
+
+typedef void (*dma_engine_handler_t)(struct dma_engine_transfer_ *transfer);
+
+/* A copy submitted to dma_engine_submit(). engine selects the controller to
+ * use and is updated with the controller actually used. handler may be NULL,
+ * in which case status can be polled. */
+typedef struct dma_engine_transfer_
+{
+    uint64_t src_addr;
+    uint64_t dest_addr;
+    uint32_t num_bytes;
+    dma_engine_id_t engine;
+    dma_engine_handler_t handler;
+    void *context;
+    volatile dma_engine_status_t status;
+} dma_engine_transfer_t;
+
+void dma_engine_init(axi4dma_instance_t *fdma);
+
+dma_region_t dma_engine_region(uint64_t address);
+
+dma_engine_id_t dma_engine_select(uint64_t src_addr, uint64_t dest_addr, uint32_t num_bytes);
+
+dma_engine_status_t dma_engine_submit(dma_engine_transfer_t *transfer);
+
+void dma_engine_wait(dma_engine_transfer_t *transfer);
+
+void dma_engine_calibrate(uint64_t src_addr, uint64_t dest_addr, uint32_t max_bytes);
+
+uint64_t
+dma_engine_calibrated_cycles(dma_region_t src_region,
+                             dma_region_t dest_region,
+                             uint32_t size_class,
+                             dma_engine_id_t engine);
+
+uint32_t dma_engine_size_class_bytes(uint32_t size_class);
+
+uint8_t dma_engine_fdma_complete(uint32_t irq_status);
+
+#endif /* DMA_ENGINE_H_ */
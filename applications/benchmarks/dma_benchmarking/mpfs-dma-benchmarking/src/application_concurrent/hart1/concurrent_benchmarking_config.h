@@ -8,6 +8,7 @@
 #define CONCURRENT_BENCHMARKING_CONFIG_H_
 
 #include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
 
 /* Setting the size range in the benchmarks to be run */
 #define MIN_TRANSFER_SIZE_BYTES (1000u)
@@ -57,6 +58,31 @@
 
 #define CONCURRENT_BENCHMARKING_LIST_SIZE (24u)
 
+/* AXI switch QoS contention benchmark: for every port in qos_port_list and
+ * every QoS value from 0 to QOS_VALUE_MAX in steps of QOS_VALUE_STEP, the P-DMA
+ * and F-DMA copy QOS_TRANSFER_SIZE_BYTES concurrently QOS_REPETITIONS times
+ * while the harts in QOS_LOAD_HART_MASK generate DDR traffic. */
+#define QOS_TRANSFER_SIZE_BYTES           (0x40000u)
+#define QOS_REPETITIONS                   (16u)
+#define QOS_VALUE_MAX                     (15u)
+#define QOS_VALUE_STEP                    (5u)
+#define QOS_LOAD_HART_MASK                ((1u << 2u) | (1u << 3u) | (1u << 4u))
+#define QOS_PORT_LIST_SIZE                (6u)
+
+/* L2 way partition benchmark: hart 1 walks a random cycle through its
+ * L2_PART_WORKSET_BYTES working set L2_PART_ITERATIONS times, without and then
+ * with the harts in L2_PART_LOAD_HART_MASK streaming through DDR. This is done
+ * with the MSS Configurator way masks, then keeping 1 to n - 1 of the n L2
+ * cache ways for hart 1 alone, the other masters sharing the rest. The working
+ * set must fit in the ways kept, one way is WAY_BYTE_LENGTH (128 KB).
+ * L2_PART_EVICT_ADDRESS is WAY_BYTE_LENGTH of cached DDR used to empty hart
+ * 1's ways when they are handed over. */
+#define L2_PART_WORKSET_ADDRESS           (0x8C000000u)
+#define L2_PART_WORKSET_BYTES             (0x18000u)
+#define L2_PART_EVICT_ADDRESS             (0x8E000000u)
+#define L2_PART_ITERATIONS                (128u)
+#define L2_PART_LOAD_HART_MASK            ((1u << 2u) | (1u << 3u) | (1u << 4u))
+
 #define STREAM_DEST_OPERAND               (0x0001u << 0u)
 #define STREAM_DEST_DATA_READY            (0x0001u << 2u)
 #define STREAM_DESCRIPTOR_VALID           (0x0001u << 3u)
@@ -122,6 +148,14 @@ typedef enum
     TRANSFER_DATA_MATCH
 } data_integrity_status_t;
 
+/* AXI switch master port swept by the QoS contention benchmark */
+
+typedef struct
+{
+    mss_axisw_mport_t port;
+    const char *name;
+} qos_port_t;
+
 /* Benchmarking parameters structure */
 
 typedef struct
@@ -382,4 +416,15 @@ const dma_benchmarking_params_t pdma_benchmark_list[CONCURRENT_BENCHMARKING_LIST
      MAX_TRANSFER_SIZE_BYTES,
      TRANSFER_STEP_SIZE}};
 
+/*
+ * AXI switch master ports swept by the QoS contention benchmark
+ */
+
+const qos_port_t qos_port_list[QOS_PORT_LIST_SIZE] = {{MSS_AXISW_FIC0_RD_CHAN, "FIC0 Read"},
+                                                      {MSS_AXISW_FIC0_WR_CHAN, "FIC0 Write"},
+                                                      {MSS_AXISW_CPLEX_D0_RD_CHAN, "CPLEX D0 Read"},
+                                                      {MSS_AXISW_CPLEX_D0_WR_CHAN, "CPLEX D0 Write"},
+                                                      {MSS_AXISW_CPLEX_NC_RD_CHAN, "CPLEX NC Read"},
+                                                      {MSS_AXISW_CPLEX_NC_WR_CHAN, "CPLEX NC Write"}};
+
 #endif /* CONCURRENT_BENCHMARKING_CONFIG_H_ */
@@ -8,6 +8,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "concurrent_benchmarking_config.h"
+#include "ddr_load/ddr_load.h"
+#include "dma_engine/dma_engine.h"
 #include "drivers/fpga_ip/CoreAXI4DMAController/core_axi4dmacontroller.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
 #include "drivers/mss/mss_pdma/mss_pdma.h"
@@ -45,6 +47,9 @@ static const char pdma_options[] = "\r\n\t1: Cached DDR to Cached DDR\r\n"
                                    "\t4: Non-Cached DDR to Non-Cached DDR\r\n"
                                    "\r\n"
                                    "\ta: Run all benchmarks\r\n"
+                                   "\tr: Route copies to the faster DMA engine\r\n"
+                                   "\tq: AXI switch QoS contention matrix\r\n"
+                                   "\tl: L2 way partitioning against noisy neighbour harts\r\n"
                                    "\tTo register a selection please press \'ENTER\'.\r\n\r\n";
 
 static const char fdma_menu_greeting[] =
@@ -79,6 +84,40 @@ static const char table_header[] = " Data             PDMA             FDMA
 static const char greeting_message[] =
     "\r\n\r\n\r\n **** PolarFire SoC Concurrent DMA Benchmarking Application ****\r\n";
 
+static const char engine_table_header[] =
+    " Data             Source           Destination      Selected         PDMA             FDMA\r\n"
+    " Size             Address          Address          Engine           Time             Time\r\n"
+    " (Bytes)                                                             (micro-sec)      (micro-sec)\r\n";
+
+static const char qos_divider[] =
+    "===================================================================================="
+    "==================================================================================="
+    "===\r\n";
+
+static const char qos_table_header[] =
+    " Master           QoS              QoS              PDMA             PDMA             "
+    "PDMA             FDMA             FDMA             FDMA             CPU\r\n"
+    " Port             Value            Write            Rate             Mean Latency     "
+    "Max Latency      Rate             Mean Latency     Max Latency      Load Rate\r\n"
+    "                                                    (MB/s)           (micro-sec)      "
+    "(micro-sec)      (MB/s)           (micro-sec)      (micro-sec)      (MB/s)\r\n";
+
+static const char l2_part_table_header[] =
+    " Hart 1           Neighbour        Min              Median           99th             "
+    "Max              Neighbour\r\n"
+    " L2 Ways          Load             Walk Time        Walk Time        Percentile       "
+    "Walk Time        Load Rate\r\n"
+    "                                   (micro-sec)      (micro-sec)      (micro-sec)      "
+    "(micro-sec)      (MB/s)\r\n";
+
+/* Region pairs calibrated and exercised by the DMA engine benchmark */
+static const uint64_t engine_region_pairs[4][2] = {
+    {PDMA_CAHCED_DDR0, PDMA_CACHED_DDR1},
+    {PDMA_CAHCED_DDR0, PDMA_NON_CACHED_DDR0},
+    {PDMA_NON_CACHED_DDR0, PDMA_CACHED_DDR1},
+    {PDMA_NON_CACHED_DDR0, PDMA_NON_CACHED_DDR1},
+};
+
 static const char memory_descriptors[3][21] = {"Cached DDR", "Non-Cached DDR", "FPGA Fabric"};
 
 void
@@ -102,10 +141,17 @@ configure_board(void)
     PLIC_SetPriority(DMA_CH0_DONE_IRQn, 2u);
     PLIC_SetPriority(DMA_CH0_ERR_IRQn, 1u);
 
+    PLIC_SetPriority(DMA_CH1_DONE_IRQn, 2u);
+    PLIC_SetPriority(DMA_CH1_ERR_IRQn, 1u);
+
     /* Enable PDMA Interrupts. */
     PLIC_EnableIRQ(DMA_CH0_DONE_IRQn);
     PLIC_EnableIRQ(DMA_CH0_ERR_IRQn);
 
+    /* Channel 1 is used by the DMA engine layer */
+    PLIC_EnableIRQ(DMA_CH1_DONE_IRQn);
+    PLIC_EnableIRQ(DMA_CH1_ERR_IRQn);
+
     MSS_UART_init(uart1,
                   MSS_UART_115200_BAUD,
                   MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY | MSS_UART_ONE_STOP_BIT);
@@ -192,6 +238,17 @@ PLIC_f2m_2_IRQHandler(void)
 
     uint32_t irq_status = AXI4DMA_transfer_status(&g_dmac, IRQ_NUM_0, &desc_id, &ext_ptr_addr);
 
+    /* Transfers submitted through the DMA engine layer */
+    if (dma_engine_fdma_complete(irq_status))
+    {
+        AXI4DMA_clear_irq(&g_dmac,
+                          IRQ_NUM_0,
+                          AXI4DMA_OP_COMPLETE_INTR_MASK | AXI4DMA_WR_ERR_INTR_MASK |
+                              AXI4DMA_RD_ERR_INTR_MASK | AXI4DMA_INVALID_DESC_INTR_MASK);
+
+        return EXT_IRQ_KEEP_ENABLED;
+    }
+
     transaction_status = irq_status & 0xFu;
     descriptor = (irq_status >> 4u) & 0x3Fu;
 
@@ -379,6 +436,559 @@ stream_transfer_verify_data(uint64_t transfer_size, uint64_t destination_address
     return TRANSFER_DATA_MATCH;
 }
 
+static void
+run_dma_engine_benchmark(void)
+{
+    dma_engine_transfer_t transfer;
+    uint64_t cycles;
+    uint32_t pair;
+    uint32_t size_class;
+    uint32_t transfer_size;
+    char results_cell[21] = {0};
+
+    MSS_UART_polled_tx_string(uart1, "\r\n\r\nCalibrating DMA engines.\r\n\r\n");
+
+    for (pair = 0u; pair < 4u; pair++)
+    {
+        dma_engine_calibrate(engine_region_pairs[pair][0u],
+                             engine_region_pairs[pair][1u],
+                             dma_engine_size_class_bytes(DMA_ENGINE_SIZE_CLASS_COUNT - 1u));
+    }
+
+    MSS_UART_polled_tx_string(uart1, divider);
+    MSS_UART_polled_tx_string(uart1, engine_table_header);
+    MSS_UART_polled_tx_string(uart1, divider);
+
+    for (pair = 0u; pair < 4u; pair++)
+    {
+        for (size_class = 0u; size_class < DMA_ENGINE_SIZE_CLASS_COUNT; size_class++)
+        {
+            transfer_size = dma_engine_size_class_bytes(size_class);
+
+            clear_64_mem((uint64_t *)engine_region_pairs[pair][1u],
+                         (uint64_t *)(engine_region_pairs[pair][1u] + transfer_size));
+
+            /* Set a repeating pattern in the source memory block */
+            for (uint32_t index = 0; index < transfer_size; index++)
+            {
+                *((uint8_t *)engine_region_pairs[pair][0u] + index) = ((index + 0x1u) & 0xFFu);
+            }
+
+            transfer.src_addr = engine_region_pairs[pair][0u];
+            transfer.dest_addr = engine_region_pairs[pair][1u];
+            transfer.num_bytes = transfer_size;
+            transfer.engine = DMA_ENGINE_AUTO;
+            transfer.handler = NULL;
+            transfer.context = NULL;
+
+            if (DMA_ENGINE_OK != dma_engine_submit(&transfer))
+            {
+                MSS_UART_polled_tx_string(uart1, "\r\nError: DMA engine submit!\r\n");
+                benchmark_error_count++;
+                continue;
+            }
+
+            dma_engine_wait(&transfer);
+
+            if ((DMA_ENGINE_OK != transfer.status) ||
+                (TRANSFER_DATA_MISMATCH ==
+                 block_transfer_verify_data(transfer_size,
+                                            (uint8_t *)engine_region_pairs[pair][0u],
+                                            (uint8_t *)engine_region_pairs[pair][1u])))
+            {
+                MSS_UART_polled_tx_string(uart1, "\r\nError: DMA engine transfer!\r\n");
+                benchmark_error_count++;
+                continue;
+            }
+
+            sprintf(results_cell, "%d", transfer_size);
+            print_table_cell(results_cell);
+
+            print_table_cell((DMA_REGION_CACHED_DDR ==
+                              dma_engine_region(engine_region_pairs[pair][0u]))
+                                 ? memory_descriptors[0]
+                                 : memory_descriptors[1]);
+            print_table_cell((DMA_REGION_CACHED_DDR ==
+                              dma_engine_region(engine_region_pairs[pair][1u]))
+                                 ? memory_descriptors[0]
+                                 : memory_descriptors[1]);
+            print_table_cell((DMA_ENGINE_PDMA == transfer.engine) ? "PDMA" : "FDMA");
+
+            for (uint32_t engine = 0u; engine < DMA_ENGINE_COUNT; engine++)
+            {
+                cycles = dma_engine_calibrated_cycles(
+                    dma_engine_region(engine_region_pairs[pair][0u]),
+                    dma_engine_region(engine_region_pairs[pair][1u]),
+                    size_class,
+                    (dma_engine_id_t)engine);
+
+                sprintf(results_cell,
+                        "%.3f",
+                        (1000000 * cycles) / (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK);
+                print_table_cell(results_cell);
+            }
+
+            MSS_UART_polled_tx_string(uart1, "\r\n");
+        }
+
+        MSS_UART_polled_tx_string(uart1, divider);
+    }
+
+    pdma_print_error_count();
+}
+
+static double
+cycles_to_micro_seconds(uint64_t cycles)
+{
+    return (1000000 * cycles) / (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK;
+}
+
+static double
+cycles_to_mb_per_sec(uint64_t cycles, uint64_t bytes)
+{
+    if (0u == cycles)
+    {
+        return 0.0;
+    }
+
+    return (bytes * (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK) / (cycles * 1000000.0);
+}
+
+/* Runs QOS_REPETITIONS concurrent P-DMA and F-DMA copies with the CPU load
+ * active and prints one row of the QoS contention matrix. Returns 0 if a
+ * transfer failed.
+ */
+static uint32_t
+run_qos_measurement(const qos_port_t *qos_port, uint32_t qos_value, uint32_t qos_write_error)
+{
+    mss_pdma_channel_config_t pdma_config_ch;
+    uint64_t start_mcycle;
+    uint64_t load_start_mcycle;
+    uint64_t load_cycles;
+    uint64_t latency;
+    uint64_t pdma_total = 0u;
+    uint64_t pdma_max = 0u;
+    uint64_t fdma_total = 0u;
+    uint64_t fdma_max = 0u;
+    uint64_t load_bytes = 0u;
+    uint32_t pdma_error_count = pdma_error_interrupt_count;
+    uint32_t repetition;
+    uint32_t hart_id;
+    char results_cell[21] = {0};
+
+    ddr_load_start(QOS_LOAD_HART_MASK);
+    load_start_mcycle = readmcycle();
+
+    for (repetition = 0u; repetition < QOS_REPETITIONS; repetition++)
+    {
+        pdma_transfer_status = PDMA_TRANSFER_INCOMPLETE;
+        fdma_transfer_status = FDMA_TRANSFER_INCOMPLETE;
+
+        configure_pdma(&pdma_config_ch,
+                       (uint64_t)PDMA_CAHCED_DDR0,
+                       (uint64_t)PDMA_CACHED_DDR1,
+                       QOS_TRANSFER_SIZE_BYTES);
+
+        if (MSS_PDMA_setup_transfer(MSS_PDMA_CHANNEL_0, &pdma_config_ch, pdma_isr) != MSS_PDMA_OK)
+        {
+            MSS_UART_polled_tx_string(uart1, "\r\nError: Setup Transfer!\r\n");
+            ddr_load_stop();
+            return 0u;
+        }
+
+        AXI4DMA_configure(&g_dmac,
+                          INTRN_DESC_0,
+                          OP_INC_ADDR,
+                          OP_INC_ADDR,
+                          QOS_TRANSFER_SIZE_BYTES,
+                          FDMA_CAHCED_DDR0,
+                          FDMA_CACHED_DDR1);
+
+        start_mcycle = readmcycle();
+
+        (void)MSS_PDMA_start_transfer(MSS_PDMA_CHANNEL_0);
+        AXI4DMA_start_transfer(&g_dmac, INTRN_DESC_0);
+
+        while ((PDMA_TRANSFER_COMPLETE != pdma_transfer_status) ||
+               (BLOCK_TRANSFER_COMPLETE != fdma_transfer_status))
+        {
+            if ((FDMA_TRANSFER_ERROR == fdma_transfer_status) ||
+                (PDMA_TRANSFER_ERROR == pdma_transfer_status) ||
+                (pdma_error_count != pdma_error_interrupt_count))
+            {
+                ddr_load_stop();
+                error_reporter();
+                return 0u;
+            }
+        }
+
+        latency = pdma_end_mcycle - start_mcycle;
+        pdma_total += latency;
+        pdma_max = (latency > pdma_max) ? latency : pdma_max;
+
+        latency = fdma_end_mcycle - start_mcycle;
+        fdma_total += latency;
+        fdma_max = (latency > fdma_max) ? latency : fdma_max;
+    }
+
+    load_cycles = readmcycle() - load_start_mcycle;
+    ddr_load_stop();
+
+    for (hart_id = DDR_LOAD_FIRST_HART; hart_id <= DDR_LOAD_LAST_HART; hart_id++)
+    {
+        load_bytes += ddr_load_bytes(hart_id);
+    }
+
+    if ((TRANSFER_DATA_MISMATCH == block_transfer_verify_data(QOS_TRANSFER_SIZE_BYTES,
+                                                              (uint8_t *)PDMA_CAHCED_DDR0,
+                                                              (uint8_t *)PDMA_CACHED_DDR1)) ||
+        (TRANSFER_DATA_MISMATCH == block_transfer_verify_data(QOS_TRANSFER_SIZE_BYTES,
+                                                              (uint8_t *)FDMA_CAHCED_DDR0,
+                                                              (uint8_t *)FDMA_CACHED_DDR1)))
+    {
+        MSS_UART_polled_tx_string(uart1, "\r\nError Data Mismatch!!\r\n");
+        return 0u;
+    }
+
+    print_table_cell(qos_port->name);
+
+    sprintf(results_cell, "%u", qos_value);
+    print_table_cell(results_cell);
+
+    /* The switch reports an error for QoS writes when it is not configured
+     * for programmable QoS */
+    print_table_cell(qos_write_error ? "Rejected" : "Accepted");
+
+    sprintf(results_cell,
+            "%.1f",
+            cycles_to_mb_per_sec(pdma_total,
+                                 (uint64_t)QOS_TRANSFER_SIZE_BYTES * QOS_REPETITIONS));
+    print_table_cell(results_cell);
+    sprintf(results_cell, "%.2f", cycles_to_micro_seconds(pdma_total / QOS_REPETITIONS));
+    print_table_cell(results_cell);
+    sprintf(results_cell, "%.2f", cycles_to_micro_seconds(pdma_max));
+    print_table_cell(results_cell);
+
+    sprintf(results_cell,
+            "%.1f",
+            cycles_to_mb_per_sec(fdma_total,
+                                 (uint64_t)QOS_TRANSFER_SIZE_BYTES * QOS_REPETITIONS));
+    print_table_cell(results_cell);
+    sprintf(results_cell, "%.2f", cycles_to_micro_seconds(fdma_total / QOS_REPETITIONS));
+    print_table_cell(results_cell);
+    sprintf(results_cell, "%.2f", cycles_to_micro_seconds(fdma_max));
+    print_table_cell(results_cell);
+
+    sprintf(results_cell, "%.1f", cycles_to_mb_per_sec(load_cycles, load_bytes));
+    print_table_cell(results_cell);
+
+    MSS_UART_polled_tx_string(uart1, "\r\n");
+
+    return 1u;
+}
+
+/* Sweeps the QoS value of each port in qos_port_list while both DMA
+ * controllers and the CPU load compete for DDR, restoring each port's QoS
+ * value afterwards.
+ */
+static void
+run_qos_benchmark(void)
+{
+    uint32_t port_index;
+    uint32_t qos_value;
+    uint32_t original_qos;
+    uint32_t read_error;
+    uint32_t write_error;
+
+    /* Set a repeating pattern in the source memory blocks */
+    for (uint32_t index = 0; index < QOS_TRANSFER_SIZE_BYTES; index++)
+    {
+        *((uint8_t *)PDMA_CAHCED_DDR0 + index) = ((index + 0x1u) & 0xFFu);
+        *((uint8_t *)FDMA_CAHCED_DDR0 + index) = ((index + 0x1u) & 0xFFu);
+    }
+
+    MSS_UART_polled_tx_string(uart1, qos_divider);
+    MSS_UART_polled_tx_string(uart1, qos_table_header);
+    MSS_UART_polled_tx_string(uart1, qos_divider);
+
+    for (port_index = 0u; port_index < QOS_PORT_LIST_SIZE; port_index++)
+    {
+        read_error = MSS_AXISW_read_qos_val(qos_port_list[port_index].port, &original_qos);
+
+        for (qos_value = 0u; qos_value <= QOS_VALUE_MAX; qos_value += QOS_VALUE_STEP)
+        {
+            write_error = MSS_AXISW_write_qos_val(qos_port_list[port_index].port, qos_value);
+
+            if (0u == run_qos_measurement(&qos_port_list[port_index], qos_value, write_error))
+            {
+                benchmark_error_count++;
+            }
+        }
+
+        if (0u == read_error)
+        {
+            (void)MSS_AXISW_write_qos_val(qos_port_list[port_index].port, original_qos);
+        }
+
+        MSS_UART_polled_tx_string(uart1, qos_divider);
+    }
+
+    pdma_print_error_count();
+}
+
+/* L2 way partition benchmark */
+#define L2_PART_LINES     (L2_PART_WORKSET_BYTES / CACHE_BLOCK_BYTE_LENGTH)
+#define L2_PART_P99_INDEX ((((L2_PART_ITERATIONS * 99u) + 99u) / 100u) - 1u)
+
+static uint64_t l2_part_samples[L2_PART_ITERATIONS];
+static volatile uintptr_t l2_part_sink;
+
+static int
+compare_cycles(const void *a, const void *b)
+{
+    const uint64_t left = *(const uint64_t *)a;
+    const uint64_t right = *(const uint64_t *)b;
+
+    return (left > right) - (left < right);
+}
+
+/* Links the lines of the working set into a single random cycle (Sattolo's
+ * algorithm), so that every line is visited once per walk and the hardware
+ * prefetcher cannot follow it.
+ */
+static void
+l2_part_build_workset(void)
+{
+    uintptr_t *line = (uintptr_t *)(uintptr_t)L2_PART_WORKSET_ADDRESS;
+    const uint32_t stride = CACHE_BLOCK_BYTE_LENGTH / sizeof(uintptr_t);
+    uint32_t seed = 0x2545F491u;
+    uint32_t index;
+    uint32_t other;
+    uintptr_t swap;
+
+    for (index = 0u; index < L2_PART_LINES; index++)
+    {
+        line[index * stride] = index;
+    }
+
+    for (index = L2_PART_LINES - 1u; index > 0u; index--)
+    {
+        seed ^= seed << 13u;
+        seed ^= seed >> 17u;
+        seed ^= seed << 5u;
+        other = seed % index;
+        swap = line[index * stride];
+        line[index * stride] = line[other * stride];
+        line[other * stride] = swap;
+    }
+
+    for (index = 0u; index < L2_PART_LINES; index++)
+    {
+        line[index * stride] =
+            L2_PART_WORKSET_ADDRESS + (line[index * stride] * CACHE_BLOCK_BYTE_LENGTH);
+    }
+}
+
+/* Returns the mcycles taken by one walk of the working set */
+static uint64_t
+l2_part_walk(void)
+{
+    uintptr_t next = L2_PART_WORKSET_ADDRESS;
+    uint64_t start_mcycle = readmcycle();
+    uint32_t load;
+
+    for (load = 0u; load < L2_PART_LINES; load++)
+    {
+        next = *(volatile uintptr_t *)next;
+    }
+
+    l2_part_sink = next;
+    return readmcycle() - start_mcycle;
+}
+
+/* Keeps the lowest private_ways cache ways for hart 1 and gives the rest to
+ * every other master. 0 restores the MSS Configurator way masks. Returns 0 if
+ * the partition could not be applied.
+ */
+static uint32_t
+apply_l2_partition(uint32_t private_ways)
+{
+    uint64_t cache_ways = mss_l2_cache_way_mask();
+    uint64_t hart1_ways = 0u;
+    uint64_t way;
+    uint32_t count = 0u;
+    uint32_t master;
+    uint32_t status = (uint32_t)MSS_L2_WAY_OK;
+
+    if (0u == private_ways)
+    {
+        mss_l2_restore_way_masks();
+        mss_l2_flush_range(L2_PART_WORKSET_ADDRESS, L2_PART_WORKSET_BYTES);
+        return 1u;
+    }
+
+    for (way = 1u; (0u != way) && (count < private_ways); way <<= 1u)
+    {
+        if (cache_ways & way)
+        {
+            hart1_ways |= way;
+            count++;
+        }
+    }
+
+    if ((count < private_ways) || (hart1_ways == cache_ways))
+    {
+        return 0u;
+    }
+
+    /* Move the other masters out first, then empty the ways hart 1 takes
+     * over, writing back whatever the other masters left dirty there. */
+    for (master = 0u; master < (uint32_t)MSS_L2_NB_MASTERS; master++)
+    {
+        if ((MSS_L2_MASTER_DCACHE(1u) != master) && (MSS_L2_MASTER_ICACHE(1u) != master))
+        {
+            status |= mss_l2_set_way_mask((MSS_L2_MASTER)master, cache_ways & ~hart1_ways, 0u, 0u);
+        }
+    }
+
+    status |= mss_l2_set_way_mask(MSS_L2_MASTER_ICACHE(1u), hart1_ways, 0u, 0u);
+    status |= mss_l2_evict_ways(hart1_ways, L2_PART_EVICT_ADDRESS);
+
+    /* Flush the working set so it is refetched into hart 1's ways */
+    status |= mss_l2_set_way_mask(MSS_L2_MASTER_DCACHE(1u),
+                                  hart1_ways,
+                                  L2_PART_WORKSET_ADDRESS,
+                                  L2_PART_WORKSET_BYTES);
+
+    return ((uint32_t)MSS_L2_WAY_OK == status) ? 1u : 0u;
+}
+
+/* Walks the working set L2_PART_ITERATIONS times, with or without the DDR
+ * load, and prints one row of the partition table.
+ */
+static void
+run_l2_part_measurement(uint32_t private_ways, uint32_t loaded)
+{
+    char results_cell[21] = {0};
+    uint64_t load_start_mcycle;
+    uint64_t load_cycles;
+    uint64_t load_bytes = 0u;
+    uint32_t iteration;
+    uint32_t hart_id;
+
+    if (loaded)
+    {
+        ddr_load_start(L2_PART_LOAD_HART_MASK);
+    }
+    load_start_mcycle = readmcycle();
+
+    /* Warm up walk, fills hart 1's ways */
+    (void)l2_part_walk();
+
+    for (iteration = 0u; iteration < L2_PART_ITERATIONS; iteration++)
+    {
+        l2_part_samples[iteration] = l2_part_walk();
+    }
+
+    load_cycles = readmcycle() - load_start_mcycle;
+    if (loaded)
+    {
+        ddr_load_stop();
+
+        for (hart_id = DDR_LOAD_FIRST_HART; hart_id <= DDR_LOAD_LAST_HART; hart_id++)
+        {
+            load_bytes += ddr_load_bytes(hart_id);
+        }
+    }
+
+    qsort(l2_part_samples, L2_PART_ITERATIONS, sizeof(l2_part_samples[0]), compare_cycles);
+
+    if (0u == private_ways)
+    {
+        sprintf(results_cell, "Shared");
+    }
+    else
+    {
+        sprintf(results_cell, "%u", private_ways);
+    }
+    print_table_cell(results_cell);
+    print_table_cell(loaded ? "On" : "Off");
+
+    sprintf(results_cell, "%.2f", cycles_to_micro_seconds(l2_part_samples[0]));
+    print_table_cell(results_cell);
+    sprintf(results_cell,
+            "%.2f",
+            cycles_to_micro_seconds(l2_part_samples[L2_PART_ITERATIONS / 2u]));
+    print_table_cell(results_cell);
+    /* Nearest rank */
+    sprintf(results_cell,
+            "%.2f",
+            cycles_to_micro_seconds(l2_part_samples[L2_PART_P99_INDEX]));
+    print_table_cell(results_cell);
+    sprintf(results_cell,
+            "%.2f",
+            cycles_to_micro_seconds(l2_part_samples[L2_PART_ITERATIONS - 1u]));
+    print_table_cell(results_cell);
+    sprintf(results_cell, "%.1f", cycles_to_mb_per_sec(load_cycles, load_bytes));
+    print_table_cell(results_cell);
+
+    MSS_UART_polled_tx_string(uart1, "\r\n");
+}
+
+/* Measures the walk time of hart 1's working set, idle and with harts 2 to 4
+ * as noisy neighbours, shared and then with 1 to n - 1 of the n cache ways
+ * kept for hart 1. The MSS Configurator way masks are restored afterwards.
+ */
+static void
+run_l2_partition_benchmark(void)
+{
+    uint64_t cache_ways = mss_l2_cache_way_mask();
+    uint32_t nb_cache_ways = 0u;
+    uint32_t private_ways;
+    char results_line[100u] = {0};
+
+    while (0u != cache_ways)
+    {
+        cache_ways &= cache_ways - 1u;
+        nb_cache_ways++;
+    }
+
+    sprintf(results_line,
+            "\r\nL2 cache ways 0x%lx, working set %u bytes, %u walks\r\n",
+            mss_l2_cache_way_mask(),
+            L2_PART_WORKSET_BYTES,
+            L2_PART_ITERATIONS);
+    MSS_UART_polled_tx_string(uart1, results_line);
+
+    l2_part_build_workset();
+
+    MSS_UART_polled_tx_string(uart1, divider);
+    MSS_UART_polled_tx_string(uart1, l2_part_table_header);
+    MSS_UART_polled_tx_string(uart1, divider);
+
+    /* 0 is the shared configuration, at least one way is left to the others */
+    for (private_ways = 0u; private_ways < nb_cache_ways; private_ways++)
+    {
+        if (0u == apply_l2_partition(private_ways))
+        {
+            sprintf(results_line,
+                    "\r\nError: cannot keep %u ways for hart 1!\r\n",
+                    private_ways);
+            MSS_UART_polled_tx_string(uart1, results_line);
+            benchmark_error_count++;
+            continue;
+        }
+
+        run_l2_part_measurement(private_ways, 0u);
+        run_l2_part_measurement(private_ways, 1u);
+    }
+
+    mss_l2_restore_way_masks();
+    MSS_UART_polled_tx_string(uart1, divider);
+
+    pdma_print_error_count();
+}
+
 void
 u54_1(void)
 {
@@ -424,6 +1034,7 @@ u54_1(void)
     MSS_UART_polled_tx_string(uart1, greeting_message);
 
     AXI4DMA_init(&g_dmac, DMA_CONTROL_BASE_ADDRESS);
+    dma_engine_init(&g_dmac);
 
     /* The stream descriptor is associated with IRQ0 in the IP */
     AXI4DMA_enable_irq(&g_dmac,
@@ -450,14 +1061,31 @@ u54_1(void)
                 while (1u)
                 {
                     pdma_choice = get_user_input();
-                    if ((pdma_choice == 'a') || ((pdma_choice > '0') && (pdma_choice < '5')))
+                    if ((pdma_choice == 'a') || (pdma_choice == 'r') || (pdma_choice == 'q') ||
+                        (pdma_choice == 'l') ||
+                        ((pdma_choice > '0') && (pdma_choice < '5')))
                     {
                         break;
                     }
                     MSS_UART_polled_tx_string(uart1, invalid_selection_message);
                     MSS_UART_polled_tx_string(uart1, pdma_options);
                 }
-                if ('a' == pdma_choice)
+                if ('q' == pdma_choice)
+                {
+                    run_qos_benchmark();
+                    break;
+                }
+                else if ('l' == pdma_choice)
+                {
+                    run_l2_partition_benchmark();
+                    break;
+                }
+                else if ('r' == pdma_choice)
+                {
+                    run_dma_engine_benchmark();
+                    break;
+                }
+                else if ('a' == pdma_choice)
                 {
                     MSS_UART_polled_tx_string(uart1, "\r\n\r\nRunning all benchmarks.\r\n\r\n");
                     total_benchmarks = CONCURRENT_BENCHMARKING_LIST_SIZE;
@@ -11,6 +11,7 @@
 #include <string.h>
 #include "mpfs_hal/mss_hal.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
+#include "ddr_load/ddr_load.h"
 
 volatile uint32_t count_sw_ints_h2 = 0U;
 
@@ -47,6 +48,9 @@ void u54_2(void)
 
     while (1U)
     {
+        /* Background DDR traffic for the QoS contention benchmark */
+        ddr_load_run();
+
         icount++;
         if (0x100000U == icount)
         {
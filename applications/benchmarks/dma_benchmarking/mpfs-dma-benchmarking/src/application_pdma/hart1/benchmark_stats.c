@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Summary statistics over repeated benchmark samples.
+ */
+
+#include <stdint.h>
+#include "benchmark_stats.h"
+#include "fpga_design_config/clocks/hw_mss_clks.h"
+
+#define BYTES_TO_MEGABYTES_SCALE_FACTOR (1000000.0)
+#define SQRT_ITERATIONS                 (64u)
+
+/* Newton-Raphson square root, so that the application does not need libm */
+static double
+square_root(double value)
+{
+    double estimate = value;
+    uint32_t iteration;
+
+    if (value <= 0.0)
+    {
+        return 0.0;
+    }
+
+    for (iteration = 0u; iteration < SQRT_ITERATIONS; iteration++)
+    {
+        estimate = 0.5 * (estimate + (value / estimate));
+    }
+
+    return estimate;
+}
+
+static void
+sort_samples(uint64_t *samples, uint32_t num_samples)
+{
+    uint32_t index;
+    uint32_t position;
+    uint64_t sample;
+
+    for (index = 1u; index < num_samples; index++)
+    {
+        sample = samples[index];
+        position = index;
+
+        while ((position > 0u) && (samples[position - 1u] > sample))
+        {
+            samples[position] = samples[position - 1u];
+            position--;
+        }
+
+        samples[position] = sample;
+    }
+}
+
+void
+benchmark_stats_compute(uint64_t *samples, uint32_t num_samples, benchmark_stats_t *stats)
+{
+    uint32_t index;
+    uint32_t rank;
+    double sum = 0.0;
+    double deviation;
+    double sum_of_squares = 0.0;
+
+    if (0u == num_samples)
+    {
+        stats->min = 0u;
+        stats->median = 0u;
+        stats->p99 = 0u;
+        stats->mean = 0.0;
+        stats->stddev = 0.0;
+        return;
+    }
+
+    sort_samples(samples, num_samples);
+
+    stats->min = samples[0u];
+
+    if (num_samples & 1u)
+    {
+        stats->median = samples[num_samples / 2u];
+    }
+    else
+    {
+        stats->median = (samples[(num_samples / 2u) - 1u] + samples[num_samples / 2u]) / 2u;
+    }
+
+    /* Nearest rank: the smallest sample with at least 99% of samples at or below it */
+    rank = ((num_samples * 99u) + 99u) / 100u;
+    stats->p99 = samples[rank - 1u];
+
+    for (index = 0u; index < num_samples; index++)
+    {
+        sum += (double)samples[index];
+    }
+
+    stats->mean = sum / num_samples;
+
+    for (index = 0u; index < num_samples; index++)
+    {
+        deviation = (double)samples[index] - stats->mean;
+        sum_of_squares += deviation * deviation;
+    }
+
+    stats->stddev = square_root(sum_of_squares / num_samples);
+}
+
+double
+benchmark_stats_mb_per_sec(uint64_t clock_cycles, uint32_t transfer_size)
+{
+    double seconds = clock_cycles / (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK;
+
+    if (0u == clock_cycles)
+    {
+        return 0.0;
+    }
+
+    return (transfer_size / seconds) / BYTES_TO_MEGABYTES_SCALE_FACTOR;
+}
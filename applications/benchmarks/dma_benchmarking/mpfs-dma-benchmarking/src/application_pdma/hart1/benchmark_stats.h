@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Summary statistics over repeated benchmark samples.
+ */
+
+#ifndef BENCHMARK_STATS_H_
+#define BENCHMARK_STATS_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t min;
+    uint64_t median;
+    uint64_t p99;
+    double mean;
+    double stddev;
+} benchmark_stats_t;
+
+/* Sorts the num_samples values in samples into ascending order and computes
+ * their minimum, median, 99th percentile (nearest rank), mean and standard
+ * deviation. */
+void benchmark_stats_compute(uint64_t *samples, uint32_t num_samples, benchmark_stats_t *stats);
+
+/* Returns the throughput in megabytes (10^6 bytes) per second of a transfer of
+ * transfer_size bytes that took clock_cycles CPU clock cycles. */
+double benchmark_stats_mb_per_sec(uint64_t clock_cycles, uint32_t transfer_size);
+
+#endif /* BENCHMARK_STATS_H_ */
@@ -43,6 +43,70 @@
 
 /* Other macros*/
 #define PDMA_BENCHMARKING_LIST_SIZE (16u)
+
+/* Scatter-gather benchmark: SG_TOTAL_BYTES are gathered from segments spaced
+ * SG_SEGMENT_STRIDE_FACTOR segment sizes apart in the source into a contiguous
+ * destination. */
+#define SG_SOURCE_ADDRESS           (CACHED_DDR0)
+#define SG_DESTINATION_ADDRESS      (CACHED_DDR1)
+#define SG_TOTAL_BYTES              (65536u)
+#define SG_SEGMENT_STRIDE_FACTOR    (2u)
+#define SG_MAX_SEGMENTS             (1024u)
+#define SG_SEGMENT_SIZE_LIST_SIZE   (5u)
+
+/* Number of channel counts in the striped transfer columns */
+#define STRIPED_CHANNEL_LIST_SIZE   (3u)
+
+/* Statistical benchmark: every memory pair is copied BENCHMARK_REPETITIONS
+ * times at each size, doubling from BENCHMARK_MIN_SIZE_BYTES up to the pair's
+ * maximum transfer size. Results are printed as CSV, or as JSON lines when
+ * BENCHMARK_OUTPUT_JSON is defined. Defining BENCHMARK_NON_INTERACTIVE runs the
+ * sweep at start up without waiting for a menu selection. */
+#define BENCHMARK_REPETITIONS       (32u)
+#define BENCHMARK_MIN_SIZE_BYTES    (64u)
+#undef BENCHMARK_OUTPUT_JSON
+#undef BENCHMARK_NON_INTERACTIVE
+
+/* Defining BENCHMARK_OUTPUT_TRACE makes the statistical benchmark record its
+ * CSV lines with the HAL's MSS_TRACE() instead of formatting them on the
+ * target. The events are sent as binary frames on TRACE_UART after each memory
+ * pair and are turned back into text on the host by tools/trace_decode.py. */
+#undef BENCHMARK_OUTPUT_TRACE
+#define TRACE_UART                  (&g_mss_uart2_lo)
+#define TRACE_UART_PERIPHERAL       (MSS_PERIPH_MMUART2)
+
+/* HPM profile: every memory pair is filled, copied and verified
+ * HPM_PROFILE_REPETITIONS times at HPM_PROFILE_SIZE_BYTES (or the pair's
+ * maximum if smaller), once per HPM view, with the CPU cache misses, stalls
+ * and write backs counted separately for each step. */
+#define HPM_PROFILE_SIZE_BYTES      (65536u)
+#define HPM_PROFILE_REPETITIONS     (8u)
+#define HPM_PROFILE_VIEW_LIST_SIZE  (3u)
+
+/* CPU memory benchmark: L2-LIM and scratchpad buffers are allocated at run
+ * time with the HAL's mss_l2_mem allocator from the same areas the PDMA
+ * benchmarks use. For each memory, MEM_BENCH_COPY_BYTES are copied with
+ * memcpy() MEM_BENCH_REPETITIONS times, then MEM_BENCH_CHASE_LOADS dependent
+ * loads are made through a random cycle of MEM_BENCH_CHASE_BYTES with one
+ * pointer per MEM_BENCH_CHASE_STRIDE bytes. MEM_BENCH_CHASE_BYTES is larger
+ * than the 32KB L1 data cache so the loads reach the memory, or the L2. The
+ * cost of the allocator itself is timed over MEM_BENCH_ALLOC_OPS calls. */
+#define MEM_BENCH_COPY_BYTES        (32768u)
+#define MEM_BENCH_REPETITIONS       (32u)
+#define MEM_BENCH_CHASE_BYTES       (65536u)
+#define MEM_BENCH_CHASE_STRIDE      (64u)
+#define MEM_BENCH_CHASE_LOADS       (16384u)
+#define MEM_BENCH_POOL_BLOCK_BYTES  (64u)
+#define MEM_BENCH_POOL_BLOCKS       (32u)
+#define MEM_BENCH_ALLOC_OPS         (1024u)
+#define MEM_BENCH_MEMORY_LIST_SIZE  (4u)
+
+/* Define FABRIC_MEMORY0 to the address of a memory in the FPGA fabric, such as
+ * an LSRAM behind FIC0, to add fabric pairs to the statistical benchmark. The
+ * reference design does not provide one. */
+#undef FABRIC_MEMORY0
+#define FABRIC_MEMORY_SIZE          (0x10000u)
+#define STATS_FABRIC_LIST_SIZE      (4u)
 /* Enumerations */
 
 typedef enum
@@ -125,4 +189,28 @@ const dma_benchmarking_params_t pdma_benchmark_list[PDMA_BENCHMARKING_LIST_SIZE]
      MAX_TRANSFER_SIZE_BYTES,
      TRANSFER_STEP_SIZE}};
 
+/*
+ * Scatter-gather benchmark segment sizes
+ */
+
+const uint32_t sg_segment_size_list[SG_SEGMENT_SIZE_LIST_SIZE] = {64u, 256u, 1024u, 4096u, 16384u};
+
+#ifdef FABRIC_MEMORY0
+/*
+ * Fabric memory pairs for the statistical benchmark
+ */
+
+const dma_benchmarking_params_t stats_fabric_list[STATS_FABRIC_LIST_SIZE] = {
+    {CACHED_DDR0, FABRIC_MEMORY0, BENCHMARK_MIN_SIZE_BYTES, FABRIC_MEMORY_SIZE, 0u},
+    {NON_CACHED_DDR0, FABRIC_MEMORY0, BENCHMARK_MIN_SIZE_BYTES, FABRIC_MEMORY_SIZE, 0u},
+    {FABRIC_MEMORY0, CACHED_DDR0, BENCHMARK_MIN_SIZE_BYTES, FABRIC_MEMORY_SIZE, 0u},
+    {FABRIC_MEMORY0, NON_CACHED_DDR0, BENCHMARK_MIN_SIZE_BYTES, FABRIC_MEMORY_SIZE, 0u}};
+#endif
+
+/*
+ * Striped transfer channel counts
+ */
+
+const uint8_t striped_channel_list[STRIPED_CHANNEL_LIST_SIZE] = {1u, 2u, 4u};
+
 #endif /* PDMA_BENCHMARKING_CONFIG_H_ */
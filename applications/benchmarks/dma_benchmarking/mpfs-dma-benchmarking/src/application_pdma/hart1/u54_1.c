@@ -11,10 +11,12 @@
 #include <string.h>
 #include "fpga_design_config/clocks/hw_mss_clks.h"
 #include "pdma_benchmarking_config.h"
+#include "benchmark_stats.h"
 #include "drivers/fpga_ip/CoreAXI4DMAController/core_axi4dmacontroller.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
 #include "drivers/mss/mss_pdma/mss_pdma.h"
 #include "mpfs_hal/mss_hal.h"
+#include "mpfs_hal/mpfs_hal_version.h"
 
 #define BYTES_TO_MEGABITS_SCALE_FACTOR (125000.0)
 #define CHAR_TO_LONG_CONVERSION_BASE   (10u)
@@ -54,19 +56,32 @@ static const char pdma_options[] = "\r\n\t1: L2-Lim to L2-Lim\r\n"
                                    "\t15: Non Cached DDR to Cached DDR\r\n"
                                    "\t16: Non Cached DDR to Non Cached DDR\r\n"
                                    "\r\n"
-                                   "\ta: Run all benchmarks\r\n\r\n"
+                                   "\ta: Run all benchmarks\r\n"
+                                   "\ts: Scatter-gather segments/second benchmark\r\n"
+                                   "\tb: Statistical benchmark of all memory pairs (CSV/JSON)\r\n"
+                                   "\tp: CPU performance counter profile of all memory pairs\r\n"
+                                   "\tm: CPU memcpy and load latency of each memory\r\n\r\n"
                                    "\tTo register a selection please press \'ENTER\'.\r\n\r\n";
 
 static const char invalid_selection_message[] = "\r\n\r\nInvalid option!\r\nPlease select one "
                                                 "of the following:\r\n\r\n";
 
 static const char divider[] =
-    "======================================================================================\r\n";
+    "======================================================================================"
+    "===================================================\r\n";
 
 static const char table_header[] =
-    " Data             Source           Destination      Test             Transfer\r\n"
-    " Size             Address          Address          Result           Rate\r\n"
-    " (Bytes)                                                             (MegaBits/second)\r\n";
+    " Data             Source           Destination      Test             Transfer         "
+    "1-Channel        2-Channel        4-Channel\r\n"
+    " Size             Address          Address          Result           Rate             "
+    "Striped Rate     Striped Rate     Striped Rate\r\n"
+    " (Bytes)                                                             (MegaBits/second)"
+    "(MegaBits/sec)   (MegaBits/sec)   (MegaBits/sec)\r\n";
+
+static const char sg_table_header[] =
+    " Segment          Segments         Scatter-Gather   Single Transfer  Scatter-Gather\r\n"
+    " Size             Per List         Rate             Rate             Transfer Rate\r\n"
+    " (Bytes)                           (Segments/sec)   (Segments/sec)   (MegaBits/second)\r\n";
 
 static const char greeting_message[] =
     "\r\n\r\n\r\n **** PolarFire SoC Platform DMA Benchmarking Application ****\r\n";
@@ -100,6 +115,22 @@ get_user_input(void)
             {
                 return (uint32_t)'a';
             }
+            else if ('s' == g_rx_buff[0u])
+            {
+                return (uint32_t)'s';
+            }
+            else if ('b' == g_rx_buff[0u])
+            {
+                return (uint32_t)'b';
+            }
+            else if ('p' == g_rx_buff[0u])
+            {
+                return (uint32_t)'p';
+            }
+            else if ('m' == g_rx_buff[0u])
+            {
+                return (uint32_t)'m';
+            }
             else
             {
                 if (buffer_size < sizeof(user_input))
@@ -164,6 +195,9 @@ pdma_isr(uint8_t interrupt_type)
     {
         MSS_PDMA_clear_transfer_error_status(interrupt_type);
         pdma_error_interrupt_count++;
+#ifdef BENCHMARK_OUTPUT_TRACE
+        MSS_TRACE("# pdma channel 0 error, %u so far", pdma_error_interrupt_count);
+#endif
     }
 }
 
@@ -249,6 +283,798 @@ calculate_rate(uint64_t clock_cycles, uint32_t transfer_size)
     return transfer_rate;
 }
 
+/* Repeats a benchmark copy with MSS_PDMA_memcpy_striped() across num_channels
+ * channels, checks the copied data and returns the transfer rate.
+ */
+static double
+run_striped_transfer(uint8_t num_channels,
+                     uint64_t source_address,
+                     uint64_t destination_address,
+                     uint32_t transfer_size)
+{
+    uint64_t start_mcycle;
+    uint64_t end_mcycle;
+    mss_pdma_error_id_t striped_status;
+
+    clear_64_mem((uint64_t *)destination_address,
+                 (uint64_t *)(destination_address + transfer_size));
+
+    start_mcycle = readmcycle();
+
+#ifdef FORCE_ORDER
+    striped_status = MSS_PDMA_memcpy_striped(destination_address,
+                                             source_address,
+                                             transfer_size,
+                                             num_channels,
+                                             1u,
+                                             (mss_pdma_int_handler_t)0);
+#else
+    striped_status = MSS_PDMA_memcpy_striped(destination_address,
+                                             source_address,
+                                             transfer_size,
+                                             num_channels,
+                                             0u,
+                                             (mss_pdma_int_handler_t)0);
+#endif
+
+    end_mcycle = readmcycle();
+
+    if (MSS_PDMA_OK != striped_status)
+    {
+        pdma_error_interrupt_count++;
+        benchmark_error_count++;
+    }
+    else if (TRANSFER_DATA_MISMATCH == block_transfer_verify_data(transfer_size,
+                                                                   (uint8_t *)source_address,
+                                                                   (uint8_t *)destination_address))
+    {
+        benchmark_error_count++;
+    }
+
+    return calculate_rate((end_mcycle - start_mcycle), transfer_size);
+}
+
+static mss_pdma_sg_segment_t sg_list[SG_MAX_SEGMENTS];
+
+/* Gathers SG_TOTAL_BYTES from evenly spaced source segments into a contiguous
+ * destination, once as a single scatter-gather list and once as one PDMA
+ * transfer per segment, and prints the segment rate of each.
+ */
+static void
+run_sg_benchmark(void)
+{
+    uint32_t size_index;
+    uint32_t segment_index;
+    uint32_t segment_size;
+    uint32_t num_segments;
+    uint64_t start_mcycle;
+    uint64_t sg_mcycles;
+    uint64_t single_mcycles;
+    mss_pdma_channel_config_t pdma_config_ch;
+    char results_cell[21] = {0};
+
+    MSS_UART_polled_tx_string(uart1, divider);
+    MSS_UART_polled_tx_string(uart1, sg_table_header);
+    MSS_UART_polled_tx_string(uart1, divider);
+
+    for (size_index = 0u; size_index < SG_SEGMENT_SIZE_LIST_SIZE; size_index++)
+    {
+        segment_size = sg_segment_size_list[size_index];
+        num_segments = SG_TOTAL_BYTES / segment_size;
+
+        for (segment_index = 0u; segment_index < num_segments; segment_index++)
+        {
+            sg_list[segment_index].src_addr =
+                SG_SOURCE_ADDRESS + (segment_index * segment_size * SG_SEGMENT_STRIDE_FACTOR);
+            sg_list[segment_index].dest_addr =
+                SG_DESTINATION_ADDRESS + (segment_index * segment_size);
+            sg_list[segment_index].num_bytes = segment_size;
+
+            for (uint32_t index = 0u; index < segment_size; index++)
+            {
+                *((uint8_t *)sg_list[segment_index].src_addr + index) =
+                    ((segment_index + index) & 0xFFu);
+            }
+        }
+
+        /* Scatter-gather: one completion for the whole list */
+        clear_64_mem((uint64_t *)SG_DESTINATION_ADDRESS,
+                     (uint64_t *)(SG_DESTINATION_ADDRESS + SG_TOTAL_BYTES));
+        pdma_transfer_status = PDMA_TRANSFER_INCOMPLETE;
+
+#ifdef FORCE_ORDER
+        if (MSS_PDMA_setup_sg_transfer(MSS_PDMA_CHANNEL_0, sg_list, num_segments, 1u, pdma_isr) !=
+            MSS_PDMA_OK)
+#else
+        if (MSS_PDMA_setup_sg_transfer(MSS_PDMA_CHANNEL_0, sg_list, num_segments, 0u, pdma_isr) !=
+            MSS_PDMA_OK)
+#endif
+        {
+            MSS_UART_polled_tx_string(uart1, "\r\nError: Setup Scatter-Gather Transfer!\r\n");
+            HAL_ASSERT(0);
+            return;
+        }
+
+        start_mcycle = readmcycle();
+        MSS_PDMA_start_transfer(MSS_PDMA_CHANNEL_0);
+
+        while (PDMA_TRANSFER_INCOMPLETE == pdma_transfer_status)
+        {
+            ;
+        }
+
+        sg_mcycles = pdma_end_mcycle - start_mcycle;
+
+        for (segment_index = 0u; segment_index < num_segments; segment_index++)
+        {
+            if (TRANSFER_DATA_MISMATCH ==
+                block_transfer_verify_data(segment_size,
+                                           (uint8_t *)sg_list[segment_index].src_addr,
+                                           (uint8_t *)sg_list[segment_index].dest_addr))
+            {
+                benchmark_error_count++;
+                break;
+            }
+        }
+
+        /* Single transfers: one completion interrupt per segment */
+        clear_64_mem((uint64_t *)SG_DESTINATION_ADDRESS,
+                     (uint64_t *)(SG_DESTINATION_ADDRESS + SG_TOTAL_BYTES));
+
+        start_mcycle = readmcycle();
+
+        for (segment_index = 0u; segment_index < num_segments; segment_index++)
+        {
+            pdma_transfer_status = PDMA_TRANSFER_INCOMPLETE;
+
+            configure_pdma(&pdma_config_ch,
+                           sg_list[segment_index].src_addr,
+                           sg_list[segment_index].dest_addr,
+                           segment_size);
+
+            if (MSS_PDMA_setup_transfer(MSS_PDMA_CHANNEL_0, &pdma_config_ch, pdma_isr) !=
+                MSS_PDMA_OK)
+            {
+                MSS_UART_polled_tx_string(uart1, "\r\nError: Setup Transfer!\r\n");
+                HAL_ASSERT(0);
+                return;
+            }
+
+            MSS_PDMA_start_transfer(MSS_PDMA_CHANNEL_0);
+
+            while (PDMA_TRANSFER_INCOMPLETE == pdma_transfer_status)
+            {
+                ;
+            }
+        }
+
+        single_mcycles = pdma_end_mcycle - start_mcycle;
+
+        /* Printing the results */
+        sprintf(results_cell, "%d", segment_size);
+        print_table_cell(results_cell);
+
+        sprintf(results_cell, "%d", num_segments);
+        print_table_cell(results_cell);
+
+        sprintf(results_cell,
+                "%ld",
+                (uint64_t)((num_segments * (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK) /
+                           sg_mcycles));
+        print_table_cell(results_cell);
+
+        sprintf(results_cell,
+                "%ld",
+                (uint64_t)((num_segments * (double)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK) /
+                           single_mcycles));
+        print_table_cell(results_cell);
+
+        sprintf(results_cell, "%ld", (uint64_t)calculate_rate(sg_mcycles, SG_TOTAL_BYTES));
+        print_table_cell(results_cell);
+        MSS_UART_polled_tx_string(uart1, "\r\n");
+    }
+}
+
+static uint64_t stats_samples[BENCHMARK_REPETITIONS];
+
+#ifdef BENCHMARK_OUTPUT_TRACE
+static void
+trace_uart_write(const uint8_t *data, uint32_t length)
+{
+    MSS_UART_polled_tx(TRACE_UART, data, length);
+}
+#endif
+
+static const char *
+stats_memory_name(uint32_t address)
+{
+    switch (address)
+    {
+        case L2_LIM0:
+        case L2_LIM1:
+            return "L2-LIM";
+
+        case SCRATCHPAD0:
+        case SCRATCHPAD1:
+            return "Scratchpad";
+
+        case CACHED_DDR0:
+        case CACHED_DDR1:
+            return "Cached DDR";
+
+        case NON_CACHED_DDR0:
+        case NON_CACHED_DDR1:
+            return "Non-Cached DDR";
+
+#ifdef FABRIC_MEMORY0
+        case FABRIC_MEMORY0:
+            return "Fabric";
+#endif
+
+        default:
+            return "Unknown";
+    }
+}
+
+/* Runs one PDMA copy on channel 0 and returns its duration in mcycles through
+ * cycles. Returns 0 if the transfer could not be started or raised an error.
+ */
+static uint32_t
+stats_timed_copy(uint32_t source_address,
+                 uint32_t destination_address,
+                 uint32_t transfer_size,
+                 uint64_t *cycles)
+{
+    mss_pdma_channel_config_t pdma_config_ch;
+    uint32_t error_count = pdma_error_interrupt_count;
+    uint64_t start_mcycle;
+
+    pdma_transfer_status = PDMA_TRANSFER_INCOMPLETE;
+
+    configure_pdma(&pdma_config_ch, source_address, destination_address, transfer_size);
+
+    if (MSS_PDMA_setup_transfer(MSS_PDMA_CHANNEL_0, &pdma_config_ch, pdma_isr) != MSS_PDMA_OK)
+    {
+        return 0u;
+    }
+
+    start_mcycle = readmcycle();
+
+    if (MSS_PDMA_start_transfer(MSS_PDMA_CHANNEL_0) != MSS_PDMA_OK)
+    {
+        return 0u;
+    }
+
+    while ((PDMA_TRANSFER_INCOMPLETE == pdma_transfer_status) &&
+           (error_count == pdma_error_interrupt_count))
+    {
+        ;
+    }
+
+    if (PDMA_TRANSFER_COMPLETE != pdma_transfer_status)
+    {
+        return 0u;
+    }
+
+    *cycles = pdma_end_mcycle - start_mcycle;
+    return 1u;
+}
+
+/* Sweeps one memory pair and prints one CSV or JSON line per transfer size */
+static void
+run_stats_pair(const dma_benchmarking_params_t *params)
+{
+#ifndef BENCHMARK_OUTPUT_TRACE
+    char results_line[400u] = {0};
+#endif
+    benchmark_stats_t stats;
+    uint32_t transfer_size;
+    uint32_t repetition;
+    uint32_t verified;
+
+    for (transfer_size = BENCHMARK_MIN_SIZE_BYTES; transfer_size <= params->max_transfer_size;
+         transfer_size *= 2u)
+    {
+        clear_64_mem((uint64_t *)params->destination_address,
+                     (uint64_t *)(params->destination_address + transfer_size));
+
+        /* Set a repeating pattern in the source memory block */
+        for (uint32_t index = 0; index < transfer_size; index++)
+        {
+            *((uint8_t *)params->source_address + index) = (index & 0xFFu);
+        }
+
+        for (repetition = 0u; repetition < BENCHMARK_REPETITIONS; repetition++)
+        {
+            if (0u == stats_timed_copy(params->source_address,
+                                       params->destination_address,
+                                       transfer_size,
+                                       &stats_samples[repetition]))
+            {
+                break;
+            }
+        }
+
+        verified = ((BENCHMARK_REPETITIONS == repetition) &&
+                    (TRANSFER_DATA_MATCH ==
+                     block_transfer_verify_data(transfer_size,
+                                                (uint8_t *)params->source_address,
+                                                (uint8_t *)params->destination_address)));
+
+        if (!verified)
+        {
+            benchmark_error_count++;
+        }
+
+        benchmark_stats_compute(stats_samples, repetition, &stats);
+
+#if defined(BENCHMARK_OUTPUT_TRACE)
+        MSS_TRACE("pdma,%s,%s,%u,%u,%u,%lu,%lu,%lu,%.1f,%.1f,%.2f,%.2f",
+                  MSS_TRACE_STR(stats_memory_name(params->source_address)),
+                  MSS_TRACE_STR(stats_memory_name(params->destination_address)),
+                  transfer_size,
+                  repetition,
+                  verified,
+                  stats.min,
+                  stats.median,
+                  stats.p99,
+                  MSS_TRACE_DOUBLE(stats.mean),
+                  MSS_TRACE_DOUBLE(stats.stddev),
+                  MSS_TRACE_DOUBLE(benchmark_stats_mb_per_sec(stats.median, transfer_size)),
+                  MSS_TRACE_DOUBLE(benchmark_stats_mb_per_sec(stats.min, transfer_size)));
+#elif defined(BENCHMARK_OUTPUT_JSON)
+        sprintf(results_line,
+                "{\"engine\":\"pdma\",\"source\":\"%s\",\"destination\":\"%s\","
+                "\"size_bytes\":%u,\"repetitions\":%u,\"verified\":%s,"
+                "\"min_cycles\":%lu,\"median_cycles\":%lu,\"p99_cycles\":%lu,"
+                "\"mean_cycles\":%.1f,\"stddev_cycles\":%.1f,"
+                "\"median_mb_per_s\":%.2f,\"peak_mb_per_s\":%.2f}\r\n",
+                stats_memory_name(params->source_address),
+                stats_memory_name(params->destination_address),
+                transfer_size,
+                repetition,
+                verified ? "true" : "false",
+                stats.min,
+                stats.median,
+                stats.p99,
+                stats.mean,
+                stats.stddev,
+                benchmark_stats_mb_per_sec(stats.median, transfer_size),
+                benchmark_stats_mb_per_sec(stats.min, transfer_size));
+#else
+        sprintf(results_line,
+                "pdma,%s,%s,%u,%u,%u,%lu,%lu,%lu,%.1f,%.1f,%.2f,%.2f\r\n",
+                stats_memory_name(params->source_address),
+                stats_memory_name(params->destination_address),
+                transfer_size,
+                repetition,
+                verified,
+                stats.min,
+                stats.median,
+                stats.p99,
+                stats.mean,
+                stats.stddev,
+                benchmark_stats_mb_per_sec(stats.median, transfer_size),
+                benchmark_stats_mb_per_sec(stats.min, transfer_size));
+#endif
+#ifndef BENCHMARK_OUTPUT_TRACE
+        MSS_UART_polled_tx_string(uart1, results_line);
+#endif
+    }
+
+#ifdef BENCHMARK_OUTPUT_TRACE
+    /* Outside the timed copies, the UART is only busy between pairs */
+    (void)mss_trace_drain(trace_uart_write, 0u);
+#endif
+}
+
+/* Repeats every copy in pdma_benchmark_list (and stats_fabric_list when a
+ * fabric memory is configured) BENCHMARK_REPETITIONS times per size and prints
+ * min/median/p99/mean/stddev in mcycles and MB/s. The first line identifies
+ * the design, HAL version and clock so that runs can be compared.
+ */
+static void
+run_stats_benchmark(void)
+{
+#ifndef BENCHMARK_OUTPUT_TRACE
+    char results_line[200u] = {0};
+#endif
+    uint32_t pair;
+
+#if defined(BENCHMARK_OUTPUT_TRACE)
+    uint64_t trace_mcycles = readmcycle();
+
+    MSS_TRACE("# design=%s,hal=%d.%d.%d,cpu_clk_hz=%lu",
+              MSS_TRACE_STR(LIBERO_SETTING_DESIGN_NAME),
+              MPFS_HAL_VERSION_MAJOR,
+              MPFS_HAL_VERSION_MINOR,
+              MPFS_HAL_VERSION_PATCH,
+              (uint64_t)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK);
+    trace_mcycles = readmcycle() - trace_mcycles;
+    MSS_TRACE("# trace event cost %lu mcycles", trace_mcycles);
+    MSS_TRACE("engine,source,destination,size_bytes,repetitions,verified,"
+              "min_cycles,median_cycles,p99_cycles,mean_cycles,stddev_cycles,"
+              "median_mb_per_s,peak_mb_per_s");
+    MSS_UART_polled_tx_string(uart1,
+                              "\r\nStatistical benchmark results are sent as trace frames\r\n");
+#elif defined(BENCHMARK_OUTPUT_JSON)
+    sprintf(results_line,
+            "{\"design\":\"%s\",\"hal\":\"%d.%d.%d\",\"cpu_clk_hz\":%lu,"
+            "\"force_order\":%d}\r\n",
+            LIBERO_SETTING_DESIGN_NAME,
+            MPFS_HAL_VERSION_MAJOR,
+            MPFS_HAL_VERSION_MINOR,
+            MPFS_HAL_VERSION_PATCH,
+            (uint64_t)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK,
+#ifdef FORCE_ORDER
+            1);
+#else
+            0);
+#endif
+    MSS_UART_polled_tx_string(uart1, results_line);
+#else
+    sprintf(results_line,
+            "# design=%s,hal=%d.%d.%d,cpu_clk_hz=%lu,force_order=%d\r\n",
+            LIBERO_SETTING_DESIGN_NAME,
+            MPFS_HAL_VERSION_MAJOR,
+            MPFS_HAL_VERSION_MINOR,
+            MPFS_HAL_VERSION_PATCH,
+            (uint64_t)LIBERO_SETTING_MSS_COREPLEX_CPU_CLK,
+#ifdef FORCE_ORDER
+            1);
+#else
+            0);
+#endif
+    MSS_UART_polled_tx_string(uart1, results_line);
+    MSS_UART_polled_tx_string(uart1,
+                              "engine,source,destination,size_bytes,repetitions,verified,"
+                              "min_cycles,median_cycles,p99_cycles,mean_cycles,stddev_cycles,"
+                              "median_mb_per_s,peak_mb_per_s\r\n");
+#endif
+
+    for (pair = 0u; pair < PDMA_BENCHMARKING_LIST_SIZE; pair++)
+    {
+        run_stats_pair(&pdma_benchmark_list[pair]);
+    }
+
+#ifdef FABRIC_MEMORY0
+    for (pair = 0u; pair < STATS_FABRIC_LIST_SIZE; pair++)
+    {
+        run_stats_pair(&stats_fabric_list[pair]);
+    }
+#endif
+}
+
+/* HPM profile regions, one per step of a benchmark copy */
+#define HPM_REGION_FILL   (0u)
+#define HPM_REGION_COPY   (1u)
+#define HPM_REGION_VERIFY (2u)
+
+static const MSS_HPM_VIEW hpm_profile_views[HPM_PROFILE_VIEW_LIST_SIZE] = {
+    MSS_HPM_VIEW_CACHE,
+    MSS_HPM_VIEW_STALLS,
+    MSS_HPM_VIEW_WRITEBACK};
+
+static void
+hpm_print(const char *line)
+{
+    MSS_UART_polled_tx_string(uart1, (const uint8_t *)line);
+}
+
+/* Profiles the CPU side of one memory pair: filling the source, starting the
+ * PDMA and waiting for it, and verifying the destination.
+ */
+static void
+run_hpm_pair(const dma_benchmarking_params_t *params)
+{
+    char results_line[100u] = {0};
+    uint32_t transfer_size = HPM_PROFILE_SIZE_BYTES;
+    uint32_t view;
+    uint32_t repetition;
+    uint64_t cycles;
+
+    if (transfer_size > params->max_transfer_size)
+    {
+        transfer_size = params->max_transfer_size;
+    }
+
+    sprintf(results_line,
+            "\r\n%s to %s, %u bytes\r\n",
+            stats_memory_name(params->source_address),
+            stats_memory_name(params->destination_address),
+            transfer_size);
+    MSS_UART_polled_tx_string(uart1, results_line);
+
+    for (view = 0u; view < HPM_PROFILE_VIEW_LIST_SIZE; view++)
+    {
+        mss_hpm_select_view(hpm_profile_views[view]);
+
+        for (repetition = 0u; repetition < HPM_PROFILE_REPETITIONS; repetition++)
+        {
+            mss_hpm_region_begin(HPM_REGION_FILL, "fill source");
+            clear_64_mem((uint64_t *)params->destination_address,
+                         (uint64_t *)(params->destination_address + transfer_size));
+            for (uint32_t index = 0; index < transfer_size; index++)
+            {
+                *((uint8_t *)params->source_address + index) = (index & 0xFFu);
+            }
+            mss_hpm_region_end(HPM_REGION_FILL);
+
+            mss_hpm_region_begin(HPM_REGION_COPY, "pdma copy");
+            if (0u == stats_timed_copy(params->source_address,
+                                       params->destination_address,
+                                       transfer_size,
+                                       &cycles))
+            {
+                benchmark_error_count++;
+            }
+            mss_hpm_region_end(HPM_REGION_COPY);
+
+            mss_hpm_region_begin(HPM_REGION_VERIFY, "verify");
+            if (TRANSFER_DATA_MISMATCH ==
+                block_transfer_verify_data(transfer_size,
+                                           (uint8_t *)params->source_address,
+                                           (uint8_t *)params->destination_address))
+            {
+                benchmark_error_count++;
+            }
+            mss_hpm_region_end(HPM_REGION_VERIFY);
+        }
+
+        mss_hpm_dump((uint32_t)read_csr(mhartid), hpm_print);
+    }
+}
+
+/* Runs run_hpm_pair() over every pair in pdma_benchmark_list */
+static void
+run_hpm_profile(void)
+{
+    uint32_t pair;
+
+    for (pair = 0u; pair < PDMA_BENCHMARKING_LIST_SIZE; pair++)
+    {
+        run_hpm_pair(&pdma_benchmark_list[pair]);
+    }
+}
+
+/* CPU memory benchmark. mem_bench_samples holds the memcpy() durations and
+ * mem_bench_order the visiting order of the pointer chase lines. */
+#define MEM_BENCH_CHASE_LINES (MEM_BENCH_CHASE_BYTES / MEM_BENCH_CHASE_STRIDE)
+
+static uint64_t mem_bench_samples[MEM_BENCH_REPETITIONS];
+static uint32_t mem_bench_order[MEM_BENCH_CHASE_LINES];
+static volatile uintptr_t mem_bench_sink;
+
+/* Links the lines of the chase buffer into a single random cycle (Sattolo's
+ * algorithm) so that the hardware prefetcher cannot follow it.
+ */
+static void
+mem_bench_build_chase(uintptr_t buffer)
+{
+    uint32_t seed = 0x2545F491u;
+    uint32_t line;
+    uint32_t other;
+    uint32_t swap;
+
+    for (line = 0u; line < MEM_BENCH_CHASE_LINES; line++)
+    {
+        mem_bench_order[line] = line;
+    }
+
+    for (line = MEM_BENCH_CHASE_LINES - 1u; line > 0u; line--)
+    {
+        seed ^= seed << 13u;
+        seed ^= seed >> 17u;
+        seed ^= seed << 5u;
+        other = seed % line;
+        swap = mem_bench_order[line];
+        mem_bench_order[line] = mem_bench_order[other];
+        mem_bench_order[other] = swap;
+    }
+
+    for (line = 0u; line < MEM_BENCH_CHASE_LINES; line++)
+    {
+        *(uintptr_t *)(buffer + (line * MEM_BENCH_CHASE_STRIDE)) =
+            buffer + (mem_bench_order[line] * MEM_BENCH_CHASE_STRIDE);
+    }
+}
+
+/* Returns the mcycles taken by MEM_BENCH_CHASE_LOADS dependent loads */
+static uint64_t
+mem_bench_chase(uintptr_t buffer)
+{
+    uintptr_t next = buffer;
+    uint64_t start_mcycle;
+    uint32_t load;
+
+    /* Warm up pass, so the cached memories are measured in steady state */
+    for (load = 0u; load < MEM_BENCH_CHASE_LINES; load++)
+    {
+        next = *(volatile uintptr_t *)next;
+    }
+
+    start_mcycle = readmcycle();
+    for (load = 0u; load < MEM_BENCH_CHASE_LOADS; load++)
+    {
+        next = *(volatile uintptr_t *)next;
+    }
+    start_mcycle = readmcycle() - start_mcycle;
+
+    mem_bench_sink = next;
+    return start_mcycle;
+}
+
+/* Copies, then pointer chases, one memory and prints a CSV line */
+static void
+run_mem_bench_memory(uint32_t memory, uintptr_t source, uintptr_t destination, uintptr_t chase)
+{
+    char results_line[200u] = {0};
+    benchmark_stats_t stats;
+    uint32_t repetition;
+    uint32_t verified;
+    uint64_t chase_cycles;
+
+    for (uint32_t index = 0; index < MEM_BENCH_COPY_BYTES; index++)
+    {
+        *((uint8_t *)source + index) = (index & 0xFFu);
+    }
+
+    for (repetition = 0u; repetition < MEM_BENCH_REPETITIONS; repetition++)
+    {
+        mem_bench_samples[repetition] = readmcycle();
+        memcpy((void *)destination, (const void *)source, MEM_BENCH_COPY_BYTES);
+        mem_bench_samples[repetition] = readmcycle() - mem_bench_samples[repetition];
+    }
+
+    verified = (0 == memcmp((const void *)destination, (const void *)source, MEM_BENCH_COPY_BYTES));
+    if (!verified)
+    {
+        benchmark_error_count++;
+    }
+
+    benchmark_stats_compute(mem_bench_samples, MEM_BENCH_REPETITIONS, &stats);
+
+    mem_bench_build_chase(chase);
+    chase_cycles = mem_bench_chase(chase);
+
+    sprintf(results_line,
+            "memcpy,%s,0x%lx,%u,%u,%lu,%lu,%.2f,%.2f,%u,%.1f\r\n",
+            memory_descriptors[memory],
+            (uint64_t)source,
+            MEM_BENCH_COPY_BYTES,
+            verified,
+            stats.min,
+            stats.median,
+            benchmark_stats_mb_per_sec(stats.median, MEM_BENCH_COPY_BYTES),
+            benchmark_stats_mb_per_sec(stats.min, MEM_BENCH_COPY_BYTES),
+            MEM_BENCH_CHASE_BYTES,
+            (double)chase_cycles / MEM_BENCH_CHASE_LOADS);
+    MSS_UART_polled_tx_string(uart1, results_line);
+}
+
+/* Prints the mean mcycles per call of the shared, arena and pool allocators */
+static void
+run_mem_bench_allocator(mss_l2_mem_pool_t *pool)
+{
+    char results_line[100u] = {0};
+    uintptr_t mark = mss_l2_mem_mark(MSS_L2_MEM_LIM);
+    uint64_t shared_cycles;
+    uint64_t arena_cycles;
+    uint64_t pool_cycles;
+    uint32_t op;
+    void *block;
+
+    shared_cycles = readmcycle();
+    for (op = 0u; op < MEM_BENCH_ALLOC_OPS; op++)
+    {
+        mem_bench_sink = (uintptr_t)mss_l2_mem_alloc(MSS_L2_MEM_LIM, 8u, 0u);
+    }
+    shared_cycles = readmcycle() - shared_cycles;
+    mss_l2_mem_release(MSS_L2_MEM_LIM, mark);
+
+    /* The chase buffer is no longer needed, reuse its arena */
+    mss_l2_mem_arena_reset(MSS_L2_MEM_LIM);
+    arena_cycles = readmcycle();
+    for (op = 0u; op < MEM_BENCH_ALLOC_OPS; op++)
+    {
+        mem_bench_sink = (uintptr_t)mss_l2_mem_arena_alloc(MSS_L2_MEM_LIM, 8u, 0u);
+    }
+    arena_cycles = readmcycle() - arena_cycles;
+    mss_l2_mem_arena_reset(MSS_L2_MEM_LIM);
+
+    pool_cycles = readmcycle();
+    for (op = 0u; op < MEM_BENCH_ALLOC_OPS; op++)
+    {
+        block = mss_l2_mem_pool_get(pool);
+        mss_l2_mem_pool_put(pool, block);
+    }
+    pool_cycles = readmcycle() - pool_cycles;
+
+    sprintf(results_line,
+            "\r\nallocator,shared,arena,pool get+put\r\nmcycles/call,%.1f,%.1f,%.1f\r\n",
+            (double)shared_cycles / MEM_BENCH_ALLOC_OPS,
+            (double)arena_cycles / MEM_BENCH_ALLOC_OPS,
+            (double)pool_cycles / MEM_BENCH_ALLOC_OPS);
+    MSS_UART_polled_tx_string(uart1, results_line);
+}
+
+/* Compares memcpy() throughput and load latency of L2-LIM, scratchpad, cached
+ * and non-cached DDR from this hart. The L2-LIM and scratchpad buffers come
+ * from the mss_l2_mem allocator: the copy buffers from the shared region, the
+ * chase buffer from this hart's arena. The regions are reset on every run.
+ */
+static void
+run_mem_benchmark(void)
+{
+    uintptr_t source[MEM_BENCH_MEMORY_LIST_SIZE];
+    uintptr_t destination[MEM_BENCH_MEMORY_LIST_SIZE];
+    uintptr_t chase[MEM_BENCH_MEMORY_LIST_SIZE];
+    mss_l2_mem_pool_t descriptor_pool;
+    MSS_L2_MEM_TYPE type;
+    uint32_t memory;
+
+    if ((MSS_L2_MEM_OK != mss_l2_mem_init(MSS_L2_MEM_LIM, L2_LIM0, FULL_LIM)) ||
+        (MSS_L2_MEM_OK != mss_l2_mem_init(MSS_L2_MEM_SCRATCHPAD, SCRATCHPAD0, FULL_SCRATCHPAD)))
+    {
+        MSS_UART_polled_tx_string(uart1, "\r\nError: L2 memory regions!\r\n");
+        benchmark_error_count++;
+        return;
+    }
+
+    for (memory = 0u; memory < 2u; memory++)
+    {
+        type = (0u == memory) ? MSS_L2_MEM_LIM : MSS_L2_MEM_SCRATCHPAD;
+        source[memory] = (uintptr_t)mss_l2_mem_alloc(type, MEM_BENCH_COPY_BYTES, 64u);
+        destination[memory] = (uintptr_t)mss_l2_mem_alloc(type, MEM_BENCH_COPY_BYTES, 64u);
+
+        chase[memory] = 0u;
+        if (MSS_L2_MEM_OK == mss_l2_mem_arena_init(type, MEM_BENCH_CHASE_BYTES))
+        {
+            chase[memory] = (uintptr_t)mss_l2_mem_arena_alloc(type,
+                                                              MEM_BENCH_CHASE_BYTES,
+                                                              MEM_BENCH_CHASE_STRIDE);
+        }
+
+        if ((0u == source[memory]) || (0u == destination[memory]) || (0u == chase[memory]))
+        {
+            MSS_UART_polled_tx_string(uart1, "\r\nError: L2 memory allocation!\r\n");
+            benchmark_error_count++;
+            return;
+        }
+    }
+
+    source[2] = CACHED_DDR0;
+    destination[2] = CACHED_DDR0 + MEM_BENCH_COPY_BYTES;
+    chase[2] = CACHED_DDR0 + (2u * MEM_BENCH_COPY_BYTES);
+    source[3] = NON_CACHED_DDR0;
+    destination[3] = NON_CACHED_DDR0 + MEM_BENCH_COPY_BYTES;
+    chase[3] = NON_CACHED_DDR0 + (2u * MEM_BENCH_COPY_BYTES);
+
+    MSS_UART_polled_tx_string(uart1,
+                              "test,memory,address,size_bytes,verified,min_cycles,median_cycles,"
+                              "median_mb_per_s,peak_mb_per_s,chase_bytes,cycles_per_load\r\n");
+
+    for (memory = 0u; memory < MEM_BENCH_MEMORY_LIST_SIZE; memory++)
+    {
+        run_mem_bench_memory(memory, source[memory], destination[memory], chase[memory]);
+    }
+
+    /* Descriptor sized blocks, as an application would keep its PDMA or
+     * scatter-gather descriptors in LIM */
+    if (MSS_L2_MEM_OK != mss_l2_mem_pool_init(&descriptor_pool,
+                                              MSS_L2_MEM_LIM,
+                                              MEM_BENCH_POOL_BLOCK_BYTES,
+                                              MEM_BENCH_POOL_BLOCKS,
+                                              64u))
+    {
+        MSS_UART_polled_tx_string(uart1, "\r\nError: L2 memory pool!\r\n");
+        benchmark_error_count++;
+        return;
+    }
+
+    run_mem_bench_allocator(&descriptor_pool);
+}
+
 void
 u54_1(void)
 {
@@ -291,16 +1117,37 @@ u54_1(void)
     MSS_UART_init(uart1,
                   MSS_UART_115200_BAUD,
                   MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY | MSS_UART_ONE_STOP_BIT);
+
+#ifdef BENCHMARK_OUTPUT_TRACE
+    (void)mss_config_clk_rst(TRACE_UART_PERIPHERAL, (uint8_t)MPFS_HAL_FIRST_HART, PERIPHERAL_ON);
+
+    MSS_UART_init(TRACE_UART,
+                  MSS_UART_115200_BAUD,
+                  MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY | MSS_UART_ONE_STOP_BIT);
+#endif
     PLIC_init();
     __enable_irq();
     PLIC_SetPriority_Threshold(0);
 
     PLIC_SetPriority(DMA_CH0_DONE_IRQn, 1u);
     PLIC_SetPriority(DMA_CH0_ERR_IRQn, 1u);
-
-    /* Enable PDMA Interrupts. */
+    PLIC_SetPriority(DMA_CH1_DONE_IRQn, 1u);
+    PLIC_SetPriority(DMA_CH1_ERR_IRQn, 1u);
+    PLIC_SetPriority(DMA_CH2_DONE_IRQn, 1u);
+    PLIC_SetPriority(DMA_CH2_ERR_IRQn, 1u);
+    PLIC_SetPriority(DMA_CH3_DONE_IRQn, 1u);
+    PLIC_SetPriority(DMA_CH3_ERR_IRQn, 1u);
+
+    /* Enable PDMA Interrupts. Channels 1 to 3 are used by the striped
+     * transfer columns. */
     PLIC_EnableIRQ(DMA_CH0_DONE_IRQn);
     PLIC_EnableIRQ(DMA_CH0_ERR_IRQn);
+    PLIC_EnableIRQ(DMA_CH1_DONE_IRQn);
+    PLIC_EnableIRQ(DMA_CH1_ERR_IRQn);
+    PLIC_EnableIRQ(DMA_CH2_DONE_IRQn);
+    PLIC_EnableIRQ(DMA_CH2_ERR_IRQn);
+    PLIC_EnableIRQ(DMA_CH3_DONE_IRQn);
+    PLIC_EnableIRQ(DMA_CH3_ERR_IRQn);
 
     /* If the application is being debugged from LIM.
      * The HAL will not clear LIM memory, as to avoid clearing the memory the
@@ -311,6 +1158,11 @@ u54_1(void)
 
     MSS_UART_polled_tx_string(uart1, greeting_message);
 
+#ifdef BENCHMARK_NON_INTERACTIVE
+    run_stats_benchmark();
+    pdma_print_error_count();
+#endif
+
     while (1u)
     {
         switch (transfer_state)
@@ -327,7 +1179,8 @@ u54_1(void)
                 while (1u)
                 {
                     pdma_choice = get_user_input();
-                    if ((pdma_choice == 'a') ||
+                    if ((pdma_choice == 'a') || (pdma_choice == 's') || (pdma_choice == 'b') ||
+                        (pdma_choice == 'p') || (pdma_choice == 'm') ||
                         ((pdma_choice > 0) && (pdma_choice <= PDMA_BENCHMARKING_LIST_SIZE)))
                     {
                         break;
@@ -336,6 +1189,46 @@ u54_1(void)
                     MSS_UART_polled_tx_string(uart1, pdma_options);
                 }
 
+                if ('s' == pdma_choice)
+                {
+                    MSS_UART_polled_tx_string(
+                        uart1,
+                        "\r\n\r\nRunning scatter-gather benchmark.\r\n\r\n");
+                    run_sg_benchmark();
+                    pdma_print_error_count();
+                    break;
+                }
+
+                if ('b' == pdma_choice)
+                {
+                    MSS_UART_polled_tx_string(
+                        uart1,
+                        "\r\n\r\nRunning statistical benchmark.\r\n\r\n");
+                    run_stats_benchmark();
+                    pdma_print_error_count();
+                    break;
+                }
+
+                if ('p' == pdma_choice)
+                {
+                    MSS_UART_polled_tx_string(
+                        uart1,
+                        "\r\n\r\nRunning performance counter profile.\r\n\r\n");
+                    run_hpm_profile();
+                    pdma_print_error_count();
+                    break;
+                }
+
+                if ('m' == pdma_choice)
+                {
+                    MSS_UART_polled_tx_string(
+                        uart1,
+                        "\r\n\r\nRunning CPU memory benchmark.\r\n\r\n");
+                    run_mem_benchmark();
+                    pdma_print_error_count();
+                    break;
+                }
+
                 if ('a' == pdma_choice)
                 {
                     MSS_UART_polled_tx_string(uart1, "\r\n\r\nRunning all benchmarks.\r\n\r\n");
@@ -558,6 +1451,21 @@ u54_1(void)
 
                     sprintf(results_cell, "%ld", (uint64_t)pdma_transfer_rate);
                     print_table_cell(results_cell);
+
+                    /* Striped copies of the same block */
+                    for (uint32_t stripe_index = 0u; stripe_index < STRIPED_CHANNEL_LIST_SIZE;
+                         stripe_index++)
+                    {
+                        pdma_transfer_rate = run_striped_transfer(
+                            striped_channel_list[stripe_index],
+                            (uint64_t)pdma_benchmark_list[pdma_benchmark_index].source_address,
+                            (uint64_t)pdma_benchmark_list[pdma_benchmark_index].destination_address,
+                            current_transfer_size);
+
+                        sprintf(results_cell, "%ld", (uint64_t)pdma_transfer_rate);
+                        print_table_cell(results_cell);
+                    }
+
                     MSS_UART_polled_tx_string(uart1, "\r\n");
 
                     current_transfer_size += pdma_benchmark_list[pdma_benchmark_index].step_size;
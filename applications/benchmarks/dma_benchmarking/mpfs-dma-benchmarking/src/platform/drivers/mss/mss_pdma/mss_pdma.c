@@ -30,6 +30,64 @@ uint8_t g_channel_nextcfg_rsize[MSS_PDMA_lAST_CHANNEL] =
 /* Callback handler declaration */
 mss_pdma_int_handler_t mss_pdma_isr;
 
+/* Scatter-gather list state, one entry per channel. num_segments is zero when
+ * the channel is not running a scatter-gather list.
+ */
+typedef struct _pdmasgstate
+{
+    const mss_pdma_sg_segment_t *segments;
+    uint32_t num_segments;
+    volatile uint32_t current_segment;
+    uint8_t force_order;
+} mss_pdma_sg_state_t;
+
+static mss_pdma_sg_state_t g_pdma_sg_state[MSS_PDMA_lAST_CHANNEL];
+
+/* Striped transfer state. The masks hold one bit per channel. */
+static volatile uint8_t g_pdma_striped_pending = 0u;
+static volatile uint8_t g_pdma_striped_error = 0u;
+static mss_pdma_int_handler_t g_pdma_striped_handler;
+
+/* Request queue slot. The sequence number is stored relative to the slot
+ * index so that a zero initialised queue is empty and ready for use: slot i
+ * accepts a request at queue position pos when (sequence + i) == pos and holds
+ * a request for position pos when (sequence + i) == pos + 1.
+ */
+typedef struct _pdmarequestslot
+{
+    volatile uint64_t sequence;
+    mss_pdma_request_t *request;
+} mss_pdma_request_slot_t;
+
+/* Per channel request queue. Any hart may enqueue. Only the owner of the busy
+ * flag dequeues and programs the channel: the submitter that finds the channel
+ * idle, or the done/error interrupt handler while requests are outstanding.
+ */
+typedef struct _pdmarequestqueue
+{
+    mss_pdma_request_slot_t slots[MSS_PDMA_REQUEST_QUEUE_SIZE];
+    volatile uint64_t enqueue_pos;
+    uint64_t dequeue_pos;
+    volatile uint32_t busy;
+    mss_pdma_request_t * volatile active;
+} mss_pdma_request_queue_t;
+
+#define MSS_PDMA_REQUEST_QUEUE_MASK     (MSS_PDMA_REQUEST_QUEUE_SIZE - 1u)
+#define MSS_PDMA_NUM_HARTS              5u
+
+static mss_pdma_request_queue_t g_pdma_request_queue[MSS_PDMA_lAST_CHANNEL];
+
+/* Completed requests waiting for their submitting hart, one list per hart. */
+static mss_pdma_request_t *g_pdma_completed_requests[MSS_PDMA_NUM_HARTS];
+
+static void pdma_sg_program_segment(mss_pdma_channel_id_t channel_id);
+static uint8_t pdma_sg_continue(mss_pdma_channel_id_t channel_id);
+static uint8_t pdma_striped_complete(mss_pdma_channel_id_t channel_id,
+                                     uint8_t error);
+static void pdma_queue_start_next(mss_pdma_channel_id_t channel_id);
+static uint8_t pdma_queue_complete(mss_pdma_channel_id_t channel_id,
+                                   uint8_t error);
+
 /*-------------------------------------------------------------------------*//**
  * MSS_PDMA_setup_transfer()
  * See mss_pdma.h for description of this function.
@@ -53,6 +111,10 @@ MSS_PDMA_setup_transfer
     /* Set the register structure pointer for the PDMA channel. */
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
 
+    /* A single transfer replaces any previously configured scatter-gather
+     * list on this channel. */
+    g_pdma_sg_state[channel_id].num_segments = 0u;
+
     /* Basic House Keeping, return if errors exist. */
     if (channel_config->src_addr == 0u)
     {
@@ -376,6 +438,633 @@ MSS_PDMA_clear_transfer_error_status
     return intStatus;
 }
 
+/***************************************************************************//**
+ * See mss_pdma.h for description of this function.
+ */
+mss_pdma_error_id_t
+MSS_PDMA_setup_sg_transfer
+(
+    mss_pdma_channel_id_t channel_id,
+    const mss_pdma_sg_segment_t *segments,
+    uint32_t num_segments,
+    uint8_t force_order,
+    mss_pdma_int_handler_t pdma_transfer_handler
+)
+{
+    uint32_t index;
+
+    if (channel_id > MSS_PDMA_CHANNEL_3)
+    {
+        return MSS_PDMA_ERROR_INVALID_CHANNEL_ID;
+    }
+
+    if ((segments == (const mss_pdma_sg_segment_t *)0) || (num_segments == 0u))
+    {
+        return MSS_PDMA_ERROR_INVALID_SG_LIST;
+    }
+
+    /* Set the register structure pointer for the PDMA channel. */
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+
+    /* Validate the whole list up front so that the interrupt handler never has
+     * to abort a list part way through because of a bad segment. */
+    for (index = 0u; index < num_segments; index++)
+    {
+        if (segments[index].src_addr == 0u)
+        {
+            return MSS_PDMA_ERROR_INVALID_SRC_ADDR;
+        }
+
+        if (segments[index].dest_addr == 0u)
+        {
+            return MSS_PDMA_ERROR_INVALID_DEST_ADDR;
+        }
+
+        if (segments[index].num_bytes == 0u)
+        {
+            return MSS_PDMA_ERROR_INVALID_SG_LIST;
+        }
+    }
+
+    /* If a run transaction is in progress, return error.
+     * Channel can only be claimed when run is low */
+    if (pdmareg->control_reg & MASK_PDMA_CONTROL_RUN)
+    {
+        return MSS_PDMA_ERROR_TRANSACTION_IN_PROGRESS;
+    }
+
+    /* Register callback interrupt handler */
+    mss_pdma_isr = pdma_transfer_handler;
+
+    g_pdma_sg_state[channel_id].segments = segments;
+    g_pdma_sg_state[channel_id].num_segments = num_segments;
+    g_pdma_sg_state[channel_id].current_segment = 0u;
+    g_pdma_sg_state[channel_id].force_order = force_order;
+
+    /* Segments are chained from the done interrupt, so both interrupts are
+     * always enabled for a scatter-gather list. */
+    pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
+    pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
+
+    /* clear Next registers. */
+    pdmareg->control_reg |= (uint32_t)MASK_CLAIM_PDMA_CHANNEL;
+
+    pdma_sg_program_segment(channel_id);
+
+    return MSS_PDMA_OK;
+}
+
+/***************************************************************************//**
+ * See mss_pdma.h for description of this function.
+ */
+uint32_t
+MSS_PDMA_get_sg_segments_completed
+(
+    mss_pdma_channel_id_t channel_id
+)
+{
+    if (channel_id > MSS_PDMA_CHANNEL_3)
+    {
+        return 0u;
+    }
+
+    return g_pdma_sg_state[channel_id].current_segment;
+}
+
+/***************************************************************************//**
+ * Loads the current segment of the channel's scatter-gather list into the
+ * Next registers. The run bit is left for the caller to set.
+ */
+static void
+pdma_sg_program_segment
+(
+    mss_pdma_channel_id_t channel_id
+)
+{
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+    const mss_pdma_sg_segment_t *segment =
+        &g_pdma_sg_state[channel_id].segments[g_pdma_sg_state[channel_id].current_segment];
+    uint32_t next_config;
+
+    pdmareg->next_destination = segment->dest_addr;
+    pdmareg->next_source      = segment->src_addr;
+    pdmareg->next_bytes       = segment->num_bytes;
+
+    next_config = ((uint32_t)g_channel_nextcfg_wsize[channel_id] << SHIFT_CH_CONFIG_WSIZE) |
+                  ((uint32_t)g_channel_nextcfg_rsize[channel_id] << SHIFT_CH_CONFIG_RSIZE);
+
+    if (g_pdma_sg_state[channel_id].force_order)
+    {
+        next_config |= ((uint32_t)MASK_FORCE_ORDERING);
+    }
+
+    pdmareg->next_config = next_config;
+}
+
+/***************************************************************************//**
+ * Called from the done interrupt handlers. If the channel is running a
+ * scatter-gather list with segments outstanding, the next segment is started
+ * straight away and 1 is returned so the handler does not notify the
+ * application. Returns 0 for single transfers and for the last segment of a
+ * list.
+ */
+static uint8_t
+pdma_sg_continue
+(
+    mss_pdma_channel_id_t channel_id
+)
+{
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+    mss_pdma_sg_state_t *sg_state = &g_pdma_sg_state[channel_id];
+
+    if (sg_state->num_segments == 0u)
+    {
+        return 0u;
+    }
+
+    sg_state->current_segment++;
+
+    if (sg_state->current_segment < sg_state->num_segments)
+    {
+        pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_TRANSFER_DONE);
+        pdma_sg_program_segment(channel_id);
+        pdmareg->control_reg |= ((uint32_t)MASK_PDMA_CONTROL_RUN);
+
+        return 1u;
+    }
+
+    /* Whole list transferred, release it and report a single completion. */
+    sg_state->num_segments = 0u;
+
+    return 0u;
+}
+
+/***************************************************************************//**
+ * See mss_pdma.h for description of this function.
+ */
+mss_pdma_error_id_t
+MSS_PDMA_memcpy_striped
+(
+    uint64_t dest_addr,
+    uint64_t src_addr,
+    uint64_t num_bytes,
+    uint8_t num_channels,
+    uint8_t force_order,
+    mss_pdma_int_handler_t pdma_transfer_handler
+)
+{
+    uint8_t channel;
+    uint64_t stripe_bytes;
+    uint64_t offset = 0u;
+    uint32_t next_config;
+    uint8_t pending;
+    volatile mss_pdma_t *pdmareg;
+
+    if ((num_channels == 0u) || (num_channels > MSS_PDMA_lAST_CHANNEL))
+    {
+        return MSS_PDMA_ERROR_INVALID_CHANNEL_ID;
+    }
+
+    if (src_addr == 0u)
+    {
+        return MSS_PDMA_ERROR_INVALID_SRC_ADDR;
+    }
+
+    if (dest_addr == 0u)
+    {
+        return MSS_PDMA_ERROR_INVALID_DEST_ADDR;
+    }
+
+    if (num_bytes == 0u)
+    {
+        return MSS_PDMA_ERROR_INVALID_SIZE;
+    }
+
+    /* Stripes are a whole number of cache lines. Copies too small to give
+     * every channel at least one line use fewer channels. */
+    stripe_bytes = (num_bytes / num_channels) & ~((uint64_t)MSS_PDMA_STRIPE_ALIGNMENT - 1u);
+
+    if (stripe_bytes == 0u)
+    {
+        num_channels = 1u;
+        stripe_bytes = num_bytes;
+    }
+
+    /* All channels must be free before any of them is started. */
+    for (channel = 0u; channel < num_channels; channel++)
+    {
+        pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel);
+
+        if (pdmareg->control_reg & MASK_PDMA_CONTROL_RUN)
+        {
+            return MSS_PDMA_ERROR_TRANSACTION_IN_PROGRESS;
+        }
+    }
+
+    /* Claim the striped state in one step, so that of two callers on
+     * different harts only one goes on. */
+    pending = 0u;
+    if (!__atomic_compare_exchange_n(&g_pdma_striped_pending,
+                                     &pending,
+                                     (uint8_t)((1u << num_channels) - 1u),
+                                     0,
+                                     __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED))
+    {
+        return MSS_PDMA_ERROR_TRANSACTION_IN_PROGRESS;
+    }
+
+    g_pdma_striped_handler = pdma_transfer_handler;
+    g_pdma_striped_error = 0u;
+
+    for (channel = 0u; channel < num_channels; channel++)
+    {
+        pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel);
+        g_pdma_sg_state[channel].num_segments = 0u;
+
+        pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
+        pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
+
+        /* clear Next registers. */
+        pdmareg->control_reg |= (uint32_t)MASK_CLAIM_PDMA_CHANNEL;
+
+        pdmareg->next_destination = dest_addr + offset;
+        pdmareg->next_source      = src_addr + offset;
+
+        /* The last channel also takes any remainder. */
+        if (channel == (num_channels - 1u))
+        {
+            pdmareg->next_bytes = num_bytes - offset;
+        }
+        else
+        {
+            pdmareg->next_bytes = stripe_bytes;
+        }
+
+        next_config = ((uint32_t)g_channel_nextcfg_wsize[channel] << SHIFT_CH_CONFIG_WSIZE) |
+                      ((uint32_t)g_channel_nextcfg_rsize[channel] << SHIFT_CH_CONFIG_RSIZE);
+
+        if (force_order)
+        {
+            next_config |= ((uint32_t)MASK_FORCE_ORDERING);
+        }
+
+        pdmareg->next_config = next_config;
+
+        offset += stripe_bytes;
+    }
+
+    for (channel = 0u; channel < num_channels; channel++)
+    {
+        pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel);
+        pdmareg->control_reg |= ((uint32_t)MASK_PDMA_CONTROL_RUN);
+    }
+
+    if (pdma_transfer_handler != (mss_pdma_int_handler_t)0)
+    {
+        return MSS_PDMA_OK;
+    }
+
+    /* No callback: wait for every stripe to complete. */
+    while (g_pdma_striped_pending != 0u)
+    {
+        ;
+    }
+
+    if (g_pdma_striped_error != 0u)
+    {
+        return MSS_PDMA_ERROR_STRIPED_TRANSFER;
+    }
+
+    return MSS_PDMA_OK;
+}
+
+/***************************************************************************//**
+ * Called from the done and error interrupt handlers. If the channel belongs to
+ * a striped transfer, its status is cleared and folded into the striped
+ * transfer status and 1 is returned so the handler does not notify the
+ * application. The striped callback is invoked once, when the last stripe
+ * finishes. The stripes may complete on different harts, so the status is
+ * folded in with atomics and only the hart which clears the last pending bit
+ * calls back.
+ */
+static uint8_t
+pdma_striped_complete
+(
+    mss_pdma_channel_id_t channel_id,
+    uint8_t error
+)
+{
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+    uint8_t channel_mask = (uint8_t)(1u << channel_id);
+    mss_pdma_int_handler_t handler;
+    uint8_t pending;
+
+    if ((__atomic_load_n(&g_pdma_striped_pending, __ATOMIC_ACQUIRE) & channel_mask) == 0u)
+    {
+        return 0u;
+    }
+
+    /* Stable until the last pending bit is cleared */
+    handler = g_pdma_striped_handler;
+
+    pdmareg->control_reg &= ~((uint32_t)(MASK_PDMA_ENABLE_DONE_INT |
+                                         MASK_PDMA_ENABLE_ERR_INT |
+                                         MASK_PDMA_TRANSFER_DONE |
+                                         MASK_PDMA_TRANSFER_ERROR));
+
+    if (error)
+    {
+        (void)__atomic_fetch_or(&g_pdma_striped_error, channel_mask, __ATOMIC_RELAXED);
+    }
+
+    /* Release orders the error bit before the clear, acquire makes the other
+     * stripes' error bits visible to the hart which clears the last bit. */
+    pending = __atomic_fetch_and(&g_pdma_striped_pending, (uint8_t)~channel_mask,
+                                 __ATOMIC_ACQ_REL);
+
+    if (pending == channel_mask)
+    {
+        if (handler != (mss_pdma_int_handler_t)0)
+        {
+            if (__atomic_load_n(&g_pdma_striped_error, __ATOMIC_RELAXED) != 0u)
+            {
+                handler(PDMA_STRIPED_ERROR_INT);
+            }
+            else
+            {
+                handler(PDMA_STRIPED_DONE_INT);
+            }
+        }
+    }
+
+    return 1u;
+}
+
+/***************************************************************************//**
+ * See mss_pdma.h for description of this function.
+ */
+mss_pdma_error_id_t
+MSS_PDMA_submit_request
+(
+    mss_pdma_channel_id_t channel_id,
+    mss_pdma_request_t *request
+)
+{
+    mss_pdma_request_queue_t *queue;
+    mss_pdma_request_slot_t *slot;
+    uint64_t pos;
+    int64_t diff;
+
+    if (channel_id > MSS_PDMA_CHANNEL_3)
+    {
+        return MSS_PDMA_ERROR_INVALID_CHANNEL_ID;
+    }
+
+    if (request->src_addr == 0u)
+    {
+        return MSS_PDMA_ERROR_INVALID_SRC_ADDR;
+    }
+
+    if (request->dest_addr == 0u)
+    {
+        return MSS_PDMA_ERROR_INVALID_DEST_ADDR;
+    }
+
+    queue = &g_pdma_request_queue[channel_id];
+
+    request->hart_id = read_csr(mhartid);
+    request->next = (mss_pdma_request_t *)0;
+    request->status = MSS_PDMA_REQUEST_QUEUED;
+
+    /* Claim a queue position. */
+    pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        slot = &queue->slots[pos & MSS_PDMA_REQUEST_QUEUE_MASK];
+        diff = (int64_t)((__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) +
+                          (pos & MSS_PDMA_REQUEST_QUEUE_MASK)) - pos);
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&queue->enqueue_pos, &pos, pos + 1u,
+                                            0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return MSS_PDMA_ERROR_QUEUE_FULL;
+        }
+        else
+        {
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->request = request;
+    __atomic_store_n(&slot->sequence,
+                     (pos + 1u) - (pos & MSS_PDMA_REQUEST_QUEUE_MASK),
+                     __ATOMIC_RELEASE);
+
+    /* Start the channel if it is idle. Otherwise the interrupt handler will
+     * pick the request up when the transfers ahead of it have completed. */
+    if (__atomic_exchange_n(&queue->busy, 1u, __ATOMIC_ACQUIRE) == 0u)
+    {
+        pdma_queue_start_next(channel_id);
+    }
+
+    return MSS_PDMA_OK;
+}
+
+/***************************************************************************//**
+ * See mss_pdma.h for description of this function.
+ */
+void
+MSS_PDMA_process_completed_requests
+(
+    void
+)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    mss_pdma_request_t *list;
+    mss_pdma_request_t *ordered = (mss_pdma_request_t *)0;
+    mss_pdma_request_t *next;
+
+    list = __atomic_exchange_n(&g_pdma_completed_requests[hart_id],
+                               (mss_pdma_request_t *)0,
+                               __ATOMIC_ACQUIRE);
+
+    /* The list is built newest first, reverse it to report in order. */
+    while (list != (mss_pdma_request_t *)0)
+    {
+        next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    while (ordered != (mss_pdma_request_t *)0)
+    {
+        next = ordered->next;
+        ordered->handler(ordered);
+        ordered = next;
+    }
+}
+
+/***************************************************************************//**
+ * Returns 1 if the slot at the queue's dequeue position holds a request.
+ */
+static uint8_t
+pdma_queue_not_empty
+(
+    mss_pdma_request_queue_t *queue
+)
+{
+    uint64_t pos = queue->dequeue_pos;
+    mss_pdma_request_slot_t *slot = &queue->slots[pos & MSS_PDMA_REQUEST_QUEUE_MASK];
+
+    return (uint8_t)((__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) +
+                      (pos & MSS_PDMA_REQUEST_QUEUE_MASK)) == (pos + 1u));
+}
+
+/***************************************************************************//**
+ * Starts the next queued request on the channel, or releases the channel if
+ * the queue is empty. Must only be called by the owner of the busy flag.
+ */
+static void
+pdma_queue_start_next
+(
+    mss_pdma_channel_id_t channel_id
+)
+{
+    mss_pdma_request_queue_t *queue = &g_pdma_request_queue[channel_id];
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+    mss_pdma_request_slot_t *slot;
+    mss_pdma_request_t *request;
+    uint64_t pos;
+    uint32_t next_config;
+
+    while (!pdma_queue_not_empty(queue))
+    {
+        /* Release the channel, then check again in case a request was
+         * enqueued after the check above but saw the channel busy. */
+        __atomic_store_n(&queue->busy, 0u, __ATOMIC_RELEASE);
+        mb();
+
+        if ((!pdma_queue_not_empty(queue)) ||
+            (__atomic_exchange_n(&queue->busy, 1u, __ATOMIC_ACQUIRE) != 0u))
+        {
+            return;
+        }
+    }
+
+    pos = queue->dequeue_pos;
+    slot = &queue->slots[pos & MSS_PDMA_REQUEST_QUEUE_MASK];
+    request = slot->request;
+    queue->dequeue_pos = pos + 1u;
+    __atomic_store_n(&slot->sequence,
+                     (pos + MSS_PDMA_REQUEST_QUEUE_SIZE) - (pos & MSS_PDMA_REQUEST_QUEUE_MASK),
+                     __ATOMIC_RELEASE);
+
+    queue->active = request;
+    request->status = MSS_PDMA_REQUEST_IN_PROGRESS;
+    g_pdma_sg_state[channel_id].num_segments = 0u;
+
+    pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
+    pdmareg->control_reg |= ((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
+
+    /* clear Next registers. */
+    pdmareg->control_reg |= (uint32_t)MASK_CLAIM_PDMA_CHANNEL;
+
+    pdmareg->next_destination = request->dest_addr;
+    pdmareg->next_source      = request->src_addr;
+    pdmareg->next_bytes       = request->num_bytes;
+
+    next_config = ((uint32_t)g_channel_nextcfg_wsize[channel_id] << SHIFT_CH_CONFIG_WSIZE) |
+                  ((uint32_t)g_channel_nextcfg_rsize[channel_id] << SHIFT_CH_CONFIG_RSIZE);
+
+    if (request->force_order)
+    {
+        next_config |= ((uint32_t)MASK_FORCE_ORDERING);
+    }
+
+    pdmareg->next_config = next_config;
+
+    pdmareg->control_reg |= ((uint32_t)MASK_PDMA_CONTROL_RUN);
+}
+
+/***************************************************************************//**
+ * Called from the done and error interrupt handlers. If the channel is running
+ * a queued request, the next request is started and the completed request is
+ * handed back to its submitting hart. Returns 1 if the interrupt was consumed
+ * by the request queue.
+ */
+static uint8_t
+pdma_queue_complete
+(
+    mss_pdma_channel_id_t channel_id,
+    uint8_t error
+)
+{
+    mss_pdma_request_queue_t *queue = &g_pdma_request_queue[channel_id];
+    volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET(channel_id);
+    mss_pdma_request_t *request = queue->active;
+    uint64_t hart_id;
+
+    if (request == (mss_pdma_request_t *)0)
+    {
+        return 0u;
+    }
+
+    pdmareg->control_reg &= ~((uint32_t)(MASK_PDMA_TRANSFER_DONE |
+                                         MASK_PDMA_TRANSFER_ERROR));
+    queue->active = (mss_pdma_request_t *)0;
+
+    /* Keep the channel busy before reporting the completion. */
+    pdma_queue_start_next(channel_id);
+
+    if (error)
+    {
+        request->status = MSS_PDMA_REQUEST_ERROR;
+    }
+    else
+    {
+        request->status = MSS_PDMA_REQUEST_DONE;
+    }
+
+    if (request->handler == (mss_pdma_request_handler_t)0)
+    {
+        return 1u;
+    }
+
+    hart_id = read_csr(mhartid);
+
+    if (request->hart_id == hart_id)
+    {
+        request->handler(request);
+    }
+    else
+    {
+        /* Push onto the submitting hart's list and interrupt that hart. */
+        request->next = __atomic_load_n(&g_pdma_completed_requests[request->hart_id],
+                                        __ATOMIC_RELAXED);
+
+        while (!__atomic_compare_exchange_n(&g_pdma_completed_requests[request->hart_id],
+                                            &request->next, request,
+                                            0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+            ;
+        }
+
+        raise_soft_interrupt(request->hart_id);
+    }
+
+    return 1u;
+}
+
 /***************************************************************************//**
  * Each DMA channel has two interrupts, one for transfer complete
  * and the other for the transfer error.
@@ -390,6 +1079,13 @@ dma_ch0_DONE_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_0);
 
+    if (pdma_sg_continue(MSS_PDMA_CHANNEL_0) ||
+        pdma_striped_complete(MSS_PDMA_CHANNEL_0, 0u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_0, 0u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
 
     mss_pdma_isr(PDMA_CH0_DONE_INT);
@@ -407,6 +1103,15 @@ dma_ch0_ERR_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_0);
 
+    /* Abandon the rest of any scatter-gather list. */
+    g_pdma_sg_state[MSS_PDMA_CHANNEL_0].num_segments = 0u;
+
+    if (pdma_striped_complete(MSS_PDMA_CHANNEL_0, 1u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_0, 1u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
 
     mss_pdma_isr(PDMA_CH0_ERROR_INT);
@@ -424,6 +1129,13 @@ dma_ch1_DONE_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_1);
 
+    if (pdma_sg_continue(MSS_PDMA_CHANNEL_1) ||
+        pdma_striped_complete(MSS_PDMA_CHANNEL_1, 0u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_1, 0u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
 
     mss_pdma_isr(PDMA_CH1_DONE_INT);
@@ -441,6 +1153,15 @@ dma_ch1_ERR_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_1);
 
+    /* Abandon the rest of any scatter-gather list. */
+    g_pdma_sg_state[MSS_PDMA_CHANNEL_1].num_segments = 0u;
+
+    if (pdma_striped_complete(MSS_PDMA_CHANNEL_1, 1u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_1, 1u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
 
     mss_pdma_isr(PDMA_CH1_ERROR_INT);
@@ -459,6 +1180,13 @@ dma_ch2_DONE_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_2);
 
+    if (pdma_sg_continue(MSS_PDMA_CHANNEL_2) ||
+        pdma_striped_complete(MSS_PDMA_CHANNEL_2, 0u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_2, 0u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
 
     mss_pdma_isr(PDMA_CH2_DONE_INT);
@@ -476,6 +1204,15 @@ dma_ch2_ERR_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_2);
 
+    /* Abandon the rest of any scatter-gather list. */
+    g_pdma_sg_state[MSS_PDMA_CHANNEL_2].num_segments = 0u;
+
+    if (pdma_striped_complete(MSS_PDMA_CHANNEL_2, 1u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_2, 1u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
 
     mss_pdma_isr(PDMA_CH2_ERROR_INT);
@@ -493,6 +1230,13 @@ dma_ch3_DONE_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_3);
 
+    if (pdma_sg_continue(MSS_PDMA_CHANNEL_3) ||
+        pdma_striped_complete(MSS_PDMA_CHANNEL_3, 0u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_3, 0u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_DONE_INT);
 
     mss_pdma_isr(PDMA_CH3_DONE_INT);
@@ -510,6 +1254,15 @@ dma_ch3_ERR_IRQHandler
     volatile mss_pdma_t *pdmareg = (mss_pdma_t *)MSS_PDMA_REG_OFFSET
                                                 (MSS_PDMA_CHANNEL_3);
 
+    /* Abandon the rest of any scatter-gather list. */
+    g_pdma_sg_state[MSS_PDMA_CHANNEL_3].num_segments = 0u;
+
+    if (pdma_striped_complete(MSS_PDMA_CHANNEL_3, 1u) ||
+        pdma_queue_complete(MSS_PDMA_CHANNEL_3, 1u))
+    {
+        return 0u;
+    }
+
     pdmareg->control_reg &= ~((uint32_t)MASK_PDMA_ENABLE_ERR_INT);
 
     mss_pdma_isr(PDMA_CH3_ERROR_INT);
@@ -128,6 +128,48 @@
   The MSS_PDMA_clear_transfer_error_status() function can be used to clear the
   DMA transfer error status.
 
+  --------------------------------
+  Scatter-gather transfers
+  --------------------------------
+  A list of non-contiguous segments can be moved with a single call to
+  MSS_PDMA_setup_sg_transfer() followed by MSS_PDMA_start_transfer(). Each
+  segment is described by an mss_pdma_sg_segment_t entry. The driver starts
+  the next segment directly from the channel's done interrupt handler, so the
+  application callback is invoked only once, with the channel's done interrupt
+  indicator, when the last segment has been transferred. A transfer error
+  abandons the rest of the list and invokes the callback with the channel's
+  error interrupt indicator. The segment array must remain valid until the
+  list has completed. The PLIC done and error interrupts of the channel must
+  be enabled by the application.
+
+  --------------------------------
+  Striped transfers
+  --------------------------------
+  The MSS_PDMA_memcpy_striped() function splits one large copy into equal,
+  cache line aligned stripes and transfers them concurrently on channels 0 up
+  to the requested number of channels. The done and error interrupts of those
+  channels are aggregated by the driver and a single status is reported when
+  every stripe has finished: through the callback with PDMA_STRIPED_DONE_INT
+  or PDMA_STRIPED_ERROR_INT, or as the return value when no callback is given.
+  The PLIC done and error interrupts of all channels used must be enabled by
+  the application, and handled by the same hart.
+
+  --------------------------------
+  Request queues
+  --------------------------------
+  Each channel has a lock-free request queue which any hart can submit to
+  with MSS_PDMA_submit_request(), instead of retrying
+  MSS_PDMA_setup_transfer() while the channel is busy. A request that finds
+  the channel idle is started straight away; otherwise the channel's done
+  interrupt handler starts the next queued request as soon as the current
+  one completes. When a request completes its handler is invoked on the hart
+  that submitted it: directly from the interrupt handler if that is the hart
+  servicing the channel's PLIC interrupts, otherwise from
+  MSS_PDMA_process_completed_requests(), which the submitting hart must call
+  from its software interrupt handler. The driver raises that software
+  interrupt. A channel used through its request queue must not also be used
+  by the other transfer functions of this driver.
+
 *//*==========================================================================*/
 #ifndef MSS_PDMA_H
 #define MSS_PDMA_H
@@ -179,6 +221,17 @@ typedef struct _pdmachannelconfig
                                               in-flight at a time */
 } mss_pdma_channel_config_t;
 
+/*-------------------------------------------------------------------------*//**
+  The mss_pdma_sg_segment_t structure describes one segment of a scatter-gather
+  list passed to MSS_PDMA_setup_sg_transfer().
+ */
+typedef struct _pdmasgsegment
+{
+    uint64_t src_addr;                     /* source address */
+    uint64_t dest_addr;                    /* destination address */
+    uint64_t num_bytes;                    /* Number of bytes to be transferred */
+} mss_pdma_sg_segment_t;
+
 /*------------------------ Public Constants-----------------------------------*/
 /* PDMA Interrupt status indicators */
 
@@ -194,9 +247,21 @@ typedef struct _pdmachannelconfig
 #define PDMA_CH2_ERROR_INT                             0x12u
 #define PDMA_CH3_ERROR_INT                             0x13u
 
+/* MSS PDMA striped transfer interrupt indicator constants */
+#define PDMA_STRIPED_DONE_INT                          0x20u
+#define PDMA_STRIPED_ERROR_INT                         0x30u
+
+/* Alignment, in bytes, of the stripes of a striped transfer */
+#define MSS_PDMA_STRIPE_ALIGNMENT                      64u
+
 /*------------------------Private data structures-----------------------------*/
 /*----------------------------------- PDMA -----------------------------------*/
 
+/* Number of entries in each channel's request queue. Must be a power of 2. */
+#ifndef MSS_PDMA_REQUEST_QUEUE_SIZE
+#define MSS_PDMA_REQUEST_QUEUE_SIZE                    16u
+#endif
+
 /*------------------------------------------------------------------------*//**
  * The mss_pdma_error_id_t enumeration is used to specify the error status from
  * MSS PDMA transfer / transaction functions.
@@ -210,6 +275,10 @@ typedef enum __pdma_error_id_t
     MSS_PDMA_ERROR_INVALID_CHANNEL_ID,     //!< ERROR_INVALID_CHANNEL_ID
     MSS_PDMA_ERROR_INVALID_NEXTCFG_WSIZE,  //!< ERROR_INVALID_NEXTCFG_WSIZE
     MSS_PDMA_ERROR_INVALID_NEXTCFG_RSIZE,  //!< ERROR_INVALID_NEXTCFG_RSIZE
+    MSS_PDMA_ERROR_INVALID_SG_LIST,        //!< ERROR_INVALID_SG_LIST
+    MSS_PDMA_ERROR_STRIPED_TRANSFER,       //!< ERROR_STRIPED_TRANSFER
+    MSS_PDMA_ERROR_QUEUE_FULL,             //!< ERROR_QUEUE_FULL
+    MSS_PDMA_ERROR_INVALID_SIZE,           //!< ERROR_INVALID_SIZE
     MSS_PDMA_ERROR_LAST_ID,                //!< ERROR_LAST_ID
 } mss_pdma_error_id_t;
 
@@ -242,6 +311,47 @@ typedef struct _pdmaregs
  */
 typedef void (*mss_pdma_int_handler_t)(uint8_t interrupt_type);
 
+/*-------------------------------------------------------------------------*//**
+  The mss_pdma_request_status_t enumeration reports the progress of a request
+  submitted with MSS_PDMA_submit_request().
+ */
+typedef enum __pdma_request_status
+{
+    MSS_PDMA_REQUEST_QUEUED = 0,
+    MSS_PDMA_REQUEST_IN_PROGRESS,
+    MSS_PDMA_REQUEST_DONE,
+    MSS_PDMA_REQUEST_ERROR,
+} mss_pdma_request_status_t;
+
+struct _pdmarequest;
+
+/* Request completion handler
+ * Invoked on the submitting hart when a queued request completes, with a
+ * pointer to the request. The request status indicates success or failure.
+ */
+typedef void (*mss_pdma_request_handler_t)(struct _pdmarequest *request);
+
+/*-------------------------------------------------------------------------*//**
+  The mss_pdma_request_t structure describes one transfer submitted to a
+  channel request queue. The application fills in the transfer, handler and
+  context fields; the remaining fields are owned by the driver from submission
+  until the request completes. A request must not be modified or resubmitted
+  until its handler has been invoked, or, for requests without a handler,
+  until its status is MSS_PDMA_REQUEST_DONE or MSS_PDMA_REQUEST_ERROR.
+ */
+typedef struct _pdmarequest
+{
+    uint64_t src_addr;                     /* source address */
+    uint64_t dest_addr;                    /* destination address */
+    uint64_t num_bytes;                    /* Number of bytes to be transferred */
+    uint8_t force_order;                   /* Enforce strict ordering */
+    mss_pdma_request_handler_t handler;    /* Completion handler, may be null */
+    void *context;                         /* Application data for the handler */
+    volatile mss_pdma_request_status_t status; /* Set by the driver */
+    uint64_t hart_id;                      /* Submitting hart, set by the driver */
+    struct _pdmarequest *next;             /* Used by the driver */
+} mss_pdma_request_t;
+
 /*--------------------------------Public APIs---------------------------------*/
 /*-------------------------------------------------------------------------*//**
   The MSS_PDMA_setup_transfer() function is used to configure an individual
@@ -616,6 +726,219 @@ MSS_PDMA_clear_transfer_error_status
     mss_pdma_channel_id_t channel_id
 );
 
+/*-------------------------------------------------------------------------*//**
+  The MSS_PDMA_setup_sg_transfer() function is used to configure a DMA channel
+  to transfer a scatter-gather list of segments. The first segment is loaded
+  into the channel; the remaining segments are chained by the driver from the
+  channel's done interrupt handler without involving the application. The
+  transfer is started by calling MSS_PDMA_start_transfer().
+
+  @param channel_id
+           The channel_id parameter specifies the Platform DMA channel selected
+           for DMA transaction.
+
+  @param segments
+           The segments parameter is a pointer to an array of segment
+           descriptors. The array must remain valid until the list completes.
+
+  @param num_segments
+           The num_segments parameter specifies the number of entries in the
+           segments array.
+
+  @param force_order
+           The force_order parameter enforces strict ordering for every segment
+           of the list when set to 1.
+
+  @param pdma_transfer_handler
+           A callback function to the application. It is invoked once when the
+           whole list has been transferred, or when a transfer error occurs.
+
+  @return
+           The function returns error signals of type mss_pdma_error_id_t.
+
+  Example:
+  The following call will gather two buffers into one on channel 0.
+  @code
+        static mss_pdma_sg_segment_t sg_list[2] = {
+            {(uint64_t)header_buf, (uint64_t)frame_buf, HEADER_SIZE},
+            {(uint64_t)payload_buf, (uint64_t)frame_buf + HEADER_SIZE, PAYLOAD_SIZE}
+        };
+
+        g_pdma_error_code = MSS_PDMA_setup_sg_transfer(MSS_PDMA_CHANNEL_0,
+                                                       sg_list,
+                                                       2u,
+                                                       0u,
+                                                       pdma_isr);
+        if (g_pdma_error_code == MSS_PDMA_OK)
+        {
+            MSS_PDMA_start_transfer(MSS_PDMA_CHANNEL_0);
+        }
+  @endcode
+ */
+mss_pdma_error_id_t
+MSS_PDMA_setup_sg_transfer
+(
+    mss_pdma_channel_id_t channel_id,
+    const mss_pdma_sg_segment_t *segments,
+    uint32_t num_segments,
+    uint8_t force_order,
+    mss_pdma_int_handler_t pdma_transfer_handler
+);
+
+/*-------------------------------------------------------------------------*//**
+  The MSS_PDMA_get_sg_segments_completed() function is used to request the
+  number of segments of the current scatter-gather list that have been
+  transferred on the selected DMA channel.
+
+  @param channel_id
+           The channel_id parameter specifies the Platform DMA channel selected
+           for DMA transaction.
+
+  @return
+           This function returns the number of completed segments.
+
+  Example:
+  @code
+        uint32_t segments_done;
+
+        segments_done = MSS_PDMA_get_sg_segments_completed(MSS_PDMA_CHANNEL_0);
+  @endcode
+ */
+uint32_t
+MSS_PDMA_get_sg_segments_completed
+(
+    mss_pdma_channel_id_t channel_id
+);
+
+/*-------------------------------------------------------------------------*//**
+  The MSS_PDMA_memcpy_striped() function is used to copy one block of memory
+  using several DMA channels at once. The copy is split into num_channels
+  stripes, each a multiple of MSS_PDMA_STRIPE_ALIGNMENT bytes with the last
+  stripe taking any remainder, which are started on channels 0 to
+  num_channels - 1. Copies too small to be split use channel 0 only.
+
+  @param dest_addr
+           The dest_addr parameter specifies the destination address.
+
+  @param src_addr
+           The src_addr parameter specifies the source address.
+
+  @param num_bytes
+           The num_bytes parameter specifies the number of bytes to copy.
+
+  @param num_channels
+           The num_channels parameter specifies the number of channels to
+           stripe the copy across, from 1 to 4.
+
+  @param force_order
+           The force_order parameter enforces strict ordering on every channel
+           used when set to 1.
+
+  @param pdma_transfer_handler
+           A callback function to the application. It is invoked once with
+           PDMA_STRIPED_DONE_INT when all stripes have completed, or with
+           PDMA_STRIPED_ERROR_INT if any stripe failed. If a null pointer is
+           passed, the function waits for the copy to finish before returning.
+
+  @return
+           The function returns error signals of type mss_pdma_error_id_t.
+           MSS_PDMA_ERROR_INVALID_SIZE is returned when num_bytes is 0.
+           MSS_PDMA_ERROR_TRANSACTION_IN_PROGRESS is returned when a channel
+           is running or another striped copy has not finished.
+           MSS_PDMA_ERROR_STRIPED_TRANSFER is returned when no callback is given
+           and any stripe failed.
+
+  Example:
+  The following call copies 1MB across all four channels and waits for it.
+  @code
+        g_pdma_error_code = MSS_PDMA_memcpy_striped(0x88000000u,
+                                                    0x84000000u,
+                                                    0x100000u,
+                                                    4u,
+                                                    0u,
+                                                    (mss_pdma_int_handler_t)0);
+  @endcode
+ */
+mss_pdma_error_id_t
+MSS_PDMA_memcpy_striped
+(
+    uint64_t dest_addr,
+    uint64_t src_addr,
+    uint64_t num_bytes,
+    uint8_t num_channels,
+    uint8_t force_order,
+    mss_pdma_int_handler_t pdma_transfer_handler
+);
+
+/*-------------------------------------------------------------------------*//**
+  The MSS_PDMA_submit_request() function is used to add a transfer to the
+  request queue of a DMA channel. It can be called concurrently from any hart.
+  The transfer is started immediately if the channel is idle. The PLIC done
+  and error interrupts of the channel must be enabled on one hart.
+
+  @param channel_id
+           The channel_id parameter specifies the Platform DMA channel selected
+           for DMA transaction.
+
+  @param request
+           The request parameter is a pointer to the request to submit. It must
+           remain valid until the request completes.
+
+  @return
+           The function returns error signals of type mss_pdma_error_id_t.
+           MSS_PDMA_ERROR_QUEUE_FULL is returned when the channel already holds
+           MSS_PDMA_REQUEST_QUEUE_SIZE queued requests.
+
+  Example:
+  The following code submits a copy from U54_2 and receives its completion
+  in the U54_2 software interrupt handler.
+  @code
+        static mss_pdma_request_t h2_request;
+
+        static void h2_copy_done(mss_pdma_request_t *request)
+        {
+            h2_copies_done++;
+        }
+
+        void U54_2_software_IRQHandler(void)
+        {
+            MSS_PDMA_process_completed_requests();
+        }
+
+        h2_request.src_addr = 0x84000000u;
+        h2_request.dest_addr = 0x88000000u;
+        h2_request.num_bytes = 4096u;
+        h2_request.force_order = 0u;
+        h2_request.handler = h2_copy_done;
+        h2_request.context = NULL;
+
+        g_pdma_error_code = MSS_PDMA_submit_request(MSS_PDMA_CHANNEL_1,
+                                                    &h2_request);
+  @endcode
+ */
+mss_pdma_error_id_t
+MSS_PDMA_submit_request
+(
+    mss_pdma_channel_id_t channel_id,
+    mss_pdma_request_t *request
+);
+
+/*-------------------------------------------------------------------------*//**
+  The MSS_PDMA_process_completed_requests() function invokes the handlers of
+  the requests submitted by the calling hart that were completed by the PDMA
+  interrupt handlers running on another hart. It must be called from the
+  software interrupt handler of every hart that submits requests with a
+  handler, and that hart must have its software interrupt enabled.
+
+  @return
+           This function does not return a value.
+ */
+void
+MSS_PDMA_process_completed_requests
+(
+    void
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software
+ *
+ */
+
+/***************************************************************************
+ * @file mss_hpm.c
+ * @author Microchip-FPGA Embedded Systems Solutions
+ * @brief Per hart hardware performance monitor (HPM) profiling.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+
+typedef struct HPM_VIEW_INFO_
+{
+    uint64_t event[MSS_HPM_NB_COUNTERS];
+    const char *name[MSS_HPM_NB_COUNTERS];
+} HPM_VIEW_INFO;
+
+static const HPM_VIEW_INFO g_hpm_views[MSS_HPM_NB_VIEWS] =
+{
+    /* MSS_HPM_VIEW_CACHE */
+    { { MSS_HPM_ICACHE_MISS, MSS_HPM_DCACHE_MISS },
+      { "I$ miss", "D$ miss" } },
+    /* MSS_HPM_VIEW_STALLS */
+    { { MSS_HPM_LOAD_USE_INTERLOCK | MSS_HPM_LONG_LATENCY_INTERLOCK,
+        MSS_HPM_ICACHE_BUSY | MSS_HPM_DCACHE_BUSY },
+      { "ld interlock", "cache busy" } },
+    /* MSS_HPM_VIEW_BRANCH */
+    { { MSS_HPM_BRANCH_MISPREDICT | MSS_HPM_TARGET_MISPREDICT,
+        MSS_HPM_BRANCH_RETIRED | MSS_HPM_JAL_RETIRED | MSS_HPM_JALR_RETIRED },
+      { "mispredict", "branches" } },
+    /* MSS_HPM_VIEW_TLB */
+    { { MSS_HPM_ITLB_MISS | MSS_HPM_DTLB_MISS, MSS_HPM_UTLB_MISS },
+      { "I/D TLB miss", "UTLB miss" } },
+    /* MSS_HPM_VIEW_MEMOPS */
+    { { MSS_HPM_INT_LOAD_RETIRED, MSS_HPM_INT_STORE_RETIRED },
+      { "loads", "stores" } },
+    /* MSS_HPM_VIEW_WRITEBACK */
+    { { MSS_HPM_DCACHE_MISS, MSS_HPM_DCACHE_WRITEBACK },
+      { "D$ miss", "D$ writeback" } },
+};
+
+static mss_hpm_region_t g_hpm_regions[MSS_HPM_NB_HARTS][MSS_HPM_MAX_REGIONS];
+static const char *g_hpm_names[MSS_HPM_NB_HARTS][MSS_HPM_NB_COUNTERS];
+
+/*==============================================================================
+ *
+ */
+static void hpm_reset_regions(uint64_t hart_id)
+{
+    uint32_t region;
+
+    for (region = 0U; region < MSS_HPM_MAX_REGIONS; region++)
+    {
+        g_hpm_regions[hart_id][region].name = (const char *)0;
+        g_hpm_regions[hart_id][region].calls = 0ULL;
+        g_hpm_regions[hart_id][region].total.cycles = 0ULL;
+        g_hpm_regions[hart_id][region].total.instret = 0ULL;
+        g_hpm_regions[hart_id][region].total.event[0] = 0ULL;
+        g_hpm_regions[hart_id][region].total.event[1] = 0ULL;
+        g_hpm_regions[hart_id][region].active = 0U;
+    }
+}
+
+/**
+ * mss_hpm_select()
+ */
+void mss_hpm_select(uint64_t event3, const char *name3, uint64_t event4, const char *name4)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    ASSERT(hart_id < MSS_HPM_NB_HARTS);
+
+    write_csr(mhpmevent3, event3);
+    write_csr(mhpmevent4, event4);
+    write_csr(mhpmcounter3, 0U);
+    write_csr(mhpmcounter4, 0U);
+
+    /* Let S and U mode read the counters too */
+    set_csr(mcounteren, (1U << 3U) | (1U << 4U));
+
+    g_hpm_names[hart_id][0] = (name3 != (const char *)0) ? name3 : "hpm3";
+    g_hpm_names[hart_id][1] = (name4 != (const char *)0) ? name4 : "hpm4";
+
+    hpm_reset_regions(hart_id);
+}
+
+/**
+ * mss_hpm_select_view()
+ */
+void mss_hpm_select_view(MSS_HPM_VIEW view)
+{
+    ASSERT(view < MSS_HPM_NB_VIEWS);
+
+    mss_hpm_select(g_hpm_views[view].event[0], g_hpm_views[view].name[0],
+                   g_hpm_views[view].event[1], g_hpm_views[view].name[1]);
+}
+
+/**
+ * mss_hpm_read()
+ */
+void mss_hpm_read(mss_hpm_counts_t *counts)
+{
+    counts->cycles = read_csr(mcycle);
+    counts->instret = read_csr(minstret);
+    counts->event[0] = read_csr(mhpmcounter3);
+    counts->event[1] = read_csr(mhpmcounter4);
+}
+
+/**
+ * mss_hpm_region_begin()
+ */
+void mss_hpm_region_begin(uint32_t region, const char *name)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    mss_hpm_region_t *p_region;
+
+    ASSERT((hart_id < MSS_HPM_NB_HARTS) && (region < MSS_HPM_MAX_REGIONS));
+
+    p_region = &g_hpm_regions[hart_id][region];
+    ASSERT(0U == p_region->active);
+
+    if ((const char *)0 == p_region->name)
+    {
+        p_region->name = name;
+    }
+    p_region->active = 1U;
+
+    /* Read last so the bookkeeping above is not counted */
+    mss_hpm_read(&p_region->start);
+}
+
+/**
+ * mss_hpm_region_end()
+ */
+void mss_hpm_region_end(uint32_t region)
+{
+    mss_hpm_counts_t now;
+    uint64_t hart_id;
+    mss_hpm_region_t *p_region;
+
+    /* Read first so the bookkeeping below is not counted */
+    mss_hpm_read(&now);
+
+    hart_id = read_csr(mhartid);
+    ASSERT((hart_id < MSS_HPM_NB_HARTS) && (region < MSS_HPM_MAX_REGIONS));
+
+    p_region = &g_hpm_regions[hart_id][region];
+    if (0U == p_region->active)
+    {
+        return;
+    }
+
+    p_region->total.cycles += now.cycles - p_region->start.cycles;
+    p_region->total.instret += now.instret - p_region->start.instret;
+    p_region->total.event[0] += (now.event[0] - p_region->start.event[0]) & MSS_HPM_COUNTER_MASK;
+    p_region->total.event[1] += (now.event[1] - p_region->start.event[1]) & MSS_HPM_COUNTER_MASK;
+    p_region->calls++;
+    p_region->active = 0U;
+}
+
+/**
+ * mss_hpm_region()
+ */
+const mss_hpm_region_t * mss_hpm_region(uint32_t hart_id, uint32_t region)
+{
+    if ((hart_id >= MSS_HPM_NB_HARTS) || (region >= MSS_HPM_MAX_REGIONS) ||
+        (0ULL == g_hpm_regions[hart_id][region].calls))
+    {
+        return ((const mss_hpm_region_t *)0);
+    }
+
+    return (&g_hpm_regions[hart_id][region]);
+}
+
+/**
+ * mss_hpm_reset()
+ */
+void mss_hpm_reset(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    ASSERT(hart_id < MSS_HPM_NB_HARTS);
+    hpm_reset_regions(hart_id);
+}
+
+/**
+ * mss_hpm_dump()
+ */
+void mss_hpm_dump(uint32_t hart_id, mss_hpm_print_t print)
+{
+    char line[192];
+    const mss_hpm_region_t *p_region;
+    uint64_t instret;
+    uint32_t region;
+
+    if (hart_id >= MSS_HPM_NB_HARTS)
+    {
+        return;
+    }
+
+    (void)snprintf(line, sizeof(line),
+                   "hart %u  %-20s %10s %14s %14s %6s %14s %8s %14s %8s\r\n",
+                   hart_id, "region", "calls", "cycles", "instret", "IPC",
+                   (g_hpm_names[hart_id][0] != (const char *)0) ? g_hpm_names[hart_id][0] : "hpm3",
+                   "/1k ins",
+                   (g_hpm_names[hart_id][1] != (const char *)0) ? g_hpm_names[hart_id][1] : "hpm4",
+                   "/1k ins");
+    print(line);
+
+    for (region = 0U; region < MSS_HPM_MAX_REGIONS; region++)
+    {
+        p_region = mss_hpm_region(hart_id, region);
+        if ((const mss_hpm_region_t *)0 == p_region)
+        {
+            continue;
+        }
+
+        instret = (0ULL != p_region->total.instret) ? p_region->total.instret : 1ULL;
+
+        /* IPC and rates in fixed point, two and one decimal places */
+        (void)snprintf(line, sizeof(line),
+                       "hart %u  %-20.20s %10lu %14lu %14lu %3lu.%02lu %14lu %6lu.%01lu %14lu %6lu.%01lu\r\n",
+                       hart_id,
+                       (p_region->name != (const char *)0) ? p_region->name : "-",
+                       (unsigned long)p_region->calls,
+                       (unsigned long)p_region->total.cycles,
+                       (unsigned long)p_region->total.instret,
+                       (unsigned long)((p_region->total.instret * 100ULL) /
+                                       ((0ULL != p_region->total.cycles) ? p_region->total.cycles : 1ULL)) / 100UL,
+                       (unsigned long)((p_region->total.instret * 100ULL) /
+                                       ((0ULL != p_region->total.cycles) ? p_region->total.cycles : 1ULL)) % 100UL,
+                       (unsigned long)p_region->total.event[0],
+                       (unsigned long)((p_region->total.event[0] * 10000ULL) / instret) / 10UL,
+                       (unsigned long)((p_region->total.event[0] * 10000ULL) / instret) % 10UL,
+                       (unsigned long)p_region->total.event[1],
+                       (unsigned long)((p_region->total.event[1] * 10000ULL) / instret) / 10UL,
+                       (unsigned long)((p_region->total.event[1] * 10000ULL) / instret) % 10UL);
+        print(line);
+    }
+}
@@ -35,6 +35,29 @@ static const uint64_t g_init_marker = INIT_MARKER;
  * Local functions.
  */
 static void check_config_l2_scratchpad(void);
+static uint64_t scratchpad_way_mask(void);
+
+/*
+ * Way masks set by config_l2_cache(), in MSS_L2_MASTER order
+ */
+static const uint64_t g_way_mask_default[MSS_L2_NB_MASTERS] =
+{
+    LIBERO_SETTING_WAY_MASK_DMA,
+    LIBERO_SETTING_WAY_MASK_AXI4_PORT_0,
+    LIBERO_SETTING_WAY_MASK_AXI4_PORT_1,
+    LIBERO_SETTING_WAY_MASK_AXI4_PORT_2,
+    LIBERO_SETTING_WAY_MASK_AXI4_PORT_3,
+    LIBERO_SETTING_WAY_MASK_E51_DCACHE,
+    LIBERO_SETTING_WAY_MASK_E51_ICACHE,
+    LIBERO_SETTING_WAY_MASK_U54_1_DCACHE,
+    LIBERO_SETTING_WAY_MASK_U54_1_ICACHE,
+    LIBERO_SETTING_WAY_MASK_U54_2_DCACHE,
+    LIBERO_SETTING_WAY_MASK_U54_2_ICACHE,
+    LIBERO_SETTING_WAY_MASK_U54_3_DCACHE,
+    LIBERO_SETTING_WAY_MASK_U54_3_ICACHE,
+    LIBERO_SETTING_WAY_MASK_U54_4_DCACHE,
+    LIBERO_SETTING_WAY_MASK_U54_4_ICACHE,
+};
 
 /***************************************************************************//**
  * See hw_l2_scratch.h for details of how to use this function.
@@ -240,3 +263,153 @@ static void check_config_l2_scratchpad(void)
 
     ASSERT(LIBERO_SETTING_NUM_SCRATCH_PAD_WAYS >= n_scratchpad_ways);
 }
+
+/*==============================================================================
+ * Ways reserved for scratchpad, counted down from the top enabled way as
+ * config_l2_cache() does.
+ */
+static uint64_t scratchpad_way_mask(void)
+{
+    uint64_t mask = 0U;
+    uint32_t inc;
+
+    for(inc = 0U; inc < LIBERO_SETTING_NUM_SCRATCH_PAD_WAYS; ++inc)
+    {
+        mask |= (1ULL << LIBERO_SETTING_WAY_ENABLE) >> inc;
+    }
+    return (mask);
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+uint64_t mss_l2_cache_way_mask(void)
+{
+    uint64_t enabled = (1ULL << (LIBERO_SETTING_WAY_ENABLE + 1U)) - 1U;
+
+    return (enabled & ~scratchpad_way_mask());
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+uint64_t mss_l2_get_way_mask(MSS_L2_MASTER master)
+{
+    ASSERT(master < MSS_L2_NB_MASTERS);
+
+    return (__atomic_load_8((&CACHE_CTRL->WAY_MASK_DMA) + master, __ATOMIC_RELAXED));
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+MSS_L2_WAY_STATUS mss_l2_set_way_mask(MSS_L2_MASTER master,
+                                      uint64_t way_mask,
+                                      uintptr_t flush_start,
+                                      size_t flush_size)
+{
+    if (master >= MSS_L2_NB_MASTERS)
+    {
+        return (MSS_L2_WAY_BAD_MASTER);
+    }
+
+    /* A scratchpad way must never be allocated into, it would be corrupted */
+    if ((0U == way_mask) || (0U != (way_mask & ~mss_l2_cache_way_mask())))
+    {
+        return (MSS_L2_WAY_BAD_MASK);
+    }
+
+    /* Stores to the working set complete before it is flushed */
+    mb();
+    __atomic_store_8((&CACHE_CTRL->WAY_MASK_DMA) + master, way_mask, __ATOMIC_RELAXED);
+    mb();
+
+    if (0U != flush_size)
+    {
+        mss_l2_flush_range(flush_start, flush_size);
+    }
+
+    return (MSS_L2_WAY_OK);
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+void mss_l2_restore_way_masks(void)
+{
+    uint32_t master;
+
+    mb();
+    for(master = 0U; master < (uint32_t)MSS_L2_NB_MASTERS; master++)
+    {
+        __atomic_store_8((&CACHE_CTRL->WAY_MASK_DMA) + master,
+                         g_way_mask_default[master], __ATOMIC_RELAXED);
+    }
+    mb();
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+void mss_l2_flush_range(uintptr_t start, size_t size)
+{
+    uintptr_t line = start & ~((uintptr_t)CACHE_BLOCK_BYTE_LENGTH - 1U);
+    uintptr_t end = start + size;
+
+    mb();
+    while (line < end)
+    {
+        CACHE_CTRL->FLUSH64 = (uint64_t)line;
+        line += CACHE_BLOCK_BYTE_LENGTH;
+    }
+    mb();
+}
+
+/***************************************************************************//**
+ * See mss_l2_cache.h for details of how to use this function.
+ */
+MSS_L2_WAY_STATUS mss_l2_evict_ways(uint64_t way_mask, uintptr_t evict_buffer)
+{
+    MSS_L2_MASTER master = MSS_L2_MASTER_DCACHE(read_csr(mhartid));
+    uint64_t saved_mask;
+    uint64_t way;
+    volatile const uint64_t *p_line;
+    uint64_t sink = 0U;
+    uint32_t inc;
+
+    if ((0U == way_mask) || (0U != (way_mask & ~mss_l2_cache_way_mask())))
+    {
+        return (MSS_L2_WAY_BAD_MASK);
+    }
+
+    saved_mask = mss_l2_get_way_mask(master);
+
+    for(way = 1U; way != 0U; way <<= 1U)
+    {
+        if (0U == (way_mask & way))
+        {
+            continue;
+        }
+
+        /* The buffer must miss in the L2 to be allocated into the way */
+        mss_l2_flush_range(evict_buffer, WAY_BYTE_LENGTH);
+        __atomic_store_8((&CACHE_CTRL->WAY_MASK_DMA) + master, way, __ATOMIC_RELAXED);
+        mb();
+
+        /* One line per set and bank fills the whole way */
+        p_line = (volatile const uint64_t *)evict_buffer;
+        for(inc = 0U; inc < (WAY_BYTE_LENGTH / CACHE_BLOCK_BYTE_LENGTH); ++inc)
+        {
+            sink += *p_line;
+            p_line += CACHE_BLOCK_BYTE_LENGTH / UINT64_BYTE_LENGTH;
+        }
+        mb();
+    }
+
+    __atomic_store_8((&CACHE_CTRL->WAY_MASK_DMA) + master, saved_mask, __ATOMIC_RELAXED);
+    mb();
+    mss_l2_flush_range(evict_buffer, WAY_BYTE_LENGTH);
+    (void)sink;
+
+    return (MSS_L2_WAY_OK);
+}
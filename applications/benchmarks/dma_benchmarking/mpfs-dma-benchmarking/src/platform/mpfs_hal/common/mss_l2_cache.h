@@ -16,6 +16,7 @@
 #ifndef MSS_L2_CACHE_H
 #define MSS_L2_CACHE_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include "encoding.h"
 
@@ -522,6 +523,40 @@ typedef struct {
 
 #define CACHE_CTRL  ((volatile CACHE_CTRL_typedef *) CACHE_CTRL_BASE)
 
+/*==============================================================================
+ * L2 masters with a way mask register, in register order
+ */
+typedef enum MSS_L2_MASTER_
+{
+    MSS_L2_MASTER_DMA           = 0,
+    MSS_L2_MASTER_AXI4_PORT_0   = 1,
+    MSS_L2_MASTER_AXI4_PORT_1   = 2,
+    MSS_L2_MASTER_AXI4_PORT_2   = 3,
+    MSS_L2_MASTER_AXI4_PORT_3   = 4,
+    MSS_L2_MASTER_E51_DCACHE    = 5,
+    MSS_L2_MASTER_E51_ICACHE    = 6,
+    MSS_L2_MASTER_U54_1_DCACHE  = 7,
+    MSS_L2_MASTER_U54_1_ICACHE  = 8,
+    MSS_L2_MASTER_U54_2_DCACHE  = 9,
+    MSS_L2_MASTER_U54_2_ICACHE  = 10,
+    MSS_L2_MASTER_U54_3_DCACHE  = 11,
+    MSS_L2_MASTER_U54_3_ICACHE  = 12,
+    MSS_L2_MASTER_U54_4_DCACHE  = 13,
+    MSS_L2_MASTER_U54_4_ICACHE  = 14,
+    MSS_L2_NB_MASTERS           = 15,
+} MSS_L2_MASTER;
+
+/* D-cache and I-cache master of a hart */
+#define MSS_L2_MASTER_DCACHE(hart_id)   ((MSS_L2_MASTER)(MSS_L2_MASTER_E51_DCACHE + (2U * (hart_id))))
+#define MSS_L2_MASTER_ICACHE(hart_id)   ((MSS_L2_MASTER)(MSS_L2_MASTER_E51_ICACHE + (2U * (hart_id))))
+
+typedef enum MSS_L2_WAY_STATUS_
+{
+    MSS_L2_WAY_OK               = 0,
+    MSS_L2_WAY_BAD_MASTER       = 1,
+    MSS_L2_WAY_BAD_MASK         = 2,    /* Empty, or not a subset of cache ways */
+} MSS_L2_WAY_STATUS;
+
 
 /***************************************************************************//**
   The end_l2_scratchpad_address() function is used to return the end address of
@@ -577,6 +612,79 @@ uint8_t check_num_scratch_ways(uint64_t *start, uint64_t *end);
 uint32_t num_cache_ways(void);
 uint32_t my_num_cache_ways(void);
 
+/***************************************************************************//**
+  The mss_l2_cache_way_mask() function returns the mask of the ways used as
+  cache, i.e. the enabled ways less those reserved for scratchpad. Way masks
+  passed to mss_l2_set_way_mask() must be a subset of it.
+ */
+uint64_t mss_l2_cache_way_mask(void);
+
+/***************************************************************************//**
+  The mss_l2_get_way_mask() function returns the current way mask of a master,
+  the ways it may allocate into and so evict from.
+ */
+uint64_t mss_l2_get_way_mask(MSS_L2_MASTER master);
+
+/***************************************************************************//**
+  The mss_l2_set_way_mask() function changes the ways a master may allocate
+  into at run time. It can be called from any hart while the others run.
+
+  The way masks only control allocation. Lines the master already holds in ways
+  it no longer owns stay there, and can be evicted by whoever owns those ways
+  now. Passing the master's working set in flush_start/flush_size writes it back
+  and invalidates it first, so it is refetched into the new ways. Pass a
+  flush_size of 0 to skip this.
+
+  @param master
+    The master to repartition.
+
+  @param way_mask
+    Ways the master may allocate into. Must not be empty, and must only include
+    cache ways, see mss_l2_cache_way_mask().
+
+  @param flush_start
+    Start of the address range to flush, cache line aligned down.
+
+  @param flush_size
+    Size in bytes of the address range to flush.
+
+  @return
+    MSS_L2_WAY_OK, or why the mask was not changed.
+
+  Example:
+  @code
+        // Give hart 1 ways 0 to 3 and keep the other masters out of them
+        mss_l2_set_way_mask(MSS_L2_MASTER_U54_1_DCACHE, 0x0FU, buffer, size);
+  @endcode
+ */
+MSS_L2_WAY_STATUS mss_l2_set_way_mask(MSS_L2_MASTER master,
+                                      uint64_t way_mask,
+                                      uintptr_t flush_start,
+                                      size_t flush_size);
+
+/***************************************************************************//**
+  The mss_l2_restore_way_masks() function sets the way mask of every master
+  back to the MSS Configurator settings applied by config_l2_cache().
+ */
+void mss_l2_restore_way_masks(void);
+
+/***************************************************************************//**
+  The mss_l2_flush_range() function writes back and invalidates, in the L2 and
+  in the L1 caches above it, every cache line of an address range.
+ */
+void mss_l2_flush_range(uintptr_t start, size_t size);
+
+/***************************************************************************//**
+  The mss_l2_evict_ways() function empties the ways in way_mask, writing back
+  dirty lines, so a master given those ways starts with all of them free. It
+  fills one way at a time from evict_buffer with the calling hart's D-cache
+  restricted to that way, then flushes the buffer.
+
+  evict_buffer must be WAY_BYTE_LENGTH bytes of cached memory not used by
+  anything else. Other masters must not be allocating into way_mask meanwhile.
+ */
+MSS_L2_WAY_STATUS mss_l2_evict_ways(uint64_t way_mask, uintptr_t evict_buffer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,373 @@
+/*******************************************************************************
+ * Copyright 2019-2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software
+ *
+ */
+
+/***************************************************************************
+ * @file mss_l2_mem.c
+ * @author Microchip-FPGA Embedded Systems Solutions
+ * @brief Run time allocation from L2-LIM and L2 scratchpad memory.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+
+typedef struct L2_MEM_REGION_
+{
+    uintptr_t base;
+    uintptr_t top;
+    volatile uintptr_t next;        /* Shared bump pointer, updated with CAS */
+} L2_MEM_REGION;
+
+/* Only touched by the owning hart, padded so harts don't share a line */
+typedef struct L2_MEM_ARENA_
+{
+    uintptr_t base;
+    uintptr_t top;
+    uintptr_t next;
+} __attribute__((aligned(64))) L2_MEM_ARENA;
+
+static L2_MEM_REGION g_l2_mem[MSS_L2_MEM_NB_TYPES];
+static L2_MEM_ARENA g_l2_arena[MSS_L2_MEM_NB_TYPES][MSS_L2_MEM_NB_HARTS];
+
+/*==============================================================================
+ * Round up to align, a power of 2. 0 on overflow.
+ */
+static uintptr_t l2_mem_align(uintptr_t address, size_t align)
+{
+    uintptr_t aligned = (address + (uintptr_t)align - 1U) & ~((uintptr_t)align - 1U);
+
+    return ((aligned < address) ? 0U : aligned);
+}
+
+static size_t l2_mem_check_align(size_t align)
+{
+    if (align < MSS_L2_MEM_MIN_ALIGN)
+    {
+        align = MSS_L2_MEM_MIN_ALIGN;
+    }
+    ASSERT(0U == (align & (align - 1U)));
+
+    return (align);
+}
+
+/*==============================================================================
+ * Bump size bytes off the shared region. Lock free, any hart may call it.
+ * Returns 0 if there is not enough left.
+ */
+static uintptr_t l2_mem_take(MSS_L2_MEM_TYPE type, size_t size, size_t align)
+{
+    L2_MEM_REGION *p_region;
+    uintptr_t next;
+    uintptr_t start;
+    uintptr_t end;
+
+    if ((type >= MSS_L2_MEM_NB_TYPES) || (0U == size))
+    {
+        return (0U);
+    }
+
+    p_region = &g_l2_mem[type];
+    align = l2_mem_check_align(align);
+    next = __atomic_load_n(&p_region->next, __ATOMIC_ACQUIRE);
+
+    do
+    {
+        if (0U == next)
+        {
+            return (0U);            /* Not initialised */
+        }
+
+        start = l2_mem_align(next, align);
+        end = start + size;
+        if ((0U == start) || (end < start) || (end > p_region->top))
+        {
+            return (0U);
+        }
+    } while (!__atomic_compare_exchange_n(&p_region->next, &next, end, 0,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    return (start);
+}
+
+/**
+ * mss_l2_mem_init()
+ */
+MSS_L2_MEM_STATUS mss_l2_mem_init(MSS_L2_MEM_TYPE type, uintptr_t base, size_t size)
+{
+    uint64_t bottom;
+    uint64_t top;
+    uint32_t hart;
+
+    if ((type >= MSS_L2_MEM_NB_TYPES) || (0U == size))
+    {
+        return (MSS_L2_MEM_BAD_PARAM);
+    }
+
+    if (MSS_L2_MEM_LIM == type)
+    {
+        bottom = MSS_L2_MEM_LIM_BOTTOM;
+        top = MSS_L2_MEM_LIM_TOP;
+    }
+    else
+    {
+        bottom = ZERO_DEVICE_BOTTOM;
+        top = ZERO_DEVICE_TOP;
+    }
+
+    if (((uint64_t)base < bottom) || ((uint64_t)base >= top) ||
+        ((uint64_t)size > (top - (uint64_t)base)))
+    {
+        return (MSS_L2_MEM_BAD_PARAM);
+    }
+
+    for (hart = 0U; hart < MSS_L2_MEM_NB_HARTS; hart++)
+    {
+        g_l2_arena[type][hart].base = 0U;
+        g_l2_arena[type][hart].top = 0U;
+        g_l2_arena[type][hart].next = 0U;
+    }
+
+    g_l2_mem[type].base = base;
+    g_l2_mem[type].top = base + size;
+    __atomic_store_n(&g_l2_mem[type].next, base, __ATOMIC_RELEASE);
+
+    return (MSS_L2_MEM_OK);
+}
+
+/**
+ * mss_l2_mem_alloc()
+ */
+void * mss_l2_mem_alloc(MSS_L2_MEM_TYPE type, size_t size, size_t align)
+{
+    return ((void *)l2_mem_take(type, size, align));
+}
+
+/**
+ * mss_l2_mem_alloc_stack()
+ */
+void * mss_l2_mem_alloc_stack(MSS_L2_MEM_TYPE type, size_t size)
+{
+    uintptr_t bottom;
+
+    size = (size_t)l2_mem_align((uintptr_t)size, MSS_L2_MEM_STACK_ALIGN);
+    bottom = l2_mem_take(type, size, MSS_L2_MEM_STACK_ALIGN);
+
+    return ((0U == bottom) ? (void *)0 : (void *)(bottom + size));
+}
+
+/**
+ * mss_l2_mem_mark()
+ */
+uintptr_t mss_l2_mem_mark(MSS_L2_MEM_TYPE type)
+{
+    ASSERT(type < MSS_L2_MEM_NB_TYPES);
+
+    return (__atomic_load_n(&g_l2_mem[type].next, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * mss_l2_mem_release()
+ */
+void mss_l2_mem_release(MSS_L2_MEM_TYPE type, uintptr_t mark)
+{
+    ASSERT(type < MSS_L2_MEM_NB_TYPES);
+    ASSERT((mark >= g_l2_mem[type].base) && (mark <= g_l2_mem[type].next));
+
+    __atomic_store_n(&g_l2_mem[type].next, mark, __ATOMIC_RELEASE);
+}
+
+/**
+ * mss_l2_mem_free_bytes()
+ */
+size_t mss_l2_mem_free_bytes(MSS_L2_MEM_TYPE type)
+{
+    uintptr_t next;
+
+    if (type >= MSS_L2_MEM_NB_TYPES)
+    {
+        return (0U);
+    }
+
+    next = __atomic_load_n(&g_l2_mem[type].next, __ATOMIC_ACQUIRE);
+
+    return ((0U == next) ? 0U : (size_t)(g_l2_mem[type].top - next));
+}
+
+/**
+ * mss_l2_mem_arena_init()
+ */
+MSS_L2_MEM_STATUS mss_l2_mem_arena_init(MSS_L2_MEM_TYPE type, size_t size)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uintptr_t base;
+
+    if ((type >= MSS_L2_MEM_NB_TYPES) || (0U == size) || (hart_id >= MSS_L2_MEM_NB_HARTS))
+    {
+        return (MSS_L2_MEM_BAD_PARAM);
+    }
+
+    if (0U == g_l2_mem[type].base)
+    {
+        return (MSS_L2_MEM_NOT_INIT);
+    }
+
+    /* Start each arena on its own cache line */
+    base = l2_mem_take(type, size, 64U);
+    if (0U == base)
+    {
+        return (MSS_L2_MEM_NO_SPACE);
+    }
+
+    g_l2_arena[type][hart_id].base = base;
+    g_l2_arena[type][hart_id].top = base + size;
+    g_l2_arena[type][hart_id].next = base;
+
+    return (MSS_L2_MEM_OK);
+}
+
+/**
+ * mss_l2_mem_arena_alloc()
+ */
+void * mss_l2_mem_arena_alloc(MSS_L2_MEM_TYPE type, size_t size, size_t align)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    L2_MEM_ARENA *p_arena;
+    uintptr_t start;
+
+    if ((type >= MSS_L2_MEM_NB_TYPES) || (0U == size) || (hart_id >= MSS_L2_MEM_NB_HARTS))
+    {
+        return ((void *)0);
+    }
+
+    p_arena = &g_l2_arena[type][hart_id];
+    if (0U == p_arena->next)
+    {
+        return ((void *)0);
+    }
+
+    start = l2_mem_align(p_arena->next, l2_mem_check_align(align));
+    if ((0U == start) || ((start + size) < start) || ((start + size) > p_arena->top))
+    {
+        return ((void *)0);
+    }
+
+    p_arena->next = start + size;
+
+    return ((void *)start);
+}
+
+/**
+ * mss_l2_mem_arena_reset()
+ */
+void mss_l2_mem_arena_reset(MSS_L2_MEM_TYPE type)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    ASSERT((type < MSS_L2_MEM_NB_TYPES) && (hart_id < MSS_L2_MEM_NB_HARTS));
+
+    g_l2_arena[type][hart_id].next = g_l2_arena[type][hart_id].base;
+}
+
+/**
+ * mss_l2_mem_pool_init()
+ */
+MSS_L2_MEM_STATUS mss_l2_mem_pool_init(mss_l2_mem_pool_t *pool,
+                                       MSS_L2_MEM_TYPE type,
+                                       uint32_t block_size,
+                                       uint32_t nb_blocks,
+                                       uint32_t align)
+{
+    uintptr_t base;
+    uintptr_t block;
+    uint32_t index;
+
+    if (((mss_l2_mem_pool_t *)0 == pool) || (type >= MSS_L2_MEM_NB_TYPES) ||
+        (0U == block_size) || (0U == nb_blocks))
+    {
+        return (MSS_L2_MEM_BAD_PARAM);
+    }
+
+    if (0U == g_l2_mem[type].base)
+    {
+        return (MSS_L2_MEM_NOT_INIT);
+    }
+
+    /* Each free block holds the link to the next one */
+    align = (uint32_t)l2_mem_check_align(align);
+    block_size = (uint32_t)l2_mem_align((uintptr_t)block_size, align);
+
+    base = l2_mem_take(type, (size_t)block_size * nb_blocks, align);
+    if (0U == base)
+    {
+        return (MSS_L2_MEM_NO_SPACE);
+    }
+
+    for (index = 0U; index < nb_blocks; index++)
+    {
+        block = base + ((uintptr_t)index * block_size);
+        *(void **)block = (index == (nb_blocks - 1U)) ?
+                          (void *)0 : (void *)(block + block_size);
+    }
+
+    pool->free_list = (void *)base;
+    pool->block_size = block_size;
+    pool->nb_blocks = nb_blocks;
+    pool->nb_free = nb_blocks;
+    pool->min_free = nb_blocks;
+    pool->lock = 0;
+    mb();
+
+    return (MSS_L2_MEM_OK);
+}
+
+/**
+ * mss_l2_mem_pool_get()
+ */
+void * mss_l2_mem_pool_get(mss_l2_mem_pool_t *pool)
+{
+    void *block;
+
+    spinlock(&pool->lock);
+
+    block = pool->free_list;
+    if ((void *)0 != block)
+    {
+        pool->free_list = *(void **)block;
+        pool->nb_free--;
+        if (pool->nb_free < pool->min_free)
+        {
+            pool->min_free = pool->nb_free;
+        }
+    }
+
+    spinunlock(&pool->lock);
+
+    return (block);
+}
+
+/**
+ * mss_l2_mem_pool_put()
+ */
+void mss_l2_mem_pool_put(mss_l2_mem_pool_t *pool, void *block)
+{
+    if ((void *)0 == block)
+    {
+        return;
+    }
+
+    spinlock(&pool->lock);
+
+    ASSERT(pool->nb_free < pool->nb_blocks);
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->nb_free++;
+
+    spinunlock(&pool->lock);
+}
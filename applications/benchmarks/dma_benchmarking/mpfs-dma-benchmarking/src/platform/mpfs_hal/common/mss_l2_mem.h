@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright 2019-2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software
+ *
+ */
+
+/***************************************************************************
+ * @file mss_l2_mem.h
+ * @author Microchip-FPGA Embedded Systems Solutions
+ * @brief Run time allocation from L2-LIM and L2 scratchpad memory.
+ *
+ * The ways of the L2 not used as cache are available as LIM, from 0x08000000,
+ * or as scratchpad through the zero device, from 0x0A000000. Both are lower
+ * latency than DDR, but only what the linker script places there is normally
+ * used. This module lets the application hand the rest of each to the HAL and
+ * place hot buffers, DMA descriptors and stacks there at run time.
+ *
+ * Each memory type has one region, given to mss_l2_mem_init(). The region is
+ * used three ways:
+ *  - shared bump allocation, mss_l2_mem_alloc(). Safe to call from any hart,
+ *    allocations are only returned all at once with mss_l2_mem_release().
+ *  - per hart arenas, carved from the region with mss_l2_mem_arena_init().
+ *    Allocation from the calling hart's arena takes no lock or atomic.
+ *  - fixed size block pools, carved from the region with
+ *    mss_l2_mem_pool_init(). Blocks can be taken and returned by any hart.
+ *
+ * Nothing is cleared. Scratchpad ways must have been configured, and the
+ * region must not overlap what the linker placed in the same memory.
+ */
+
+#ifndef MSS_L2_MEM_H
+#define MSS_L2_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSS_L2_MEM_LIM_BOTTOM   0x08000000ULL
+#define MSS_L2_MEM_LIM_TOP      0x08200000ULL   /* 16 ways of 128KB */
+#define MSS_L2_MEM_MIN_ALIGN    8U
+#define MSS_L2_MEM_STACK_ALIGN  16U             /* RISC-V psABI */
+#define MSS_L2_MEM_NB_HARTS     5U
+
+typedef enum MSS_L2_MEM_TYPE_
+{
+    MSS_L2_MEM_LIM          = 0,
+    MSS_L2_MEM_SCRATCHPAD   = 1,
+    MSS_L2_MEM_NB_TYPES     = 2,
+} MSS_L2_MEM_TYPE;
+
+typedef enum MSS_L2_MEM_STATUS_
+{
+    MSS_L2_MEM_OK           = 0,
+    MSS_L2_MEM_BAD_PARAM    = 1,    /* Outside the memory, or zero sized */
+    MSS_L2_MEM_NO_SPACE     = 2,    /* Not enough left in the region */
+    MSS_L2_MEM_NOT_INIT     = 3,    /* mss_l2_mem_init() not called */
+} MSS_L2_MEM_STATUS;
+
+typedef struct mss_l2_mem_pool_t_
+{
+    void *free_list;
+    uint32_t block_size;
+    uint32_t nb_blocks;
+    uint32_t nb_free;
+    uint32_t min_free;              /* Low water mark of nb_free */
+    volatile long lock;
+} mss_l2_mem_pool_t;
+
+/*==============================================================================
+ * mss_l2_mem_init() - give the HAL size bytes of LIM or scratchpad from base.
+ *   Calling it again resets the region, including any arenas and pools in it.
+ *   Call it from one hart, before the others use the region.
+ * mss_l2_mem_alloc() - size bytes from the region, align a power of 2 or 0
+ *   for MSS_L2_MEM_MIN_ALIGN. NULL if there is not enough left.
+ * mss_l2_mem_alloc_stack() - a 16 byte aligned stack of size bytes. Returns
+ *   its top, the initial sp, or NULL.
+ * mss_l2_mem_mark()/mss_l2_mem_release() - return everything allocated from
+ *   the region since the mark. Arenas and pools allocated since then are
+ *   returned too and must no longer be used.
+ * mss_l2_mem_free_bytes() - bytes left in the region.
+ *
+ * mss_l2_mem_arena_init() - carve an arena of size bytes from the region for
+ *   the calling hart. Replaces any earlier arena of that hart.
+ * mss_l2_mem_arena_alloc() - size bytes from the calling hart's arena.
+ * mss_l2_mem_arena_reset() - return everything in the calling hart's arena.
+ *
+ * mss_l2_mem_pool_init() - carve nb_blocks blocks of block_size bytes from the
+ *   region. block_size is rounded up to a multiple of align, which is at least
+ *   MSS_L2_MEM_MIN_ALIGN. Use 64 for cache line aligned DMA descriptors.
+ * mss_l2_mem_pool_get() - take a block, NULL if none are free.
+ * mss_l2_mem_pool_put() - return a block taken from the same pool.
+ */
+MSS_L2_MEM_STATUS mss_l2_mem_init(MSS_L2_MEM_TYPE type, uintptr_t base, size_t size);
+void * mss_l2_mem_alloc(MSS_L2_MEM_TYPE type, size_t size, size_t align);
+void * mss_l2_mem_alloc_stack(MSS_L2_MEM_TYPE type, size_t size);
+uintptr_t mss_l2_mem_mark(MSS_L2_MEM_TYPE type);
+void mss_l2_mem_release(MSS_L2_MEM_TYPE type, uintptr_t mark);
+size_t mss_l2_mem_free_bytes(MSS_L2_MEM_TYPE type);
+
+MSS_L2_MEM_STATUS mss_l2_mem_arena_init(MSS_L2_MEM_TYPE type, size_t size);
+void * mss_l2_mem_arena_alloc(MSS_L2_MEM_TYPE type, size_t size, size_t align);
+void mss_l2_mem_arena_reset(MSS_L2_MEM_TYPE type);
+
+MSS_L2_MEM_STATUS mss_l2_mem_pool_init(mss_l2_mem_pool_t *pool,
+                                       MSS_L2_MEM_TYPE type,
+                                       uint32_t block_size,
+                                       uint32_t nb_blocks,
+                                       uint32_t align);
+void * mss_l2_mem_pool_get(mss_l2_mem_pool_t *pool);
+void mss_l2_mem_pool_put(mss_l2_mem_pool_t *pool, void *block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_L2_MEM_H */
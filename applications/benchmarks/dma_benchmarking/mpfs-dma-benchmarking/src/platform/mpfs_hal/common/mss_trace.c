@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * Copyright 2019-2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software
+ *
+ */
+
+/***************************************************************************
+ * @file mss_trace.c
+ * @author Microchip-FPGA Embedded Systems Solutions
+ * @brief Binary trace events with deferred formatting.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mpfs_hal/mss_hal.h"
+
+#if ((MSS_TRACE_RING_WORDS & (MSS_TRACE_RING_WORDS - 1U)) != 0U)
+#error "MSS_TRACE_RING_WORDS must be a power of 2"
+#endif
+
+#define TRACE_RING_MASK         (MSS_TRACE_RING_WORDS - 1U)
+#define TRACE_NB_ARGS_SHIFT     56U
+#define TRACE_FMT_MASK          ((1ULL << TRACE_NB_ARGS_SHIFT) - 1U)
+
+/*
+ * An event is a header word, the format address with the number of arguments
+ * in the top byte, then the timestamp and the arguments. The header is written
+ * last, a non zero header at the tail means the event is complete. The drain
+ * clears every word it takes so a stale argument is never seen as a header.
+ */
+typedef struct TRACE_RING_
+{
+    /* Written by any context on the owning hart */
+    volatile uint32_t head;
+    mss_trace_stats_t stats;
+
+    /* Written by the draining hart */
+    volatile uint32_t tail __attribute__((aligned(64)));
+    uint64_t reported_drops;
+
+    volatile uint64_t word[MSS_TRACE_RING_WORDS] __attribute__((aligned(64)));
+} TRACE_RING;
+
+static TRACE_RING g_trace_ring[MSS_TRACE_NB_HARTS];
+
+/*==============================================================================
+ * Append value to the frame, little endian, adding its bytes to the checksum
+ */
+static uint32_t trace_put(uint8_t *frame, uint32_t length, uint64_t value,
+                          uint32_t nb_bytes, uint8_t *checksum)
+{
+    uint32_t index;
+
+    for (index = 0U; index < nb_bytes; index++)
+    {
+        frame[length] = (uint8_t)(value >> (8U * index));
+        *checksum += frame[length];
+        length++;
+    }
+
+    return (length);
+}
+
+static uint32_t trace_frame(uint8_t *frame, uint32_t hart_id, uint64_t timestamp,
+                            uint64_t fmt, uint32_t nb_args,
+                            const volatile uint64_t *word, uint32_t first)
+{
+    uint8_t checksum = 0U;
+    uint32_t length = 0U;
+    uint32_t arg;
+
+    frame[length] = MSS_TRACE_SYNC;
+    length++;
+    length = trace_put(frame, length, hart_id, 1U, &checksum);
+    length = trace_put(frame, length, nb_args, 1U, &checksum);
+    length = trace_put(frame, length, timestamp, 8U, &checksum);
+    length = trace_put(frame, length, fmt, 8U, &checksum);
+
+    for (arg = 0U; arg < nb_args; arg++)
+    {
+        length = trace_put(frame, length, word[(first + arg) & TRACE_RING_MASK], 8U, &checksum);
+    }
+
+    frame[length] = checksum;
+    length++;
+
+    return (length);
+}
+
+/*==============================================================================
+ * The hart whose next complete event is the oldest, MSS_TRACE_NB_HARTS if no
+ * hart has one
+ */
+static uint32_t trace_oldest(void)
+{
+    uint32_t oldest = MSS_TRACE_NB_HARTS;
+    uint64_t oldest_stamp = 0U;
+    TRACE_RING *p_ring;
+    uint64_t stamp;
+    uint32_t hart;
+
+    for (hart = 0U; hart < MSS_TRACE_NB_HARTS; hart++)
+    {
+        p_ring = &g_trace_ring[hart];
+
+        if (0U != __atomic_load_n(&p_ring->word[p_ring->tail & TRACE_RING_MASK], __ATOMIC_ACQUIRE))
+        {
+            stamp = p_ring->word[(p_ring->tail + 1U) & TRACE_RING_MASK];
+            if ((MSS_TRACE_NB_HARTS == oldest) || (stamp < oldest_stamp))
+            {
+                oldest = hart;
+                oldest_stamp = stamp;
+            }
+        }
+    }
+
+    return (oldest);
+}
+
+/**
+ * mss_trace_event()
+ */
+void mss_trace_event(const char *fmt, uint32_t nb_args, const uint64_t *args)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uint32_t size = nb_args + 2U;
+    TRACE_RING *p_ring;
+    uint32_t head;
+    uint32_t used;
+    uint32_t arg;
+
+    if ((hart_id >= MSS_TRACE_NB_HARTS) || (nb_args > MSS_TRACE_MAX_ARGS))
+    {
+        return;
+    }
+
+    p_ring = &g_trace_ring[hart_id];
+
+    /* A handler on this hart may trace between the load and the CAS, in which
+     * case the CAS fails and the space is worked out again */
+    head = __atomic_load_n(&p_ring->head, __ATOMIC_RELAXED);
+    do
+    {
+        used = head - __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+        if (size > (MSS_TRACE_RING_WORDS - used))
+        {
+            (void)__atomic_fetch_add(&p_ring->stats.dropped, 1U, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&p_ring->head, &head, head + size, 0,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    p_ring->word[(head + 1U) & TRACE_RING_MASK] = CLINT->MTIME;
+    for (arg = 0U; arg < nb_args; arg++)
+    {
+        p_ring->word[(head + 2U + arg) & TRACE_RING_MASK] = args[arg];
+    }
+
+    __atomic_store_n(&p_ring->word[head & TRACE_RING_MASK],
+                     ((uint64_t)nb_args << TRACE_NB_ARGS_SHIFT) | ((uintptr_t)fmt & TRACE_FMT_MASK),
+                     __ATOMIC_RELEASE);
+
+    (void)__atomic_fetch_add(&p_ring->stats.events, 1U, __ATOMIC_RELAXED);
+    if ((used + size) > p_ring->stats.max_used)
+    {
+        p_ring->stats.max_used = used + size;
+    }
+}
+
+/**
+ * mss_trace_drain()
+ */
+uint32_t mss_trace_drain(mss_trace_write_t write, uint32_t max_events)
+{
+    uint8_t frame[MSS_TRACE_FRAME_MAX];
+    TRACE_RING *p_ring;
+    uint32_t sent = 0U;
+    uint32_t length;
+    uint32_t hart;
+    uint32_t tail;
+    uint32_t nb_args;
+    uint32_t word;
+    uint64_t header;
+    uint64_t dropped;
+
+    for (hart = 0U; hart < MSS_TRACE_NB_HARTS; hart++)
+    {
+        p_ring = &g_trace_ring[hart];
+        dropped = __atomic_load_n(&p_ring->stats.dropped, __ATOMIC_RELAXED);
+
+        if (dropped != p_ring->reported_drops)
+        {
+            p_ring->reported_drops = dropped;
+            length = trace_frame(frame, hart, CLINT->MTIME, 0U, 1U, &p_ring->reported_drops, 0U);
+            write(frame, length);
+        }
+    }
+
+    while ((0U == max_events) || (sent < max_events))
+    {
+        hart = trace_oldest();
+        if (MSS_TRACE_NB_HARTS == hart)
+        {
+            break;
+        }
+
+        p_ring = &g_trace_ring[hart];
+        tail = p_ring->tail;
+        header = p_ring->word[tail & TRACE_RING_MASK];
+        nb_args = (uint32_t)(header >> TRACE_NB_ARGS_SHIFT);
+
+        length = trace_frame(frame, hart, p_ring->word[(tail + 1U) & TRACE_RING_MASK],
+                             header & TRACE_FMT_MASK, nb_args, p_ring->word, tail + 2U);
+
+        for (word = 0U; word < (nb_args + 2U); word++)
+        {
+            p_ring->word[(tail + word) & TRACE_RING_MASK] = 0U;
+        }
+        __atomic_store_n(&p_ring->tail, tail + nb_args + 2U, __ATOMIC_RELEASE);
+
+        write(frame, length);
+        sent++;
+    }
+
+    return (sent);
+}
+
+/**
+ * mss_trace_reset()
+ */
+void mss_trace_reset(void)
+{
+    uint32_t hart;
+
+    for (hart = 0U; hart < MSS_TRACE_NB_HARTS; hart++)
+    {
+        (void)memset((void *)&g_trace_ring[hart], 0, sizeof(g_trace_ring[hart]));
+    }
+
+    mb();
+}
+
+/**
+ * mss_trace_stats()
+ */
+void mss_trace_stats(uint32_t hart_id, mss_trace_stats_t *stats)
+{
+    ASSERT(hart_id < MSS_TRACE_NB_HARTS);
+
+    *stats = g_trace_ring[hart_id].stats;
+}
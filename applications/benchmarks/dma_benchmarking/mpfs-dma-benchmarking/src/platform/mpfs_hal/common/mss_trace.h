@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * Copyright 2019-2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software
+ *
+ */
+
+/***************************************************************************
+ * @file mss_trace.h
+ * @author Microchip-FPGA Embedded Systems Solutions
+ * @brief Binary trace events with deferred formatting.
+ *
+ * Formatting a line with sprintf() and sending it with a polled UART write
+ * costs thousands of cycles, far too much for an interrupt handler or a timed
+ * loop. MSS_TRACE() instead stores the address of its format string, the mtime
+ * timestamp and the raw argument values in a ring belonging to the calling
+ * hart. Nothing is formatted on the target.
+ *
+ * mss_trace_drain() is called later, from wherever the time can be spent. It
+ * takes the events from all harts in timestamp order and passes them, framed,
+ * to a write function supplied by the application, e.g. a UART or a UDP
+ * socket. tools/trace_decode.py reads the frames back, fetches each format
+ * string from the ELF the target is running and prints the text.
+ *
+ * Arguments are stored as 64 bit words:
+ *  - integers as they are. Use the C length modifiers in the format, %lu for
+ *    uint64_t, %u for uint32_t, so the decoder knows the width and sign.
+ *  - doubles with MSS_TRACE_DOUBLE(), printed with %f, %e or %g.
+ *  - strings with MSS_TRACE_STR(), printed with %s. Only the pointer is kept,
+ *    so the string must be in the ELF and never change: literals and const
+ *    tables, not buffers.
+ *
+ * An event is 2 + number of arguments words. A hart's ring is reserved with
+ * one CAS, so MSS_TRACE() can be used from interrupt handlers, including ones
+ * which interrupt a MSS_TRACE() on the same hart. Events which do not fit are
+ * dropped and counted, the drain reports the count in the output.
+ */
+
+#ifndef MSS_TRACE_H
+#define MSS_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSS_TRACE_NB_HARTS      5U
+#ifndef MSS_TRACE_RING_WORDS
+#define MSS_TRACE_RING_WORDS    512U        /* 64 bit words per hart, a power of 2 */
+#endif
+#define MSS_TRACE_MAX_ARGS      14U
+
+/*------------------------------------------------------------------------------
+ * Frame sent for each event by mss_trace_drain(), little endian:
+ *   MSS_TRACE_SYNC, hart, nb_args, timestamp (8), format (8), arguments (8
+ *   each), checksum
+ * The checksum is the low byte of the sum of every byte after the sync byte.
+ * A format of 0 reports dropped events, its one argument is the count of
+ * events the hart has dropped so far.
+ */
+#define MSS_TRACE_SYNC          0xA5U
+#define MSS_TRACE_FRAME_MAX     (20U + (8U * MSS_TRACE_MAX_ARGS))
+
+typedef void (*mss_trace_write_t)(const uint8_t *data, uint32_t length);
+
+typedef struct mss_trace_stats_t_
+{
+    uint64_t events;                /* Events stored */
+    uint64_t dropped;               /* Events dropped, ring full */
+    uint32_t max_used;              /* Ring high water mark in words */
+} mss_trace_stats_t;
+
+/*==============================================================================
+ * Trace an event, e.g.
+ *   MSS_TRACE("ch%u done after %lu cycles", channel, cycles);
+ * The format must be a string literal.
+ */
+#define MSS_TRACE(fmt, ...)                                                     \
+    do                                                                          \
+    {                                                                           \
+        static const char mss_trace_fmt_[] = fmt;                               \
+        const uint64_t mss_trace_args_[] = { 0U, ##__VA_ARGS__ };               \
+        _Static_assert((sizeof(mss_trace_args_) / sizeof(uint64_t)) <=          \
+                       (MSS_TRACE_MAX_ARGS + 1U), "Too many trace arguments");  \
+        mss_trace_event(mss_trace_fmt_,                                         \
+                        (uint32_t)((sizeof(mss_trace_args_) / sizeof(uint64_t)) - 1U), \
+                        &mss_trace_args_[1]);                                   \
+    } while (0)
+
+#define MSS_TRACE_STR(s)        ((uint64_t)(uintptr_t)(s))
+#define MSS_TRACE_DOUBLE(d)     mss_trace_double(d)
+
+static inline uint64_t mss_trace_double(double value)
+{
+    union
+    {
+        double d;
+        uint64_t u;
+    } bits;
+
+    bits.d = value;
+
+    return (bits.u);
+}
+
+/*==============================================================================
+ * mss_trace_event() - store an event on the calling hart's ring. Called by
+ *   MSS_TRACE(), args holds nb_args words.
+ * mss_trace_drain() - send up to max_events events, oldest first across all
+ *   harts, through write. 0 for no limit. Returns the number sent. Call it
+ *   from one hart at a time, any hart may trace while it runs.
+ * mss_trace_reset() - discard every event and clear the counters. No hart may
+ *   trace while it runs.
+ * mss_trace_stats() - counters of hart_id.
+ */
+void mss_trace_event(const char *fmt, uint32_t nb_args, const uint64_t *args);
+uint32_t mss_trace_drain(mss_trace_write_t write, uint32_t max_events);
+void mss_trace_reset(void);
+void mss_trace_stats(uint32_t hart_id, mss_trace_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_TRACE_H */
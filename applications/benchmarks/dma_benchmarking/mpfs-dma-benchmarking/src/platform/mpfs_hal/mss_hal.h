@@ -61,8 +61,11 @@ typedef long            ssize_t;
 #include "common/mss_seg.h"
 #include "common/mss_sysreg.h"
 #include "common/mss_util.h"
+#include "common/mss_hpm.h"
 #include "common/mss_mtrap.h"
 #include "common/mss_l2_cache.h"
+#include "common/mss_l2_mem.h"
+#include "common/mss_trace.h"
 #include "common/mss_axiswitch.h"
 #include "common/mss_peripherals.h"
 #include "common/nwc/mss_cfm.h"
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+#
+# Copyright 2019-2023 Microchip FPGA Embedded Systems Solutions.
+#
+# SPDX-License-Identifier: MIT
+#
+# Decode the binary trace frames sent by mss_trace_drain() back into text,
+# using the ELF the target is running to look up the format strings.
+#
+# The input is a raw capture of the trace UART. Bytes which are not part of a
+# frame with a good checksum are skipped, so a capture may start part way into
+# a frame or have text mixed in. Each frame is:
+#   0xA5, hart, nb_args, timestamp (8), format address (8), arguments (8 each),
+#   checksum
+# all little endian. The format string is read from the ELF at the format
+# address. %s arguments are addresses of strings in the ELF too.
+#
+# The C length modifiers give the width of integer arguments, %u is 32 bits,
+# %lu 64 bits. Floating point conversions take the argument as a double.
+#
+# Example:
+#   stty -F /dev/ttyUSB2 115200 raw
+#   cat /dev/ttyUSB2 | trace_decode.py -e LIM-Debug/mpfs-dma-benchmarking.elf
+#   trace_decode.py -e app.elf -t trace.bin > results.csv
+#
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+NB_HARTS = 5
+MAX_ARGS = 14
+HEADER_SIZE = 19            # sync, hart, nb_args, timestamp, format
+
+CONVERSION = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\d+)?(?:\.(?P<prec>\d+))?"
+                        r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conv>[diouxXcsfFeEgGaAp%])")
+INT_BITS = {"hh": 8, "h": 16, None: 32, "l": 64, "ll": 64, "j": 64, "z": 64, "t": 64}
+
+
+class Elf:
+    """Read only access to the contents of the loaded sections of an ELF"""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf:
+            self.data = elf.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit("%s is not an ELF" % path)
+        if self.data[5] != 1:
+            sys.exit("%s is not little endian" % path)
+        if self.data[4] == 2:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3A)
+            section = "<IIQQQQ"
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+            section = "<IIIIII"
+        self.sections = []
+        for index in range(shnum):
+            _, kind, flags, addr, offset, size = struct.unpack_from(
+                section, self.data, shoff + index * shentsize)
+            # SHF_ALLOC, and not SHT_NOBITS (.bss)
+            if (flags & 0x2) and kind != 8 and size:
+                self.sections.append((addr, offset, size))
+
+    def string(self, address):
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("latin-1")
+        return None
+
+
+def format_event(elf, fmt, values):
+    """printf() fmt with the raw 64 bit argument values"""
+    values = list(values)
+    out = []
+    last = 0
+    for match in CONVERSION.finditer(fmt):
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        conv = match.group("conv")
+        if conv == "%":
+            out.append("%")
+            continue
+        value = values.pop(0) if values else 0
+        spec = "%" + (match.group("flags") or "") + (match.group("width") or "")
+        if match.group("prec") is not None:
+            spec += "." + match.group("prec")
+        if conv in "di":
+            bits = INT_BITS.get(match.group("length"), 64)
+            value &= (1 << bits) - 1
+            if value >> (bits - 1):
+                value -= 1 << bits
+            out.append((spec + "d") % value)
+        elif conv in "ouxX":
+            value &= (1 << INT_BITS.get(match.group("length"), 64)) - 1
+            out.append((spec + ("d" if conv == "u" else conv)) % value)
+        elif conv == "c":
+            out.append((spec + "c") % chr(value & 0xFF))
+        elif conv == "s":
+            text = elf.string(value)
+            out.append((spec + "s") % (text if text is not None else "<0x%x>" % value))
+        elif conv == "p":
+            out.append((spec + "s") % ("0x%x" % value))
+        else:
+            number, = struct.unpack("<d", struct.pack("<Q", value))
+            if conv in "aA":
+                out.append((spec + "s") % number.hex())
+            else:
+                out.append((spec + conv) % number)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def frames(stream):
+    """Yield (hart, timestamp, format address, arguments) for each good frame"""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read1(4096)
+        if not chunk:
+            return
+        buffer += chunk
+        while True:
+            start = buffer.find(bytes([SYNC]))
+            if start < 0:
+                del buffer[:]
+                break
+            del buffer[:start]
+            if len(buffer) < 3:
+                break
+            hart, nb_args = buffer[1], buffer[2]
+            if hart >= NB_HARTS or nb_args > MAX_ARGS:
+                del buffer[:1]
+                continue
+            length = HEADER_SIZE + 8 * nb_args + 1
+            if len(buffer) < length:
+                break
+            if (sum(buffer[1:length - 1]) & 0xFF) != buffer[length - 1]:
+                del buffer[:1]
+                continue
+            timestamp, fmt = struct.unpack_from("<QQ", buffer, 3)
+            values = struct.unpack_from("<%uQ" % nb_args, buffer, HEADER_SIZE)
+            del buffer[:length]
+            yield hart, timestamp, fmt, values
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode mss_trace frames against an ELF")
+    parser.add_argument("-e", "--elf", required=True, help="the traced ELF")
+    parser.add_argument("-t", "--text-only", action="store_true",
+                        help="print the text only, without timestamp and hart")
+    parser.add_argument("--mtime-hz", type=float, default=1000000.0,
+                        help="mtime frequency (default 1000000)")
+    parser.add_argument("--hart", type=int, action="append",
+                        help="only print events from this hart, may be repeated")
+    parser.add_argument("-o", "--output", help="write to a file, not stdout")
+    parser.add_argument("capture", nargs="*", default=["-"],
+                        help="trace UART capture(s), stdin if none")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    out = open(args.output, "w") if args.output else sys.stdout
+
+    for name in args.capture:
+        stream = sys.stdin.buffer if name == "-" else open(name, "rb")
+        for hart, timestamp, fmt, values in frames(stream):
+            if args.hart and hart not in args.hart:
+                continue
+            if fmt == 0:
+                text = "*** %u events dropped" % (values[0] if values else 0)
+            else:
+                fmt_string = elf.string(fmt)
+                if fmt_string is None:
+                    text = "*** unknown format 0x%x %s" % (fmt, " ".join("0x%x" % v for v in values))
+                else:
+                    text = format_event(elf, fmt_string, values).rstrip("\r\n")
+            if args.text_only:
+                out.write(text + "\n")
+            else:
+                out.write("[%14.6f] h%u %s\n" % (timestamp / args.mtime_hz, hart, text))
+            out.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -14,6 +14,7 @@
 
 #include "mpfs_hal/mss_hal.h"
 #include "inc/common.h"
+#include "inc/ring_bench.h"
 #include <iostream>
 
 volatile uint32_t count_sw_ints_h0 = 0U;
@@ -34,10 +35,9 @@ void e51(void)
 
     /* Raise software interrupt to wake hart 1 */
     raise_soft_interrupt(1U);
-    for (;;)
-    {
 
-    }
+    /* Act as a producer in the U54_1 hart ring benchmark */
+    ring_bench_worker();
     /* never return */
 }
 
@@ -46,4 +46,5 @@ void Software_h0_IRQHandler(void)
 {
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h0++;
+    ring_bench_soft_irq();
 }
@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file heap_bench.c
+ *
+ * @author Microchip FPGA Embedded Systems Solutions
+ *
+ * @brief malloc()/free() throughput benchmark running on all four U54s.
+ *
+ * Tests, all four U54s at once, coordinated from U54_1:
+ *  - newlib: each hart frees and reallocates random blocks of
+ *    HEAP_BENCH_MIN_SIZE to HEAP_BENCH_MAX_SIZE bytes, HEAP_BENCH_LIVE held at
+ *    a time, calling newlib's _malloc_r()/_free_r() directly. Every call is
+ *    serialised by __malloc_lock().
+ *  - malloc: the same through malloc()/free(), served from the per hart
+ *    arenas when MPFS_HAL_HEAP_ARENAS is defined.
+ *  - cross hart: each hart allocates blocks and passes them through a hart
+ *    ring to the next U54, which frees them, so every free is remote.
+ * Each hart times its own loop. The total is all pairs over the slowest hart.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <reent.h>
+#include "mpfs_hal/mss_hal.h"
+#include "inc/heap_bench.h"
+
+#define BENCH_COORDINATOR   1U
+#define BENCH_FIRST_HART    1U
+#define BENCH_LAST_HART     4U
+#define BENCH_HARTS         ((1U << 1) | (1U << 2) | (1U << 3) | (1U << 4))
+#define BENCH_WORKERS       (BENCH_HARTS & ~(1U << BENCH_COORDINATOR))
+
+typedef enum HEAP_PHASE_
+{
+    HEAP_IDLE           = 0,
+    HEAP_NEWLIB         = 1,
+    HEAP_MALLOC         = 2,
+    HEAP_CROSS          = 3,
+    HEAP_EXIT           = 4,
+}   HEAP_PHASE;
+
+typedef void * (*heap_alloc_t)(size_t size);
+typedef void (*heap_free_t)(void *block);
+
+/* Written by each hart for itself */
+typedef struct HEAP_RESULT_
+{
+    uint64_t cycles;
+    uint64_t failed;
+} __attribute__((aligned(64))) HEAP_RESULT;
+
+/* Control block, written by the coordinator */
+static volatile uint32_t g_heap_seq HART_RING_ALIGNED;
+static volatile uint32_t g_heap_phase;
+
+/* Worker status, updated with atomics */
+static volatile uint32_t g_heap_ready HART_RING_ALIGNED;
+static volatile uint32_t g_heap_done;
+
+static HEAP_RESULT g_heap_result[BENCH_LAST_HART + 1U];
+
+/* Ring n carries blocks allocated by the previous U54 to U54_n */
+static hart_ring_t g_cross_ring[BENCH_LAST_HART + 1U];
+static uint64_t g_cross_slots[BENCH_LAST_HART + 1U][HEAP_BENCH_RING_SIZE] HART_RING_ALIGNED;
+
+/*==============================================================================
+ *
+ */
+static void * newlib_alloc(size_t size)
+{
+    return (_malloc_r(_REENT, size));
+}
+
+static void newlib_free(void *block)
+{
+    _free_r(_REENT, block);
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+    /* xorshift32 */
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+
+    return (*seed);
+}
+
+/*==============================================================================
+ * Free and reallocate a random one of the hart's live blocks each time round
+ */
+static void run_local(uint64_t hart_id, heap_alloc_t heap_alloc, heap_free_t heap_free)
+{
+    void *live[HEAP_BENCH_LIVE] = { 0 };
+    uint32_t seed = 0x9E3779B9U * (uint32_t)hart_id;
+    uint64_t failed = 0U;
+    uint64_t start;
+    uint32_t random;
+    uint32_t slot;
+    uint32_t op;
+
+    start = readmcycle();
+
+    for (op = 0U; op < HEAP_BENCH_OPS; op++)
+    {
+        random = next_random(&seed);
+        slot = random % HEAP_BENCH_LIVE;
+
+        heap_free(live[slot]);
+        live[slot] = heap_alloc(HEAP_BENCH_MIN_SIZE +
+                                ((random >> 8) % (HEAP_BENCH_MAX_SIZE - HEAP_BENCH_MIN_SIZE + 1U)));
+        if ((void *)0 == live[slot])
+        {
+            failed++;
+        }
+    }
+
+    g_heap_result[hart_id].cycles = readmcycle() - start;
+    g_heap_result[hart_id].failed = failed;
+
+    for (slot = 0U; slot < HEAP_BENCH_LIVE; slot++)
+    {
+        heap_free(live[slot]);
+    }
+}
+
+/*==============================================================================
+ * Allocate blocks for the next U54 and free the ones the previous U54 sends
+ */
+static void run_cross(uint64_t hart_id)
+{
+    hart_ring_t *p_tx = &g_cross_ring[(BENCH_LAST_HART == hart_id) ?
+                                      BENCH_FIRST_HART : (hart_id + 1U)];
+    hart_ring_t *p_rx = &g_cross_ring[hart_id];
+    void *pending = (void *)0;
+    uint64_t failed = 0U;
+    uint64_t message;
+    uint64_t start;
+    uint32_t sent = 0U;
+    uint32_t freed = 0U;
+
+    start = readmcycle();
+
+    while ((sent < HEAP_BENCH_OPS) || (freed < HEAP_BENCH_OPS))
+    {
+        if (sent < HEAP_BENCH_OPS)
+        {
+            if ((void *)0 == pending)
+            {
+                pending = malloc(HEAP_BENCH_CROSS_SIZE);
+                if ((void *)0 == pending)
+                {
+                    failed++;
+                }
+            }
+
+            /* A failed allocation is sent as NULL so the counts still match */
+            if (hart_ring_send(p_tx, (uint64_t)(uintptr_t)pending))
+            {
+                pending = (void *)0;
+                sent++;
+            }
+        }
+
+        if (hart_ring_pop(p_rx, &message))
+        {
+            free((void *)(uintptr_t)message);
+            freed++;
+        }
+    }
+
+    g_heap_result[hart_id].cycles = readmcycle() - start;
+    g_heap_result[hart_id].failed = failed;
+}
+
+static void run_phase(HEAP_PHASE phase, uint64_t hart_id)
+{
+    switch (phase)
+    {
+        case HEAP_NEWLIB:
+            run_local(hart_id, newlib_alloc, newlib_free);
+            break;
+
+        case HEAP_MALLOC:
+            run_local(hart_id, malloc, free);
+            break;
+
+        case HEAP_CROSS:
+            run_cross(hart_id);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void start_phase(HEAP_PHASE phase)
+{
+    g_heap_done = 0U;
+    g_heap_phase = (uint32_t)phase;
+    mb();
+    g_heap_seq = g_heap_seq + 1U;
+    mb();
+}
+
+static void wait_workers_done(void)
+{
+    while (g_heap_done != BENCH_WORKERS)
+    {
+    }
+}
+
+/**
+ * heap_bench_worker()
+ */
+void heap_bench_worker(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uint32_t seen = g_heap_seq;
+    uint32_t phase = HEAP_IDLE;
+
+    __atomic_fetch_or(&g_heap_ready, 1U << hart_id, __ATOMIC_RELEASE);
+
+    while (HEAP_EXIT != phase)
+    {
+        while (g_heap_seq == seen)
+        {
+        }
+        seen = g_heap_seq;
+        phase = g_heap_phase;
+
+        run_phase((HEAP_PHASE)phase, hart_id);
+
+        __atomic_fetch_or(&g_heap_done, 1U << hart_id, __ATOMIC_RELEASE);
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void heap_test(HEAP_PHASE phase, const char *name)
+{
+    uint64_t slowest = 0ULL;
+    uint64_t failed = 0ULL;
+    uint64_t hart;
+
+    if (HEAP_CROSS == phase)
+    {
+        for (hart = BENCH_FIRST_HART; hart <= BENCH_LAST_HART; hart++)
+        {
+            hart_ring_init(&g_cross_ring[hart], g_cross_slots[hart], HEAP_BENCH_RING_SIZE,
+                           HART_RING_NO_DOORBELL);
+        }
+    }
+
+    start_phase(phase);
+    run_phase(phase, BENCH_COORDINATOR);
+    wait_workers_done();
+
+    printf("%-12s cycles/pair", name);
+    for (hart = BENCH_FIRST_HART; hart <= BENCH_LAST_HART; hart++)
+    {
+        printf(" h%lu %lu", hart, g_heap_result[hart].cycles / HEAP_BENCH_OPS);
+        if (g_heap_result[hart].cycles > slowest)
+        {
+            slowest = g_heap_result[hart].cycles;
+        }
+        failed += g_heap_result[hart].failed;
+    }
+
+    printf(", all harts %lu kpairs/s, %lu failed\n\r",
+           (uint64_t)(((uint64_t)HEAP_BENCH_OPS * 4ULL *
+                       (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000ULL)) / slowest),
+           failed);
+}
+
+/**
+ * heap_bench_run()
+ */
+void heap_bench_run(void)
+{
+#ifdef MPFS_HAL_HEAP_ARENAS
+    mss_heap_stats_t stats;
+    uint32_t hart;
+#endif
+
+    printf("\n\rHeap benchmark, waiting for workers\n\r");
+    while ((g_heap_ready & BENCH_WORKERS) != BENCH_WORKERS)
+    {
+    }
+
+    heap_test(HEAP_NEWLIB, "newlib");
+    heap_test(HEAP_MALLOC, "malloc");
+    heap_test(HEAP_CROSS, "cross hart");
+
+    start_phase(HEAP_EXIT);
+    wait_workers_done();
+
+#ifdef MPFS_HAL_HEAP_ARENAS
+    for (hart = BENCH_FIRST_HART; hart <= BENCH_LAST_HART; hart++)
+    {
+        mss_heap_stats(hart, &stats);
+        printf("Arena h%u: %lu allocs, %lu local frees, %lu remote frees, %lu reclaimed, "
+               "%lu misses, %u spans\n\r",
+               hart, stats.allocs, stats.frees, stats.remote_frees, stats.reclaimed,
+               stats.misses, stats.spans);
+    }
+#else
+    printf("MPFS_HAL_HEAP_ARENAS not defined, malloc is newlib's\n\r");
+#endif
+
+    g_heap_phase = HEAP_IDLE;
+    printf("Heap benchmark done\n\r");
+}
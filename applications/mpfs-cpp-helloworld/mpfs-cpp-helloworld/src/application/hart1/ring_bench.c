@@ -0,0 +1,414 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file ring_bench.c
+ *
+ * @author Microchip FPGA Embedded Systems Solutions
+ *
+ * @brief Cross-hart latency and throughput benchmark for the HAL hart rings.
+ *
+ * Tests, all coordinated from U54_1:
+ *  - Ping-pong latency with U54_2, both sides polling.
+ *  - Ping-pong latency with U54_2 woken by the ring doorbell.
+ *  - SPSC stream U54_2 -> U54_1, one commit per message.
+ *  - SPSC stream U54_2 -> U54_1, RING_BENCH_BATCH messages per commit.
+ *  - MPSC stream from all other harts -> U54_1.
+ * In the stream tests U54_1 drains its ring from the software interrupt
+ * handler and sleeps in WFI otherwise, so the interrupt count shows how well
+ * doorbells are batched.
+ */
+
+#include <stdio.h>
+#include "mpfs_hal/mss_hal.h"
+#include "inc/ring_bench.h"
+
+#define BENCH_COORDINATOR   1U
+
+#if (IMAGE_LOADED_BY_BOOTLOADER == 0)
+#define BENCH_WORKERS       ((1U << 0) | (1U << 2) | (1U << 3) | (1U << 4))
+#define BENCH_PRODUCERS     4U
+#else
+/* E51 is not running this image */
+#define BENCH_WORKERS       ((1U << 2) | (1U << 3) | (1U << 4))
+#define BENCH_PRODUCERS     3U
+#endif
+
+typedef enum BENCH_PHASE_
+{
+    BENCH_IDLE          = 0,
+    BENCH_PING_POLL     = 1,
+    BENCH_PING_IRQ      = 2,
+    BENCH_STREAM        = 3,
+    BENCH_STREAM_BATCH  = 4,
+    BENCH_MPSC          = 5,
+}   BENCH_PHASE;
+
+/* Control block, written by the coordinator */
+static volatile uint32_t g_bench_seq HART_RING_ALIGNED;
+static volatile uint32_t g_bench_phase;
+
+/* Worker status, updated with atomics */
+static volatile uint32_t g_bench_ready HART_RING_ALIGNED;
+static volatile uint32_t g_bench_done;
+
+/* Consumer side counters, U54_1 only */
+static volatile uint64_t g_rx_count HART_RING_ALIGNED;
+static volatile uint64_t g_rx_errors;
+static volatile uint64_t g_rx_irqs;
+static uint64_t g_rx_expected[5];
+
+/* Pings echoed by U54_2 */
+static volatile uint64_t g_echo_count HART_RING_ALIGNED;
+
+static hart_ring_t g_ping_ring;
+static hart_ring_t g_pong_ring;
+static hart_ring_t g_stream_ring;
+static hart_mpsc_ring_t g_mpsc_ring;
+
+static uint64_t g_ping_slots[RING_BENCH_SIZE] HART_RING_ALIGNED;
+static uint64_t g_pong_slots[RING_BENCH_SIZE] HART_RING_ALIGNED;
+static uint64_t g_stream_slots[RING_BENCH_SIZE] HART_RING_ALIGNED;
+static hart_mpsc_slot_t g_mpsc_slots[RING_BENCH_SIZE] HART_RING_ALIGNED;
+
+/*==============================================================================
+ * Sleep until *count reaches target. Interrupts are masked around the check so
+ * a doorbell arriving just before WFI still wakes us.
+ */
+static void wait_for_count(volatile uint64_t *count, uint64_t target)
+{
+    __disable_irq();
+    while (*count < target)
+    {
+        __asm("wfi");
+        __enable_irq();
+        __disable_irq();
+    }
+    __enable_irq();
+}
+
+/*==============================================================================
+ *
+ */
+static void start_phase(BENCH_PHASE phase)
+{
+    g_bench_done = 0U;
+    g_bench_phase = (uint32_t)phase;
+    mb();
+    g_bench_seq = g_bench_seq + 1U;
+    mb();
+}
+
+static void wait_workers_done(void)
+{
+    while (g_bench_done != BENCH_WORKERS)
+    {
+    }
+}
+
+/*==============================================================================
+ * Drain the U54_1 rings. Messages carry the producer hart id in the top byte
+ * and a per producer sequence number below it.
+ */
+static void drain_consumer(void)
+{
+    uint64_t message;
+    uint64_t hart;
+
+    if (BENCH_MPSC == g_bench_phase)
+    {
+        while (hart_mpsc_pop(&g_mpsc_ring, &message))
+        {
+            hart = message >> 56;
+            if ((hart > 4U) || ((message & 0x00FFFFFFFFFFFFFFULL) != g_rx_expected[hart]))
+            {
+                g_rx_errors++;
+            }
+            else
+            {
+                g_rx_expected[hart]++;
+            }
+            g_rx_count++;
+        }
+    }
+    else
+    {
+        while (hart_ring_pop(&g_stream_ring, &message))
+        {
+            if (message != g_rx_count)
+            {
+                g_rx_errors++;
+            }
+            g_rx_count++;
+        }
+    }
+}
+
+/*==============================================================================
+ * U54_2 side of the ping-pong test, echo every ping back
+ */
+static uint32_t echo_pings(void)
+{
+    uint64_t message;
+    uint32_t echoed = 0U;
+
+    while (hart_ring_pop(&g_ping_ring, &message))
+    {
+        while (!hart_ring_send(&g_pong_ring, message))
+        {
+        }
+        echoed++;
+    }
+
+    return (echoed);
+}
+
+/*==============================================================================
+ *
+ */
+static void produce_stream(uint32_t batch)
+{
+    uint64_t message = 0ULL;
+    uint32_t staged = 0U;
+
+    while (message < RING_BENCH_MESSAGES)
+    {
+        if (hart_ring_push(&g_stream_ring, message))
+        {
+            message++;
+            staged++;
+            if (staged == batch)
+            {
+                hart_ring_commit(&g_stream_ring);
+                staged = 0U;
+            }
+        }
+        else
+        {
+            /* Full, make sure the consumer can see what we have */
+            hart_ring_commit(&g_stream_ring);
+            staged = 0U;
+        }
+    }
+
+    hart_ring_commit(&g_stream_ring);
+}
+
+static void produce_mpsc(uint64_t hart_id)
+{
+    uint64_t sequence = 0ULL;
+    uint64_t tag = hart_id << 56;
+
+    while (sequence < (RING_BENCH_MESSAGES / BENCH_PRODUCERS))
+    {
+        if (hart_mpsc_send(&g_mpsc_ring, tag | sequence))
+        {
+            sequence++;
+        }
+    }
+}
+
+/**
+ * ring_bench_soft_irq()
+ */
+void ring_bench_soft_irq(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    if (BENCH_COORDINATOR == hart_id)
+    {
+        if ((BENCH_STREAM == g_bench_phase) || (BENCH_STREAM_BATCH == g_bench_phase) ||
+            (BENCH_MPSC == g_bench_phase))
+        {
+            g_rx_irqs++;
+            drain_consumer();
+        }
+    }
+    else if ((2U == hart_id) && (BENCH_PING_IRQ == g_bench_phase))
+    {
+        g_echo_count += echo_pings();
+    }
+    else
+    {
+        /* Nothing for this hart */
+    }
+}
+
+/**
+ * ring_bench_worker()
+ */
+void ring_bench_worker(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uint32_t seen = g_bench_seq;
+    uint32_t phase;
+
+    set_csr(mie, MIP_MSIP);
+    __enable_irq();
+
+    __atomic_fetch_or(&g_bench_ready, 1U << hart_id, __ATOMIC_RELEASE);
+
+    for (;;)
+    {
+        while (g_bench_seq == seen)
+        {
+        }
+        seen = g_bench_seq;
+        phase = g_bench_phase;
+
+        if (2U == hart_id)
+        {
+            switch (phase)
+            {
+                case BENCH_PING_POLL:
+                    while (g_echo_count < RING_BENCH_PINGS)
+                    {
+                        g_echo_count += echo_pings();
+                    }
+                    break;
+
+                case BENCH_PING_IRQ:
+                    wait_for_count(&g_echo_count, RING_BENCH_PINGS);
+                    break;
+
+                case BENCH_STREAM:
+                    produce_stream(1U);
+                    break;
+
+                case BENCH_STREAM_BATCH:
+                    produce_stream(RING_BENCH_BATCH);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (BENCH_MPSC == phase)
+        {
+            produce_mpsc(hart_id);
+        }
+
+        __atomic_fetch_or(&g_bench_done, 1U << hart_id, __ATOMIC_RELEASE);
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void ping_test(BENCH_PHASE phase, const char *name)
+{
+    uint64_t message;
+    uint64_t start;
+    uint64_t rtt;
+    uint64_t rtt_min = UINT64_MAX;
+    uint64_t rtt_max = 0ULL;
+    uint64_t rtt_sum = 0ULL;
+    uint32_t ping;
+
+    hart_ring_init(&g_ping_ring, g_ping_slots, RING_BENCH_SIZE,
+                   (BENCH_PING_IRQ == phase) ? 2U : HART_RING_NO_DOORBELL);
+    hart_ring_init(&g_pong_ring, g_pong_slots, RING_BENCH_SIZE, HART_RING_NO_DOORBELL);
+    g_echo_count = 0ULL;
+
+    start_phase(phase);
+
+    for (ping = 0U; ping < RING_BENCH_PINGS; ping++)
+    {
+        start = readmcycle();
+        (void)hart_ring_send(&g_ping_ring, ping);
+        while (!hart_ring_pop(&g_pong_ring, &message))
+        {
+        }
+        rtt = readmcycle() - start;
+
+        rtt_sum += rtt;
+        if (rtt < rtt_min)
+        {
+            rtt_min = rtt;
+        }
+        if (rtt > rtt_max)
+        {
+            rtt_max = rtt;
+        }
+    }
+
+    wait_workers_done();
+
+    printf("%-26s round trip cycles min %lu avg %lu max %lu, one way ~%lu ns\n\r",
+           name, rtt_min, rtt_sum / RING_BENCH_PINGS, rtt_max,
+           (uint64_t)(((rtt_sum / RING_BENCH_PINGS) * 1000ULL) /
+                      (2ULL * (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000000ULL))));
+}
+
+/*==============================================================================
+ *
+ */
+static void stream_test(BENCH_PHASE phase, const char *name)
+{
+    uint64_t start;
+    uint64_t cycles;
+    uint64_t doorbells;
+    uint32_t hart;
+
+    g_rx_count = 0ULL;
+    g_rx_errors = 0ULL;
+    g_rx_irqs = 0ULL;
+    for (hart = 0U; hart < 5U; hart++)
+    {
+        g_rx_expected[hart] = 0ULL;
+    }
+
+    if (BENCH_MPSC == phase)
+    {
+        hart_mpsc_init(&g_mpsc_ring, g_mpsc_slots, RING_BENCH_SIZE, BENCH_COORDINATOR);
+    }
+    else
+    {
+        hart_ring_init(&g_stream_ring, g_stream_slots, RING_BENCH_SIZE, BENCH_COORDINATOR);
+    }
+
+    start = readmcycle();
+    start_phase(phase);
+    wait_for_count(&g_rx_count,
+                   (BENCH_MPSC == phase) ?
+                   ((RING_BENCH_MESSAGES / BENCH_PRODUCERS) * BENCH_PRODUCERS) :
+                   RING_BENCH_MESSAGES);
+    cycles = readmcycle() - start;
+    wait_workers_done();
+
+    doorbells = (BENCH_MPSC == phase) ? g_mpsc_ring.doorbells : g_stream_ring.doorbells;
+
+    printf("%-26s %lu msgs, %lu cycles/msg, %lu kmsg/s, %lu doorbells, %lu irqs, %lu errors\n\r",
+           name,
+           g_rx_count,
+           cycles / g_rx_count,
+           (uint64_t)((g_rx_count * (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000ULL)) / cycles),
+           doorbells,
+           g_rx_irqs,
+           g_rx_errors);
+}
+
+/**
+ * ring_bench_run()
+ */
+void ring_bench_run(void)
+{
+    set_csr(mie, MIP_MSIP);
+    __enable_irq();
+
+    printf("\n\rHart ring benchmark, waiting for workers\n\r");
+    while ((g_bench_ready & BENCH_WORKERS) != BENCH_WORKERS)
+    {
+    }
+
+    ping_test(BENCH_PING_POLL, "Ping-pong polled");
+    ping_test(BENCH_PING_IRQ, "Ping-pong doorbell");
+    stream_test(BENCH_STREAM, "SPSC stream");
+    stream_test(BENCH_STREAM_BATCH, "SPSC stream batched");
+    stream_test(BENCH_MPSC, "MPSC stream");
+
+    g_bench_phase = BENCH_IDLE;
+    printf("Hart ring benchmark done\n\r");
+}
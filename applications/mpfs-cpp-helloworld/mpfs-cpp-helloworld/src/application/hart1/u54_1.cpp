@@ -10,12 +10,31 @@
  * @brief Application code running on U54_1.
  */
 
+#include <stdio.h>
 #include "mpfs_hal/mss_hal.h"
+#include "inc/ring_bench.h"
+#include "inc/heap_bench.h"
 #include <iostream>
 
 volatile uint32_t count_sw_ints_h1 = 0U;
 using namespace std;
 
+/* Show how much output each hart queued and how much the rings dropped */
+static void print_stdio_stats(void)
+{
+    mss_stdio_stats_t stats;
+    uint32_t hart;
+
+    for (hart = 0U; hart < MSS_STDIO_NB_HARTS; hart++)
+    {
+        mss_stdio_stats(hart, &stats);
+        printf("stdio h%u: %lu bytes, %lu dropped in %lu writes, ring high water %u\n\r",
+               hart, stats.written, stats.dropped, stats.dropped_writes, stats.max_used);
+    }
+
+    mss_stdio_flush();
+}
+
 /* Main function for the hart1(U54_1 processor).
  * Application code running on hart1 is placed here
  *
@@ -44,6 +63,12 @@ void u54_1(void)
     __enable_irq();
 #endif
 
+    /* From here on stdio output from all harts is queued and sent from the
+     * UART interrupt on this hart */
+    PLIC_init();
+    mss_stdio_async_start();
+    __enable_irq();
+
 #if (IMAGE_LOADED_BY_BOOTLOADER == 1)
     cout<<"\r\n\n\n **** PolarFire SoC MSS C++ example ****\n\n\r"<<endl;
 #endif
@@ -53,6 +78,14 @@ void u54_1(void)
     /* Raise software interrupt to wake hart 2 */
     raise_soft_interrupt(2U);
 
+    /* Measure malloc()/free() throughput with all four U54s allocating */
+    heap_bench_run();
+
+    /* Measure inter-hart ring latency and throughput against the other harts */
+    ring_bench_run();
+
+    print_stdio_stats();
+
     for (;;)
     {
 
@@ -65,4 +98,5 @@ void Software_h1_IRQHandler(void)
 {
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h1++;
+    ring_bench_soft_irq();
 }
@@ -11,6 +11,8 @@
  */
 
 #include "mpfs_hal/mss_hal.h"
+#include "inc/ring_bench.h"
+#include "inc/heap_bench.h"
 #include <iostream>
 
 volatile uint32_t count_sw_ints_h2 = 0U;
@@ -48,10 +50,8 @@ void u54_2(void)
     /* Raise software interrupt to wake hart 3 */
     raise_soft_interrupt(3U);
 
-    for (;;)
-    {
-
-    }
+    heap_bench_worker();
+    ring_bench_worker();
     /* never return */
 }
 
@@ -60,4 +60,5 @@ void Software_h2_IRQHandler(void)
 {
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h2++;
+    ring_bench_soft_irq();
 }
@@ -11,6 +11,8 @@
  */
 #include <stdio.h>
 #include "mpfs_hal/mss_hal.h"
+#include "inc/ring_bench.h"
+#include "inc/heap_bench.h"
 
 volatile uint32_t count_sw_ints_h3 = 0U;
 
@@ -45,10 +47,9 @@ void u54_3(void)
 
     /* Raise software interrupt to wake hart 4 */
     raise_soft_interrupt(4U);
-    for (;;)
-    {
 
-    }
+    heap_bench_worker();
+    ring_bench_worker();
     /* never return */
 }
 
@@ -57,4 +58,5 @@ void Software_h3_IRQHandler(void)
 {
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h3++;
+    ring_bench_soft_irq();
 }
@@ -11,6 +11,8 @@
  */
 #include <stdio.h>
 #include "mpfs_hal/mss_hal.h"
+#include "inc/ring_bench.h"
+#include "inc/heap_bench.h"
 
 volatile uint32_t count_sw_ints_h4 = 0U;
 
@@ -43,10 +45,8 @@ void u54_4(void)
 
     printf("Hello World from u54 core 4 - hart4.\n\r\n");
 
-    for (;;)
-    {
-
-    }
+    heap_bench_worker();
+    ring_bench_worker();
     /* never return */
 }
 
@@ -55,4 +55,5 @@ void Software_h4_IRQHandler(void)
 {
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h4++;
+    ring_bench_soft_irq();
 }
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file heap_bench.h
+ *
+ * @author Microchip FPGA Embedded Systems Solutions
+ *
+ * @brief malloc()/free() throughput benchmark running on all four U54s.
+ *
+ * U54_1 coordinates and prints the results. U54_2 to U54_4 call
+ * heap_bench_worker() once they are up, it returns when the benchmark is done.
+ */
+
+#ifndef HEAP_BENCH_H_
+#define HEAP_BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HEAP_BENCH_OPS          20000U  /* malloc()/free() pairs per hart per test */
+#define HEAP_BENCH_LIVE         16U     /* Blocks each hart keeps allocated */
+#define HEAP_BENCH_MIN_SIZE     8U
+#define HEAP_BENCH_MAX_SIZE     128U
+#define HEAP_BENCH_CROSS_SIZE   64U     /* Block size in the cross hart test */
+#define HEAP_BENCH_RING_SIZE    32U     /* Blocks in flight between two harts */
+
+/* Run the benchmark from U54_1, returns when all tests are complete */
+void heap_bench_run(void);
+
+/* Called by U54_2 to U54_4, returns when all tests are complete */
+void heap_bench_worker(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_BENCH_H_ */
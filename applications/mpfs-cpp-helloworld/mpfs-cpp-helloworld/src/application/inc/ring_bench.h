@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright 2023 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file ring_bench.h
+ *
+ * @author Microchip FPGA Embedded Systems Solutions
+ *
+ * @brief Cross-hart latency and throughput benchmark for the HAL hart rings.
+ *
+ * U54_1 coordinates and prints the results. The other harts call
+ * ring_bench_worker() once they are up and every hart's software interrupt
+ * handler calls ring_bench_soft_irq() so ring doorbells are serviced.
+ */
+
+#ifndef RING_BENCH_H_
+#define RING_BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_BENCH_SIZE        256U     /* Messages per ring */
+#define RING_BENCH_PINGS       10000U   /* Round trips per latency test */
+#define RING_BENCH_MESSAGES    200000U  /* Messages per throughput test */
+#define RING_BENCH_BATCH       16U      /* Messages per commit in batched test */
+
+/* Run the benchmark from U54_1, returns when all tests are complete */
+void ring_bench_run(void);
+
+/* Called by the other harts, never returns */
+void ring_bench_worker(void);
+
+/* Called from each hart's software interrupt handler */
+void ring_bench_soft_irq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BENCH_H_ */
@@ -113,6 +113,14 @@
 
 //#define MPFS_HAL_SHARED_MEM_ENABLED
 
+/*
+ * Per hart heap arenas. Small malloc()/free() requests are served from per
+ * hart size class slabs at the top of the heap without taking a lock, see
+ * mss_heap.h. Comment out to use newlib's allocator for everything, it is
+ * made safe to call from several harts by __malloc_lock() either way.
+ */
+#define MPFS_HAL_HEAP_ARENAS
+
 
 /* define the required tick rate in Milliseconds */
 /* if this program is running on one hart only, only that particular hart value
@@ -174,6 +182,13 @@
 #define MICROCHIP_STDIO_THRU_MMUARTX    &g_mss_uart0_lo
 #define MICROCHIP_STDIO_BAUD_RATE       MSS_UART_115200_BAUD
 
+/*
+ * Buffered stdio. Once mss_stdio_async_start() has been called, output is
+ * queued in a ring per hart and sent by the UART transmit interrupt instead of
+ * the writing hart waiting for the UART, see mss_stdio.h.
+ */
+#define MPFS_HAL_STDIO_ASYNC
+
 /*
  * DDR software options
  */
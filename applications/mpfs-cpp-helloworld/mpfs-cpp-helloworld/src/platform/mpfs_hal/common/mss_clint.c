@@ -130,6 +130,12 @@ void handle_m_soft_interrupt(void)
     volatile uint64_t hart_id = read_csr(mhartid);
     volatile uint32_t error_loop;
 
+    /*
+     * Clear software interrupt before calling the handler so a new interrupt
+     * raised while the handler runs (e.g. a hart ring doorbell) is not lost
+     */
+    clear_soft_interrupt();
+
     switch(hart_id)
     {
         case 0U:
@@ -154,8 +160,5 @@ void handle_m_soft_interrupt(void)
             }
             break;
     }
-
-    /*Clear software interrupt*/
-    clear_soft_interrupt();
 }
 
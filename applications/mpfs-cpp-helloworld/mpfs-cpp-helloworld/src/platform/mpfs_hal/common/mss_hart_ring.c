@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_hart_ring.c
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Lock-free inter-hart message rings with CLINT doorbells.
+ *
+ * Doorbell correctness relies on a store/fence/load handshake on each side:
+ * the producer publishes its tail, fences, then reads head; the consumer
+ * publishes its head, fences, then re-reads tail before deciding the ring is
+ * empty. At least one side sees the other's update so a message is never left
+ * in a ring the consumer believes empty without the doorbell being rung.
+ */
+
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+
+/*==============================================================================
+ *
+ */
+static inline void ring_doorbell(uint32_t consumer_hart)
+{
+    if (HART_RING_NO_DOORBELL != consumer_hart)
+    {
+        raise_soft_interrupt(consumer_hart);
+    }
+}
+
+/**
+ * hart_ring_init()
+ */
+void hart_ring_init(hart_ring_t *ring, uint64_t *slots, uint32_t size, uint32_t consumer_hart)
+{
+    ASSERT((size != 0U) && ((size & (size - 1U)) == 0U));
+
+    ring->tail = 0ULL;
+    ring->staged = 0ULL;
+    ring->head_cache = 0ULL;
+    ring->doorbells = 0ULL;
+    ring->head = 0ULL;
+    ring->tail_cache = 0ULL;
+    ring->slots = slots;
+    ring->mask = (uint64_t)size - 1ULL;
+    ring->consumer_hart = consumer_hart;
+    mb();
+}
+
+/**
+ * hart_ring_push()
+ */
+bool hart_ring_push(hart_ring_t *ring, uint64_t message)
+{
+    if ((ring->staged - ring->head_cache) > ring->mask)
+    {
+        ring->head_cache = atomic_read(&ring->head);
+        if ((ring->staged - ring->head_cache) > ring->mask)
+        {
+            return (false);
+        }
+    }
+
+    ring->slots[ring->staged & ring->mask] = message;
+    ring->staged++;
+
+    return (true);
+}
+
+/**
+ * hart_ring_commit()
+ */
+void hart_ring_commit(hart_ring_t *ring)
+{
+    uint64_t old_tail = ring->tail;
+
+    if (old_tail == ring->staged)
+    {
+        return;
+    }
+
+    /* Messages before index, then check whether the consumer had caught up */
+    __atomic_store_n(&ring->tail, ring->staged, __ATOMIC_RELEASE);
+    mb();
+    ring->head_cache = atomic_read(&ring->head);
+
+    if (ring->head_cache == old_tail)
+    {
+        ring->doorbells++;
+        ring_doorbell(ring->consumer_hart);
+    }
+}
+
+/**
+ * hart_ring_send()
+ */
+bool hart_ring_send(hart_ring_t *ring, uint64_t message)
+{
+    bool sent = hart_ring_push(ring, message);
+
+    if (sent)
+    {
+        hart_ring_commit(ring);
+    }
+
+    return (sent);
+}
+
+/**
+ * hart_ring_pop()
+ */
+bool hart_ring_pop(hart_ring_t *ring, uint64_t *message)
+{
+    uint64_t head = ring->head;
+
+    if (head == ring->tail_cache)
+    {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == ring->tail_cache)
+        {
+            /* Looks empty, order our head against the producer's tail */
+            mb();
+            ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+            if (head == ring->tail_cache)
+            {
+                return (false);
+            }
+        }
+    }
+
+    *message = ring->slots[head & ring->mask];
+    __atomic_store_n(&ring->head, head + 1ULL, __ATOMIC_RELEASE);
+
+    return (true);
+}
+
+/**
+ * hart_ring_count()
+ */
+uint32_t hart_ring_count(const hart_ring_t *ring)
+{
+    return ((uint32_t)(atomic_read(&ring->tail) - atomic_read(&ring->head)));
+}
+
+/**
+ * hart_mpsc_init()
+ */
+void hart_mpsc_init(hart_mpsc_ring_t *ring, hart_mpsc_slot_t *slots, uint32_t size,
+                    uint32_t consumer_hart)
+{
+    uint32_t index;
+
+    ASSERT((size != 0U) && ((size & (size - 1U)) == 0U));
+
+    for (index = 0U; index < size; index++)
+    {
+        slots[index].sequence = index;
+        slots[index].message = 0ULL;
+    }
+
+    ring->tail = 0ULL;
+    ring->doorbells = 0ULL;
+    ring->head = 0ULL;
+    ring->slots = slots;
+    ring->mask = (uint64_t)size - 1ULL;
+    ring->consumer_hart = consumer_hart;
+    mb();
+}
+
+/**
+ * hart_mpsc_send()
+ * A slot is free for position pos when its sequence equals pos. Once filled
+ * its sequence is set to pos + 1, which the consumer waits for.
+ */
+bool hart_mpsc_send(hart_mpsc_ring_t *ring, uint64_t message)
+{
+    hart_mpsc_slot_t *slot;
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint64_t sequence;
+
+    for (;;)
+    {
+        slot = &ring->slots[pos & ring->mask];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == pos)
+        {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1ULL, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+            /* pos reloaded by the failed CAS */
+        }
+        else if (sequence < pos)
+        {
+            return (false); /* Full */
+        }
+        else
+        {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->message = message;
+    __atomic_store_n(&slot->sequence, pos + 1ULL, __ATOMIC_RELEASE);
+    mb();
+
+    /* Consumer is waiting on this slot, i.e. the ring was empty up to here */
+    if (atomic_read(&ring->head) == pos)
+    {
+        __atomic_fetch_add(&ring->doorbells, 1ULL, __ATOMIC_RELAXED);
+        ring_doorbell(ring->consumer_hart);
+    }
+
+    return (true);
+}
+
+/**
+ * hart_mpsc_pop()
+ */
+bool hart_mpsc_pop(hart_mpsc_ring_t *ring, uint64_t *message)
+{
+    uint64_t head = ring->head;
+    hart_mpsc_slot_t *slot = &ring->slots[head & ring->mask];
+
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != (head + 1ULL))
+    {
+        mb();
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != (head + 1ULL))
+        {
+            return (false);
+        }
+    }
+
+    *message = slot->message;
+
+    /* Hand the slot back to the producers for the next lap */
+    __atomic_store_n(&slot->sequence, head + ring->mask + 1ULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->head, head + 1ULL, __ATOMIC_RELEASE);
+
+    return (true);
+}
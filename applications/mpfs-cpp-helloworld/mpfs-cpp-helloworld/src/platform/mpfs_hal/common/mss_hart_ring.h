@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_hart_ring.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Lock-free inter-hart message rings with CLINT doorbells.
+ *
+ * Two ring types are provided, both carrying 64 bit messages (a value or a
+ * pointer to a larger buffer):
+ *
+ *  - hart_ring_t, single producer / single consumer. The producer and consumer
+ *    indexes live in separate cache lines and each side keeps a private copy
+ *    of the other's index so the shared lines are only touched when the cached
+ *    copy says the ring is full or empty.
+ *  - hart_mpsc_ring_t, multiple producers / single consumer. Producers reserve
+ *    a slot with an atomic compare and swap on the tail. Each slot carries a
+ *    sequence number which tells the consumer when the slot has been filled.
+ *
+ * Doorbells: when a ring is created with a consumer hart, the producer raises
+ * a software interrupt (MSIP) on that hart only when the ring goes from empty
+ * to not empty. A consumer which drains the ring until empty from its software
+ * interrupt handler therefore takes one interrupt per burst rather than one per
+ * message. SPSC producers can batch further by staging several messages with
+ * hart_ring_push() and publishing them with one hart_ring_commit().
+ *
+ * The consumer must clear MSIP before it starts draining, which
+ * handle_m_soft_interrupt() does before calling the hart's handler.
+ *
+ * Ring sizes must be a power of 2. Message storage is provided by the caller
+ * and should be cache line aligned (HART_RING_ALIGNED).
+ */
+
+#ifndef MSS_HART_RING_H
+#define MSS_HART_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HART_RING_CACHE_LINE    64U
+#define HART_RING_ALIGNED       __attribute__((aligned(HART_RING_CACHE_LINE)))
+#define HART_RING_NO_DOORBELL   0xFFFFFFFFU /* Consumer polls, no MSIP */
+
+/*==============================================================================
+ * Single producer / single consumer ring
+ */
+typedef struct hart_ring_t_
+{
+    /* Written by the producer */
+    volatile uint64_t tail HART_RING_ALIGNED;   /* Published messages */
+    uint64_t staged;                            /* Pushed, not yet committed */
+    uint64_t head_cache;                        /* Producer copy of head */
+    uint64_t doorbells;                         /* MSIPs raised */
+
+    /* Written by the consumer */
+    volatile uint64_t head HART_RING_ALIGNED;   /* Consumed messages */
+    uint64_t tail_cache;                        /* Consumer copy of tail */
+
+    /* Read only after init */
+    uint64_t *slots HART_RING_ALIGNED;
+    uint64_t mask;
+    uint32_t consumer_hart;
+} hart_ring_t;
+
+/*==============================================================================
+ * Multiple producer / single consumer ring
+ */
+typedef struct hart_mpsc_slot_t_
+{
+    volatile uint64_t sequence;
+    uint64_t message;
+} hart_mpsc_slot_t;
+
+typedef struct hart_mpsc_ring_t_
+{
+    /* Shared by the producers */
+    volatile uint64_t tail HART_RING_ALIGNED;
+    volatile uint64_t doorbells;
+
+    /* Written by the consumer */
+    volatile uint64_t head HART_RING_ALIGNED;
+
+    /* Read only after init */
+    hart_mpsc_slot_t *slots HART_RING_ALIGNED;
+    uint64_t mask;
+    uint32_t consumer_hart;
+} hart_mpsc_ring_t;
+
+/*==============================================================================
+ * SPSC functions.
+ *
+ * hart_ring_init() - slots must hold size entries, size a power of 2.
+ *   consumer_hart is the hart to interrupt or HART_RING_NO_DOORBELL.
+ * hart_ring_push() - stage one message, returns false if the ring is full.
+ *   Staged messages are not visible to the consumer until committed.
+ * hart_ring_commit() - publish staged messages and ring the doorbell if the
+ *   consumer had emptied the ring.
+ * hart_ring_send() - push and commit one message.
+ * hart_ring_pop() - take one message, returns false if the ring is empty.
+ */
+void hart_ring_init(hart_ring_t *ring, uint64_t *slots, uint32_t size, uint32_t consumer_hart);
+bool hart_ring_push(hart_ring_t *ring, uint64_t message);
+void hart_ring_commit(hart_ring_t *ring);
+bool hart_ring_send(hart_ring_t *ring, uint64_t message);
+bool hart_ring_pop(hart_ring_t *ring, uint64_t *message);
+uint32_t hart_ring_count(const hart_ring_t *ring);
+
+/*==============================================================================
+ * MPSC functions. hart_mpsc_send() may be called from any hart, each message
+ * is published immediately. Only the consumer hart may call hart_mpsc_pop().
+ */
+void hart_mpsc_init(hart_mpsc_ring_t *ring, hart_mpsc_slot_t *slots, uint32_t size,
+                    uint32_t consumer_hart);
+bool hart_mpsc_send(hart_mpsc_ring_t *ring, uint64_t message);
+bool hart_mpsc_pop(hart_mpsc_ring_t *ring, uint64_t *message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_HART_RING_H */
@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_heap.c
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Per hart small block heap arenas.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+
+#ifdef MPFS_HAL_HEAP_ARENAS
+
+/* Set once by the hart which takes the span, read by any hart freeing into it */
+typedef struct HEAP_SPAN_
+{
+    uint8_t owner;
+    uint8_t size_class;
+} HEAP_SPAN;
+
+typedef struct HEAP_CLASS_
+{
+    void *free_list;
+    uintptr_t carve;                /* Next never used block of the current span */
+    uintptr_t carve_end;
+} HEAP_CLASS;
+
+/* Only touched by the owning hart */
+typedef struct HEAP_HART_
+{
+    HEAP_CLASS size_class[MSS_HEAP_NB_CLASSES];
+    mss_heap_stats_t stats;
+} __attribute__((aligned(64))) HEAP_HART;
+
+/* Blocks freed by other harts, pushed by them and taken whole by the owner */
+typedef struct HEAP_REMOTE_
+{
+    void * volatile head;
+} __attribute__((aligned(64))) HEAP_REMOTE;
+
+static HEAP_SPAN g_heap_span[MSS_HEAP_NB_SPANS];
+static HEAP_HART g_heap_hart[MSS_HEAP_NB_HARTS];
+static HEAP_REMOTE g_heap_remote[MSS_HEAP_NB_HARTS];
+static volatile uint32_t g_heap_next_span;
+
+/*==============================================================================
+ * The slab zone is the top of the linker script heap
+ */
+static inline uintptr_t heap_zone_base(void)
+{
+    extern char __heap_end;
+
+    return ((uintptr_t)&__heap_end - MSS_HEAP_SLAB_SIZE);
+}
+
+static inline uint32_t heap_size_class(size_t size)
+{
+    if (size <= MSS_HEAP_MIN_BLOCK)
+    {
+        return (0U);
+    }
+
+    /* log2 of size rounded up to a power of 2, less log2 of the smallest */
+    return ((uint32_t)(64 - __builtin_clzl((unsigned long)(size - 1U))) - 4U);
+}
+
+static inline const HEAP_SPAN * heap_span_of(const void *block)
+{
+    return (&g_heap_span[((uintptr_t)block - heap_zone_base()) / MSS_HEAP_SPAN_SIZE]);
+}
+
+/*==============================================================================
+ * Move the blocks other harts have freed onto the calling hart's free lists
+ */
+static void heap_reclaim(uint64_t hart_id)
+{
+    HEAP_HART *p_hart = &g_heap_hart[hart_id];
+    HEAP_CLASS *p_class;
+    void *block;
+    void *next;
+
+    if ((void *)0 == g_heap_remote[hart_id].head)
+    {
+        return;
+    }
+
+    block = __atomic_exchange_n(&g_heap_remote[hart_id].head, (void *)0, __ATOMIC_ACQUIRE);
+
+    while ((void *)0 != block)
+    {
+        next = *(void **)block;
+        p_class = &p_hart->size_class[heap_span_of(block)->size_class];
+        *(void **)block = p_class->free_list;
+        p_class->free_list = block;
+        p_hart->stats.reclaimed++;
+        block = next;
+    }
+}
+
+/*==============================================================================
+ * Give the calling hart a new span to carve blocks of size_class from
+ */
+static bool heap_take_span(uint64_t hart_id, uint32_t size_class)
+{
+    HEAP_CLASS *p_class = &g_heap_hart[hart_id].size_class[size_class];
+    uint32_t span;
+
+    if (g_heap_next_span >= MSS_HEAP_NB_SPANS)
+    {
+        return (false);
+    }
+
+    span = __atomic_fetch_add(&g_heap_next_span, 1U, __ATOMIC_RELAXED);
+    if (span >= MSS_HEAP_NB_SPANS)
+    {
+        return (false);
+    }
+
+    g_heap_span[span].owner = (uint8_t)hart_id;
+    g_heap_span[span].size_class = (uint8_t)size_class;
+
+    p_class->carve = heap_zone_base() + ((uintptr_t)span * MSS_HEAP_SPAN_SIZE);
+    p_class->carve_end = p_class->carve + MSS_HEAP_SPAN_SIZE;
+    g_heap_hart[hart_id].stats.spans++;
+
+    return (true);
+}
+
+/**
+ * mss_heap_alloc()
+ */
+void * mss_heap_alloc(size_t size)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    HEAP_HART *p_hart;
+    HEAP_CLASS *p_class;
+    uint32_t size_class;
+    void *block;
+
+    if ((size > MSS_HEAP_MAX_BLOCK) || (hart_id >= MSS_HEAP_NB_HARTS))
+    {
+        return ((void *)0);
+    }
+
+    size_class = heap_size_class(size);
+    p_hart = &g_heap_hart[hart_id];
+    p_class = &p_hart->size_class[size_class];
+
+    block = p_class->free_list;
+    if ((void *)0 == block)
+    {
+        heap_reclaim(hart_id);
+        block = p_class->free_list;
+    }
+
+    if ((void *)0 != block)
+    {
+        p_class->free_list = *(void **)block;
+    }
+    else
+    {
+        if ((p_class->carve == p_class->carve_end) && !heap_take_span(hart_id, size_class))
+        {
+            p_hart->stats.misses++;
+            return ((void *)0);
+        }
+
+        block = (void *)p_class->carve;
+        p_class->carve += (uintptr_t)MSS_HEAP_MIN_BLOCK << size_class;
+    }
+
+    p_hart->stats.allocs++;
+
+    return (block);
+}
+
+/**
+ * mss_heap_free()
+ */
+void mss_heap_free(void *block)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    const HEAP_SPAN *p_span;
+    HEAP_CLASS *p_class;
+    HEAP_REMOTE *p_remote;
+    void *head;
+
+    if ((void *)0 == block)
+    {
+        return;
+    }
+
+    ASSERT(mss_heap_owns(block));
+    p_span = heap_span_of(block);
+
+    if (p_span->owner == hart_id)
+    {
+        p_class = &g_heap_hart[hart_id].size_class[p_span->size_class];
+        *(void **)block = p_class->free_list;
+        p_class->free_list = block;
+        g_heap_hart[hart_id].stats.frees++;
+    }
+    else
+    {
+        /* The owner only ever takes the whole list, so there is no ABA */
+        p_remote = &g_heap_remote[p_span->owner];
+        head = __atomic_load_n(&p_remote->head, __ATOMIC_RELAXED);
+        do
+        {
+            *(void **)block = head;
+        } while (!__atomic_compare_exchange_n(&p_remote->head, &head, block, 0,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+        if (hart_id < MSS_HEAP_NB_HARTS)
+        {
+            g_heap_hart[hart_id].stats.remote_frees++;
+        }
+    }
+}
+
+/**
+ * mss_heap_owns()
+ */
+bool mss_heap_owns(const void *block)
+{
+    uintptr_t address = (uintptr_t)block;
+
+    return ((address >= heap_zone_base()) &&
+            (address < (heap_zone_base() + MSS_HEAP_SLAB_SIZE)));
+}
+
+/**
+ * mss_heap_block_size()
+ */
+size_t mss_heap_block_size(const void *block)
+{
+    ASSERT(mss_heap_owns(block));
+
+    return ((size_t)MSS_HEAP_MIN_BLOCK << heap_span_of(block)->size_class);
+}
+
+/**
+ * mss_heap_slab_base()
+ */
+uintptr_t mss_heap_slab_base(void)
+{
+    extern char __heap_start;
+
+    /* Increase HEAP_SIZE in the linker script if this fires */
+    ASSERT(heap_zone_base() > (uintptr_t)&__heap_start);
+
+    return (heap_zone_base());
+}
+
+/**
+ * mss_heap_stats()
+ */
+void mss_heap_stats(uint32_t hart_id, mss_heap_stats_t *stats)
+{
+    ASSERT(hart_id < MSS_HEAP_NB_HARTS);
+
+    *stats = g_heap_hart[hart_id].stats;
+}
+
+#endif /* MPFS_HAL_HEAP_ARENAS */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_heap.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Per hart small block heap arenas.
+ *
+ * Enabled by defining MPFS_HAL_HEAP_ARENAS in mss_sw_config.h. malloc(),
+ * free(), calloc() and realloc() in newlib_stubs.c then serve blocks of up to
+ * MSS_HEAP_MAX_BLOCK bytes from here and everything else from newlib's
+ * allocator, which is serialised between harts by __malloc_lock().
+ *
+ * The top MSS_HEAP_SLAB_SIZE bytes of the linker script heap are set aside as
+ * the slab zone and _sbrk() stops below it. The zone is split into spans of
+ * MSS_HEAP_SPAN_SIZE bytes. A hart takes a span when it runs out of blocks of
+ * one size class and carves it into blocks of that class. Spans stay with the
+ * hart and class that took them.
+ *
+ * Each hart allocates from its own free lists, so allocation takes no lock.
+ * A block freed by the hart that owns its span goes straight back on that
+ * hart's free list. A block freed by any other hart is pushed onto the owner's
+ * remote free list with one CAS, and the owner takes the whole list back the
+ * next time one of its free lists runs dry.
+ *
+ * Memory from mss_heap_alloc() must only be passed to mss_heap_free() or to
+ * the free()/realloc() in newlib_stubs.c. None of the functions may be called
+ * from an interrupt handler which could interrupt the same hart's allocation.
+ */
+
+#ifndef MSS_HEAP_H
+#define MSS_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSS_HEAP_NB_HARTS       5U
+#define MSS_HEAP_MIN_BLOCK      16U         /* malloc() alignment on RV64 */
+#define MSS_HEAP_NB_CLASSES     5U          /* 16, 32, 64, 128, 256 bytes */
+#define MSS_HEAP_MAX_BLOCK      (MSS_HEAP_MIN_BLOCK << (MSS_HEAP_NB_CLASSES - 1U))
+
+#ifndef MSS_HEAP_SLAB_SIZE
+#define MSS_HEAP_SLAB_SIZE      (24U * 1024U)   /* Taken from the top of the heap */
+#endif
+#ifndef MSS_HEAP_SPAN_SIZE
+#define MSS_HEAP_SPAN_SIZE      1024U
+#endif
+#define MSS_HEAP_NB_SPANS       (MSS_HEAP_SLAB_SIZE / MSS_HEAP_SPAN_SIZE)
+
+#if ((MSS_HEAP_SPAN_SIZE % MSS_HEAP_MAX_BLOCK) != 0U) || \
+    ((MSS_HEAP_SLAB_SIZE % MSS_HEAP_SPAN_SIZE) != 0U)
+#error "MSS_HEAP_SPAN_SIZE must be a multiple of MSS_HEAP_MAX_BLOCK and divide MSS_HEAP_SLAB_SIZE"
+#endif
+
+typedef struct mss_heap_stats_t_
+{
+    uint64_t allocs;                /* Blocks handed out by this hart */
+    uint64_t frees;                 /* Blocks this hart freed to its own lists */
+    uint64_t remote_frees;          /* Blocks this hart freed to other harts */
+    uint64_t reclaimed;             /* Blocks other harts freed back to this hart */
+    uint64_t misses;                /* Allocations the slab zone could not serve */
+    uint32_t spans;                 /* Spans owned by this hart */
+} mss_heap_stats_t;
+
+/*==============================================================================
+ * mss_heap_alloc() - a block of at least size bytes from the calling hart's
+ *   arena. NULL if size is above MSS_HEAP_MAX_BLOCK or no span is left.
+ * mss_heap_free() - return a block from mss_heap_alloc(). Any hart may free
+ *   any block.
+ * mss_heap_owns() - true if block is in the slab zone, i.e. came from
+ *   mss_heap_alloc().
+ * mss_heap_block_size() - usable size of a block from mss_heap_alloc().
+ * mss_heap_slab_base() - bottom of the slab zone, the top of the heap left to
+ *   _sbrk().
+ * mss_heap_stats() - allocation counters of hart_id. Read them while the hart
+ *   is not allocating.
+ */
+void * mss_heap_alloc(size_t size);
+void mss_heap_free(void *block);
+bool mss_heap_owns(const void *block);
+size_t mss_heap_block_size(const void *block);
+uintptr_t mss_heap_slab_base(void);
+void mss_heap_stats(uint32_t hart_id, mss_heap_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_HEAP_H */
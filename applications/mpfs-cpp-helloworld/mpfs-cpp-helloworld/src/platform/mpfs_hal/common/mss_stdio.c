@@ -0,0 +1,376 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_stdio.c
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief stdio output over the MMUART selected by MICROCHIP_STDIO_THRU_MMUARTX.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mpfs_hal/mss_hal.h"
+
+#ifdef MICROCHIP_STDIO_THRU_MMUARTX
+#include "drivers/mss/mss_mmuart/mss_uart_regs.h"
+#include "drivers/mss/mss_mmuart/mss_uart.h"
+
+#ifndef MICROCHIP_STDIO_BAUD_RATE
+#define MICROCHIP_STDIO_BAUD_RATE  MSS_UART_115200_BAUD
+#endif
+
+#define STDIO_TX_FIFO_SIZE      16U
+
+static mss_uart_instance_t * const gp_my_uart = MICROCHIP_STDIO_THRU_MMUARTX;
+
+/*------------------------------------------------------------------------------
+ * Global flag used to indicate if the UART driver needs to be initialized.
+ */
+static int g_stdio_uart_init_done = 0;
+
+#ifdef MPFS_HAL_STDIO_ASYNC
+typedef struct STDIO_RING_
+{
+    /* Written by the owning hart */
+    volatile uint32_t tail HART_RING_ALIGNED;
+    mss_stdio_stats_t stats;
+
+    /* Written by the draining hart */
+    volatile uint32_t head HART_RING_ALIGNED;
+
+    uint8_t buffer[MSS_STDIO_RING_SIZE] HART_RING_ALIGNED;
+} STDIO_RING;
+
+#if ((MSS_STDIO_RING_SIZE & (MSS_STDIO_RING_SIZE - 1U)) != 0U)
+#error "MSS_STDIO_RING_SIZE must be a power of 2"
+#endif
+
+static STDIO_RING g_stdio_ring[MSS_STDIO_NB_HARTS];
+static volatile uint32_t g_stdio_async;         /* Output goes to the rings */
+static volatile uint32_t g_stdio_tx_active;     /* THRE interrupt enabled */
+static uint64_t g_stdio_drain_hart;
+static uint32_t g_stdio_next_ring;              /* Draining hart only */
+#endif /* MPFS_HAL_STDIO_ASYNC */
+
+/*==============================================================================
+ * Clock the UART and set it up, the first time stdio is used
+ */
+static void stdio_uart_init(void)
+{
+    mss_peripherals peripheral = MSS_PERIPH_INVALID;
+
+    if ((&g_mss_uart0_lo == gp_my_uart) || (&g_mss_uart0_hi == gp_my_uart))
+    {
+        peripheral = MSS_PERIPH_MMUART0;
+    }
+    else if ((&g_mss_uart1_lo == gp_my_uart) || (&g_mss_uart1_hi == gp_my_uart))
+    {
+        peripheral = MSS_PERIPH_MMUART1;
+    }
+    else if ((&g_mss_uart2_lo == gp_my_uart) || (&g_mss_uart2_hi == gp_my_uart))
+    {
+        peripheral = MSS_PERIPH_MMUART2;
+    }
+    else if ((&g_mss_uart3_lo == gp_my_uart) || (&g_mss_uart3_hi == gp_my_uart))
+    {
+        peripheral = MSS_PERIPH_MMUART3;
+    }
+    else
+    {
+        ASSERT(0);
+    }
+
+    (void)mss_config_clk_rst(peripheral, (uint8_t) MPFS_HAL_FIRST_HART, PERIPHERAL_ON);
+
+    MSS_UART_init(gp_my_uart,
+                  MICROCHIP_STDIO_BAUD_RATE,
+                  MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY);
+
+    g_stdio_uart_init_done = 1;
+}
+
+#ifdef MPFS_HAL_STDIO_ASYNC
+static PLIC_IRQn_Type stdio_uart_plic_irq(void)
+{
+    PLIC_IRQn_Type plic_num;
+
+    if ((&g_mss_uart0_lo == gp_my_uart) || (&g_mss_uart0_hi == gp_my_uart))
+    {
+        plic_num = MMUART0_PLIC_77;
+    }
+    else if ((&g_mss_uart1_lo == gp_my_uart) || (&g_mss_uart1_hi == gp_my_uart))
+    {
+        plic_num = MMUART1_PLIC;
+    }
+    else if ((&g_mss_uart2_lo == gp_my_uart) || (&g_mss_uart2_hi == gp_my_uart))
+    {
+        plic_num = MMUART2_PLIC;
+    }
+    else
+    {
+        plic_num = MMUART3_PLIC;
+    }
+
+    return (plic_num);
+}
+
+static bool stdio_pending(void)
+{
+    uint32_t hart;
+
+    for (hart = 0U; hart < MSS_STDIO_NB_HARTS; hart++)
+    {
+        if (g_stdio_ring[hart].head != __atomic_load_n(&g_stdio_ring[hart].tail, __ATOMIC_ACQUIRE))
+        {
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*==============================================================================
+ * Start the transmit interrupt if it is not already running. Whoever changes
+ * the flag from 0 to 1 is the only one touching IER until the interrupt
+ * handler clears it again.
+ */
+static void stdio_kick(void)
+{
+    if (0U == __atomic_exchange_n(&g_stdio_tx_active, 1U, __ATOMIC_SEQ_CST))
+    {
+        gp_my_uart->hw_reg->IER |= ETBEI_MASK;
+    }
+}
+
+/*==============================================================================
+ * Copy up to a FIFO's worth of queued output to the UART. Stays with one ring
+ * until it is empty so the output of a hart is not broken up more than needed.
+ * Only called by the draining hart, with the FIFO empty.
+ */
+static uint32_t stdio_fill_fifo(void)
+{
+    STDIO_RING *p_ring;
+    uint32_t sent = 0U;
+    uint32_t empty = 0U;
+    uint32_t head;
+    uint32_t tail;
+
+    while ((sent < STDIO_TX_FIFO_SIZE) && (empty < MSS_STDIO_NB_HARTS))
+    {
+        p_ring = &g_stdio_ring[g_stdio_next_ring];
+        head = p_ring->head;
+        tail = __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+
+        if (head == tail)
+        {
+            g_stdio_next_ring = (g_stdio_next_ring + 1U) % MSS_STDIO_NB_HARTS;
+            empty++;
+        }
+        else
+        {
+            while ((head != tail) && (sent < STDIO_TX_FIFO_SIZE))
+            {
+                gp_my_uart->hw_reg->THR = p_ring->buffer[head & (MSS_STDIO_RING_SIZE - 1U)];
+                head++;
+                sent++;
+            }
+
+            __atomic_store_n(&p_ring->head, head, __ATOMIC_RELEASE);
+            empty = 0U;
+        }
+    }
+
+    return (sent);
+}
+
+/*==============================================================================
+ * THRE interrupt, called by the driver's interrupt handler
+ */
+static void stdio_tx_handler(mss_uart_instance_t *this_uart)
+{
+    if (0U != stdio_fill_fifo())
+    {
+        return;
+    }
+
+    /* Nothing left. Stop the interrupt, then look again in case a hart queued
+     * more after the rings were checked but still saw the flag set. */
+    MSS_UART_disable_irq(this_uart, MSS_UART_TBE_IRQ);
+    __atomic_store_n(&g_stdio_tx_active, 0U, __ATOMIC_SEQ_CST);
+
+    if (stdio_pending())
+    {
+        stdio_kick();
+    }
+}
+
+/*==============================================================================
+ * Queue len bytes on the calling hart's ring, or drop them if they don't fit
+ */
+static void stdio_queue(const char *ptr, uint32_t len)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    STDIO_RING *p_ring;
+    unsigned long irq_state;
+    uint32_t tail;
+    uint32_t used;
+    uint32_t index;
+    uint32_t first;
+
+    if (hart_id >= MSS_STDIO_NB_HARTS)
+    {
+        return;
+    }
+
+    p_ring = &g_stdio_ring[hart_id];
+
+    /* A handler on this hart may print too, keep the ring to one producer */
+    irq_state = clear_csr(mstatus, MSTATUS_MIE);
+
+    tail = p_ring->tail;
+    used = tail - __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+
+    if (len > (MSS_STDIO_RING_SIZE - used))
+    {
+        p_ring->stats.dropped += len;
+        p_ring->stats.dropped_writes++;
+    }
+    else
+    {
+        index = tail & (MSS_STDIO_RING_SIZE - 1U);
+        first = MSS_STDIO_RING_SIZE - index;
+        if (first > len)
+        {
+            first = len;
+        }
+
+        (void)memcpy(&p_ring->buffer[index], ptr, first);
+        (void)memcpy(&p_ring->buffer[0], &ptr[first], len - first);
+        __atomic_store_n(&p_ring->tail, tail + len, __ATOMIC_SEQ_CST);
+
+        p_ring->stats.written += len;
+        used += len;
+        if (used > p_ring->stats.max_used)
+        {
+            p_ring->stats.max_used = used;
+        }
+    }
+
+    if (0U != (irq_state & MSTATUS_MIE))
+    {
+        set_csr(mstatus, MSTATUS_MIE);
+    }
+
+    stdio_kick();
+}
+#endif /* MPFS_HAL_STDIO_ASYNC */
+
+/**
+ * mss_stdio_write()
+ */
+int mss_stdio_write(const char *ptr, int len)
+{
+    if (len <= 0)
+    {
+        return (0);
+    }
+
+    /*--------------------------------------------------------------------------
+     * Initialize the UART driver if it is the first time this function is
+     * called.
+     */
+    if (!g_stdio_uart_init_done)
+    {
+        stdio_uart_init();
+    }
+
+#ifdef MPFS_HAL_STDIO_ASYNC
+    if (0U != g_stdio_async)
+    {
+        stdio_queue(ptr, (uint32_t)len);
+        return (len);
+    }
+#endif
+
+    /*--------------------------------------------------------------------------
+     * Output text to the UART.
+     */
+    MSS_UART_polled_tx(gp_my_uart, (const uint8_t *)ptr, (uint32_t)len);
+
+    return (len);
+}
+
+/**
+ * mss_stdio_async_start()
+ */
+void mss_stdio_async_start(void)
+{
+#ifdef MPFS_HAL_STDIO_ASYNC
+    PLIC_IRQn_Type plic_num = stdio_uart_plic_irq();
+
+    if (!g_stdio_uart_init_done)
+    {
+        stdio_uart_init();
+    }
+
+    g_stdio_drain_hart = read_csr(mhartid);
+
+    /* Keep tx_idx and tx_buff_size different so the driver leaves the THRE
+     * interrupt enable to stdio_tx_handler() */
+    gp_my_uart->tx_idx = 0U;
+    gp_my_uart->tx_buff_size = 1U;
+    MSS_UART_set_tx_handler(gp_my_uart, stdio_tx_handler);
+
+    PLIC_SetPriority(plic_num, 1U);
+    PLIC_EnableIRQ(plic_num);
+
+    mb();
+    g_stdio_async = 1U;
+    mb();
+#endif
+}
+
+/**
+ * mss_stdio_flush()
+ */
+void mss_stdio_flush(void)
+{
+#ifdef MPFS_HAL_STDIO_ASYNC
+    bool drain_here;
+
+    if (0U == g_stdio_async)
+    {
+        return;     /* Polled output has already gone */
+    }
+
+    drain_here = (read_csr(mhartid) == g_stdio_drain_hart) &&
+                 (0U == (read_csr(mstatus) & MSTATUS_MIE));
+
+    while (stdio_pending() || (0U == (MSS_UART_get_tx_status(gp_my_uart) & MSS_UART_TEMT)))
+    {
+        if (drain_here && (0U != (MSS_UART_get_tx_status(gp_my_uart) & MSS_UART_THRE)))
+        {
+            (void)stdio_fill_fifo();
+        }
+    }
+#endif
+}
+
+/**
+ * mss_stdio_stats()
+ */
+void mss_stdio_stats(uint32_t hart_id, mss_stdio_stats_t *stats)
+{
+    ASSERT(hart_id < MSS_STDIO_NB_HARTS);
+
+#ifdef MPFS_HAL_STDIO_ASYNC
+    *stats = g_stdio_ring[hart_id].stats;
+#else
+    (void)memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+#endif /* MICROCHIP_STDIO_THRU_MMUARTX */
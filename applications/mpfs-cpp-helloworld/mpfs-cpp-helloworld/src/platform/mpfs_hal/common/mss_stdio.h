@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_stdio.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief stdio output over the MMUART selected by MICROCHIP_STDIO_THRU_MMUARTX.
+ *
+ * _write_r() in newlib_stubs.c passes everything printf(), puts(), cout etc.
+ * write to mss_stdio_write(). The UART is initialised on first use.
+ *
+ * By default output is polled, the calling hart waits until the last byte is
+ * in the UART FIFO, about 87us per character at 115200 baud.
+ *
+ * With MPFS_HAL_STDIO_ASYNC defined in mss_sw_config.h, once a hart has called
+ * mss_stdio_async_start() each hart's output is copied into its own ring of
+ * MSS_STDIO_RING_SIZE bytes and mss_stdio_write() returns straight away. The
+ * rings are emptied into the UART FIFO by the UART transmit interrupt, on the
+ * hart which called mss_stdio_async_start(). A ring has one producer, the
+ * owning hart, and one consumer, the interrupt, so neither side takes a lock.
+ *
+ * A write which does not fit in the space left in the ring is dropped whole
+ * and counted, output is never blocked on the UART. Each write is committed in
+ * one go, so output from different harts is only interleaved at write
+ * boundaries, normally whole lines as stdout is line buffered.
+ *
+ * Use mss_stdio_flush() before anything that must not lose buffered output,
+ * e.g. a reset or going to sleep with the interrupt disabled.
+ */
+
+#ifndef MSS_STDIO_H
+#define MSS_STDIO_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSS_STDIO_NB_HARTS      5U
+#ifndef MSS_STDIO_RING_SIZE
+#define MSS_STDIO_RING_SIZE     1024U       /* Bytes per hart, a power of 2 */
+#endif
+
+typedef struct mss_stdio_stats_t_
+{
+    uint64_t written;               /* Bytes queued */
+    uint64_t dropped;               /* Bytes dropped, ring full */
+    uint64_t dropped_writes;        /* Writes dropped */
+    uint32_t max_used;              /* Ring high water mark in bytes */
+} mss_stdio_stats_t;
+
+/*==============================================================================
+ * mss_stdio_write() - send len bytes. Polled until mss_stdio_async_start(),
+ *   queued after it. Returns len, dropped bytes are only counted.
+ *
+ * mss_stdio_async_start() - switch to buffered output. The UART interrupt is
+ *   enabled in the PLIC for the calling hart, which must have called
+ *   PLIC_init() and must keep interrupts enabled for the output to drain.
+ * mss_stdio_flush() - wait until everything queued so far, from all harts, has
+ *   left the UART. If called on the draining hart with interrupts disabled it
+ *   empties the rings itself.
+ * mss_stdio_stats() - output counters of hart_id.
+ */
+int mss_stdio_write(const char *ptr, int len);
+
+void mss_stdio_async_start(void);
+void mss_stdio_flush(void);
+void mss_stdio_stats(uint32_t hart_id, mss_stdio_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_STDIO_H */
@@ -56,8 +56,11 @@ typedef long            ssize_t;
 #include "common/mss_seg.h"
 #include "common/mss_sysreg.h"
 #include "common/mss_util.h"
+#include "common/mss_hart_ring.h"
 #include "common/mss_mtrap.h"
 #include "common/mss_l2_cache.h"
+#include "common/mss_heap.h"
+#include "common/mss_stdio.h"
 #include "common/mss_axiswitch.h"
 #include "common/mss_peripherals.h"
 #include "common/nwc/mss_cfm.h"
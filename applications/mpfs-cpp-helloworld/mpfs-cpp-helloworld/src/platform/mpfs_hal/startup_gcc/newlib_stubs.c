@@ -14,6 +14,9 @@
 #include <sys/types.h>
 #include <errno.h>
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <reent.h>
 #include "../mss_hal.h"
 
 /*==============================================================================
@@ -40,22 +43,11 @@
  *
  * Also note defaults to 115200 baud if no baud rate is specified using the
  * MICROCHIP_STDIO_BAUD_RATE #define.
+ *
+ * The UART itself is driven by common/mss_stdio.c. Output is polled unless
+ * MPFS_HAL_STDIO_ASYNC is defined and mss_stdio_async_start() has been called,
+ * see mss_stdio.h.
  */
-#ifdef MICROCHIP_STDIO_THRU_MMUARTX
-#include "drivers/mss/mss_mmuart/mss_uart.h"
-
-#ifndef MICROCHIP_STDIO_BAUD_RATE
-#define MICROCHIP_STDIO_BAUD_RATE  MSS_UART_115200_BAUD
-#endif
-
-static mss_uart_instance_t * const gp_my_uart = MICROCHIP_STDIO_THRU_MMUARTX;
-
-/*------------------------------------------------------------------------------
- * Global flag used to indicate if the UART driver needs to be initialized.
- */
-static int g_stdio_uart_init_done = 0;
-
-#endif /* MICROCHIP_STDIO_THRU_MMUARTX */
 
 /*==============================================================================
  * Environment variables.
@@ -216,50 +208,7 @@ int _write_r( void * reent, int file, char * ptr, int len )
     (void)ptr;
     (void)len;
 #ifdef MICROCHIP_STDIO_THRU_MMUARTX
-    /*--------------------------------------------------------------------------
-     * Initialize the UART driver if it is the first time this function is
-     * called.
-     */
-    if(!g_stdio_uart_init_done)
-    {
-        mss_peripherals peripheral = MSS_PERIPH_INVALID;
-
-        if ((&g_mss_uart0_lo == gp_my_uart) || (&g_mss_uart0_hi == gp_my_uart))
-        {
-            peripheral = MSS_PERIPH_MMUART0;
-        }
-        else if ((&g_mss_uart1_lo == gp_my_uart) || (&g_mss_uart1_hi == gp_my_uart))
-        {
-            peripheral = MSS_PERIPH_MMUART1;
-        }
-        else if ((&g_mss_uart2_lo == gp_my_uart) || (&g_mss_uart2_hi == gp_my_uart))
-        {
-            peripheral = MSS_PERIPH_MMUART2;
-        }
-        else if ((&g_mss_uart3_lo == gp_my_uart) || (&g_mss_uart3_hi == gp_my_uart))
-        {
-            peripheral = MSS_PERIPH_MMUART3;
-        }
-        else
-        {
-            ASSERT(0);
-        }
-
-        (void)mss_config_clk_rst(peripheral, (uint8_t) MPFS_HAL_FIRST_HART, PERIPHERAL_ON);
-
-        MSS_UART_init(gp_my_uart,
-                      MICROCHIP_STDIO_BAUD_RATE,
-                      MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY);
-
-        g_stdio_uart_init_done = 1;
-    }
-
-    /*--------------------------------------------------------------------------
-     * Output text to the UART.
-     */
-    MSS_UART_polled_tx(gp_my_uart, (uint8_t *)ptr, len);
-
-    return len;
+    return (mss_stdio_write(ptr, len));
 #else   /* MICROCHIP_STDIO_THRU_MMUARTX */
     return (0);
 #endif  /* MICROCHIP_STDIO_THRU_MMUARTX */
@@ -270,6 +219,9 @@ int _write_r( void * reent, int file, char * ptr, int len )
  * it is useful to have a working implementation. The following suffices for a
  * standalone system; it exploits the symbol _end automatically defined by the
  * GNU linker.
+ * The break is moved with a CAS so harts calling it at the same time each get
+ * their own memory. With MPFS_HAL_HEAP_ARENAS the top of the heap is kept for
+ * the slab zone, see mss_heap.h.
  */
 caddr_t _sbrk(int incr);
 caddr_t _sbrk(int incr)
@@ -278,7 +230,10 @@ caddr_t _sbrk(int incr)
     extern char __heap_start;
     extern char __heap_end;
     static char *heap_end;
+    char *expected;
     char *prev_heap_end;
+    char *new_heap_end;
+    char *heap_limit;
 
     (void)__heap_start;
     (void)__heap_end;
@@ -293,66 +248,201 @@ caddr_t _sbrk(int incr)
      */
     ASSERT(&__heap_end > &__heap_start);
 
-    if (heap_end == NULL)
-    {
-      heap_end = &_end;
-    }
+#ifdef MPFS_HAL_HEAP_ARENAS
+    heap_limit = (char *)mss_heap_slab_base();
+#else
+    heap_limit = &__heap_end;
+#endif
 
-    prev_heap_end = heap_end;
+    expected = __atomic_load_n(&heap_end, __ATOMIC_ACQUIRE);
 
-#ifdef DEBUG_HEAP_SIZE          /* add this define if you want to debug crash due to overflow of  heap */
-    /* fixme- this test needs to be reworked to take account of multiple harts and TLS */
-    stack_ptr = read_csr(sp);
-    /* stack_ptr has just been placed on the stack, so its address in currently pointing to the stack end */
-    if(heap_end < stack_ptr)
+    do
     {
-        /*
-         * Heap is at an address below the stack, growing up toward the stack.
-         * The stack is above the heap, growing down towards the heap.
-         * Make sure the stack and heap do not run into each other.
-         */
-        if (heap_end + incr > stack_ptr)
+        prev_heap_end = (expected == NULL) ? &_end : expected;
+        new_heap_end = prev_heap_end + incr;
+
+#ifdef DEBUG_HEAP_SIZE          /* add this define if you want to debug crash due to overflow of  heap */
+        /* fixme- this test needs to be reworked to take account of multiple harts and TLS */
+        stack_ptr = read_csr(sp);
+        /* stack_ptr has just been placed on the stack, so its address in currently pointing to the stack end */
+        if(prev_heap_end < stack_ptr)
         {
-          _write_r ((void *)0, 1, "Heap and stack collision\n", 25);
-          _exit (1);
+            /*
+             * Heap is at an address below the stack, growing up toward the stack.
+             * The stack is above the heap, growing down towards the heap.
+             * Make sure the stack and heap do not run into each other.
+             */
+            if (new_heap_end > stack_ptr)
+            {
+              _write_r ((void *)0, 1, "Heap and stack collision\n", 25);
+              _exit (1);
+            }
         }
-    }
-    else
-    {
-        /*
-         * If the heap and stack are not growing towards each other then use the
-         * _eheap linker script symbol to figure out if there is room left on
-         * the heap.
-         * Please note that this use case makes sense when the stack is located
-         * in internal eSRAM in the 0x20000000 address range and the heap is
-         * located in the external memory in the 0xA0000000 memory range.
-         * Please note that external memory should not be accessed using the
-         * 0x00000000 memory range to read/write variables/data because of the
-         * SmartFusion2 cache design.
-         */
-        extern char _heap_end;     /* Defined by the linker */
-        char *top_of_heap;
-
-        top_of_heap = &_heap_end;
-        if(heap_end + incr  > top_of_heap)
+        else
         {
-          _write_r ((void *)0, 1, "Out of heap memory\n", 25);
-          _exit (1);
+            /*
+             * If the heap and stack are not growing towards each other then use
+             * the heap limit to figure out if there is room left on the heap.
+             */
+            if(new_heap_end > heap_limit)
+            {
+              _write_r ((void *)0, 1, "Out of heap memory\n", 25);
+              _exit (1);
+            }
         }
-    }
 #endif
-    heap_end += incr;
 
-    /*
-     * Did we run out of heap?
-     * You need to increase the heap size in the linker script if the following
-     * assertion fires.
-     * */
-    ASSERT(heap_end <= &__heap_end);
+        if (new_heap_end > heap_limit)
+        {
+            /*
+             * Did we run out of heap?
+             * You need to increase the heap size in the linker script if the
+             * following assertion fires.
+             */
+            ASSERT(0);
+            errno = ENOMEM;
+            return ((caddr_t)-1);
+        }
+    } while (!__atomic_compare_exchange_n(&heap_end, &expected, new_heap_end, 0,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
 
     return ((caddr_t) prev_heap_end);
 }
 
+/*==============================================================================
+ * Lock around newlib's allocator, which otherwise assumes a single thread.
+ * newlib takes it recursively, e.g. realloc() calling malloc(), so it is held
+ * by a hart rather than a call. The owner is stored as hart id + 1, 0 is free.
+ * Must not be taken from an interrupt handler which could interrupt an
+ * allocation on the same hart.
+ */
+static volatile uint64_t g_malloc_lock_owner;
+static uint32_t g_malloc_lock_depth;
+
+void __malloc_lock(struct _reent *reent);
+void __malloc_lock(struct _reent *reent)
+{
+    uint64_t owner = read_csr(mhartid) + 1U;
+    uint64_t expected;
+
+    (void)reent;
+
+    if (__atomic_load_n(&g_malloc_lock_owner, __ATOMIC_RELAXED) != owner)
+    {
+        do
+        {
+            expected = 0U;
+        } while (!__atomic_compare_exchange_n(&g_malloc_lock_owner, &expected, owner, 0,
+                                              __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+    }
+
+    g_malloc_lock_depth++;
+}
+
+void __malloc_unlock(struct _reent *reent);
+void __malloc_unlock(struct _reent *reent)
+{
+    (void)reent;
+
+    ASSERT(g_malloc_lock_owner == (read_csr(mhartid) + 1U));
+
+    g_malloc_lock_depth--;
+    if (0U == g_malloc_lock_depth)
+    {
+        __atomic_store_n(&g_malloc_lock_owner, 0U, __ATOMIC_RELEASE);
+    }
+}
+
+#ifdef MPFS_HAL_HEAP_ARENAS
+/*==============================================================================
+ * malloc() and friends. Blocks of up to MSS_HEAP_MAX_BLOCK bytes come from the
+ * calling hart's arena without taking a lock, larger ones, and small ones once
+ * the slab zone is used up, from newlib under __malloc_lock(). free() tells
+ * the two apart by address. These replace newlib's own malloc(), free(),
+ * calloc() and realloc(); the _r versions newlib uses internally are left
+ * alone and only ever see newlib's blocks.
+ */
+void * malloc(size_t size)
+{
+    void *block = NULL;
+
+    if (size <= MSS_HEAP_MAX_BLOCK)
+    {
+        block = mss_heap_alloc(size);
+    }
+
+    if (NULL == block)
+    {
+        block = _malloc_r(_REENT, size);
+    }
+
+    return (block);
+}
+
+void free(void *block)
+{
+    if (mss_heap_owns(block))
+    {
+        mss_heap_free(block);
+    }
+    else
+    {
+        _free_r(_REENT, block);
+    }
+}
+
+void * calloc(size_t count, size_t size)
+{
+    size_t bytes;
+    void *block;
+
+    if (__builtin_mul_overflow(count, size, &bytes))
+    {
+        errno = ENOMEM;
+        return (NULL);
+    }
+
+    block = malloc(bytes);
+    if (NULL != block)
+    {
+        (void)memset(block, 0, bytes);
+    }
+
+    return (block);
+}
+
+void * realloc(void *block, size_t size)
+{
+    void *new_block;
+    size_t block_size;
+
+    if (NULL == block)
+    {
+        return (malloc(size));
+    }
+
+    if (!mss_heap_owns(block))
+    {
+        return (_realloc_r(_REENT, block, size));
+    }
+
+    block_size = mss_heap_block_size(block);
+    if (size <= block_size)
+    {
+        return (block);
+    }
+
+    new_block = malloc(size);
+    if (NULL != new_block)
+    {
+        (void)memcpy(new_block, block, block_size);
+        mss_heap_free(block);
+    }
+
+    return (new_block);
+}
+#endif /* MPFS_HAL_HEAP_ARENAS */
+
 /*==============================================================================
  * Status of a file (by name).
  */
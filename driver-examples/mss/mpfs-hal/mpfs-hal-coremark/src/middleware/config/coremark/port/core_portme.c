@@ -23,6 +23,14 @@ Original Author: Shay Gal-on
 
 mss_uart_instance_t *gp_my_uart;
 
+/* HPM events counted over the timed portion of the benchmark, see mss_hpm.h.
+ * Only two events can be counted per run, rebuild with a different view to
+ * see the others. */
+#ifndef COREMARK_HPM_VIEW
+#define COREMARK_HPM_VIEW   MSS_HPM_VIEW_CACHE
+#endif
+#define COREMARK_HPM_REGION 0U
+
 #if VALIDATION_RUN
 	volatile ee_s32 seed1_volatile=0x3415;
 	volatile ee_s32 seed2_volatile=0x3415;
@@ -73,6 +81,8 @@ static CORETIMETYPE start_time_val, stop_time_val;
 	or zeroing some system parameters - e.g. setting the cpu clocks cycles to 0.
 */
 void start_time(void) {
+	mss_hpm_select_view(COREMARK_HPM_VIEW);
+	mss_hpm_region_begin(COREMARK_HPM_REGION, "coremark");
 	GETMYTIME(&start_time_val );      
 }
 /* Function : stop_time
@@ -83,6 +93,7 @@ void start_time(void) {
 */
 void stop_time(void) {
 	GETMYTIME(&stop_time_val );      
+	mss_hpm_region_end(COREMARK_HPM_REGION);
 }
 /* Function : get_time
 	Return an abstract "ticks" number that signifies time on the system.
@@ -182,8 +193,15 @@ void portable_init(core_portable *p, int *argc, char *argv[])
 /* Function : portable_fini
 	Target specific final code 
 */
+static void coremark_hpm_print(const char *line)
+{
+	ee_printf("%s", line);
+}
+
 void portable_fini(core_portable *p)
 {
+	ee_printf("\nHardware performance counters, timed portion:\n");
+	mss_hpm_dump((uint32_t)read_csr(mhartid), coremark_hpm_print);
 	p->portable_id=0;
 }
 
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_hpm.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Per hart hardware performance monitor (HPM) profiling.
+ *
+ * Each E51/U54 hart has two programmable event counters, mhpmcounter3 and
+ * mhpmcounter4, alongside mcycle and minstret. mhpmevent3/4 select what they
+ * count: bits 7:0 give the event class and bits 63:8 a mask of events in that
+ * class. When several mask bits are set the counter counts the sum.
+ *
+ * Since only two events can be counted at a time, the usual approach is to run
+ * the code under test once per view (cache, stalls, branches ..) and compare.
+ * Selecting events resets the calling hart's regions.
+ *
+ * Regions are numbered 0 to MSS_HPM_MAX_REGIONS - 1 by the application and are
+ * kept per hart, so each hart can profile its own code at the same time. A
+ * region may be entered many times, counts are accumulated. Different regions
+ * may be nested, a region may not be nested inside itself.
+ */
+
+#ifndef MSS_HPM_H
+#define MSS_HPM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MSS_HPM_NB_COUNTERS     2U      /* mhpmcounter3 and mhpmcounter4 */
+#define MSS_HPM_COUNTER_MASK    0xFFFFFFFFFFULL /* HPM counters are 40 bits */
+#define MSS_HPM_MAX_REGIONS     8U
+#define MSS_HPM_NB_HARTS        5U
+
+/*==============================================================================
+ * Event selectors
+ */
+#define MSS_HPM_EVENT(class, mask)      ((((uint64_t)(mask)) << 8U) | (uint64_t)(class))
+
+/* Class 0, instruction commit events */
+#define MSS_HPM_EXCEPTION_TAKEN         MSS_HPM_EVENT(0U, 1UL << 0U)
+#define MSS_HPM_INT_LOAD_RETIRED        MSS_HPM_EVENT(0U, 1UL << 1U)
+#define MSS_HPM_INT_STORE_RETIRED       MSS_HPM_EVENT(0U, 1UL << 2U)
+#define MSS_HPM_ATOMIC_RETIRED          MSS_HPM_EVENT(0U, 1UL << 3U)
+#define MSS_HPM_SYSTEM_RETIRED          MSS_HPM_EVENT(0U, 1UL << 4U)
+#define MSS_HPM_INT_ARITH_RETIRED       MSS_HPM_EVENT(0U, 1UL << 5U)
+#define MSS_HPM_BRANCH_RETIRED          MSS_HPM_EVENT(0U, 1UL << 6U)
+#define MSS_HPM_JAL_RETIRED             MSS_HPM_EVENT(0U, 1UL << 7U)
+#define MSS_HPM_JALR_RETIRED            MSS_HPM_EVENT(0U, 1UL << 8U)
+#define MSS_HPM_INT_MUL_RETIRED         MSS_HPM_EVENT(0U, 1UL << 9U)
+#define MSS_HPM_INT_DIV_RETIRED         MSS_HPM_EVENT(0U, 1UL << 10U)
+#define MSS_HPM_FP_LOAD_RETIRED         MSS_HPM_EVENT(0U, 1UL << 11U)
+#define MSS_HPM_FP_STORE_RETIRED        MSS_HPM_EVENT(0U, 1UL << 12U)
+#define MSS_HPM_FP_ADD_RETIRED          MSS_HPM_EVENT(0U, 1UL << 13U)
+#define MSS_HPM_FP_MUL_RETIRED          MSS_HPM_EVENT(0U, 1UL << 14U)
+#define MSS_HPM_FP_FMA_RETIRED          MSS_HPM_EVENT(0U, 1UL << 15U)
+#define MSS_HPM_FP_DIV_RETIRED          MSS_HPM_EVENT(0U, 1UL << 16U)
+#define MSS_HPM_FP_OTHER_RETIRED        MSS_HPM_EVENT(0U, 1UL << 17U)
+
+/* Class 1, micro-architectural events */
+#define MSS_HPM_LOAD_USE_INTERLOCK      MSS_HPM_EVENT(1U, 1UL << 0U)
+#define MSS_HPM_LONG_LATENCY_INTERLOCK  MSS_HPM_EVENT(1U, 1UL << 1U)
+#define MSS_HPM_CSR_READ_INTERLOCK      MSS_HPM_EVENT(1U, 1UL << 2U)
+#define MSS_HPM_ICACHE_BUSY             MSS_HPM_EVENT(1U, 1UL << 3U)
+#define MSS_HPM_DCACHE_BUSY             MSS_HPM_EVENT(1U, 1UL << 4U)
+#define MSS_HPM_BRANCH_MISPREDICT       MSS_HPM_EVENT(1U, 1UL << 5U)
+#define MSS_HPM_TARGET_MISPREDICT       MSS_HPM_EVENT(1U, 1UL << 6U)
+#define MSS_HPM_CSR_WRITE_FLUSH         MSS_HPM_EVENT(1U, 1UL << 7U)
+#define MSS_HPM_OTHER_FLUSH             MSS_HPM_EVENT(1U, 1UL << 8U)
+#define MSS_HPM_INT_MUL_INTERLOCK       MSS_HPM_EVENT(1U, 1UL << 9U)
+#define MSS_HPM_FP_INTERLOCK            MSS_HPM_EVENT(1U, 1UL << 10U)
+
+/* Class 2, memory system events */
+#define MSS_HPM_ICACHE_MISS             MSS_HPM_EVENT(2U, 1UL << 0U)
+#define MSS_HPM_DCACHE_MISS             MSS_HPM_EVENT(2U, 1UL << 1U) /* Includes MMIO */
+#define MSS_HPM_DCACHE_WRITEBACK        MSS_HPM_EVENT(2U, 1UL << 2U)
+#define MSS_HPM_ITLB_MISS               MSS_HPM_EVENT(2U, 1UL << 3U)
+#define MSS_HPM_DTLB_MISS               MSS_HPM_EVENT(2U, 1UL << 4U)
+#define MSS_HPM_UTLB_MISS               MSS_HPM_EVENT(2U, 1UL << 5U)
+
+/*==============================================================================
+ * Ready made event pairs
+ */
+typedef enum MSS_HPM_VIEW_
+{
+    MSS_HPM_VIEW_CACHE      = 0,    /* I$ misses, D$ misses */
+    MSS_HPM_VIEW_STALLS     = 1,    /* Load interlocks, cache busy */
+    MSS_HPM_VIEW_BRANCH     = 2,    /* Mispredicts, branches retired */
+    MSS_HPM_VIEW_TLB        = 3,    /* I/D TLB misses, UTLB misses */
+    MSS_HPM_VIEW_MEMOPS     = 4,    /* Loads and stores retired */
+    MSS_HPM_VIEW_WRITEBACK  = 5,    /* D$ misses, D$ writebacks */
+    MSS_HPM_NB_VIEWS        = 6,
+} MSS_HPM_VIEW;
+
+typedef struct mss_hpm_counts_t_
+{
+    uint64_t cycles;
+    uint64_t instret;
+    uint64_t event[MSS_HPM_NB_COUNTERS];
+} mss_hpm_counts_t;
+
+typedef struct mss_hpm_region_t_
+{
+    const char *name;
+    uint64_t calls;
+    mss_hpm_counts_t total;
+    mss_hpm_counts_t start;
+    uint8_t active;
+} mss_hpm_region_t;
+
+/* Output function for mss_hpm_dump(), called once per line */
+typedef void (*mss_hpm_print_t)(const char *line);
+
+/*==============================================================================
+ * mss_hpm_select() - program the calling hart's event selectors and reset its
+ *   regions. names are used by mss_hpm_dump(), either may be NULL.
+ * mss_hpm_select_view() - select one of the ready made event pairs.
+ * mss_hpm_read() - raw counter values for the calling hart.
+ * mss_hpm_region_begin()/mss_hpm_region_end() - accumulate counts for the
+ *   code in between into the calling hart's region. name is only stored on
+ *   the first call after a reset and must stay valid.
+ * mss_hpm_region() - the accumulated counts for a region, NULL if unused.
+ * mss_hpm_reset() - clear the calling hart's regions, keep the events.
+ * mss_hpm_dump() - one line per used region of hart_id: calls, cycles,
+ *   instructions, IPC and both events with their rate per 1000 instructions.
+ */
+void mss_hpm_select(uint64_t event3, const char *name3, uint64_t event4, const char *name4);
+void mss_hpm_select_view(MSS_HPM_VIEW view);
+void mss_hpm_read(mss_hpm_counts_t *counts);
+void mss_hpm_region_begin(uint32_t region, const char *name);
+void mss_hpm_region_end(uint32_t region);
+const mss_hpm_region_t * mss_hpm_region(uint32_t hart_id, uint32_t region);
+void mss_hpm_reset(void);
+void mss_hpm_dump(uint32_t hart_id, mss_hpm_print_t print);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_HPM_H */
@@ -118,6 +118,7 @@ extern mss_ddr_diag ddr_diag;
  */
 static void ddr_read_write_nc (uint32_t no_access);
 static void display_clocks(void);
+static void display_boot_log(void);
 static void display_mss_regs(void);
 
 /*
@@ -246,6 +247,8 @@ void e51(void)
     MSS_UART_polled_tx(g_uart, (const uint8_t*)info_string,(uint32_t)
                        strlen(info_string));
 
+    display_boot_log();
+
     MSS_UART_polled_tx_string (g_uart, g_message);
 
     /* Start the other harts with appropriate UART input from user */
@@ -791,6 +794,58 @@ void handle_local_beu_interrupt(void)
     BEU->regs[hart_id].VALUE       = 0ULL;
 }
 
+/*==============================================================================
+ * Boot timeline, as logged by the HAL start-up code. The phases are printed in
+ * the order they ran, each starting where the one before ended. The first
+ * line is the time from reset to entry.S starting the log.
+ */
+static void display_boot_log(void)
+{
+    const mss_boot_log_t *p_log = mss_boot_log_get();
+    uint8_t order[MSS_BOOT_NB_PHASES];
+    mss_boot_phase_t boot_phase;
+    uint32_t nb_marked = 0U;
+    uint8_t phase;
+
+    if ((NULL == p_log) || (0U == p_log->marked))
+    {
+        MSS_UART_polled_tx_string(g_uart,(const uint8_t*)
+                                  "\n\rNo boot log, see HLS_DEBUG_AREA_SIZE\n\r");
+        return;
+    }
+
+    /* Walk back from the latest mark */
+    phase = p_log->last;
+    while ((phase < (uint8_t)MSS_BOOT_NB_PHASES) && (nb_marked < (uint32_t)MSS_BOOT_NB_PHASES))
+    {
+        order[(uint32_t)MSS_BOOT_NB_PHASES - 1U - nb_marked] = phase;
+        nb_marked++;
+        phase = p_log->previous[phase];
+    }
+
+    MSS_UART_polled_tx_string(g_uart,(const uint8_t*)
+            "\n\rBoot timeline      start(us)  length(us)      cycles\n\r");
+    sprintf(info_string, "%-17s %10lu %11lu\n\r", "reset",
+            0UL, mss_boot_log_to_us(p_log->start.mtime));
+    MSS_UART_polled_tx_string(g_uart,(const uint8_t*)info_string);
+
+    for (phase = (uint8_t)((uint32_t)MSS_BOOT_NB_PHASES - nb_marked);
+         phase < (uint8_t)MSS_BOOT_NB_PHASES; phase++)
+    {
+        (void)mss_boot_log_phase((MSS_BOOT_PHASE)order[phase], &boot_phase);
+        sprintf(info_string, "%-17s %10lu %11lu %11lu\n\r",
+                mss_boot_log_phase_name((MSS_BOOT_PHASE)order[phase]),
+                mss_boot_log_to_us(boot_phase.start.mtime),
+                mss_boot_log_to_us(boot_phase.end.mtime - boot_phase.start.mtime),
+                boot_phase.end.mcycle - boot_phase.start.mcycle);
+        MSS_UART_polled_tx_string(g_uart,(const uint8_t*)info_string);
+    }
+
+    sprintf(info_string, "Boot total        %10lu %11lu\n\r", 0UL,
+            mss_boot_log_to_us(p_log->end[p_log->last].mtime));
+    MSS_UART_polled_tx_string(g_uart,(const uint8_t*)info_string);
+}
+
 /*==============================================================================
  *
  */
@@ -126,9 +126,11 @@
  * boot phase.
  * This includes the flags which indicate the hart state regarding boot state.
  * The HLS will take memory from top of each stack allocated at boot time.
+ * 64 bytes are used by the HAL, the 240 bytes above them hold the boot log
+ * (see mss_boot_log.h). Set 64 if the boot log is not wanted.
  *
  */
-#define HLS_DEBUG_AREA_SIZE     64
+#define HLS_DEBUG_AREA_SIZE     304
 
 /*
  * Bus Error Unit (BEU) configurations
@@ -153,6 +155,27 @@
 #define MPFS_HAL_CLEAR_MEMORY  1
 #endif
 
+/*
+ * Clear DDR on startup, once it has been trained
+ * 0 => do not clear DDR
+ * 1 => Clears the cached DDR window, e.g. so ECC is initialised before use.
+ *      This adds the time taken to write the whole window to every boot.
+ */
+#ifndef MPFS_HAL_CLEAR_DDR
+#define MPFS_HAL_CLEAR_DDR  0
+#endif
+
+/*
+ * Parallel boot
+ * When defined, the first hart wakes all the other harts together rather than
+ * one at a time, and if MPFS_HAL_CLEAR_DDR is 1 the DDR clearing is split
+ * between harts MPFS_HAL_FIRST_HART to MPFS_HAL_LAST_HART. Each hart clears
+ * its share before its application code is called, and no hart calls its
+ * application code until all of DDR is clear.
+ * The time taken by each boot phase can be read with mss_boot_log_get().
+ */
+#define MPFS_HAL_PARALLEL_BOOT
+
 /*
  * We sometimes want to know which board we are compiling
  * enable define for particular board you are using if you are using this switch
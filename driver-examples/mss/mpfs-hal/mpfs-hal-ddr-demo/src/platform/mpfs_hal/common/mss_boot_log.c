@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_boot_log.c
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Boot phase timestamp log.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+#include "../startup_gcc/system_startup_defs.h"
+
+#define BOOT_LOG_IN_HLS     (HLS_DEBUG_AREA_SIZE >= (HLS_BOOT_LOG_OFFSET + HLS_BOOT_LOG_SIZE))
+
+_Static_assert(sizeof(mss_boot_log_t) <= HLS_BOOT_LOG_SIZE, "Boot log does not fit in the HLS");
+
+static const char * const g_boot_phase_name[MSS_BOOT_NB_PHASES] =
+{
+    "config_l2_cache",
+    "init_memory",
+    "load_virtual_rom",
+    "hw_setup",
+    "nwc_mssio",
+    "nwc_sgmii",
+    "nwc_mss_pll",
+    "nwc_init_ddr",
+    "plic_init",
+    "wake_harts",
+    "fabric",
+    "clear_ddr"
+};
+
+/*==============================================================================
+ * The log in the first hart's HLS, NULL if HLS_DEBUG_AREA_SIZE has no room for
+ * it. No switch, its jump table would be in .rodata.
+ */
+__attribute__((section(".text.init")))
+static mss_boot_log_t * boot_log(void)
+{
+#if BOOT_LOG_IN_HLS
+    ptrdiff_t stack_top;
+
+#if (MPFS_HAL_FIRST_HART == 0)
+    stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h0$);
+#elif (MPFS_HAL_FIRST_HART == 1)
+    stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h1$);
+#elif (MPFS_HAL_FIRST_HART == 2)
+    stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h2$);
+#elif (MPFS_HAL_FIRST_HART == 3)
+    stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h3$);
+#else
+    stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h4$);
+#endif
+
+    return ((mss_boot_log_t *)(stack_top - HLS_DEBUG_AREA_SIZE + HLS_BOOT_LOG_OFFSET));
+#else
+    return (NULL);
+#endif
+}
+
+__attribute__((section(".text.init")))
+static void boot_stamp(mss_boot_stamp_t *p_stamp)
+{
+    p_stamp->mcycle = read_csr(mcycle);
+    p_stamp->mtime = CLINT->MTIME;
+}
+
+/**
+ * mss_boot_log_start()
+ */
+__attribute__((section(".text.init")))
+void mss_boot_log_start(void)
+{
+    mss_boot_log_t *p_log = boot_log();
+    uint32_t phase;
+
+    if (NULL == p_log)
+    {
+        return;
+    }
+
+    /* The HLS was cleared by entry.S, only what is not 0 is set */
+    for (phase = 0U; phase < (uint32_t)MSS_BOOT_NB_PHASES; phase++)
+    {
+        p_log->previous[phase] = (uint8_t)MSS_BOOT_NB_PHASES;
+    }
+    p_log->last = (uint8_t)MSS_BOOT_NB_PHASES;
+    p_log->marked = 0U;
+
+    boot_stamp(&p_log->start);
+}
+
+/**
+ * mss_boot_log_mark()
+ */
+__attribute__((section(".text.init")))
+void mss_boot_log_mark(MSS_BOOT_PHASE phase)
+{
+    mss_boot_log_t *p_log = boot_log();
+
+    if ((NULL == p_log) || (phase >= MSS_BOOT_NB_PHASES))
+    {
+        return;
+    }
+
+    boot_stamp(&p_log->end[phase]);
+    p_log->previous[phase] = p_log->last;
+    p_log->last = (uint8_t)phase;
+    p_log->marked |= (1UL << (uint32_t)phase);
+}
+
+/**
+ * mss_boot_log_get()
+ */
+const mss_boot_log_t * mss_boot_log_get(void)
+{
+    return (boot_log());
+}
+
+/**
+ * mss_boot_log_phase()
+ */
+uint8_t mss_boot_log_phase(MSS_BOOT_PHASE phase, mss_boot_phase_t *p_phase)
+{
+    const mss_boot_log_t *p_log = boot_log();
+    uint8_t previous;
+
+    if ((NULL == p_log) || (phase >= MSS_BOOT_NB_PHASES) ||
+        (0U == (p_log->marked & (1UL << (uint32_t)phase))))
+    {
+        return (0U);
+    }
+
+    previous = p_log->previous[phase];
+    p_phase->start = (previous < (uint8_t)MSS_BOOT_NB_PHASES) ?
+                     p_log->end[previous] : p_log->start;
+    p_phase->end = p_log->end[phase];
+
+    return (1U);
+}
+
+/**
+ * mss_boot_log_phase_us()
+ */
+uint64_t mss_boot_log_phase_us(MSS_BOOT_PHASE phase)
+{
+    mss_boot_phase_t boot_phase;
+
+    if (0U == mss_boot_log_phase(phase, &boot_phase))
+    {
+        return (0U);
+    }
+
+    return (mss_boot_log_to_us(boot_phase.end.mtime - boot_phase.start.mtime));
+}
+
+/**
+ * mss_boot_log_to_us()
+ */
+uint64_t mss_boot_log_to_us(uint64_t mtime)
+{
+    return ((mtime * 1000000UL) / LIBERO_SETTING_MSS_RTC_TOGGLE_CLK);
+}
+
+/**
+ * mss_boot_log_phase_name()
+ */
+const char * mss_boot_log_phase_name(MSS_BOOT_PHASE phase)
+{
+    return ((phase < MSS_BOOT_NB_PHASES) ? g_boot_phase_name[phase] : "?");
+}
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_boot_log.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Boot phase timestamp log.
+ *
+ * The first hart stamps mtime and mcycle at the end of each boot step with
+ * mss_boot_log_mark(). A phase starts where the previous mark, or the start
+ * stamp, left off, so the phases add up to the whole boot. The application
+ * can print the timeline once it has a UART up.
+ *
+ * entry.S starts the log just before config_l2_cache(), so the log cannot be
+ * in the bss, which init_memory() clears later. It is kept in the first hart's
+ * HLS instead, after the HLS_BOOT_LOG_OFFSET bytes used by HLS_DATA.
+ * HLS_DEBUG_AREA_SIZE in mss_sw_config.h must be at least
+ * HLS_BOOT_LOG_OFFSET + HLS_BOOT_LOG_SIZE, 304, for the log to be kept. If it
+ * is not, marks are ignored and mss_boot_log_get() returns NULL.
+ *
+ * mss_boot_log_start() and mss_boot_log_mark() run before the code is copied
+ * by init_memory(), so they are in the .text.init section and do not use any
+ * data section.
+ *
+ * mtime counts at the RTC toggle rate (1MHz) from reset, mcycle counts CPU
+ * clocks from reset on the first hart.
+ */
+
+#ifndef MSS_BOOT_LOG_H
+#define MSS_BOOT_LOG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * In the order they normally run. MSS_BOOT_PHASE_CLEAR_DDR runs after
+ * MSS_BOOT_PHASE_NWC_INIT_DDR in a serial boot and after
+ * MSS_BOOT_PHASE_FABRIC in a parallel one.
+ */
+typedef enum MSS_BOOT_PHASE_
+{
+    MSS_BOOT_PHASE_L2_CACHE         = 0,    /* config_l2_cache(), scratchpad
+                                               and heap cleared */
+    MSS_BOOT_PHASE_INIT_MEMORY      = 1,    /* Sections copied and cleared */
+    MSS_BOOT_PHASE_VIRTUAL_ROM      = 2,    /* load_virtual_rom() */
+    MSS_BOOT_PHASE_HW_SETUP         = 3,    /* BEU, MPU, PMP */
+    MSS_BOOT_PHASE_NWC_MSSIO        = 4,    /* RTC divisor, MSSIO and IOMUX */
+    MSS_BOOT_PHASE_NWC_SGMII        = 5,    /* MSSIO enabled, SGMII set up */
+    MSS_BOOT_PHASE_NWC_MSS_PLL      = 6,    /* MSS PLL locked */
+    MSS_BOOT_PHASE_NWC_INIT_DDR     = 7,    /* DDR training */
+    MSS_BOOT_PHASE_PLIC_INIT        = 8,    /* Constructors and PLIC */
+    MSS_BOOT_PHASE_WAKE_HARTS       = 9,    /* Other harts out of wfi */
+    MSS_BOOT_PHASE_FABRIC           = 10,   /* RAM clocks off, FICs on */
+    MSS_BOOT_PHASE_CLEAR_DDR        = 11,   /* DDR cleared */
+    MSS_BOOT_NB_PHASES              = 12,
+} MSS_BOOT_PHASE;
+
+typedef struct mss_boot_stamp_t_
+{
+    uint64_t mtime;
+    uint64_t mcycle;
+} mss_boot_stamp_t;
+
+typedef struct mss_boot_phase_t_
+{
+    mss_boot_stamp_t start;
+    mss_boot_stamp_t end;
+} mss_boot_phase_t;
+
+typedef struct mss_boot_log_t_
+{
+    mss_boot_stamp_t start;         /* Taken before config_l2_cache() */
+    mss_boot_stamp_t end[MSS_BOOT_NB_PHASES];
+    uint8_t previous[MSS_BOOT_NB_PHASES];   /* Phase marked before this one,
+                                               MSS_BOOT_NB_PHASES if none */
+    uint8_t last;                   /* Latest phase marked, MSS_BOOT_NB_PHASES
+                                       if none */
+    uint32_t marked;                /* Bit per phase marked */
+} mss_boot_log_t;
+
+/*==============================================================================
+ * mss_boot_log_start() - clear the log and set the start stamp. Called by
+ *   entry.S on the first hart, before config_l2_cache().
+ * mss_boot_log_mark() - stamp the end of phase, which started at the previous
+ *   mark. First hart only.
+ * mss_boot_log_get() - the log, read it once boot is over. NULL if the HLS is
+ *   too small to keep it.
+ * mss_boot_log_phase() - start and end stamps of phase. Returns 0 if it was not
+ *   marked, 1 otherwise.
+ * mss_boot_log_phase_us() - duration of phase in microseconds, 0 if it was not
+ *   marked.
+ * mss_boot_log_to_us() - mtime in microseconds.
+ * mss_boot_log_phase_name() - short name of phase for printing.
+ */
+void mss_boot_log_start(void);
+void mss_boot_log_mark(MSS_BOOT_PHASE phase);
+const mss_boot_log_t * mss_boot_log_get(void);
+uint8_t mss_boot_log_phase(MSS_BOOT_PHASE phase, mss_boot_phase_t *p_phase);
+uint64_t mss_boot_log_phase_us(MSS_BOOT_PHASE phase);
+uint64_t mss_boot_log_to_us(uint64_t mtime);
+const char * mss_boot_log_phase_name(MSS_BOOT_PHASE phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_BOOT_LOG_H */
@@ -146,6 +146,7 @@ uint8_t mss_nwc_init(void)
         error |= mssio_setup();
 #endif
     }
+    mss_boot_log_mark(MSS_BOOT_PHASE_NWC_MSSIO);
 
     /*************************************************************************/
 
@@ -295,11 +296,13 @@ uint8_t mss_nwc_init(void)
      * be called before configuring the MSS PLL
      */
     sgmii_setup();
+    mss_boot_log_mark(MSS_BOOT_PHASE_NWC_SGMII);
 
     /*
      * Setup the MSS PLL
      */
     mss_pll_config();
+    mss_boot_log_mark(MSS_BOOT_PHASE_NWC_MSS_PLL);
 
     return error;
 }
@@ -58,6 +58,7 @@ typedef long            ssize_t;
 #include "common/mss_util.h"
 #include "common/mss_mtrap.h"
 #include "common/mss_l2_cache.h"
+#include "common/mss_boot_log.h"
 #include "common/mss_axiswitch.h"
 #include "common/mss_peripherals.h"
 #include "common/nwc/mss_cfm.h"
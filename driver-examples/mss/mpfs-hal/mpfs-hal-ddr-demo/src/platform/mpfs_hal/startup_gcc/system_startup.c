@@ -23,6 +23,17 @@ static uint32_t parked_harts = 0U;
 void* __dso_handle = (void*) &__dso_handle;
 static void init_global_constructors(void);
 
+#if defined(MPFS_HAL_HW_CONFIG) && (MPFS_HAL_CLEAR_DDR == 1)
+static bool g_clear_ddr = false;    /* DDR trained, set before harts wake */
+#ifdef MPFS_HAL_PARALLEL_BOOT
+static volatile uint32_t g_ddr_clear_count = 0U;
+static void clear_ddr_share(uint32_t hart_id);
+#endif
+#endif
+#if defined(MPFS_HAL_HW_CONFIG) && defined(MPFS_HAL_PARALLEL_BOOT)
+static void wake_other_harts(void);
+#endif
+
 /*==============================================================================
  * This function is called by the lowest enabled hart (MPFS_HAL_FIRST_HART) in
  * the configuration file :
@@ -44,6 +55,9 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
         uint8_t hart_id;
         ptrdiff_t stack_top;
 
+        /* Started by entry.S, covers config_l2_cache() up to here */
+        mss_boot_log_mark(MSS_BOOT_PHASE_L2_CACHE);
+
         /*
          * We only use code within the conditional compile
          * #ifdef MPFS_HAL_HW_CONFIG
@@ -53,16 +67,19 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
          * as required.
          */
         init_memory();
+        mss_boot_log_mark(MSS_BOOT_PHASE_INIT_MEMORY);
 #ifndef MPFS_HAL_HW_CONFIG
         hls->my_hart_id = MPFS_HAL_FIRST_HART;
 #endif
 #ifdef  MPFS_HAL_HW_CONFIG
         load_virtual_rom();
+        mss_boot_log_mark(MSS_BOOT_PHASE_VIRTUAL_ROM);
         (void)init_bus_error_unit();
         (void)init_mem_protection_unit();
         (void)init_pmp((uint8_t)MPFS_HAL_FIRST_HART);
         (void)mss_set_apb_bus_cr((uint32_t)LIBERO_SETTING_APBBUS_CR);
         (void)mss_set_gpio_interrupt_fab_cr((uint32_t)LIBERO_SETTING_GPIO_INTERRUPT_FAB_CR);
+        mss_boot_log_mark(MSS_BOOT_PHASE_HW_SETUP);
 #endif  /* MPFS_HAL_HW_CONFIG */
         /*
          * Initialise NWC
@@ -72,12 +89,27 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
          *      IOMUX
          */
 #ifdef  MPFS_HAL_HW_CONFIG
+        /* Marks MSS_BOOT_PHASE_NWC_MSSIO to MSS_BOOT_PHASE_NWC_MSS_PLL */
         (void)mss_nwc_init();
+#if (MPFS_HAL_CLEAR_DDR == 1)
+        g_clear_ddr = (0U == mss_nwc_init_ddr());
+        mss_boot_log_mark(MSS_BOOT_PHASE_NWC_INIT_DDR);
+#ifndef MPFS_HAL_PARALLEL_BOOT
+        if (g_clear_ddr)
+        {
+            init_ddr();
+        }
+        mss_boot_log_mark(MSS_BOOT_PHASE_CLEAR_DDR);
+#endif
+#else
         (void)mss_nwc_init_ddr();
+        mss_boot_log_mark(MSS_BOOT_PHASE_NWC_INIT_DDR);
+#endif
         init_global_constructors();
 
         /* main hart init's the PLIC */
         PLIC_init_on_reset();
+        mss_boot_log_mark(MSS_BOOT_PHASE_PLIC_INIT);
         /*
          * Start the other harts. They are put in wfi in entry.S
          * When debugging, harts are released from reset separately,
@@ -85,8 +117,14 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
         */
         stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h0$);
         hls = (HLS_DATA*)(stack_top - HLS_DEBUG_AREA_SIZE);
+        /* Anything the other harts read when they wake must be written first */
+        mb();
         hls->in_wfi_indicator = HLS_MAIN_HART_STARTED;
         hls->my_hart_id = MPFS_HAL_FIRST_HART;
+#ifdef MPFS_HAL_PARALLEL_BOOT
+        wake_other_harts();
+        (void)hart_id;
+#else
         WFI_SM sm_check_thread = INIT_THREAD_PR;
         hart_id = MPFS_HAL_FIRST_HART + 1U;
         while( hart_id <= MPFS_HAL_LAST_HART)
@@ -156,6 +194,8 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
                     break;
             }
         }
+#endif /* MPFS_HAL_PARALLEL_BOOT */
+        mss_boot_log_mark(MSS_BOOT_PHASE_WAKE_HARTS);
         stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h0$);
         hls = (HLS_DATA*)(stack_top - HLS_DEBUG_AREA_SIZE);
         hls->in_wfi_indicator = HLS_MAIN_HART_FIN_INIT;
@@ -172,6 +212,7 @@ __attribute__((weak)) int main_first_hart(HLS_DATA* hls)
         (void)mss_config_clk_rst(MSS_PERIPH_FIC3, (uint8_t)MPFS_HAL_FIRST_HART, PERIPHERAL_ON);
         /* enable the fabric */
         mss_enable_fabric();
+        mss_boot_log_mark(MSS_BOOT_PHASE_FABRIC);
 
 #endif /* MPFS_HAL_HW_CONFIG */
         (void)main_other_hart(hls);
@@ -364,6 +405,15 @@ __attribute__((weak)) int main_other_hart(HLS_DATA* hls)
 #endif
 #endif
 
+#if defined(MPFS_HAL_HW_CONFIG) && defined(MPFS_HAL_PARALLEL_BOOT) && (MPFS_HAL_CLEAR_DDR == 1)
+    /* Every hart clears its share of DDR before any application code runs */
+    clear_ddr_share(hls->my_hart_id);
+    if (MPFS_HAL_FIRST_HART == hls->my_hart_id)
+    {
+        mss_boot_log_mark(MSS_BOOT_PHASE_CLEAR_DDR);
+    }
+#endif
+
     volatile uint64_t dummy;
 
     switch(hls->my_hart_id)
@@ -474,6 +524,127 @@ void load_virtual_rom(void)
 }
 #endif  /* MPFS_HAL_HW_CONFIG */
 
+#if defined(MPFS_HAL_HW_CONFIG) && defined(MPFS_HAL_PARALLEL_BOOT)
+/*==============================================================================
+ * HLS of hart_id, at the top of its boot stack
+ */
+static HLS_DATA* boot_hls(uint32_t hart_id)
+{
+    ptrdiff_t stack_top;
+
+    switch (hart_id)
+    {
+        case 1:
+            stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h1$);
+            break;
+        case 2:
+            stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h2$);
+            break;
+        case 3:
+            stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h3$);
+            break;
+        case 4:
+            stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h4$);
+            break;
+        default:
+            stack_top = (ptrdiff_t)((uint8_t*)&__stack_top_h0$);
+            break;
+    }
+
+    return ((HLS_DATA*)(stack_top - HLS_DEBUG_AREA_SIZE));
+}
+
+/*==============================================================================
+ * Wake the other harts together. Each hart is sent its software interrupt as
+ * soon as it is in wfi, rather than after the hart before it has left wfi. As
+ * in the sequential start up, the interrupt is sent again if a hart is still
+ * in wfi after a while.
+ */
+static void wake_other_harts(void)
+{
+    uint32_t wait_count[MPFS_HAL_LAST_HART + 1U] = {0U};
+    uint32_t pending = 0U;      /* Bit per hart not out of wfi yet */
+    uint32_t sent = 0U;         /* Bit per hart sent its interrupt */
+    uint32_t hart_id;
+    uint32_t hart_bit;
+    HLS_DATA* p_hls;
+
+    for (hart_id = MPFS_HAL_FIRST_HART + 1U; hart_id <= MPFS_HAL_LAST_HART; hart_id++)
+    {
+        pending |= (1U << hart_id);
+    }
+
+    while (0U != pending)
+    {
+        for (hart_id = MPFS_HAL_FIRST_HART + 1U; hart_id <= MPFS_HAL_LAST_HART; hart_id++)
+        {
+            hart_bit = (1U << hart_id);
+            if (0U == (pending & hart_bit))
+            {
+                continue;
+            }
+
+            p_hls = boot_hls(hart_id);
+            if (HLS_OTHER_HART_PASSED_WFI == p_hls->in_wfi_indicator)
+            {
+                pending &= ~hart_bit;
+            }
+            else if (HLS_OTHER_HART_IN_WFI == p_hls->in_wfi_indicator)
+            {
+                if ((0U == (sent & hart_bit)) || (wait_count[hart_id] > 0x10U))
+                {
+                    p_hls->my_hart_id = hart_id; /* record hartid locally */
+                    raise_soft_interrupt(hart_id);
+                    sent |= hart_bit;
+                    wait_count[hart_id] = 0U;
+                }
+                else
+                {
+                    wait_count[hart_id]++;
+                }
+            }
+        }
+    }
+}
+
+#if (MPFS_HAL_CLEAR_DDR == 1)
+/*==============================================================================
+ * Clear hart_id's share of the cached DDR window, the same window init_ddr()
+ * clears, then wait until every hart has cleared its share.
+ */
+static void clear_ddr_share(uint32_t hart_id)
+{
+    const uint32_t nb_harts = (MPFS_HAL_LAST_HART - MPFS_HAL_FIRST_HART) + 1U;
+
+#ifdef DDR_SUPPORT
+    const uint64_t end_address = LIBERO_SETTING_DDR_64_CACHE + LIBERO_SETTING_CFG_AXI_END_ADDRESS_AXI1_0 + LIBERO_SETTING_CFG_AXI_END_ADDRESS_AXI1_1;
+    /* Shares are whole cache lines, so no two harts write the same line */
+    const uint64_t share = (((end_address - LIBERO_SETTING_DDR_64_CACHE) / nb_harts) + 63U) & ~63ULL;
+    uint64_t start = LIBERO_SETTING_DDR_64_CACHE + (share * (hart_id - MPFS_HAL_FIRST_HART));
+    uint64_t end = start + share;
+
+    if (end > end_address)
+    {
+        end = end_address;
+    }
+
+    if (g_clear_ddr &&
+        ((LIBERO_SETTING_DDRPHY_MODE & DDRPHY_MODE_MASK) != DDR_OFF_MODE) &&
+        (start < end))
+    {
+        zero_section((uint64_t *)start, (uint64_t *)end);
+    }
+#endif
+
+    (void)__atomic_fetch_add(&g_ddr_clear_count, 1U, __ATOMIC_SEQ_CST);
+    while (g_ddr_clear_count < nb_harts)
+    {
+        ;
+    }
+}
+#endif  /* MPFS_HAL_CLEAR_DDR */
+#endif  /* MPFS_HAL_PARALLEL_BOOT */
+
 /*==============================================================================
  * Initialize the global constructor before using any C++ feature which depends
  * on global constructors.
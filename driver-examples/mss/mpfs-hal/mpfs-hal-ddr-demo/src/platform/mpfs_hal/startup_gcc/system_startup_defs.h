@@ -30,10 +30,23 @@ extern "C" {
  * as well as flags for wfi instruction management.
  * The TLS will take memory from top of the stack if allocated
  *
+ * The boot log (mss_boot_log.h) is kept after the first HLS_BOOT_LOG_OFFSET
+ * bytes of the first hart's HLS, if HLS_DEBUG_AREA_SIZE leaves room for it.
+ * entry.S clears the HLS before the log is started and init_memory() does not
+ * touch it, so the log covers the boot from config_l2_cache() on.
  */
 #if !defined (HLS_DEBUG_AREA_SIZE)
 #define HLS_DEBUG_AREA_SIZE     64
 #endif
+#define HLS_BOOT_LOG_OFFSET     64
+#define HLS_BOOT_LOG_SIZE       240
+
+/*------------------------------------------------------------------------------
+ * DDR is not cleared on startup unless mss_sw_config.h says so
+ */
+#if !defined (MPFS_HAL_CLEAR_DDR)
+#define MPFS_HAL_CLEAR_DDR      0
+#endif
 
 #ifdef __cplusplus
 }
@@ -16,6 +16,9 @@
 #include <string.h>
 #include "mpfs_hal/mss_hal.h"
 #include "inc/common.h"
+#include "inc/lock_bench.h"
+#include "inc/sample_profile.h"
+#include "inc/irq_bench.h"
 
 #ifndef SIFIVE_HIFIVE_UNLEASHED
 #include "drivers/mss/mss_mmuart/mss_uart.h"
@@ -39,6 +42,10 @@ Type 2  Raise sw int hart 2\r\n\
 Type 3  Raise sw int hart 3\r\n\
 Type 4  Raise sw int hart 4\r\n\
 Type 5  Print debug messages from hart0\r\n\
+Type 6  Run lock contention benchmark\r\n\
+Type 7  Start PC sampling profile of awake harts\r\n\
+Type 8  Stop profile and print samples\r\n\
+Type 9  Run interrupt latency benchmark\r\n\
 ";
 
 #ifndef  MPFS_HAL_SHARED_MEM_ENABLED
@@ -64,12 +71,13 @@ void e51(void)
     SYSREG->SOFT_RESET_CR   &= ~SOFT_RESET_CR_MMUART0_MASK;
 
     HLS_DATA* hls = (HLS_DATA*)(uintptr_t)get_tp_reg();
-    /* This mutex is used to serialize accesses to UART0 when all harts want to
-     * TX/RX on UART0. This mutex is shared across all harts. */
+    /* This ticket lock is used to serialize accesses to UART0 when all harts
+     * want to TX/RX on UART0. It is shared across all harts and grants the
+     * UART in the order the harts asked for it. */
     HART_SHARED_DATA * hart_share = (HART_SHARED_DATA *)hls->shared_mem;
     /* set point for sharing across harts */
     hart_share->g_mss_uart0_lo = &g_mss_uart0_lo;
-    hart_share->mutex_uart0 = 0U; /* Init spinlock mutex */
+    mss_ticket_lock_init(&hart_share->uart0_lock); /* Init UART0 lock */
 
     MSS_UART_init( hart_share->g_mss_uart0_lo,
             MSS_UART_115200_BAUD,
@@ -77,9 +85,9 @@ void e51(void)
 
     sprintf(info_string, "\r\nHart %u, HLS mem address 0x%lx, Shared mem 0x%lx\r\n",\
                                                           hls->my_hart_id, (uint64_t)hls, (uint64_t)hls->shared_mem);
-    spinlock(&hart_share->mutex_uart0);
+    mss_ticket_lock(&hart_share->uart0_lock);
     MSS_UART_polled_tx(hart_share->g_mss_uart0_lo, (const uint8_t*)info_string,(uint32_t)strlen(info_string));
-    spinunlock(&hart_share->mutex_uart0);
+    mss_ticket_unlock(&hart_share->uart0_lock);
 
     MSS_UART_polled_tx_string (&g_mss_uart0_lo, g_message);
 
@@ -95,23 +103,23 @@ void e51(void)
           debug_hart0 = 0U;
           sprintf(info_string,"Hart %ld, %ld delta_mcycle %ld mtime\r\n",
           hartid, delta_mcycle, readmtime());
-          spinlock(&hart_share->mutex_uart0);
+          mss_ticket_lock(&hart_share->uart0_lock);
           MSS_UART_polled_tx(hart_share->g_mss_uart0_lo, info_string,strlen(info_string));
-          spinunlock(&hart_share->mutex_uart0);
+          mss_ticket_unlock(&hart_share->uart0_lock);
         }
 
-        spinlock(&hart_share->mutex_uart0);
+        mss_ticket_lock(&hart_share->uart0_lock);
         rx_size = MSS_UART_get_rx(hart_share->g_mss_uart0_lo, rx_buff, sizeof(rx_buff));
-        spinunlock(&hart_share->mutex_uart0);
+        mss_ticket_unlock(&hart_share->uart0_lock);
 
         if (rx_size > 0)
         {
             switch(rx_buff[0])
             {
                 case '0':
-                    spinlock(&hart_share->mutex_uart0);
+                    mss_ticket_lock(&hart_share->uart0_lock);
                     MSS_UART_polled_tx_string (hart_share->g_mss_uart0_lo, g_message );
-                    spinunlock(&hart_share->mutex_uart0);
+                    mss_ticket_unlock(&hart_share->uart0_lock);
                     break;
                 case '1':
                     raise_soft_interrupt(1u);
@@ -128,12 +136,24 @@ void e51(void)
                 case '5':
                     debug_hart0 = 1;
                     break;
+                case '6':
+                    lock_bench_run(hart_share);
+                    break;
+                case '7':
+                    sample_profile_start(hart_share);
+                    break;
+                case '8':
+                    sample_profile_stop(hart_share);
+                    break;
+                case '9':
+                    irq_bench_run(hart_share);
+                    break;
 
                 default:
                     /* echo input */
-                    spinlock(&hart_share->mutex_uart0);
+                    mss_ticket_lock(&hart_share->uart0_lock);
                     MSS_UART_polled_tx_string(hart_share->g_mss_uart0_lo, rx_buff);
-                    spinunlock(&hart_share->mutex_uart0);
+                    mss_ticket_unlock(&hart_share->uart0_lock);
                     break;
             }
         }
@@ -146,6 +166,7 @@ void e51(void)
 /* HART0 Software interrupt handler */
 void Software_h0_IRQHandler(void)
 {
+    irq_bench_soft_isr();
     uint64_t hart_id = read_csr(mhartid);
     count_sw_ints_h0++;
 }
@@ -0,0 +1,316 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * Interrupt latency benchmark
+ *
+ * Each interrupt is raised by the E51 itself, mcycle is read just before it is
+ * raised and again at the start of its handler:
+ *  - soft:       CLINT MSIP, the machine software interrupt
+ *  - local:      MMUART0 transmit holding register empty, as an E51 local
+ *                interrupt
+ *  - plic:       the same UART interrupt routed through the PLIC
+ *  - plic burst: MMUART0 to MMUART3 raised together while external
+ *                interrupts are masked, timed until the last handler runs.
+ *                This is where claiming several sources per trap helps.
+ * The UART interrupt fires as soon as it is enabled since the transmitter is
+ * idle. MMUART1 to MMUART3 are only used as interrupt sources, nothing is
+ * transmitted on them.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mpfs_hal/mss_hal.h"
+#include "inc/common.h"
+#include "inc/irq_bench.h"
+#include "drivers/mss/mss_mmuart/mss_uart.h"
+
+#define BENCH_NB_UARTS      4U
+
+typedef enum BENCH_IRQ_TYPE_
+{
+    BENCH_SOFT          = 0,
+    BENCH_LOCAL         = 1,
+    BENCH_PLIC          = 2,
+    BENCH_PLIC_BURST    = 3,
+    BENCH_NB_TYPES      = 4,
+}   BENCH_IRQ_TYPE;
+
+static const char * const g_type_names[BENCH_NB_TYPES] =
+{
+    "soft",
+    "local",
+    "plic",
+    "plic burst x4",
+};
+
+static mss_uart_instance_t * const g_bench_uarts[BENCH_NB_UARTS] =
+{
+    &g_mss_uart0_lo,
+    &g_mss_uart1_lo,
+    &g_mss_uart2_lo,
+    &g_mss_uart3_lo,
+};
+
+static const PLIC_IRQn_Type g_bench_uart_plic[BENCH_NB_UARTS] =
+{
+    MMUART0_PLIC_77,
+    MMUART1_PLIC,
+    MMUART2_PLIC,
+    MMUART3_PLIC,
+};
+
+static volatile uint32_t g_bench_active;
+static volatile uint32_t g_isr_count;
+static volatile uint64_t g_isr_cycle;
+
+/**
+ * irq_bench_soft_isr()
+ */
+void irq_bench_soft_isr(void)
+{
+    if (0U != g_bench_active)
+    {
+        g_isr_cycle = readmcycle();
+        g_isr_count = g_isr_count + 1U;
+    }
+}
+
+/*==============================================================================
+ * Transmit holding register empty handler for all the UARTs
+ */
+static void bench_uart_isr(mss_uart_instance_t * this_uart)
+{
+    g_isr_cycle = readmcycle();
+    this_uart->hw_reg->IER &= (uint8_t)~MSS_UART_TBE_IRQ;
+    g_isr_count = g_isr_count + 1U;
+}
+
+/*==============================================================================
+ * Wait for count handlers to have run since the count was zeroed
+ */
+static bool bench_wait(uint32_t count)
+{
+    uint32_t timeout = IRQ_BENCH_TIMEOUT;
+
+    while ((g_isr_count < count) && (0U != timeout))
+    {
+        timeout--;
+    }
+
+    return (0U != timeout);
+}
+
+/*==============================================================================
+ * Raise one interrupt, or a burst, and return the cycles to the last handler
+ */
+static uint64_t bench_once(BENCH_IRQ_TYPE type, bool *ok)
+{
+    uint64_t start;
+    uint32_t count = 1U;
+    uint32_t uart;
+
+    g_isr_count = 0U;
+    mb();
+
+    switch (type)
+    {
+        case BENCH_SOFT:
+            start = readmcycle();
+            raise_soft_interrupt(0U);
+            break;
+
+        case BENCH_LOCAL:
+        case BENCH_PLIC:
+            while (0 == MSS_UART_tx_complete(g_bench_uarts[0]))
+            {
+            }
+            start = readmcycle();
+            g_bench_uarts[0]->hw_reg->IER |= (uint8_t)MSS_UART_TBE_IRQ;
+            break;
+
+        default:
+            clear_csr(mie, MIP_MEIP);
+            for (uart = 0U; uart < BENCH_NB_UARTS; uart++)
+            {
+                while (0 == MSS_UART_tx_complete(g_bench_uarts[uart]))
+                {
+                }
+                g_bench_uarts[uart]->hw_reg->IER |= (uint8_t)MSS_UART_TBE_IRQ;
+            }
+            for (uart = 0U; uart < BENCH_NB_UARTS; uart++)
+            {
+                while (0U == PLIC_pending(g_bench_uart_plic[uart]))
+                {
+                }
+            }
+            count = BENCH_NB_UARTS;
+            start = readmcycle();
+            set_csr(mie, MIP_MEIP);
+            break;
+    }
+
+    *ok = bench_wait(count) && *ok;
+
+    return (g_isr_cycle - start);
+}
+
+/*==============================================================================
+ * Route the UART interrupts for a test
+ */
+static void bench_route(BENCH_IRQ_TYPE type)
+{
+    uint32_t uart;
+
+    for (uart = 0U; uart < BENCH_NB_UARTS; uart++)
+    {
+        g_bench_uarts[uart]->hw_reg->IER &= (uint8_t)~MSS_UART_TBE_IRQ;
+        PLIC_DisableIRQ(g_bench_uart_plic[uart]);
+    }
+    __disable_local_irq((uint8_t)MMUART0_E51_INT);
+    g_bench_uarts[0]->local_irq_enabled = 0U;
+
+    if (BENCH_LOCAL == type)
+    {
+        MSS_UART_enable_local_irq(g_bench_uarts[0]);
+    }
+    else if ((BENCH_PLIC == type) || (BENCH_PLIC_BURST == type))
+    {
+        for (uart = 0U; uart < ((BENCH_PLIC == type) ? 1U : BENCH_NB_UARTS); uart++)
+        {
+            PLIC_EnableIRQ(g_bench_uart_plic[uart]);
+        }
+    }
+    else
+    {
+        /* software interrupt only */
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void bench_print(HART_SHARED_DATA * hart_share, const char *text)
+{
+    mss_ticket_lock(&hart_share->uart0_lock);
+    MSS_UART_polled_tx_string(hart_share->g_mss_uart0_lo, (const uint8_t *)text);
+    mss_ticket_unlock(&hart_share->uart0_lock);
+}
+
+/*==============================================================================
+ * Run each test with the current trap mode and claim limit
+ */
+static void bench_pass(HART_SHARED_DATA * hart_share, const char *mode_name)
+{
+    char info_string[160];
+    uint64_t cycles;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint32_t type;
+    uint32_t i;
+    bool ok;
+
+    for (type = 0U; type < (uint32_t)BENCH_NB_TYPES; type++)
+    {
+        sum = 0ULL;
+        min = UINT64_MAX;
+        max = 0ULL;
+        ok = true;
+
+        /* Keep the other harts off UART0 so the transmitter stays idle */
+        mss_ticket_lock(&hart_share->uart0_lock);
+        bench_route((BENCH_IRQ_TYPE)type);
+
+        /* The first pass warms up the caches and is not counted */
+        (void)bench_once((BENCH_IRQ_TYPE)type, &ok);
+        for (i = 0U; i < IRQ_BENCH_ITERATIONS; i++)
+        {
+            cycles = bench_once((BENCH_IRQ_TYPE)type, &ok);
+            sum += cycles;
+            if (cycles < min)
+            {
+                min = cycles;
+            }
+            if (cycles > max)
+            {
+                max = cycles;
+            }
+        }
+
+        bench_route(BENCH_SOFT);
+        mss_ticket_unlock(&hart_share->uart0_lock);
+
+        sprintf(info_string,
+                "%-9s %-14s avg %5lu min %5lu max %6lu cycles (avg %4lu ns) %s\r\n",
+                mode_name, g_type_names[type], sum / IRQ_BENCH_ITERATIONS, min, max,
+                (uint64_t)(((sum / IRQ_BENCH_ITERATIONS) * 1000ULL) /
+                           (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000000ULL)),
+                ok ? "" : "TIMEOUT");
+        bench_print(hart_share, info_string);
+    }
+}
+
+/**
+ * irq_bench_run()
+ */
+void irq_bench_run(HART_SHARED_DATA * hart_share)
+{
+    uint64_t saved_mie = read_csr(mie);
+    uint64_t saved_mstatus = read_csr(mstatus);
+    uint32_t uart;
+
+    bench_print(hart_share, "\r\nInterrupt latency benchmark\r\n");
+
+    for (uart = 1U; uart < BENCH_NB_UARTS; uart++)
+    {
+        (void)mss_config_clk_rst((mss_peripherals)((uint32_t)MSS_PERIPH_MMUART0 + uart),
+                                 (uint8_t)MPFS_HAL_FIRST_HART, PERIPHERAL_ON);
+        MSS_UART_init(g_bench_uarts[uart], MSS_UART_115200_BAUD,
+                      MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY | MSS_UART_ONE_STOP_BIT);
+    }
+
+    for (uart = 0U; uart < BENCH_NB_UARTS; uart++)
+    {
+        /* Also sets the TBE enable, cleared again by bench_route() */
+        MSS_UART_set_tx_handler(g_bench_uarts[uart], bench_uart_isr);
+        PLIC_SetPriority(g_bench_uart_plic[uart], 1U);
+    }
+    bench_route(BENCH_SOFT);
+    PLIC_SetPriority_Threshold(0U);
+
+    g_bench_active = 1U;
+    set_csr(mie, MIP_MSIP | MIP_MEIP);
+    __enable_irq();
+
+#ifdef MPFS_HAL_VECTORED_INTERRUPTS
+    mss_set_trap_mode(MTVEC_MODE_DIRECT);
+#endif
+    PLIC_set_claim_limit(1U);
+    bench_pass(hart_share, "direct");
+
+#ifdef MPFS_HAL_VECTORED_INTERRUPTS
+    mss_set_trap_mode(MTVEC_MODE_VECTORED);
+    PLIC_set_claim_limit(PLIC_MAX_CLAIMS_PER_TRAP);
+    bench_pass(hart_share, "vectored");
+#else
+    PLIC_set_claim_limit(PLIC_MAX_CLAIMS_PER_TRAP);
+    bench_pass(hart_share, "drain");
+#endif
+
+    g_bench_active = 0U;
+    write_csr(mie, saved_mie);
+    if (0U == (saved_mstatus & MSTATUS_MIE))
+    {
+        __disable_irq();
+    }
+
+    bench_print(hart_share, "Interrupt latency benchmark done\r\n");
+}
@@ -0,0 +1,328 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * Lock contention benchmark
+ *
+ * Each test runs with 1, 2, .. up to all awake harts. Every hart acquires the
+ * lock LOCK_BENCH_ITERATIONS times, timing each acquire with mcycle, spends
+ * LOCK_BENCH_HOLD_LOOPS in the critical section incrementing a shared counter
+ * and LOCK_BENCH_THINK_LOOPS outside it. The counter is checked at the end to
+ * catch a lock which lets two harts in at once.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mpfs_hal/mss_hal.h"
+#include "inc/common.h"
+#include "inc/lock_bench.h"
+
+#define BENCH_MAX_HARTS     5U
+
+typedef enum BENCH_LOCK_TYPE_
+{
+    BENCH_SPINLOCK          = 0,
+    BENCH_TICKET            = 1,
+    BENCH_MCS               = 2,
+    BENCH_RW_WRITE          = 3,
+    BENCH_RW_READ_MOSTLY    = 4,
+    BENCH_NB_TYPES          = 5,
+}   BENCH_LOCK_TYPE;
+
+static const char * const g_type_names[BENCH_NB_TYPES] =
+{
+    "spinlock",
+    "ticket",
+    "mcs",
+    "rw write",
+    "rw read 7/8",
+};
+
+typedef struct BENCH_RESULT_
+{
+    uint64_t acquire_sum;
+    uint64_t acquire_max;
+    uint64_t run_cycles;
+} MSS_LOCK_ALIGNED BENCH_RESULT;
+
+/* Control, written by the E51 */
+static volatile uint32_t g_bench_seq MSS_LOCK_ALIGNED;
+static volatile uint32_t g_bench_type;
+static volatile uint32_t g_bench_mask;
+
+/* Hart status, updated with atomics */
+static volatile uint32_t g_bench_ready MSS_LOCK_ALIGNED;
+static volatile uint32_t g_bench_arrived;
+static volatile uint32_t g_bench_done;
+
+/* The locks under test, each in its own cache line */
+static volatile long g_spin_lock MSS_LOCK_ALIGNED;
+static mss_ticket_lock_t g_ticket_lock MSS_LOCK_ALIGNED;
+static mss_mcs_lock_t g_mcs_lock MSS_LOCK_ALIGNED;
+static mss_rw_lock_t g_rw_lock MSS_LOCK_ALIGNED;
+static mss_mcs_node_t g_mcs_nodes[BENCH_MAX_HARTS];
+
+/* Protected data */
+static volatile uint64_t g_shared_counter MSS_LOCK_ALIGNED;
+
+static BENCH_RESULT g_results[BENCH_MAX_HARTS];
+static uint32_t g_seen_seq[BENCH_MAX_HARTS];
+
+/*==============================================================================
+ *
+ */
+static uint32_t count_harts(uint32_t mask)
+{
+    uint32_t count = 0U;
+
+    while (0U != mask)
+    {
+        count += mask & 1U;
+        mask >>= 1U;
+    }
+
+    return (count);
+}
+
+/*==============================================================================
+ * One pass of the acquire/release loop on the calling hart
+ */
+static void run_hart(uint64_t hart_id)
+{
+    BENCH_RESULT *result = &g_results[hart_id];
+    BENCH_LOCK_TYPE type = (BENCH_LOCK_TYPE)g_bench_type;
+    uint32_t harts = count_harts(g_bench_mask);
+    uint64_t sum = 0ULL;
+    uint64_t max = 0ULL;
+    uint64_t start;
+    uint64_t latency;
+    uint64_t run_start;
+    uint32_t i;
+    bool write;
+
+    /* Start together so the harts really compete */
+    (void)mss_amoadd_w(&g_bench_arrived, 1U);
+    while (g_bench_arrived != harts)
+    {
+    }
+
+    run_start = readmcycle();
+
+    for (i = 0U; i < LOCK_BENCH_ITERATIONS; i++)
+    {
+        write = (BENCH_RW_READ_MOSTLY != type) || (0U == (i % LOCK_BENCH_WRITE_RATIO));
+
+        start = readmcycle();
+        switch (type)
+        {
+            case BENCH_SPINLOCK:
+                spinlock(&g_spin_lock);
+                break;
+            case BENCH_TICKET:
+                mss_ticket_lock(&g_ticket_lock);
+                break;
+            case BENCH_MCS:
+                mss_mcs_lock(&g_mcs_lock, &g_mcs_nodes[hart_id]);
+                break;
+            default:
+                if (write)
+                {
+                    mss_rw_write_lock(&g_rw_lock);
+                }
+                else
+                {
+                    mss_rw_read_lock(&g_rw_lock);
+                }
+                break;
+        }
+        latency = readmcycle() - start;
+
+        if (write)
+        {
+            g_shared_counter = g_shared_counter + 1ULL;
+        }
+        else
+        {
+            (void)g_shared_counter;
+        }
+        mss_lock_pause(LOCK_BENCH_HOLD_LOOPS);
+
+        switch (type)
+        {
+            case BENCH_SPINLOCK:
+                spinunlock(&g_spin_lock);
+                break;
+            case BENCH_TICKET:
+                mss_ticket_unlock(&g_ticket_lock);
+                break;
+            case BENCH_MCS:
+                mss_mcs_unlock(&g_mcs_lock, &g_mcs_nodes[hart_id]);
+                break;
+            default:
+                if (write)
+                {
+                    mss_rw_write_unlock(&g_rw_lock);
+                }
+                else
+                {
+                    mss_rw_read_unlock(&g_rw_lock);
+                }
+                break;
+        }
+
+        mss_lock_pause(LOCK_BENCH_THINK_LOOPS);
+
+        sum += latency;
+        if (latency > max)
+        {
+            max = latency;
+        }
+    }
+
+    result->acquire_sum = sum;
+    result->acquire_max = max;
+    result->run_cycles = readmcycle() - run_start;
+
+    (void)mss_amoor_w(&g_bench_done, 1U << hart_id);
+}
+
+/**
+ * lock_bench_poll()
+ */
+void lock_bench_poll(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uint32_t hart_bit = 1U << hart_id;
+    uint32_t seq;
+
+    if (0U == (g_bench_ready & hart_bit))
+    {
+        g_seen_seq[hart_id] = g_bench_seq;
+        (void)mss_amoor_w(&g_bench_ready, hart_bit);
+    }
+
+    seq = g_bench_seq;
+    if (seq != g_seen_seq[hart_id])
+    {
+        g_seen_seq[hart_id] = seq;
+        mb();
+        if (0U != (g_bench_mask & hart_bit))
+        {
+            run_hart(hart_id);
+        }
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void bench_print(HART_SHARED_DATA * hart_share, const char *text)
+{
+    mss_ticket_lock(&hart_share->uart0_lock);
+    MSS_UART_polled_tx_string(hart_share->g_mss_uart0_lo, (const uint8_t *)text);
+    mss_ticket_unlock(&hart_share->uart0_lock);
+}
+
+/*==============================================================================
+ * Run one lock type with the harts in mask, E51 included
+ */
+static void run_test(HART_SHARED_DATA * hart_share, BENCH_LOCK_TYPE type, uint32_t mask)
+{
+    char info_string[160];
+    uint32_t harts = count_harts(mask);
+    uint64_t expected;
+    uint64_t sum = 0ULL;
+    uint64_t max = 0ULL;
+    uint64_t run_cycles = 0ULL;
+    uint64_t avg;
+    uint32_t hart;
+
+    g_spin_lock = 0;
+    mss_ticket_lock_init(&g_ticket_lock);
+    mss_mcs_lock_init(&g_mcs_lock);
+    mss_rw_lock_init(&g_rw_lock);
+    g_shared_counter = 0ULL;
+    g_bench_arrived = 0U;
+    g_bench_done = 0U;
+    g_bench_type = (uint32_t)type;
+    g_bench_mask = mask;
+    mb();
+    g_bench_seq = g_bench_seq + 1U;
+    mb();
+
+    run_hart(0U);
+    while (g_bench_done != mask)
+    {
+    }
+
+    for (hart = 0U; hart < BENCH_MAX_HARTS; hart++)
+    {
+        if (0U != (mask & (1U << hart)))
+        {
+            sum += g_results[hart].acquire_sum;
+            if (g_results[hart].acquire_max > max)
+            {
+                max = g_results[hart].acquire_max;
+            }
+            if (g_results[hart].run_cycles > run_cycles)
+            {
+                run_cycles = g_results[hart].run_cycles;
+            }
+        }
+    }
+
+    expected = (uint64_t)harts * LOCK_BENCH_ITERATIONS;
+    if (BENCH_RW_READ_MOSTLY == type)
+    {
+        expected = (uint64_t)harts *
+                   ((LOCK_BENCH_ITERATIONS + LOCK_BENCH_WRITE_RATIO - 1U) / LOCK_BENCH_WRITE_RATIO);
+    }
+
+    avg = sum / ((uint64_t)harts * LOCK_BENCH_ITERATIONS);
+    sprintf(info_string,
+            "%-12s %u harts  acquire avg %5lu max %7lu cycles (%4lu ns)  %5lu kacq/s %s\r\n",
+            g_type_names[type], harts, avg, max,
+            (uint64_t)((avg * 1000ULL) / (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000000ULL)),
+            (uint64_t)(((uint64_t)harts * LOCK_BENCH_ITERATIONS *
+                        (LIBERO_SETTING_MSS_COREPLEX_CPU_CLK / 1000ULL)) / run_cycles),
+            (g_shared_counter == expected) ? "" : "COUNT ERROR");
+    bench_print(hart_share, info_string);
+}
+
+/**
+ * lock_bench_run()
+ */
+void lock_bench_run(HART_SHARED_DATA * hart_share)
+{
+    char info_string[100];
+    uint32_t available = g_bench_ready | 1U;
+    uint32_t type;
+    uint32_t mask;
+    uint32_t hart;
+
+    sprintf(info_string, "\r\nLock benchmark, %u harts available (mask 0x%x)\r\n",
+            count_harts(available), available);
+    bench_print(hart_share, info_string);
+
+    for (type = 0U; type < (uint32_t)BENCH_NB_TYPES; type++)
+    {
+        mask = 0U;
+        for (hart = 0U; hart < BENCH_MAX_HARTS; hart++)
+        {
+            if (0U != (available & (1U << hart)))
+            {
+                mask |= 1U << hart;
+                run_test(hart_share, (BENCH_LOCK_TYPE)type, mask);
+            }
+        }
+    }
+
+    bench_print(hart_share, "Lock benchmark done\r\n");
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * PC sampling profile of all awake harts
+ *
+ * The E51 publishes a command and bumps a sequence number, each U54 acts on it
+ * the next time it calls sample_profile_poll() and sets its bit in the ack
+ * mask. A hart can only start or stop its own sampling since the timer
+ * interrupt and mie are per hart.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mpfs_hal/mss_hal.h"
+#include "inc/common.h"
+#include "inc/sample_profile.h"
+
+#define PROFILE_MAX_HARTS       5U
+#define PROFILE_ACK_TIMEOUT     0x1000000U
+
+typedef enum PROFILE_CMD_
+{
+    PROFILE_CMD_NONE    = 0,
+    PROFILE_CMD_START   = 1,
+    PROFILE_CMD_STOP    = 2,
+}   PROFILE_CMD;
+
+/* Control, written by the E51 */
+static volatile uint32_t g_profile_seq MSS_LOCK_ALIGNED;
+static volatile uint32_t g_profile_cmd;
+
+/* Hart status, updated with atomics */
+static volatile uint32_t g_profile_ready MSS_LOCK_ALIGNED;
+static volatile uint32_t g_profile_ack;
+static volatile uint32_t g_profile_running;
+
+static uint32_t g_seen_seq[PROFILE_MAX_HARTS];
+static mss_prof_sample_t g_samples[PROFILE_MAX_HARTS][SAMPLE_PROFILE_SAMPLES];
+
+static HART_SHARED_DATA * g_print_share;
+
+/*==============================================================================
+ * Carry out a command on the calling hart
+ */
+static void profile_do(uint64_t hart_id, PROFILE_CMD cmd)
+{
+    uint32_t hart_bit = 1U << hart_id;
+
+    if (PROFILE_CMD_START == cmd)
+    {
+        mss_prof_init(g_samples[hart_id], SAMPLE_PROFILE_SAMPLES);
+        mss_prof_start(SAMPLE_PROFILE_RATE_HZ);
+        (void)mss_amoor_w(&g_profile_running, hart_bit);
+    }
+    else if (PROFILE_CMD_STOP == cmd)
+    {
+        mss_prof_stop();
+        (void)mss_amoand_w(&g_profile_running, ~hart_bit);
+    }
+    else
+    {
+        /* nothing to do */
+    }
+
+    (void)mss_amoor_w(&g_profile_ack, hart_bit);
+}
+
+/**
+ * sample_profile_poll()
+ */
+void sample_profile_poll(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    uint32_t hart_bit = 1U << hart_id;
+    uint32_t seq;
+
+    if (0U == (g_profile_ready & hart_bit))
+    {
+        g_seen_seq[hart_id] = g_profile_seq;
+        (void)mss_amoor_w(&g_profile_ready, hart_bit);
+    }
+
+    seq = g_profile_seq;
+    if (seq != g_seen_seq[hart_id])
+    {
+        g_seen_seq[hart_id] = seq;
+        mb();
+        profile_do(hart_id, (PROFILE_CMD)g_profile_cmd);
+    }
+}
+
+/*==============================================================================
+ *
+ */
+static void profile_print(const char *text)
+{
+    mss_ticket_lock(&g_print_share->uart0_lock);
+    MSS_UART_polled_tx_string(g_print_share->g_mss_uart0_lo, (const uint8_t *)text);
+    mss_ticket_unlock(&g_print_share->uart0_lock);
+}
+
+/*==============================================================================
+ * Send a command to the awake U54s, run it on the E51 and wait for the acks.
+ * Returns the harts which acted on it.
+ */
+static uint32_t profile_command(PROFILE_CMD cmd)
+{
+    uint32_t harts = g_profile_ready | 1U;
+    uint32_t timeout = PROFILE_ACK_TIMEOUT;
+
+    g_profile_ack = 0U;
+    g_profile_cmd = (uint32_t)cmd;
+    mb();
+    g_profile_seq = g_profile_seq + 1U;
+    mb();
+
+    profile_do(0U, cmd);
+
+    while ((g_profile_ack != harts) && (0U != timeout))
+    {
+        timeout--;
+    }
+
+    return (g_profile_ack);
+}
+
+/**
+ * sample_profile_start()
+ */
+void sample_profile_start(HART_SHARED_DATA * hart_share)
+{
+    char info_string[100];
+    uint32_t harts;
+
+    g_print_share = hart_share;
+    harts = profile_command(PROFILE_CMD_START);
+
+    sprintf(info_string, "\r\nProfiling harts 0x%x at %u Hz, type 8 to stop\r\n",
+            harts, SAMPLE_PROFILE_RATE_HZ);
+    profile_print(info_string);
+}
+
+/**
+ * sample_profile_stop()
+ */
+void sample_profile_stop(HART_SHARED_DATA * hart_share)
+{
+    uint32_t harts = g_profile_running;
+    uint32_t hart;
+
+    g_print_share = hart_share;
+    if (0U == harts)
+    {
+        profile_print("\r\nNot profiling, type 7 to start\r\n");
+        return;
+    }
+
+    (void)profile_command(PROFILE_CMD_STOP);
+
+    for (hart = 0U; hart < PROFILE_MAX_HARTS; hart++)
+    {
+        if (0U != (harts & (1U << hart)))
+        {
+            mss_prof_dump(hart, profile_print);
+        }
+    }
+}
@@ -15,6 +15,8 @@
 #include <string.h>
 #include "mpfs_hal/mss_hal.h"
 #include "inc/common.h"
+#include "inc/lock_bench.h"
+#include "inc/sample_profile.h"
 
 #ifndef SIFIVE_HIFIVE_UNLEASHED
 #include "drivers/mss/mss_mmuart/mss_uart.h"
@@ -59,23 +61,25 @@ void u54_3(void)
 
     __enable_irq();
 #ifdef  MPFS_HAL_SHARED_MEM_ENABLED
-    spinlock(&hart_share->mutex_uart0);
+    mss_ticket_lock(&hart_share->uart0_lock);
     MSS_UART_polled_tx_string(&g_mss_uart0_lo,
             "Hello World from u54 core 3 - hart3.\r\n");
-    spinunlock(&hart_share->mutex_uart0);
+    mss_ticket_unlock(&hart_share->uart0_lock);
 #endif
 
     while (1U)
     {
+        lock_bench_poll();
+        sample_profile_poll();
         icount++;
         if (0x100000U == icount)
         {
             icount = 0U;
             sprintf(info_string,"This is a message from HartID: %d, \r\n", hartid);
 #ifdef  MPFS_HAL_SHARED_MEM_ENABLED
-            spinlock(&hart_share->mutex_uart0);
+            mss_ticket_lock(&hart_share->uart0_lock);
             MSS_UART_polled_tx(&g_mss_uart0_lo, info_string, strlen(info_string));
-            spinunlock(&hart_share->mutex_uart0);
+            mss_ticket_unlock(&hart_share->uart0_lock);
 #endif
         }
     }
@@ -16,6 +16,7 @@
 #define COMMON_H_
 
 #include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
 
 typedef enum COMMAND_TYPE_
@@ -28,7 +29,7 @@ typedef enum COMMAND_TYPE_
 typedef struct HART_SHARED_DATA_
 {
     uint64_t init_marker;
-    volatile long mutex_uart0;
+    mss_ticket_lock_t uart0_lock MSS_LOCK_ALIGNED;
     mss_uart_instance_t *g_mss_uart0_lo;
 } HART_SHARED_DATA;
 
@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * Interrupt latency benchmark. Measures the cycles from raising an interrupt
+ * on the E51 to its handler running, with direct trap entry and one PLIC claim
+ * per trap, then with vectored trap entry and the PLIC claim loop.
+ *
+ */
+
+#ifndef IRQ_BENCH_H_
+#define IRQ_BENCH_H_
+
+#include "inc/common.h"
+
+#define IRQ_BENCH_ITERATIONS    256U    /* Interrupts per test */
+#define IRQ_BENCH_TIMEOUT       0x100000U
+
+/**
+ * Run all tests from the E51 and print the results on UART0
+ */
+void irq_bench_run(HART_SHARED_DATA * hart_share);
+
+/**
+ * Called first thing from the E51 software interrupt handler
+ */
+void irq_bench_soft_isr(void);
+
+#endif /* IRQ_BENCH_H_ */
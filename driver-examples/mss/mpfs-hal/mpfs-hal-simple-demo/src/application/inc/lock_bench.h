@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * Lock contention benchmark. Measures the acquire latency of the HAL locks as
+ * 1 to 5 harts compete for them.
+ *
+ * The E51 runs the benchmark from the CLI. The U54 harts take part once they
+ * have been woken and are calling lock_bench_poll() from their main loop.
+ *
+ */
+
+#ifndef LOCK_BENCH_H_
+#define LOCK_BENCH_H_
+
+#include "inc/common.h"
+
+#define LOCK_BENCH_ITERATIONS   8192U   /* Acquires per hart per test */
+#define LOCK_BENCH_HOLD_LOOPS   16U     /* Work done holding the lock */
+#define LOCK_BENCH_THINK_LOOPS  64U     /* Work done between acquires */
+#define LOCK_BENCH_WRITE_RATIO  8U      /* One write in N for the reader test */
+
+/**
+ * Run all tests from the E51 and print the results on UART0
+ */
+void lock_bench_run(HART_SHARED_DATA * hart_share);
+
+/**
+ * Called from the U54 main loops, returns straight away unless a test which
+ * includes this hart has been started
+ */
+void lock_bench_poll(void);
+
+#endif /* LOCK_BENCH_H_ */
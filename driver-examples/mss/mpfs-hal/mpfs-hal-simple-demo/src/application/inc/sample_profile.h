@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * Copyright 2019-2022 Microchip FPGA Embedded Systems Solution.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * MPFS HAL Embedded Software example
+ *
+ */
+/*******************************************************************************
+ *
+ * PC sampling profile of all awake harts, using the HAL profiler (mss_prof.h).
+ *
+ * The E51 starts and stops the profile from the CLI. Each U54 starts and stops
+ * sampling itself from sample_profile_poll(), called from its main loop. The
+ * samples are printed on UART0, to be captured and passed to
+ * tools/prof_symbolise.py.
+ *
+ */
+
+#ifndef SAMPLE_PROFILE_H_
+#define SAMPLE_PROFILE_H_
+
+#include "inc/common.h"
+
+#define SAMPLE_PROFILE_RATE_HZ  997U    /* Not a multiple of the SysTick rate */
+#define SAMPLE_PROFILE_SAMPLES  256U    /* Ring size per hart, a power of 2.
+                                           Kept small to fit in the LIM */
+
+/**
+ * Start sampling all awake harts
+ */
+void sample_profile_start(HART_SHARED_DATA * hart_share);
+
+/**
+ * Stop sampling and print the samples of each hart on UART0
+ */
+void sample_profile_stop(HART_SHARED_DATA * hart_share);
+
+/**
+ * Called from the U54 main loops, starts or stops sampling the calling hart
+ * when the E51 asks
+ */
+void sample_profile_poll(void);
+
+#endif /* SAMPLE_PROFILE_H_ */
@@ -110,6 +110,22 @@
 
 #define MPFS_HAL_SHARED_MEM_ENABLED
 
+/*
+ * Define MPFS_HAL_PROFILER to build the CLINT timer driven PC sampling
+ * profiler, see mss_prof.h. To record callers as well as the sampled PC,
+ * also define MSS_PROF_FRAME_POINTERS and build with -fno-omit-frame-pointer
+ * -mno-omit-leaf-frame-pointer.
+ */
+#define MPFS_HAL_PROFILER
+
+/*
+ * Define MPFS_HAL_VECTORED_INTERRUPTS to start the harts with mtvec in
+ * vectored mode. Software, external and local interrupts then jump straight
+ * to their handlers, saving only the caller saved registers, rather than
+ * going through trap_from_machine_mode(). See mss_entry.S.
+ */
+#define MPFS_HAL_VECTORED_INTERRUPTS
+
 
 /* define the required tick rate in Milliseconds */
 /* if this program is running on one hart only, only that particular hart value
@@ -13,6 +13,9 @@
 #include "mpfs_hal/mss_hal.h"
 
 static uint64_t g_systick_increment[5] = {0ULL,0ULL,0ULL,0ULL,0ULL};
+#ifdef MPFS_HAL_PROFILER
+static uint64_t g_systick_next[5] = {0ULL,0ULL,0ULL,0ULL,0ULL};
+#endif
 
 /**
  * call once at startup
@@ -60,6 +63,9 @@ uint32_t SysTick_Config(void)
     {
 
         CLINT->MTIMECMP[mhart_id] = CLINT->MTIME + g_systick_increment[mhart_id];
+#ifdef MPFS_HAL_PROFILER
+        g_systick_next[mhart_id] = CLINT->MTIMECMP[mhart_id];
+#endif
 
         set_csr(mie, MIP_MTIP);   /* mie Register - Machine Timer Interrupt Enable */
 
@@ -89,8 +95,41 @@ void handle_m_timer_interrupt(void)
 
     volatile uint64_t hart_id = read_csr(mhartid);
     volatile uint32_t error_loop;
+    uint64_t next_tick;
     clear_csr(mie, MIP_MTIP);
 
+#ifdef MPFS_HAL_PROFILER
+    /*
+     * The profiler shares the timer with SysTick. Take a sample if one is due
+     * and only run the SysTick handler when its own deadline has passed.
+     */
+    uint64_t next_sample = mss_prof_timer_tick(hart_id, CLINT->MTIME);
+
+    if ((0ULL == g_systick_increment[hart_id]) ||
+        (CLINT->MTIME < g_systick_next[hart_id]))
+    {
+        if (0ULL == g_systick_increment[hart_id])
+        {
+            next_tick = next_sample;
+        }
+        else if ((0ULL != next_sample) && (next_sample < g_systick_next[hart_id]))
+        {
+            next_tick = next_sample;
+        }
+        else
+        {
+            next_tick = g_systick_next[hart_id];
+        }
+
+        if (0ULL != next_tick)
+        {
+            CLINT->MTIMECMP[hart_id] = next_tick;
+            set_csr(mie, MIP_MTIP);
+        }
+        return;
+    }
+#endif
+
     switch(hart_id)
     {
         case 0U:
@@ -116,7 +155,15 @@ void handle_m_timer_interrupt(void)
             break;
     }
 
-    CLINT->MTIMECMP[read_csr(mhartid)] = CLINT->MTIME + g_systick_increment[hart_id];
+    next_tick = CLINT->MTIME + g_systick_increment[hart_id];
+#ifdef MPFS_HAL_PROFILER
+    g_systick_next[hart_id] = next_tick;
+    if ((0ULL != next_sample) && (next_sample < next_tick))
+    {
+        next_tick = next_sample;
+    }
+#endif
+    CLINT->MTIMECMP[read_csr(mhartid)] = next_tick;
 
     set_csr(mie, MIP_MTIP);
 
@@ -609,29 +609,45 @@ local_int_p_t *local_int_mux[5] =
     local_irq_handler_4_table
 };
 
+static uint32_t g_plic_claim_limit = PLIC_MAX_CLAIMS_PER_TRAP;
+
 /*------------------------------------------------------------------------------
- *
+ * Sources which became pending while a handler ran are claimed and handled in
+ * the same trap, up to the claim limit, rather than taking a trap each.
  */
 void handle_m_ext_interrupt(void)
 {
+    uint32_t claims = 0U;
+    uint32_t int_num = PLIC_ClaimIRQ();
+    uint8_t disable;
 
-    volatile uint32_t int_num  = PLIC_ClaimIRQ();
-
-    if (PLIC_INVALID_INT_OFFSET == int_num)
+    while (PLIC_INVALID_INT_OFFSET != int_num)
     {
-       return;
-    }
+        disable = ext_irq_handler_table[int_num]();
 
-    uint8_t disable = EXT_IRQ_KEEP_ENABLED;
-    disable = ext_irq_handler_table[int_num]();
+        PLIC_CompleteIRQ(int_num);
 
-    PLIC_CompleteIRQ(int_num);
+        if(EXT_IRQ_DISABLE == disable)
+        {
+            PLIC_DisableIRQ((PLIC_IRQn_Type)int_num);
+        }
 
-    if(EXT_IRQ_DISABLE == disable)
-    {
-        PLIC_DisableIRQ((PLIC_IRQn_Type)int_num);
+        claims++;
+        if (claims >= g_plic_claim_limit)
+        {
+            break;
+        }
+
+        int_num = PLIC_ClaimIRQ();
     }
+}
 
+/*------------------------------------------------------------------------------
+ *
+ */
+void PLIC_set_claim_limit(uint32_t limit)
+{
+    g_plic_claim_limit = (0U != limit) ? limit : 1U;
 }
 
 
@@ -647,6 +663,34 @@ void handle_local_interrupt(uint8_t interrupt_no)
     (*local_int_table[local_interrupt_no])();
 }
 
+#ifdef MPFS_HAL_VECTORED_INTERRUPTS
+extern void trap_vector(void);
+extern void trap_vector_table(void);
+
+/*------------------------------------------------------------------------------
+ *
+ */
+void mss_set_trap_mode(uint32_t mode)
+{
+    if (MTVEC_MODE_VECTORED == mode)
+    {
+        write_csr(mtvec, (uintptr_t)&trap_vector_table | MTVEC_MODE_VECTORED);
+    }
+    else
+    {
+        write_csr(mtvec, (uintptr_t)&trap_vector);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ *
+ */
+uint32_t mss_get_trap_mode(void)
+{
+    return ((uint32_t)(read_csr(mtvec) & MTVEC_MODE_MASK));
+}
+#endif
+
 /*------------------------------------------------------------------------------
  *
  */
@@ -672,6 +716,9 @@ void trap_from_machine_mode(uintptr_t * regs, uintptr_t dummy, uintptr_t mepc)
     else if (((mcause & MCAUSE_INT) == MCAUSE_INT) && ((mcause & MCAUSE_CAUSE)\
             == IRQ_M_TIMER))
     {
+#ifdef MPFS_HAL_PROFILER
+        mss_prof_trap_frame(regs, mepc);
+#endif
         handle_m_timer_interrupt();
     }
     else if (((mcause & MCAUSE_INT) == MCAUSE_INT) && ((mcause & MCAUSE_CAUSE)\
@@ -49,6 +49,10 @@ extern "C" {
 #define IRQ_M_LOCAL_MIN   16
 #define IRQ_M_LOCAL_MAX   63
 
+#define MTVEC_MODE_DIRECT     0
+#define MTVEC_MODE_VECTORED   1
+#define MTVEC_MODE_MASK       3
+
 #define MACHINE_STACK_SIZE  (RISCV_PGSIZE)    /* this is 4k for HLS and 4k for the stack*/
 #define MENTRY_HLS_OFFSET   (INTEGER_CONTEXT_SIZE + SOFT_FLOAT_CONTEXT_SIZE)
 #define MENTRY_FRAME_SIZE   (MENTRY_HLS_OFFSET + HLS_SIZE)
@@ -86,6 +90,17 @@ typedef struct {
 #define HLS() ((hls_t*)(MACHINE_STACK_TOP() - HLS_SIZE))
 #define OTHER_HLS(id) ((hls_t*)((void *)HLS() + RISCV_PGSIZE * ((id) - read_const_csr(mhartid))))
 
+#ifdef MPFS_HAL_VECTORED_INTERRUPTS
+/*
+ * Select direct (MTVEC_MODE_DIRECT) or vectored (MTVEC_MODE_VECTORED) trap
+ * entry for the calling hart. With MPFS_HAL_VECTORED_INTERRUPTS defined the
+ * harts start in vectored mode, this allows switching back e.g. to compare
+ * interrupt latency.
+ */
+void mss_set_trap_mode(uint32_t mode);
+uint32_t mss_get_trap_mode(void);
+#endif
+
 #endif
 
 #ifdef __cplusplus
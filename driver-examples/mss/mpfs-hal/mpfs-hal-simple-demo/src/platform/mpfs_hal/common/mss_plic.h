@@ -32,6 +32,21 @@ extern "C" {
 #define EXT_IRQ_KEEP_ENABLED                                0U
 #define EXT_IRQ_DISABLE                                     1U
 
+/*
+ * Maximum number of PLIC sources claimed and handled in one external interrupt
+ * trap. Sources still pending after this raise a new trap, so local and timer
+ * interrupts are not held off indefinitely by a busy PLIC source.
+ */
+#ifndef PLIC_MAX_CLAIMS_PER_TRAP
+#define PLIC_MAX_CLAIMS_PER_TRAP                            8U
+#endif
+
+/*
+ * Change the number of claims per trap at run time. A limit of 1 gives one
+ * trap per interrupt.
+ */
+void PLIC_set_claim_limit(uint32_t limit);
+
 /*------------------------------------------------------------------------------
  *
  */
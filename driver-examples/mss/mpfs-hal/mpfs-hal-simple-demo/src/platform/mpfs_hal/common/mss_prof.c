@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_prof.c
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Statistical PC sampling profiler driven by the CLINT timer.
+ *
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "mpfs_hal/mss_hal.h"
+
+#ifdef MPFS_HAL_PROFILER
+
+typedef struct PROF_HART_
+{
+    mss_prof_sample_t *samples;
+    uint64_t mask;
+    volatile uint64_t taken;
+    uint64_t period;                /* mtime ticks between samples */
+    uint64_t next;                  /* mtime of the next sample */
+    const uintptr_t *regs;          /* Trap frame of the current interrupt */
+    uintptr_t mepc;
+    volatile uint32_t running;
+    uint32_t rate_hz;
+} __attribute__((aligned(64))) PROF_HART;
+
+static PROF_HART g_prof[MSS_PROF_NB_HARTS];
+
+/*==============================================================================
+ * Record where the hart was interrupted
+ */
+static void prof_record(PROF_HART *p_prof)
+{
+    mss_prof_sample_t *sample = &p_prof->samples[p_prof->taken & p_prof->mask];
+    const uintptr_t *regs = p_prof->regs;
+    uint32_t depth = 1U;
+
+    sample->pc[0] = p_prof->mepc;
+
+    if ((const uintptr_t *)0 != regs)
+    {
+#ifdef MSS_PROF_FRAME_POINTERS
+        /* sp before the trap, s0 is the frame pointer. Each frame holds the
+         * return address at fp - 8 and the caller's fp at fp - 16. */
+        uintptr_t sp = (uintptr_t)regs + INTEGER_CONTEXT_SIZE;
+        uintptr_t fp = regs[8];
+        uintptr_t caller_fp;
+
+        while ((depth < MSS_PROF_DEPTH) && (fp > sp) && (fp <= (sp + MSS_PROF_STACK_SPAN)) &&
+               (0U == (fp & (sizeof(uintptr_t) - 1U))))
+        {
+            sample->pc[depth] = ((const uintptr_t *)fp)[-1];
+            caller_fp = ((const uintptr_t *)fp)[-2];
+            if (0U == sample->pc[depth])
+            {
+                break;
+            }
+            depth++;
+            if (caller_fp <= fp)
+            {
+                break;
+            }
+            fp = caller_fp;
+        }
+#else
+        if (MSS_PROF_DEPTH > 1U)
+        {
+            sample->pc[1] = regs[1];    /* ra */
+            depth = 2U;
+        }
+#endif
+    }
+
+    while (depth < MSS_PROF_DEPTH)
+    {
+        sample->pc[depth] = 0U;
+        depth++;
+    }
+
+    p_prof->taken = p_prof->taken + 1U;
+}
+
+/**
+ * mss_prof_init()
+ */
+void mss_prof_init(mss_prof_sample_t *samples, uint32_t nb_samples)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    PROF_HART *p_prof = &g_prof[hart_id];
+
+    ASSERT(hart_id < MSS_PROF_NB_HARTS);
+    ASSERT((nb_samples != 0U) && ((nb_samples & (nb_samples - 1U)) == 0U));
+
+    p_prof->running = 0U;
+    mb();
+    p_prof->samples = samples;
+    p_prof->mask = (uint64_t)nb_samples - 1U;
+    p_prof->taken = 0U;
+    p_prof->regs = (const uintptr_t *)0;
+}
+
+/**
+ * mss_prof_start()
+ */
+void mss_prof_start(uint32_t rate_hz)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    PROF_HART *p_prof = &g_prof[hart_id];
+
+    ASSERT((hart_id < MSS_PROF_NB_HARTS) && (p_prof->samples != (mss_prof_sample_t *)0));
+
+    if (rate_hz > MSS_PROF_MAX_RATE_HZ)
+    {
+        rate_hz = MSS_PROF_MAX_RATE_HZ;
+    }
+    if (0U == rate_hz)
+    {
+        rate_hz = 1U;
+    }
+
+    clear_csr(mie, MIP_MTIP);
+
+    p_prof->rate_hz = rate_hz;
+    p_prof->period = LIBERO_SETTING_MSS_RTC_TOGGLE_CLK / rate_hz;
+    p_prof->next = CLINT->MTIME + p_prof->period;
+    p_prof->running = 1U;
+
+    /* Leave an earlier SysTick deadline alone, the timer handler takes the
+     * nearer of the two each time it re-arms */
+    if (CLINT->MTIMECMP[hart_id] > p_prof->next)
+    {
+        CLINT->MTIMECMP[hart_id] = p_prof->next;
+    }
+
+    set_csr(mie, MIP_MTIP);
+    __enable_irq();
+}
+
+/**
+ * mss_prof_stop()
+ */
+void mss_prof_stop(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    ASSERT(hart_id < MSS_PROF_NB_HARTS);
+    g_prof[hart_id].running = 0U;
+    mb();
+}
+
+/**
+ * mss_prof_count()
+ */
+void mss_prof_count(uint32_t hart_id, uint64_t *taken, uint64_t *lost)
+{
+    uint64_t samples = 0U;
+    uint64_t size = 0U;
+
+    if (hart_id < MSS_PROF_NB_HARTS)
+    {
+        samples = g_prof[hart_id].taken;
+        size = (g_prof[hart_id].samples != (mss_prof_sample_t *)0) ?
+               (g_prof[hart_id].mask + 1U) : 0U;
+    }
+
+    *taken = samples;
+    *lost = (samples > size) ? (samples - size) : 0U;
+}
+
+/**
+ * mss_prof_dump()
+ */
+void mss_prof_dump(uint32_t hart_id, mss_prof_print_t print)
+{
+    char line[32U + (MSS_PROF_DEPTH * 18U)];
+    const PROF_HART *p_prof;
+    const mss_prof_sample_t *sample;
+    uint64_t taken;
+    uint64_t lost;
+    uint64_t index;
+    uint32_t depth;
+    int32_t length;
+
+    if ((hart_id >= MSS_PROF_NB_HARTS) || (g_prof[hart_id].samples == (mss_prof_sample_t *)0))
+    {
+        return;
+    }
+
+    p_prof = &g_prof[hart_id];
+    mss_prof_count(hart_id, &taken, &lost);
+
+    (void)snprintf(line, sizeof(line), "# mss_prof hart %u rate %u depth %u\r\n",
+                   hart_id, p_prof->rate_hz, MSS_PROF_DEPTH);
+    print(line);
+    (void)snprintf(line, sizeof(line), "# taken %lu lost %lu\r\n",
+                   (unsigned long)taken, (unsigned long)lost);
+    print(line);
+
+    for (index = lost; index < taken; index++)
+    {
+        sample = &p_prof->samples[index & p_prof->mask];
+        length = snprintf(line, sizeof(line), "P %u", hart_id);
+
+        for (depth = 0U; (depth < MSS_PROF_DEPTH) && (0U != sample->pc[depth]); depth++)
+        {
+            length += snprintf(&line[length], sizeof(line) - (uint32_t)length, " %lx",
+                               (unsigned long)sample->pc[depth]);
+        }
+
+        (void)snprintf(&line[length], sizeof(line) - (uint32_t)length, "\r\n");
+        print(line);
+    }
+
+    (void)snprintf(line, sizeof(line), "# end hart %u\r\n", hart_id);
+    print(line);
+}
+
+/**
+ * mss_prof_trap_frame()
+ */
+void mss_prof_trap_frame(const uintptr_t *regs, uintptr_t mepc)
+{
+    uint64_t hart_id = read_csr(mhartid);
+
+    if (hart_id < MSS_PROF_NB_HARTS)
+    {
+        g_prof[hart_id].regs = regs;
+        g_prof[hart_id].mepc = mepc;
+    }
+}
+
+/**
+ * mss_prof_timer_tick()
+ */
+uint64_t mss_prof_timer_tick(uint64_t hart_id, uint64_t now)
+{
+    PROF_HART *p_prof;
+
+    if (hart_id >= MSS_PROF_NB_HARTS)
+    {
+        return (0U);
+    }
+
+    p_prof = &g_prof[hart_id];
+    if (0U == p_prof->running)
+    {
+        return (0U);
+    }
+
+    if (now >= p_prof->next)
+    {
+        prof_record(p_prof);
+        p_prof->next += p_prof->period;
+
+        /* Fell behind, e.g. interrupts were masked. Don't try to catch up. */
+        if (p_prof->next <= now)
+        {
+            p_prof->next = now + p_prof->period;
+        }
+    }
+
+    return (p_prof->next);
+}
+
+#endif /* MPFS_HAL_PROFILER */
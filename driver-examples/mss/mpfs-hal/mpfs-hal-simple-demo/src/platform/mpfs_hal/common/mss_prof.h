@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @file mss_prof.h
+ * @author Microchip FPGA Embedded Systems Solutions
+ * @brief Statistical PC sampling profiler driven by the CLINT timer.
+ *
+ * Enabled by defining MPFS_HAL_PROFILER in mss_sw_config.h.
+ *
+ * While a hart is profiling, its machine timer interrupt fires at the sample
+ * rate as well as at its SysTick rate. Each sample records mepc, the PC the
+ * hart was interrupted at, followed by up to MSS_PROF_DEPTH - 1 callers:
+ *  - with MSS_PROF_FRAME_POINTERS defined, and the code built with
+ *    -fno-omit-frame-pointer, the frame pointer chain is walked.
+ *  - otherwise the interrupted ra is recorded as the only caller. This is only
+ *    reliable when the sampled function is a leaf, the host script discards it
+ *    when it points back into the sampled function.
+ *
+ * Samples go into a per hart ring in memory provided by the application. When
+ * the ring is full the oldest samples are overwritten and counted as lost.
+ *
+ * mss_prof_dump() prints the ring as text, one sample per line:
+ *   P <hart> <pc> <caller> <caller's caller> ..
+ * in hex, with header and trailer lines starting with '#'. Capture the UART
+ * output to a file and pass it to tools/prof_symbolise.py with the ELF to get
+ * a flat profile or folded stacks for flamegraph.pl.
+ */
+
+#ifndef MSS_PROF_H
+#define MSS_PROF_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MSS_PROF_DEPTH
+#define MSS_PROF_DEPTH          4U          /* PC plus callers per sample */
+#endif
+#define MSS_PROF_STACK_SPAN     0x10000U    /* Frame walk limit above sp */
+#define MSS_PROF_MAX_RATE_HZ    100000U
+#define MSS_PROF_NB_HARTS       5U
+
+typedef struct mss_prof_sample_t_
+{
+    uint64_t pc[MSS_PROF_DEPTH];
+} mss_prof_sample_t;
+
+/* Output function for mss_prof_dump(), called once per line */
+typedef void (*mss_prof_print_t)(const char *line);
+
+/*==============================================================================
+ * mss_prof_init() - give the calling hart a ring of nb_samples samples,
+ *   nb_samples must be a power of 2. Clears any previous samples.
+ * mss_prof_start() - start sampling the calling hart at rate_hz samples per
+ *   second of mtime. Enables the machine timer interrupt.
+ * mss_prof_stop() - stop sampling the calling hart. SysTick, if configured,
+ *   carries on.
+ * mss_prof_dump() - print the samples of hart_id, oldest first. The hart
+ *   should be stopped first.
+ * mss_prof_count() - samples taken and lost (overwritten) by hart_id since
+ *   mss_prof_init().
+ *
+ * Called by the HAL only:
+ * mss_prof_trap_frame() - records the trap frame of a timer interrupt.
+ * mss_prof_timer_tick() - takes a sample if it is due. Returns the mtime the
+ *   next sample is due at, or 0 if the hart is not profiling.
+ */
+void mss_prof_init(mss_prof_sample_t *samples, uint32_t nb_samples);
+void mss_prof_start(uint32_t rate_hz);
+void mss_prof_stop(void);
+void mss_prof_dump(uint32_t hart_id, mss_prof_print_t print);
+void mss_prof_count(uint32_t hart_id, uint64_t *taken, uint64_t *lost);
+
+void mss_prof_trap_frame(const uintptr_t *regs, uintptr_t mepc);
+uint64_t mss_prof_timer_tick(uint64_t hart_id, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MSS_PROF_H */
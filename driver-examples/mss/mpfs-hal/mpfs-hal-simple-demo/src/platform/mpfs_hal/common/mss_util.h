@@ -69,6 +69,190 @@ void __disable_local_irq(uint8_t local_interrupt);
 void disable_branch_prediction(void);
 void enable_branch_prediction(void);
 
+/*==============================================================================
+ * Inter-hart locks
+ *
+ * spinlock()/spinunlock() - test and test-and-set lock. Waiters spin on a
+ *   plain load and back off exponentially, so the line is only written when
+ *   the lock looks free. Unfair, use for short, lightly contended sections.
+ * mss_ticket_lock_t - FIFO lock. One amoadd.d takes a ticket, waiters back off
+ *   in proportion to their distance from the head of the queue.
+ * mss_mcs_lock_t - queue lock. Each waiter spins on its own node, so a release
+ *   only touches the line of the next waiter. Use for heavily contended locks.
+ *   The caller provides a node, one per hart, which must stay valid until
+ *   mss_mcs_unlock() returns.
+ * mss_rw_lock_t - any number of readers or one writer. Waiting writers block
+ *   new readers so writers are not starved.
+ *
+ * All locks must be zero initialised (or use the _init() functions) and be in
+ * memory visible to all harts. Locks should be placed in their own cache line
+ * (MSS_LOCK_ALIGNED) so lock traffic does not disturb neighbouring data.
+ */
+#define MSS_LOCK_CACHE_LINE     64U
+#define MSS_LOCK_ALIGNED        __attribute__((aligned(MSS_LOCK_CACHE_LINE)))
+#define MSS_LOCK_BACKOFF_MIN    4U      /* Pause loops, first retry */
+#define MSS_LOCK_BACKOFF_MAX    1024U   /* Pause loops, upper bound */
+#define MSS_LOCK_TICKET_BACKOFF 32U     /* Pause loops per waiter ahead of us */
+
+#define MSS_RW_WRITER           0x1U    /* Writer holds the lock */
+#define MSS_RW_WRITER_WAITING   0x2U    /* Writer waiting, hold off new readers */
+#define MSS_RW_READER           0x4U    /* One reader */
+
+typedef struct mss_ticket_lock_t_
+{
+    union
+    {
+        volatile uint64_t word;
+        struct
+        {
+            volatile uint32_t owner;    /* Ticket now being served */
+            volatile uint32_t next;     /* Next ticket to hand out */
+        } ticket;
+    } u;
+} mss_ticket_lock_t;
+
+typedef struct mss_mcs_node_t_
+{
+    struct mss_mcs_node_t_ * volatile next;
+    volatile uint64_t locked;
+} MSS_LOCK_ALIGNED mss_mcs_node_t;
+
+typedef struct mss_mcs_lock_t_
+{
+    mss_mcs_node_t * volatile tail;
+} mss_mcs_lock_t;
+
+typedef struct mss_rw_lock_t_
+{
+    volatile uint32_t word;
+} mss_rw_lock_t;
+
+/*
+ * Atomic primitives. On RISC-V these map directly to A extension
+ * instructions, otherwise fall back to the compiler builtins.
+ */
+static inline uint64_t mss_amoadd_d(volatile uint64_t *ptr, uint64_t inc)
+{
+#ifdef __riscv_atomic
+    uint64_t old;
+    __asm volatile ("amoadd.d.aq %0, %2, (%1)" : "=r"(old) : "r"(ptr), "r"(inc) : "memory");
+    return (old);
+#else
+    return (__atomic_fetch_add(ptr, inc, __ATOMIC_ACQUIRE));
+#endif
+}
+
+static inline uint32_t mss_amoadd_w(volatile uint32_t *ptr, uint32_t inc)
+{
+#ifdef __riscv_atomic
+    uint32_t old;
+    __asm volatile ("amoadd.w.aqrl %0, %2, (%1)" : "=r"(old) : "r"(ptr), "r"(inc) : "memory");
+    return (old);
+#else
+    return (__atomic_fetch_add(ptr, inc, __ATOMIC_ACQ_REL));
+#endif
+}
+
+static inline uint32_t mss_amoor_w(volatile uint32_t *ptr, uint32_t bits)
+{
+#ifdef __riscv_atomic
+    uint32_t old;
+    __asm volatile ("amoor.w.aqrl %0, %2, (%1)" : "=r"(old) : "r"(ptr), "r"(bits) : "memory");
+    return (old);
+#else
+    return (__atomic_fetch_or(ptr, bits, __ATOMIC_ACQ_REL));
+#endif
+}
+
+static inline uint32_t mss_amoand_w(volatile uint32_t *ptr, uint32_t bits)
+{
+#ifdef __riscv_atomic
+    uint32_t old;
+    __asm volatile ("amoand.w.rl %0, %2, (%1)" : "=r"(old) : "r"(ptr), "r"(bits) : "memory");
+    return (old);
+#else
+    return (__atomic_fetch_and(ptr, bits, __ATOMIC_RELEASE));
+#endif
+}
+
+static inline uint64_t mss_amoswap_d(volatile uint64_t *ptr, uint64_t value)
+{
+#ifdef __riscv_atomic
+    uint64_t old;
+    __asm volatile ("amoswap.d.aqrl %0, %2, (%1)" : "=r"(old) : "r"(ptr), "r"(value) : "memory");
+    return (old);
+#else
+    return (__atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL));
+#endif
+}
+
+/* Returns true if *ptr was expected and has been replaced by desired */
+static inline bool mss_cas_d(volatile uint64_t *ptr, uint64_t expected, uint64_t desired)
+{
+#ifdef __riscv_atomic
+    uint64_t old;
+    uint64_t fail;
+    __asm volatile (
+        "1: lr.d.aqrl %0, (%2)\n"
+        "   bne %0, %3, 2f\n"
+        "   sc.d.rl %1, %4, (%2)\n"
+        "   bnez %1, 1b\n"
+        "2:\n"
+        : "=&r"(old), "=&r"(fail)
+        : "r"(ptr), "r"(expected), "r"(desired)
+        : "memory");
+    return (old == expected);
+#else
+    return (__atomic_compare_exchange_n(ptr, &expected, desired, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+#endif
+}
+
+static inline bool mss_cas_w(volatile uint32_t *ptr, uint32_t expected, uint32_t desired)
+{
+#ifdef __riscv_atomic
+    uint32_t old;
+    uint32_t fail;
+    __asm volatile (
+        "1: lr.w.aqrl %0, (%2)\n"
+        "   bne %0, %3, 2f\n"
+        "   sc.w.rl %1, %4, (%2)\n"
+        "   bnez %1, 1b\n"
+        "2:\n"
+        : "=&r"(old), "=&r"(fail)
+        : "r"(ptr), "r"((int64_t)(int32_t)expected), "r"(desired)
+        : "memory");
+    return (old == expected);
+#else
+    return (__atomic_compare_exchange_n(ptr, &expected, desired, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+#endif
+}
+
+/*
+ * Spin for a number of loops without touching memory. With an OS we give the
+ * CPU away instead.
+ */
+static inline void mss_lock_pause(uint32_t loops)
+{
+#if defined USING_FREERTOS
+    (void)loops;
+    taskYIELD();
+#else
+    while (loops != 0U)
+    {
+        __asm volatile ("nop");
+        loops--;
+    }
+#endif
+}
+
+static inline uint32_t mss_lock_backoff(uint32_t backoff)
+{
+    mss_lock_pause(backoff);
+    return ((backoff < MSS_LOCK_BACKOFF_MAX) ? (backoff << 1U) : MSS_LOCK_BACKOFF_MAX);
+}
+
 static inline void spinunlock(volatile long *pLock)
 {
     __sync_lock_release(pLock);
@@ -76,15 +260,187 @@ static inline void spinunlock(volatile long *pLock)
 
 static inline void spinlock(volatile long *pLock)
 {
+    uint32_t backoff = MSS_LOCK_BACKOFF_MIN;
+
     while(__sync_lock_test_and_set(pLock, 1))
     {
-        /* add yield if OS */
-#if defined USING_FREERTOS
-        taskYIELD();
-#endif
+        /* Wait for the lock to look free before trying to write it again */
+        while (0 != *pLock)
+        {
+            backoff = mss_lock_backoff(backoff);
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Ticket lock. owner is the low word of the 64 bit value, so a ticket is taken
+ * by adding 1 << 32; a carry out of next is simply lost.
+ */
+static inline void mss_ticket_lock_init(mss_ticket_lock_t *lock)
+{
+    lock->u.word = 0ULL;
+    __asm volatile ("fence" ::: "memory");
+}
+
+static inline void mss_ticket_lock(mss_ticket_lock_t *lock)
+{
+    uint32_t ticket = (uint32_t)(mss_amoadd_d(&lock->u.word, 1ULL << 32U) >> 32U);
+    uint32_t ahead;
+
+    while (0U != (ahead = ticket - __atomic_load_n(&lock->u.ticket.owner, __ATOMIC_ACQUIRE)))
+    {
+        mss_lock_pause(ahead * MSS_LOCK_TICKET_BACKOFF);
+    }
+}
+
+static inline bool mss_ticket_trylock(mss_ticket_lock_t *lock)
+{
+    uint64_t word = lock->u.word;
+
+    if ((uint32_t)word != (uint32_t)(word >> 32U))
+    {
+        return (false);
+    }
+
+    return (mss_cas_d(&lock->u.word, word, word + (1ULL << 32U)));
+}
+
+static inline void mss_ticket_unlock(mss_ticket_lock_t *lock)
+{
+    /* Only the owner writes owner, a 32 bit store cannot carry into next */
+    __atomic_store_n(&lock->u.ticket.owner, lock->u.ticket.owner + 1U, __ATOMIC_RELEASE);
+}
+
+/*------------------------------------------------------------------------------
+ * MCS lock
+ */
+static inline void mss_mcs_lock_init(mss_mcs_lock_t *lock)
+{
+    lock->tail = (mss_mcs_node_t *)0;
+    __asm volatile ("fence" ::: "memory");
+}
+
+static inline void mss_mcs_lock(mss_mcs_lock_t *lock, mss_mcs_node_t *node)
+{
+    mss_mcs_node_t *pred;
+
+    node->next = (mss_mcs_node_t *)0;
+    node->locked = 1U;
+
+    pred = (mss_mcs_node_t *)(uintptr_t)mss_amoswap_d((volatile uint64_t *)&lock->tail,
+                                                      (uint64_t)(uintptr_t)node);
+    if ((mss_mcs_node_t *)0 != pred)
+    {
+        __atomic_store_n(&pred->next, node, __ATOMIC_RELEASE);
+        while (0U != __atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+        {
+            /* Our own line, the predecessor writes it once */
+            mss_lock_pause(MSS_LOCK_BACKOFF_MIN);
+        }
+    }
+}
+
+static inline bool mss_mcs_trylock(mss_mcs_lock_t *lock, mss_mcs_node_t *node)
+{
+    node->next = (mss_mcs_node_t *)0;
+    node->locked = 0U;
+
+    return (mss_cas_d((volatile uint64_t *)&lock->tail, 0ULL, (uint64_t)(uintptr_t)node));
+}
+
+static inline void mss_mcs_unlock(mss_mcs_lock_t *lock, mss_mcs_node_t *node)
+{
+    mss_mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+    if ((mss_mcs_node_t *)0 == next)
+    {
+        if (mss_cas_d((volatile uint64_t *)&lock->tail, (uint64_t)(uintptr_t)node, 0ULL))
+        {
+            return;
+        }
+
+        /* A successor has swapped itself in but not linked yet */
+        while ((mss_mcs_node_t *)0 == (next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)))
+        {
+            mss_lock_pause(MSS_LOCK_BACKOFF_MIN);
+        }
+    }
+
+    __atomic_store_n(&next->locked, 0U, __ATOMIC_RELEASE);
+}
+
+/*------------------------------------------------------------------------------
+ * Reader-writer lock
+ */
+static inline void mss_rw_lock_init(mss_rw_lock_t *lock)
+{
+    lock->word = 0U;
+    __asm volatile ("fence" ::: "memory");
+}
+
+static inline void mss_rw_read_lock(mss_rw_lock_t *lock)
+{
+    uint32_t backoff = MSS_LOCK_BACKOFF_MIN;
+
+    for (;;)
+    {
+        while (0U != (lock->word & (MSS_RW_WRITER | MSS_RW_WRITER_WAITING)))
+        {
+            backoff = mss_lock_backoff(backoff);
+        }
+
+        if (0U == (mss_amoadd_w(&lock->word, MSS_RW_READER) &
+                   (MSS_RW_WRITER | MSS_RW_WRITER_WAITING)))
+        {
+            return;
+        }
+
+        /* Lost the race with a writer, back out */
+        (void)mss_amoadd_w(&lock->word, 0U - MSS_RW_READER);
+    }
+}
+
+static inline void mss_rw_read_unlock(mss_rw_lock_t *lock)
+{
+    (void)mss_amoadd_w(&lock->word, 0U - MSS_RW_READER);
+}
+
+static inline void mss_rw_write_lock(mss_rw_lock_t *lock)
+{
+    uint32_t backoff = MSS_LOCK_BACKOFF_MIN;
+    uint32_t word;
+
+    for (;;)
+    {
+        word = lock->word;
+
+        if (0U == (word & ~MSS_RW_WRITER_WAITING))
+        {
+            /* Free, taking it clears our (or any) waiting flag */
+            if (mss_cas_w(&lock->word, word, MSS_RW_WRITER))
+            {
+                return;
+            }
+        }
+        else if (0U == (word & MSS_RW_WRITER_WAITING))
+        {
+            (void)mss_amoor_w(&lock->word, MSS_RW_WRITER_WAITING);
+        }
+        else
+        {
+            /* Already flagged */
+        }
+
+        backoff = mss_lock_backoff(backoff);
     }
 }
 
+static inline void mss_rw_write_unlock(mss_rw_lock_t *lock)
+{
+    /* Leave any waiting flag set by another writer */
+    (void)mss_amoand_w(&lock->word, ~MSS_RW_WRITER);
+}
+
 
 #ifdef __cplusplus
 }
@@ -56,6 +56,7 @@ typedef long            ssize_t;
 #include "common/mss_seg.h"
 #include "common/mss_sysreg.h"
 #include "common/mss_util.h"
+#include "common/mss_prof.h"
 #include "common/mss_mtrap.h"
 #include "common/mss_l2_cache.h"
 #include "common/mss_axiswitch.h"
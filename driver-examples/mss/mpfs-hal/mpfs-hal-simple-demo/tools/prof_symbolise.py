@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+#
+# Copyright 2019-2022 Microchip FPGA Embedded Systems Solutions.
+#
+# SPDX-License-Identifier: MIT
+#
+# Symbolise the samples printed by mss_prof_dump() against the ELF they were
+# taken from.
+#
+# The input is a capture of the UART output. Lines which don't start with
+# "P " or "# " are ignored, so the whole terminal log can be passed in.
+# Each sample line is:
+#   P <hart> <pc> <caller> <caller's caller> ..
+#
+# Outputs:
+#   flat    - samples per function, self and inclusive, per hart and in total
+#   folded  - one line per distinct stack, "hartN;outer;..;leaf count", the
+#             input format of flamegraph.pl and speedscope
+#   lines   - samples per source line of the sampled PC, uses addr2line
+#
+# Symbols come from the toolchain's nm, riscv64-unknown-elf-nm by default.
+#
+# Example:
+#   prof_symbolise.py -e LIM-Debug/mpfs-hal-simple-demo.elf putty.log
+#   prof_symbolise.py -e app.elf -m folded putty.log | flamegraph.pl > prof.svg
+#
+
+import argparse
+import bisect
+import collections
+import subprocess
+import sys
+
+DEFAULT_PREFIX = "riscv64-unknown-elf-"
+
+
+class Symbols:
+    """Address to function lookup built from nm -n -S output"""
+
+    def __init__(self, elf, prefix):
+        self.prefix = prefix
+        self.elf = elf
+        self.starts = []
+        self.entries = []
+        out = subprocess.run([prefix + "nm", "-n", "-S", "-C", elf],
+                             check=True, capture_output=True, text=True).stdout
+        for line in out.splitlines():
+            fields = line.split(None, 3)
+            if len(fields) == 4:
+                addr, size, kind, name = fields
+                size = int(size, 16)
+            elif len(fields) == 3:
+                addr, kind, name = fields
+                size = 0
+            else:
+                continue
+            if kind not in "tTwW":
+                continue
+            addr = int(addr, 16)
+            # Aliases share an address, keep the first
+            if self.starts and self.starts[-1] == addr:
+                continue
+            self.starts.append(addr)
+            self.entries.append((addr, size, name))
+
+    def lookup(self, pc):
+        """Returns (function start, name), or (None, hex pc) if unknown"""
+        index = bisect.bisect_right(self.starts, pc) - 1
+        if index >= 0:
+            addr, size, name = self.entries[index]
+            # Unsized symbols cover everything up to the next symbol
+            if size == 0 or pc < addr + size:
+                return addr, name
+        return None, "0x%x" % pc
+
+    def lines(self, pcs):
+        """Map each pc to file:line with addr2line"""
+        pcs = sorted(pcs)
+        if not pcs:
+            return {}
+        out = subprocess.run([self.prefix + "addr2line", "-e", self.elf] +
+                             ["0x%x" % pc for pc in pcs],
+                             check=True, capture_output=True, text=True).stdout
+        return dict(zip(pcs, out.splitlines()))
+
+
+def read_samples(files):
+    """Returns a list of (hart, [pc, caller, ..]) and the header lines"""
+    samples = []
+    headers = []
+    for name in files:
+        with (sys.stdin if name == "-" else open(name, errors="replace")) as f:
+            for line in f:
+                line = line.strip()
+                if line.startswith("P "):
+                    fields = line.split()
+                    try:
+                        hart = int(fields[1])
+                        pcs = [int(pc, 16) for pc in fields[2:]]
+                    except ValueError:
+                        continue
+                    if pcs:
+                        samples.append((hart, pcs))
+                elif line.startswith("# "):
+                    headers.append(line)
+    return samples, headers
+
+
+def stack_of(symbols, pcs):
+    """Function names, leaf first, of one sample"""
+    stack = []
+    leaf_addr = None
+    for depth, pc in enumerate(pcs):
+        if depth > 0:
+            # A return address points after the call, look up the call itself
+            pc -= 2
+        addr, name = symbols.lookup(pc)
+        if depth == 0:
+            leaf_addr = addr
+        elif depth == 1 and addr is not None and addr == leaf_addr:
+            # ra still pointing into the sampled function: it wasn't a leaf
+            # so ra is stale, or it is genuine recursion. Either way skip it.
+            continue
+        stack.append(name)
+    return stack
+
+
+def report_flat(symbols, samples, out):
+    per_hart = collections.defaultdict(list)
+    for hart, pcs in samples:
+        per_hart[hart].append(pcs)
+    groups = [("hart %u" % hart, per_hart[hart]) for hart in sorted(per_hart)]
+    if len(groups) > 1:
+        groups.append(("all harts", [pcs for _, pcs in samples]))
+
+    for title, group in groups:
+        total = len(group)
+        self_count = collections.Counter()
+        incl_count = collections.Counter()
+        for pcs in group:
+            stack = stack_of(symbols, pcs)
+            self_count[stack[0]] += 1
+            for name in set(stack):
+                incl_count[name] += 1
+        out.write("%s, %u samples\n" % (title, total))
+        out.write("%7s %6s %7s %6s  %s\n" % ("self", "%", "incl", "%", "function"))
+        for name, count in sorted(incl_count.items(),
+                                  key=lambda item: (-self_count[item[0]], -item[1], item[0])):
+            out.write("%7u %5.1f%% %7u %5.1f%%  %s\n" %
+                      (self_count[name], 100.0 * self_count[name] / total,
+                       count, 100.0 * count / total, name))
+        out.write("\n")
+
+
+def report_folded(symbols, samples, out):
+    folded = collections.Counter()
+    for hart, pcs in samples:
+        stack = stack_of(symbols, pcs)
+        folded[";".join(["hart%u" % hart] + stack[::-1])] += 1
+    for stack, count in sorted(folded.items()):
+        out.write("%s %u\n" % (stack, count))
+
+
+def report_lines(symbols, samples, out):
+    counts = collections.Counter(pcs[0] for _, pcs in samples)
+    where = symbols.lines(counts.keys())
+    per_line = collections.Counter()
+    for pc, count in counts.items():
+        per_line[(where.get(pc, "??"), symbols.lookup(pc)[1])] += count
+    total = len(samples)
+    for (line, name), count in per_line.most_common():
+        out.write("%7u %5.1f%%  %s  %s\n" % (count, 100.0 * count / total, name, line))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Symbolise mss_prof samples against an ELF")
+    parser.add_argument("-e", "--elf", required=True, help="the profiled ELF")
+    parser.add_argument("-m", "--mode", choices=("flat", "folded", "lines"),
+                        default="flat", help="output format (default flat)")
+    parser.add_argument("-p", "--prefix", default=DEFAULT_PREFIX,
+                        help="toolchain prefix (default %s)" % DEFAULT_PREFIX)
+    parser.add_argument("--hart", type=int, action="append",
+                        help="only use samples from this hart, may be repeated")
+    parser.add_argument("-o", "--output", help="write to a file, not stdout")
+    parser.add_argument("capture", nargs="*", default=["-"],
+                        help="UART capture(s), stdin if none")
+    args = parser.parse_args()
+
+    samples, headers = read_samples(args.capture)
+    if args.hart:
+        samples = [sample for sample in samples if sample[0] in args.hart]
+    if not samples:
+        sys.exit("no samples found")
+
+    symbols = Symbols(args.elf, args.prefix)
+    out = open(args.output, "w") if args.output else sys.stdout
+
+    if args.mode == "flat":
+        for line in headers:
+            out.write(line + "\n")
+        out.write("\n")
+        report_flat(symbols, samples, out)
+    elif args.mode == "folded":
+        report_folded(symbols, samples, out)
+    else:
+        report_lines(symbols, samples, out)
+
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -47,6 +47,7 @@
 #include "drivers/mss/mss_ethernet_mac/phy.h"
 
 #include "ptp_packets.h"
+#include "ptp_clock.h"
 #if defined(MSS_MAC_USE_DDR) && (MSS_MAC_USE_DDR == MSS_MAC_MEM_CRYPTO)
 /*
  * The crypto libraries have been removed from the example projects as they are
@@ -523,6 +524,8 @@ packet_tx_complete_handler0(/* mss_mac_instance_t*/ void *this_mac,
     {
         g_tx_ts_count0++;
     }
+
+    ptp_clock_tx_complete((mss_mac_instance_t *)this_mac, cdesc, caller_info);
 #endif
 }
 
@@ -567,6 +570,8 @@ packet_tx_complete_handler1(/* mss_mac_instance_t*/ void *this_mac,
     {
         g_tx_ts_count1++;
     }
+
+    ptp_clock_tx_complete((mss_mac_instance_t *)this_mac, cdesc, caller_info);
 #endif
 }
 
@@ -611,6 +616,7 @@ mac_rx_callback0(
 {
     (void)caller_info;
     int32_t tx_status;
+    uint32_t ptp_frame = 0U;
 
     /*
      * Looking for packet so grab a copy
@@ -638,9 +644,12 @@ mac_rx_callback0(
     {
         g_rx_ts_count0++;
     }
+
+    /* PTP clock messages are consumed here and never looped back */
+    ptp_frame = ptp_clock_rx((mss_mac_instance_t *)this_mac, p_rx_packet, pckt_length, cdesc);
 #endif
 
-    if (g_loopback0) /* Send what we receive if set to loopback */
+    if (g_loopback0 && (0U == ptp_frame)) /* Send what we receive if set to loopback */
     {
         /*
          * We send back any packets we receive (with optional extra bytes to
@@ -841,6 +850,7 @@ mac_rx_callback1(
 {
     (void)caller_info;
     int32_t tx_status;
+    uint32_t ptp_frame = 0U;
 
     /*
      * Looking for packet so grab a copy
@@ -868,9 +878,12 @@ mac_rx_callback1(
     {
         g_rx_ts_count1++;
     }
+
+    /* PTP clock messages are consumed here and never looped back */
+    ptp_frame = ptp_clock_rx((mss_mac_instance_t *)this_mac, p_rx_packet, pckt_length, cdesc);
 #endif
 
-    if (g_loopback1) /* Send what we receive if set to loopback */
+    if (g_loopback1 && (0U == ptp_frame)) /* Send what we receive if set to loopback */
     {
         /*
          * We send back any packets we receive (with an optional extra byte to
@@ -1865,6 +1878,14 @@ print_help(void)
             "x - Toggle PHY register dump mode ---------(%s)\n\r",
             g_phy_dump ? "enabled" : "disabled");
     PRINT_STRING(info_string);
+#if defined(MSS_MAC_TIME_STAMPED_MODE)
+    sprintf(info_string, "y - Display PTP clock offset and jitter statistics\n\r");
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Y - Start/stop PTP clock, GEM0 master -----(%s)\n\r",
+            ptp_clock_running() ? "running" : "stopped");
+    PRINT_STRING(info_string);
+#endif
     sprintf(info_string,
             "z - Toggle FCS passthrough mode -----------(%s)\n\r",
             g_crc ? "enabled" : "disabled");
@@ -1994,6 +2015,56 @@ static uint64_t mac_tx_good = 0; /* P3 reg 15 */
 static uint32_t mac_tx_err = 0; /* P3 reg 16 */
 #endif
 
+#if defined(MSS_MAC_TIME_STAMPED_MODE)
+/*==============================================================================
+ * Display the PTP clock servo state and the offset statistics since the last
+ * step or clear.
+ */
+static void
+ptp_stats_dump(void)
+{
+    char info_string[200];
+    ptp_clock_stats_t stats;
+
+    ptp_clock_get_stats(&stats);
+
+    sprintf(info_string,
+            "PTP clock %s, GEM0 master, GEM1 slave\n\r",
+            ptp_clock_running() ? "running" : "stopped");
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Samples %u, steps %u, frequency adjust %" PRId64 " ppb\n\r",
+            stats.samples,
+            stats.steps,
+            stats.freq_ppb);
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Offset last %" PRId64 " min %" PRId64 " max %" PRId64 " mean %" PRId64 " ns\n\r",
+            stats.last_offset,
+            stats.min_offset,
+            stats.max_offset,
+            stats.mean_offset);
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Offset RMS %" PRIu64 " ns, jitter %" PRIu64 " ns\n\r",
+            stats.rms_offset,
+            stats.jitter);
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Path delay last %" PRId64 " mean %" PRId64 " ns\n\r",
+            stats.last_delay,
+            stats.mean_delay);
+    PRINT_STRING(info_string);
+    sprintf(info_string,
+            "Missing TX TS %u, missing RX TS %u, TX busy %u, sequence errors %u\n\r",
+            stats.tx_ts_missing,
+            stats.rx_ts_missing,
+            stats.tx_busy,
+            stats.sequence_errors);
+    PRINT_STRING(info_string);
+}
+
+#endif
 /*==============================================================================
  *
  */
@@ -3417,6 +3488,9 @@ e51_task(void *pvParameters)
     while (1)
     {
         prvLinkStatusTask();
+#if defined(MSS_MAC_TIME_STAMPED_MODE)
+        ptp_clock_task(g_tick_counter);
+#endif
 #ifdef TEST_SW_INT
         raise_soft_interrupt((uint32_t)1);
 #endif
@@ -4988,6 +5062,32 @@ e51_task(void *pvParameters)
                     PRINT_STRING("Phy register dump disabled\n\r");
                 }
             }
+#if defined(MSS_MAC_TIME_STAMPED_MODE)
+            else if (rx_buff[0] == 'y')
+            {
+                ptp_stats_dump();
+                ptp_clock_clear_stats();
+            }
+            else if (rx_buff[0] == 'Y')
+            {
+                if (ptp_clock_running())
+                {
+                    ptp_clock_stop();
+                    PRINT_STRING("PTP clock stopped\n\r");
+                }
+                else
+                {
+                    if (g_loopback0 || g_loopback1)
+                    {
+                        PRINT_STRING("Note. software loopback hides TX time stamps from "
+                                     "the PTP clock, use 'l' to disable it.\n\r");
+                    }
+
+                    ptp_clock_start(&g_mac0, &g_mac1);
+                    PRINT_STRING("PTP clock started, GEM0 master, GEM1 slave\n\r");
+                }
+            }
+#endif
             else if (rx_buff[0] == 'z')
             {
                 if (g_crc)
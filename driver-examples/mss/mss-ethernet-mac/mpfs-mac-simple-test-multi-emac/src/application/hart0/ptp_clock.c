@@ -0,0 +1,785 @@
+/***********************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * IEEE 1588 ordinary clock on the GEM TSU. See ptp_clock.h.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mpfs_hal/mss_hal.h"
+
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_registers.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_sw_cfg.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_regs.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+
+#include "ptp_packets.h"
+#include "ptp_clock.h"
+
+#if defined(MSS_MAC_TIME_STAMPED_MODE)
+
+#define PTP_ETHERTYPE       0x88F7U
+#define PTP_ETH_HDR_LEN     14U
+#define PTP_HDR_LEN         34U
+#define PTP_MIN_FRAME       60U
+#define PTP_FRAME_MAX       64U
+
+/* messageType values */
+#define PTP_MSG_SYNC        0x0U
+#define PTP_MSG_DELAY_REQ   0x1U
+#define PTP_MSG_FOLLOW_UP   0x8U
+#define PTP_MSG_DELAY_RESP  0x9U
+
+/* Offsets into the PTP header and bodies */
+#define PTP_OFF_TYPE        0U
+#define PTP_OFF_VERSION     1U
+#define PTP_OFF_LENGTH      2U
+#define PTP_OFF_DOMAIN      4U
+#define PTP_OFF_FLAGS       6U
+#define PTP_OFF_PORT_ID     20U
+#define PTP_OFF_SEQUENCE    30U
+#define PTP_OFF_CONTROL     32U
+#define PTP_OFF_INTERVAL    33U
+#define PTP_OFF_TIMESTAMP   34U
+#define PTP_OFF_REQ_PORT_ID 44U
+
+#define PTP_PORT_ID_LEN     10U
+#define PTP_TIMESTAMP_LEN   10U
+#define PTP_FLAG_TWO_STEP   0x02U /* First octet of flagField */
+
+#define PTP_NS_PER_SEC      1000000000LL
+#define PTP_DESC_SECS_MASK  0x3FU /* Seconds bits held in a descriptor */
+#define PTP_MAX_ADJUST_NS   ((int64_t)GEM_TSU_NANOSECONDS)
+
+/* Send slots, one buffer per message type as several may be in flight */
+typedef enum ptp_tx_slot
+{
+    PTP_TX_SYNC = 0,
+    PTP_TX_FOLLOW_UP,
+    PTP_TX_DELAY_REQ,
+    PTP_TX_DELAY_RESP,
+    PTP_TX_SLOTS
+} ptp_tx_slot_t;
+
+static const uint8_t g_ptp_mcast[6] = {0x01, 0x1B, 0x19, 0x00, 0x00, 0x00};
+
+static uint8_t g_ptp_tx_buf[PTP_TX_SLOTS][PTP_FRAME_MAX] __attribute__((aligned(8)));
+
+/* Passed as caller_info so the TX callback knows which event completed */
+static const uint8_t g_ptp_tx_tag[PTP_TX_SLOTS] = {PTP_TX_SYNC,
+                                                   PTP_TX_FOLLOW_UP,
+                                                   PTP_TX_DELAY_REQ,
+                                                   PTP_TX_DELAY_RESP};
+
+static mss_mac_instance_t *volatile g_ptp_master = 0;
+static mss_mac_instance_t *volatile g_ptp_slave = 0;
+static volatile uint32_t g_ptp_running = 0U;
+
+static uint8_t g_master_port_id[PTP_PORT_ID_LEN];
+static uint8_t g_slave_port_id[PTP_PORT_ID_LEN];
+
+/* Master side. Written in the MAC callbacks, consumed by ptp_clock_task() */
+static uint64_t g_next_sync_ms;
+static uint16_t g_sync_seq;
+static volatile uint16_t g_sync_tx_seq; /* Sequence id of the Sync being sent */
+static volatile int64_t g_master_t1;
+static volatile uint16_t g_master_t1_seq;
+static volatile uint32_t g_master_t1_valid;
+static volatile int64_t g_master_t4;
+static volatile uint16_t g_master_t4_seq;
+static volatile uint32_t g_master_t4_valid;
+static uint8_t g_master_req_port_id[PTP_PORT_ID_LEN];
+
+/* Slave side, one exchange at a time identified by the Sync sequence id */
+static volatile uint16_t g_slave_seq;
+static volatile int64_t g_slave_t1;
+static volatile int64_t g_slave_t2;
+static volatile int64_t g_slave_t3;
+static volatile int64_t g_slave_t4;
+static volatile uint32_t g_slave_have_t1;
+static volatile uint32_t g_slave_have_t2;
+static volatile uint32_t g_slave_have_t3;
+static volatile uint32_t g_slave_have_t4;
+static volatile uint32_t g_slave_req_sent;
+
+/* Servo */
+static int64_t g_drift_ppb;
+static int64_t g_freq_ppb;
+
+/* Statistics accumulators */
+static ptp_clock_stats_t g_ptp_stats;
+static int64_t g_offset_sum;
+static uint64_t g_offset_sum_sq;
+static int64_t g_delay_sum;
+
+/**=============================================================================
+ * Integer square root, used for the RMS and jitter figures
+ */
+static uint64_t
+ptp_isqrt(uint64_t value)
+{
+    uint64_t root = 0U;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (0U != bit)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (root);
+}
+
+/**=============================================================================
+ *
+ */
+static int64_t
+ptp_tsu_to_ns(const mss_mac_tsu_time_t *tsu_time)
+{
+    uint64_t secs = ((uint64_t)tsu_time->secs_msb << 32) | tsu_time->secs_lsb;
+
+    return ((int64_t)secs * PTP_NS_PER_SEC + (int64_t)tsu_time->nanoseconds);
+}
+
+/**=============================================================================
+ * Convert a descriptor time stamp to a full TSU time. The descriptor holds
+ * nanoseconds and seconds bits 1:0 in the first word and seconds bits 5:2 in
+ * the second. The time stamp is always in the recent past so the rest of the
+ * seconds count is taken from the current TSU value.
+ */
+static int64_t
+ptp_desc_to_ns(const mss_mac_instance_t *this_mac, uint32_t nano_seconds, uint32_t seconds)
+{
+    mss_mac_tsu_time_t now;
+    uint64_t now_secs;
+    uint64_t ts_secs;
+
+    MSS_MAC_read_TSU(this_mac, &now);
+    now_secs = ((uint64_t)now.secs_msb << 32) | now.secs_lsb;
+
+    ts_secs = ((seconds & 0xFU) << 2) | ((nano_seconds >> 30) & 3U);
+    ts_secs = now_secs - ((now_secs - ts_secs) & PTP_DESC_SECS_MASK);
+
+    return ((int64_t)ts_secs * PTP_NS_PER_SEC + (int64_t)(nano_seconds & GEM_TSU_NANOSECONDS));
+}
+
+/**=============================================================================
+ * PTP timestamps are 48 bits of seconds plus 32 bits of nanoseconds, big endian
+ */
+static void
+ptp_put_timestamp(uint8_t *p_dest, int64_t time_ns)
+{
+    uint64_t secs = (uint64_t)(time_ns / PTP_NS_PER_SEC);
+    uint32_t nsecs = (uint32_t)(time_ns % PTP_NS_PER_SEC);
+    uint32_t index;
+
+    for (index = 0U; index != 6U; index++)
+    {
+        p_dest[index] = (uint8_t)(secs >> (40U - (index * 8U)));
+    }
+
+    for (index = 0U; index != 4U; index++)
+    {
+        p_dest[6U + index] = (uint8_t)(nsecs >> (24U - (index * 8U)));
+    }
+}
+
+/**=============================================================================
+ *
+ */
+static int64_t
+ptp_get_timestamp(const uint8_t *p_src)
+{
+    uint64_t secs = 0U;
+    uint32_t nsecs = 0U;
+    uint32_t index;
+
+    for (index = 0U; index != 6U; index++)
+    {
+        secs = (secs << 8) | p_src[index];
+    }
+
+    for (index = 6U; index != PTP_TIMESTAMP_LEN; index++)
+    {
+        nsecs = (nsecs << 8) | p_src[index];
+    }
+
+    return ((int64_t)secs * PTP_NS_PER_SEC + (int64_t)nsecs);
+}
+
+/**=============================================================================
+ * Port identity is an EUI-64 clock identity formed from the MAC address plus
+ * port number 1
+ */
+static void
+ptp_make_port_id(uint8_t *p_port_id, const mss_mac_instance_t *this_mac)
+{
+    p_port_id[0] = this_mac->mac_addr[0];
+    p_port_id[1] = this_mac->mac_addr[1];
+    p_port_id[2] = this_mac->mac_addr[2];
+    p_port_id[3] = 0xFFU;
+    p_port_id[4] = 0xFEU;
+    p_port_id[5] = this_mac->mac_addr[3];
+    p_port_id[6] = this_mac->mac_addr[4];
+    p_port_id[7] = this_mac->mac_addr[5];
+    p_port_id[8] = 0x00U;
+    p_port_id[9] = 0x01U;
+}
+
+/**=============================================================================
+ * Build and queue one message. Returns non zero if the frame was handed to
+ * the MAC, otherwise the caller retries on the next pass.
+ */
+static uint32_t
+ptp_send(mss_mac_instance_t *this_mac,
+         ptp_tx_slot_t slot,
+         uint8_t msg_type,
+         uint16_t seq,
+         const uint8_t *p_port_id,
+         int64_t time_ns,
+         const uint8_t *p_req_port_id)
+{
+    uint8_t *p_frame = g_ptp_tx_buf[slot];
+    uint8_t *p_ptp = p_frame + PTP_ETH_HDR_LEN;
+    uint32_t msg_len = PTP_HDR_LEN + PTP_TIMESTAMP_LEN;
+    uint32_t frame_len;
+    uint8_t control;
+    int8_t interval;
+
+    if (PTP_MSG_DELAY_RESP == msg_type)
+    {
+        msg_len += PTP_PORT_ID_LEN;
+    }
+
+    memset(p_frame, 0, PTP_FRAME_MAX);
+    memcpy(p_frame, g_ptp_mcast, 6);
+    memcpy(p_frame + 6, this_mac->mac_addr, 6);
+    p_frame[12] = (uint8_t)(PTP_ETHERTYPE >> 8);
+    p_frame[13] = (uint8_t)PTP_ETHERTYPE;
+
+    p_ptp[PTP_OFF_TYPE] = msg_type;
+    p_ptp[PTP_OFF_VERSION] = 2U;
+    p_ptp[PTP_OFF_LENGTH] = (uint8_t)(msg_len >> 8);
+    p_ptp[PTP_OFF_LENGTH + 1U] = (uint8_t)msg_len;
+    p_ptp[PTP_OFF_DOMAIN] = 0U;
+    memcpy(&p_ptp[PTP_OFF_PORT_ID], p_port_id, PTP_PORT_ID_LEN);
+    p_ptp[PTP_OFF_SEQUENCE] = (uint8_t)(seq >> 8);
+    p_ptp[PTP_OFF_SEQUENCE + 1U] = (uint8_t)seq;
+
+    interval = 0x7F; /* Not used for Delay_Req */
+    switch (msg_type)
+    {
+        case PTP_MSG_SYNC:
+            control = 0U;
+            interval = -3;
+            p_ptp[PTP_OFF_FLAGS] = PTP_FLAG_TWO_STEP;
+            break;
+
+        case PTP_MSG_DELAY_REQ:
+            control = 1U;
+            break;
+
+        case PTP_MSG_FOLLOW_UP:
+            control = 2U;
+            interval = -3;
+            ptp_put_timestamp(&p_ptp[PTP_OFF_TIMESTAMP], time_ns);
+            break;
+
+        default: /* PTP_MSG_DELAY_RESP */
+            control = 3U;
+            interval = 0;
+            ptp_put_timestamp(&p_ptp[PTP_OFF_TIMESTAMP], time_ns);
+            memcpy(&p_ptp[PTP_OFF_REQ_PORT_ID], p_req_port_id, PTP_PORT_ID_LEN);
+            break;
+    }
+
+    p_ptp[PTP_OFF_CONTROL] = control;
+    p_ptp[PTP_OFF_INTERVAL] = (uint8_t)interval;
+
+    frame_len = PTP_ETH_HDR_LEN + msg_len;
+    if (frame_len < PTP_MIN_FRAME)
+    {
+        frame_len = PTP_MIN_FRAME;
+    }
+
+    if (MSS_MAC_SUCCESS !=
+        MSS_MAC_send_pkt(this_mac, 0, p_frame, frame_len, (void *)&g_ptp_tx_tag[slot]))
+    {
+        g_ptp_stats.tx_busy++;
+        return (0U);
+    }
+
+    return (1U);
+}
+
+/**=============================================================================
+ * Move the slave clock by -offset_ns. The adjust register handles steps up to
+ * about 1 second, anything larger reloads the TSU count.
+ */
+static void
+ptp_step_slave(int64_t offset_ns)
+{
+    mss_mac_tsu_time_t now;
+    mss_mac_tsu_config_t tsu_cfg;
+    uint64_t increment;
+    int64_t time_ns;
+
+    if ((offset_ns < PTP_MAX_ADJUST_NS) && (offset_ns > -PTP_MAX_ADJUST_NS))
+    {
+        MSS_MAC_adjust_TSU(g_ptp_slave, (int32_t)(-offset_ns));
+    }
+    else
+    {
+        increment = ((uint64_t)PTP_CLOCK_NS_INC << 24);
+        increment += (uint64_t)(((int64_t)increment * g_freq_ppb) / PTP_NS_PER_SEC);
+
+        MSS_MAC_read_TSU(g_ptp_slave, &now);
+        time_ns = ptp_tsu_to_ns(&now) - offset_ns;
+
+        tsu_cfg.secs_msb = (uint32_t)((uint64_t)(time_ns / PTP_NS_PER_SEC) >> 32);
+        tsu_cfg.secs_lsb = (uint32_t)(time_ns / PTP_NS_PER_SEC);
+        tsu_cfg.nanoseconds = (uint32_t)(time_ns % PTP_NS_PER_SEC);
+        tsu_cfg.ns_inc = (uint32_t)(increment >> 24);
+        tsu_cfg.sub_ns_inc = (uint32_t)(increment & 0xFFFFFFU);
+
+        MSS_MAC_init_TSU(g_ptp_slave, &tsu_cfg);
+    }
+}
+
+/**=============================================================================
+ * PI servo. Offset is slave - master so a positive offset slows the slave down.
+ * Gains are scaled by the sync interval so they read as per second values.
+ */
+static void
+ptp_servo(int64_t offset_ns)
+{
+    uint64_t increment;
+    int64_t p_term;
+
+    p_term = (offset_ns * PTP_CLOCK_KP) / (int64_t)PTP_CLOCK_SYNC_INTERVAL_MS;
+    g_drift_ppb += (offset_ns * PTP_CLOCK_KI) / (int64_t)PTP_CLOCK_SYNC_INTERVAL_MS;
+
+    if (g_drift_ppb > PTP_CLOCK_MAX_PPB)
+    {
+        g_drift_ppb = PTP_CLOCK_MAX_PPB;
+    }
+    else if (g_drift_ppb < -PTP_CLOCK_MAX_PPB)
+    {
+        g_drift_ppb = -PTP_CLOCK_MAX_PPB;
+    }
+
+    g_freq_ppb = -(p_term + g_drift_ppb);
+    if (g_freq_ppb > PTP_CLOCK_MAX_PPB)
+    {
+        g_freq_ppb = PTP_CLOCK_MAX_PPB;
+    }
+    else if (g_freq_ppb < -PTP_CLOCK_MAX_PPB)
+    {
+        g_freq_ppb = -PTP_CLOCK_MAX_PPB;
+    }
+
+    /* Increment in 1/2^24 ns units, ~0.0075ppb resolution at 8ns */
+    increment = ((uint64_t)PTP_CLOCK_NS_INC << 24);
+    increment += (uint64_t)(((int64_t)increment * g_freq_ppb) / PTP_NS_PER_SEC);
+
+    MSS_MAC_set_TSU_increment(g_ptp_slave,
+                              (uint32_t)(increment >> 24),
+                              (uint32_t)(increment & 0xFFFFFFU));
+}
+
+/**=============================================================================
+ * Slave exchange complete - work out offset and path delay
+ */
+static void
+ptp_slave_sample(void)
+{
+    int64_t ms_delay = g_slave_t2 - g_slave_t1;
+    int64_t sm_delay = g_slave_t4 - g_slave_t3;
+    int64_t offset = (ms_delay - sm_delay) / 2;
+    int64_t delay = (ms_delay + sm_delay) / 2;
+
+    if ((offset > PTP_CLOCK_STEP_THRESHOLD_NS) || (offset < -PTP_CLOCK_STEP_THRESHOLD_NS))
+    {
+        ptp_step_slave(offset);
+        ptp_clock_clear_stats();
+        g_ptp_stats.steps++;
+        g_ptp_stats.last_offset = offset;
+        return;
+    }
+
+    ptp_servo(offset);
+
+    if ((0U == g_ptp_stats.samples) || (offset < g_ptp_stats.min_offset))
+    {
+        g_ptp_stats.min_offset = offset;
+    }
+
+    if ((0U == g_ptp_stats.samples) || (offset > g_ptp_stats.max_offset))
+    {
+        g_ptp_stats.max_offset = offset;
+    }
+
+    g_ptp_stats.samples++;
+    g_ptp_stats.last_offset = offset;
+    g_ptp_stats.last_delay = delay;
+    g_offset_sum += offset;
+    g_offset_sum_sq += (uint64_t)(offset * offset);
+    g_delay_sum += delay;
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_start(mss_mac_instance_t *master, mss_mac_instance_t *slave)
+{
+    uint64_t hash;
+
+    g_ptp_running = 0U;
+    g_ptp_master = master;
+    g_ptp_slave = slave;
+
+    ptp_make_port_id(g_master_port_id, master);
+    ptp_make_port_id(g_slave_port_id, slave);
+
+    /* Time stamp event messages only and leave outgoing frames untouched */
+    MSS_MAC_set_TSU_rx_mode(master, MSS_MAC_TSU_MODE_PTP_EVENT);
+    MSS_MAC_set_TSU_tx_mode(master, MSS_MAC_TSU_MODE_PTP_EVENT);
+    MSS_MAC_set_TSU_oss_mode(master, MSS_MAC_OSS_MODE_DISABLED);
+    MSS_MAC_set_TSU_rx_mode(slave, MSS_MAC_TSU_MODE_PTP_EVENT);
+    MSS_MAC_set_TSU_tx_mode(slave, MSS_MAC_TSU_MODE_PTP_EVENT);
+    MSS_MAC_set_TSU_oss_mode(slave, MSS_MAC_OSS_MODE_DISABLED);
+
+    /* Accept the PTP multicast address on both ports */
+    hash = 1ULL << calc_gem_hash_index((uint8_t *)g_ptp_mcast);
+    MSS_MAC_set_hash_mode(master, MSS_MAC_HASH_MULTICAST);
+    MSS_MAC_set_hash(master, MSS_MAC_get_hash(master) | hash);
+    MSS_MAC_set_hash_mode(slave, MSS_MAC_HASH_MULTICAST);
+    MSS_MAC_set_hash(slave, MSS_MAC_get_hash(slave) | hash);
+
+    /* Start from the nominal rate */
+    g_drift_ppb = 0;
+    g_freq_ppb = 0;
+    MSS_MAC_set_TSU_increment(slave, PTP_CLOCK_NS_INC, 0U);
+
+    g_sync_seq = 0U;
+    g_sync_tx_seq = 0U;
+    g_next_sync_ms = 0U;
+    g_master_t1_valid = 0U;
+    g_master_t4_valid = 0U;
+    g_slave_have_t1 = 0U;
+    g_slave_have_t2 = 0U;
+    g_slave_have_t3 = 0U;
+    g_slave_have_t4 = 0U;
+    g_slave_req_sent = 0U;
+
+    ptp_clock_clear_stats();
+    g_ptp_stats.steps = 0U;
+    g_ptp_stats.tx_ts_missing = 0U;
+    g_ptp_stats.rx_ts_missing = 0U;
+    g_ptp_stats.tx_busy = 0U;
+    g_ptp_stats.sequence_errors = 0U;
+
+    g_ptp_running = 1U;
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_stop(void)
+{
+    g_ptp_running = 0U;
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+uint32_t
+ptp_clock_running(void)
+{
+    return (g_ptp_running);
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_task(uint64_t now_ms)
+{
+    uint16_t seq;
+
+    if (0U == g_ptp_running)
+    {
+        return;
+    }
+
+    /* Master: periodic Sync then Follow_Up once the Sync has left */
+    if (now_ms >= g_next_sync_ms)
+    {
+        /* Set before sending as the TX callback may run before we return */
+        g_sync_tx_seq = (uint16_t)(g_sync_seq + 1U);
+        if (0U != ptp_send(g_ptp_master, PTP_TX_SYNC, PTP_MSG_SYNC, g_sync_tx_seq,
+                           g_master_port_id, 0, 0))
+        {
+            g_sync_seq = g_sync_tx_seq;
+            g_next_sync_ms = now_ms + PTP_CLOCK_SYNC_INTERVAL_MS;
+        }
+    }
+
+    if (0U != g_master_t1_valid)
+    {
+        if (0U != ptp_send(g_ptp_master, PTP_TX_FOLLOW_UP, PTP_MSG_FOLLOW_UP, g_master_t1_seq,
+                           g_master_port_id, g_master_t1, 0))
+        {
+            g_master_t1_valid = 0U;
+        }
+    }
+
+    if (0U != g_master_t4_valid)
+    {
+        if (0U != ptp_send(g_ptp_master, PTP_TX_DELAY_RESP, PTP_MSG_DELAY_RESP, g_master_t4_seq,
+                           g_master_port_id, g_master_t4, g_master_req_port_id))
+        {
+            g_master_t4_valid = 0U;
+        }
+    }
+
+    /* Slave: Delay_Req once Sync and Follow_Up are in, servo once all 4 are */
+    seq = g_slave_seq;
+    if ((0U != g_slave_have_t1) && (0U != g_slave_have_t2) && (0U == g_slave_req_sent))
+    {
+        if (0U != ptp_send(g_ptp_slave, PTP_TX_DELAY_REQ, PTP_MSG_DELAY_REQ, seq,
+                           g_slave_port_id, 0, 0))
+        {
+            g_slave_req_sent = 1U;
+        }
+    }
+
+    if ((0U != g_slave_have_t3) && (0U != g_slave_have_t4) && (seq == g_slave_seq))
+    {
+        g_slave_have_t3 = 0U;
+        g_slave_have_t4 = 0U;
+        ptp_slave_sample();
+    }
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+uint32_t
+ptp_clock_rx(const mss_mac_instance_t *this_mac,
+             const uint8_t *p_rx_packet,
+             uint32_t pckt_length,
+             const mss_mac_rx_desc_t *cdesc)
+{
+    const uint8_t *p_ptp = p_rx_packet + PTP_ETH_HDR_LEN;
+    uint32_t have_ts = (0U != (cdesc->addr_low & GEM_RX_DMA_TS_PRESENT)) ? 1U : 0U;
+    uint8_t msg_type;
+    uint16_t seq;
+    int64_t time_ns = 0;
+
+    if ((0U == g_ptp_running) || (pckt_length < (PTP_ETH_HDR_LEN + PTP_HDR_LEN)))
+    {
+        return (0U);
+    }
+
+    if ((((uint32_t)p_rx_packet[12] << 8) | p_rx_packet[13]) != PTP_ETHERTYPE)
+    {
+        return (0U);
+    }
+
+    if ((2U != (p_ptp[PTP_OFF_VERSION] & 0x0FU)) || (0U != p_ptp[PTP_OFF_DOMAIN]))
+    {
+        return (0U);
+    }
+
+    msg_type = p_ptp[PTP_OFF_TYPE] & 0x0FU;
+    seq = (uint16_t)(((uint16_t)p_ptp[PTP_OFF_SEQUENCE] << 8) | p_ptp[PTP_OFF_SEQUENCE + 1U]);
+
+    if ((PTP_MSG_SYNC == msg_type) || (PTP_MSG_DELAY_REQ == msg_type))
+    {
+        if (0U == have_ts)
+        {
+            g_ptp_stats.rx_ts_missing++;
+            return (1U);
+        }
+
+        time_ns = ptp_desc_to_ns(this_mac, cdesc->nano_seconds, cdesc->seconds);
+    }
+
+    if (this_mac == g_ptp_slave)
+    {
+        switch (msg_type)
+        {
+            case PTP_MSG_SYNC: /* Start of a new exchange */
+                g_slave_have_t1 = 0U;
+                g_slave_have_t3 = 0U;
+                g_slave_have_t4 = 0U;
+                g_slave_req_sent = 0U;
+                g_slave_seq = seq;
+                g_slave_t2 = time_ns;
+                g_slave_have_t2 = 1U;
+                break;
+
+            case PTP_MSG_FOLLOW_UP:
+                if (seq == g_slave_seq)
+                {
+                    g_slave_t1 = ptp_get_timestamp(&p_ptp[PTP_OFF_TIMESTAMP]);
+                    g_slave_have_t1 = 1U;
+                }
+                else
+                {
+                    g_ptp_stats.sequence_errors++;
+                }
+                break;
+
+            case PTP_MSG_DELAY_RESP:
+                if ((pckt_length >= (PTP_ETH_HDR_LEN + PTP_OFF_REQ_PORT_ID + PTP_PORT_ID_LEN)) &&
+                    (0 == memcmp(&p_ptp[PTP_OFF_REQ_PORT_ID], g_slave_port_id, PTP_PORT_ID_LEN)))
+                {
+                    if (seq == g_slave_seq)
+                    {
+                        g_slave_t4 = ptp_get_timestamp(&p_ptp[PTP_OFF_TIMESTAMP]);
+                        g_slave_have_t4 = 1U;
+                    }
+                    else
+                    {
+                        g_ptp_stats.sequence_errors++;
+                    }
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+    else if (this_mac == g_ptp_master)
+    {
+        if (PTP_MSG_DELAY_REQ == msg_type)
+        {
+            memcpy(g_master_req_port_id, &p_ptp[PTP_OFF_PORT_ID], PTP_PORT_ID_LEN);
+            g_master_t4 = time_ns;
+            g_master_t4_seq = seq;
+            g_master_t4_valid = 1U;
+        }
+    }
+    else
+    {
+        return (0U);
+    }
+
+    return (1U);
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_tx_complete(const mss_mac_instance_t *this_mac,
+                      const mss_mac_tx_desc_t *cdesc,
+                      const void *caller_info)
+{
+    const uint8_t *p_tag = (const uint8_t *)caller_info;
+    int64_t time_ns;
+
+    if ((0U == g_ptp_running) || (p_tag < &g_ptp_tx_tag[0]) ||
+        (p_tag >= &g_ptp_tx_tag[PTP_TX_SLOTS]))
+    {
+        return;
+    }
+
+    if ((PTP_TX_SYNC != *p_tag) && (PTP_TX_DELAY_REQ != *p_tag))
+    {
+        return; /* General messages are not time stamped */
+    }
+
+    if (0U == (cdesc->status & GEM_TX_DMA_TS_PRESENT))
+    {
+        g_ptp_stats.tx_ts_missing++;
+        return;
+    }
+
+    time_ns = ptp_desc_to_ns(this_mac, cdesc->nano_seconds, cdesc->seconds);
+
+    if ((PTP_TX_SYNC == *p_tag) && (this_mac == g_ptp_master))
+    {
+        g_master_t1 = time_ns;
+        g_master_t1_seq = g_sync_tx_seq;
+        g_master_t1_valid = 1U;
+    }
+    else if ((PTP_TX_DELAY_REQ == *p_tag) && (this_mac == g_ptp_slave) &&
+             (0U != g_slave_req_sent)) /* Ignore a late one from an old exchange */
+    {
+        g_slave_t3 = time_ns;
+        g_slave_have_t3 = 1U;
+    }
+    else
+    {
+        /* Not ours */
+    }
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_get_stats(ptp_clock_stats_t *stats)
+{
+    int64_t mean_sq;
+    int64_t variance;
+
+    *stats = g_ptp_stats;
+    stats->freq_ppb = g_freq_ppb;
+
+    if (0U != g_ptp_stats.samples)
+    {
+        stats->mean_offset = g_offset_sum / (int64_t)g_ptp_stats.samples;
+        stats->mean_delay = g_delay_sum / (int64_t)g_ptp_stats.samples;
+
+        mean_sq = (int64_t)(g_offset_sum_sq / g_ptp_stats.samples);
+        stats->rms_offset = ptp_isqrt((uint64_t)mean_sq);
+
+        variance = mean_sq - (stats->mean_offset * stats->mean_offset);
+        stats->jitter = (variance > 0) ? ptp_isqrt((uint64_t)variance) : 0U;
+    }
+}
+
+/******************************************************************************
+ * See ptp_clock.h for details of how to use this function.
+ */
+void
+ptp_clock_clear_stats(void)
+{
+    g_ptp_stats.samples = 0U;
+    g_ptp_stats.min_offset = 0;
+    g_ptp_stats.max_offset = 0;
+    g_ptp_stats.mean_offset = 0;
+    g_ptp_stats.rms_offset = 0U;
+    g_ptp_stats.jitter = 0U;
+    g_ptp_stats.last_delay = 0;
+    g_ptp_stats.mean_delay = 0;
+    g_offset_sum = 0;
+    g_offset_sum_sq = 0U;
+    g_delay_sum = 0;
+}
+
+#endif /* MSS_MAC_TIME_STAMPED_MODE */
@@ -0,0 +1,97 @@
+/***********************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * ptp_clock.h
+ *
+ * IEEE 1588-2008 ordinary clock built on the GEM Time Stamp Unit.
+ *
+ * One pMAC acts as master and the other as slave with the two ports cabled
+ * together. PTP messages are sent over Ethernet (Ethertype 0x88F7) to the
+ * 01:1B:19:00:00:00 multicast address using the two step end to end delay
+ * mechanism:
+ *
+ *   master                     slave
+ *     | Sync              t1 -> t2 |
+ *     | Follow_Up (t1)   ------->  |
+ *     | Delay_Req         t4 <- t3 |
+ *     | Delay_Resp (t4)  ------->  |
+ *
+ * t1 and t3 are taken from the TX descriptor time stamp when the frame
+ * completes and t2 and t4 from the RX descriptor. The descriptors only hold
+ * the lower 6 bits of the seconds count so the upper bits are recovered from
+ * the TSU when the time stamp is collected.
+ *
+ * Each completed exchange gives the slave offset from master and the mean path
+ * delay. Offsets larger than PTP_CLOCK_STEP_THRESHOLD_NS step the slave TSU,
+ * smaller ones are fed to a PI servo which trims the slave TSU increment.
+ *
+ * All timestamps are handled as signed 64 bit nanosecond counts so TSU values
+ * above 2^63 ns (292 years) are not supported.
+ */
+
+#ifndef PTP_CLOCK_H_
+#define PTP_CLOCK_H_
+
+#include <stdint.h>
+
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+
+#define PTP_CLOCK_SYNC_INTERVAL_MS  125U    /* logSyncInterval of -3 */
+#define PTP_CLOCK_NS_INC            8U      /* Nominal increment for 125MHz TSU clock */
+#define PTP_CLOCK_STEP_THRESHOLD_NS 20000LL /* Step rather than slew above this */
+#define PTP_CLOCK_MAX_PPB           500000LL /* Servo frequency adjustment limit */
+
+/* Servo gains in thousandths, normalised to a 1 second sync interval */
+#define PTP_CLOCK_KP                700LL
+#define PTP_CLOCK_KI                300LL
+
+typedef struct ptp_clock_stats
+{
+    uint32_t samples;          /* Offset samples since last clear */
+    uint32_t steps;            /* Times the slave clock has been stepped */
+    int64_t last_offset;       /* Slave - master, ns */
+    int64_t min_offset;
+    int64_t max_offset;
+    int64_t mean_offset;
+    uint64_t rms_offset;       /* RMS of offset */
+    uint64_t jitter;           /* Standard deviation of offset */
+    int64_t last_delay;        /* Mean path delay, ns */
+    int64_t mean_delay;
+    int64_t freq_ppb;          /* Current slave frequency adjustment */
+    uint32_t tx_ts_missing;    /* Event frames sent without a time stamp */
+    uint32_t rx_ts_missing;    /* Event frames received without a time stamp */
+    uint32_t tx_busy;          /* Sends deferred as no TX descriptor was free */
+    uint32_t sequence_errors;  /* Messages which did not match the current exchange */
+} ptp_clock_stats_t;
+
+/* Configure time stamping on both pMACs and start the clock. master and slave
+ * must be pMACs as the eMAC TSUs are slaved to their pMAC TSUs */
+void ptp_clock_start(mss_mac_instance_t *master, mss_mac_instance_t *slave);
+
+void ptp_clock_stop(void);
+
+uint32_t ptp_clock_running(void);
+
+/* Called from the main loop to send messages and run the servo */
+void ptp_clock_task(uint64_t now_ms);
+
+/* Called from the receive callback. Returns non zero if the frame was a PTP
+ * message for the clock and should not be processed further */
+uint32_t ptp_clock_rx(const mss_mac_instance_t *this_mac,
+                      const uint8_t *p_rx_packet,
+                      uint32_t pckt_length,
+                      const mss_mac_rx_desc_t *cdesc);
+
+/* Called from the transmit complete callback with the caller_info that was
+ * passed to MSS_MAC_send_pkt() */
+void ptp_clock_tx_complete(const mss_mac_instance_t *this_mac,
+                           const mss_mac_tx_desc_t *cdesc,
+                           const void *caller_info);
+
+void ptp_clock_get_stats(ptp_clock_stats_t *stats);
+
+void ptp_clock_clear_stats(void);
+
+#endif /* PTP_CLOCK_H_ */
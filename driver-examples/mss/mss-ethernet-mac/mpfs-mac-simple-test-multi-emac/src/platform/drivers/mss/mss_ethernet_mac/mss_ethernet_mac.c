@@ -3557,6 +3557,51 @@ MSS_MAC_read_TSU(const mss_mac_instance_t *this_mac, mss_mac_tsu_time_t *tsu_tim
     }
 }
 
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+void
+MSS_MAC_set_TSU_increment(const mss_mac_instance_t *this_mac, uint32_t ns_inc, uint32_t sub_ns_inc)
+{
+    uint32_t temp;
+
+    /* The eMAC TSU is slaved to the pMAC TSU so only the pMAC is adjusted */
+    if ((MSS_MAC_AVAILABLE == this_mac->mac_available) && (0U == this_mac->is_emac))
+    {
+        temp = (sub_ns_inc & 0xFFU) << 24;
+        temp |= (sub_ns_inc >> 8) & 0xFFFFU;
+
+        /* Sub-nanoseconds first, the new rate takes effect on the ns write */
+        this_mac->mac_base->TSU_TIMER_INCR_SUB_NSEC = temp;
+        this_mac->mac_base->TSU_TIMER_INCR = ns_inc & GEM_NS_INCREMENT;
+    }
+}
+
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+void
+MSS_MAC_adjust_TSU(const mss_mac_instance_t *this_mac, int32_t nanoseconds)
+{
+    uint32_t temp;
+
+    if ((MSS_MAC_AVAILABLE == this_mac->mac_available) && (0U == this_mac->is_emac))
+    {
+        if (nanoseconds < 0)
+        {
+            temp = GEM_ADD_SUBTRACT | ((uint32_t)(-nanoseconds) & GEM_TSU_NANOSECONDS);
+        }
+        else
+        {
+            temp = (uint32_t)nanoseconds & GEM_TSU_NANOSECONDS;
+        }
+
+        this_mac->mac_base->TSU_TIMER_ADJUST = temp;
+    }
+}
+
 /******************************************************************************
  * See mss_ethernet_mac.h for details of how to use this function.
  */
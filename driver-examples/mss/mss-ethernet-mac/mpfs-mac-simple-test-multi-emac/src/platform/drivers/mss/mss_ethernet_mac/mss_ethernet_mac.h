@@ -195,6 +195,8 @@
     Ethernet MAC devices.
         - _MSS_MAC_read_TSU()_
         - _MSS_MAC_init_TSU()_
+        - _MSS_MAC_set_TSU_increment()_
+        - _MSS_MAC_adjust_TSU()_
         - _MSS_MAC_set_TSU_rx_mode()_
         - _MSS_MAC_set_TSU_tx_mode()_
         - _MSS_MAC_get_TSU_rx_mode()_
@@ -1580,6 +1582,98 @@ MSS_MAC_read_TSU
     mss_mac_tsu_time_t *tsu_time
 );
 
+/***************************************************************************//**
+  The _MSS_MAC_set_TSU_increment()_ function changes the amount the TSU counter
+  advances by on each TSU clock tick without disturbing the current count. This
+  is used by a PTP servo to trim the rate of the local clock. The increment is
+  given as a whole number of nanoseconds plus a 24 bit fraction of a nanosecond
+  so, with a 125MHz TSU clock, the rate can be trimmed in steps of under 0.01
+  parts per billion.
+
+  The eMAC TSU is slaved to the pMAC TSU, calling this function for an eMAC has
+  no effect.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param ns_inc
+    This parameter is the whole nanoseconds part of the increment, 0 to 255.
+
+  @param sub_ns_inc
+    This parameter is the fractional part of the increment in units of 1/2^24
+    nanoseconds.
+
+  @return
+    This function does not return a value.
+
+  Example:
+  This example speeds up a TSU running from a 125MHz clock by 100 parts per
+  billion.
+  @code
+    #include "mss_ethernet_mac.h"
+
+    void speed_up_tsu(void)
+    {
+        uint64_t increment = 8ULL << 24;
+
+        increment += (increment * 100ULL) / 1000000000ULL;
+        MSS_MAC_set_TSU_increment(&g_mac0, (uint32_t)(increment >> 24),
+                                  (uint32_t)(increment & 0xFFFFFFULL));
+    }
+  @endcode
+ */
+void
+MSS_MAC_set_TSU_increment
+(
+    const mss_mac_instance_t *this_mac,
+    uint32_t ns_inc,
+    uint32_t sub_ns_inc
+);
+
+/***************************************************************************//**
+  The _MSS_MAC_adjust_TSU()_ function steps the TSU count forwards or backwards
+  by a number of nanoseconds using the TSU timer adjust register. The step is
+  applied atomically by the hardware with any carry into or borrow from the
+  seconds count handled automatically.
+
+  The eMAC TSU is slaved to the pMAC TSU, calling this function for an eMAC has
+  no effect.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param nanoseconds
+    This parameter is the signed number of nanoseconds to add to the TSU count.
+    The magnitude must be less than 2^30. Larger steps should be made by reading
+    the TSU and setting a new time with _MSS_MAC_init_TSU()_.
+
+  @return
+    This function does not return a value.
+
+  Example:
+  This example moves the GEM0 TSU back by 1.5uS.
+  @code
+    #include "mss_ethernet_mac.h"
+
+    void step_tsu(void)
+    {
+        MSS_MAC_adjust_TSU(&g_mac0, -1500);
+    }
+  @endcode
+ */
+void
+MSS_MAC_adjust_TSU
+(
+    const mss_mac_instance_t *this_mac,
+    int32_t nanoseconds
+);
+
 /***************************************************************************//**
   The _MSS_MAC_set_TSU_rx_mode()_ function configures time stamp recording for
   received packets. This allows recording the TSU value for received packets in
@@ -50,6 +50,7 @@
 // #include "if_utils.h"
 
 #include "ptp_packets.h"
+#include "flow_steering.h"
 #if defined(MSS_MAC_USE_DDR) && (MSS_MAC_USE_DDR == MSS_MAC_MEM_CRYPTO)
 /*
  * The crypto libraries have been removed from the example projects as they are
@@ -1248,6 +1249,261 @@ e51(void)
     e51_task(0);
 }
 
+/*==============================================================================
+ * Flow steering benchmark.
+ *
+ * Steers a set of UDP flows across queues 1 to 3 and hands each queue to its
+ * own U54. The flows are then streamed through the GEM in local loopback from
+ * queue 0 for FLOW_BENCH_DURATION_MS at each frame size and the per queue
+ * receive rates show how the load spreads across the harts. For line rate
+ * figures, leave the U54s servicing their queues and drive the same flows from
+ * an external generator.
+ */
+#define FLOW_BENCH_FLOWS       8U
+#define FLOW_BENCH_DURATION_MS 2000U
+#define FLOW_BENCH_ATTACH_MS   100U
+#define FLOW_BENCH_DRAIN_MS    20U
+#define FLOW_BENCH_FRAME_MAX   1520U
+
+static uint8_t g_flow_frames[FLOW_BENCH_FLOWS][FLOW_BENCH_FRAME_MAX] __attribute__((aligned(8)));
+
+/* 64, 512 and 1518 bytes on the wire once the FCS is added */
+static const uint32_t g_flow_bench_sizes[] = {60U, 508U, 1514U};
+
+static uint32_t g_flow_harts_started = 0U;
+
+static void
+flow_bench_build_frame(uint8_t *frame, const flow_5tuple_t *flow, uint32_t length)
+{
+    uint32_t ip_length = length - 14U;
+    uint32_t checksum = 0U;
+    uint32_t index;
+
+    memset(frame, 0, length);
+
+    memset(frame, 0xFF, 6); /* Broadcast so it is received in loopback */
+    memcpy(&frame[6], g_mac_config.mac_addr, 6);
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+
+    /* IPv4 header */
+    frame[14] = 0x45;
+    frame[16] = (uint8_t)(ip_length >> 8);
+    frame[17] = (uint8_t)ip_length;
+    frame[20] = 0x40; /* Don't fragment */
+    frame[22] = 64;   /* TTL */
+    frame[23] = flow->protocol;
+    frame[26] = (uint8_t)(flow->src_ip >> 24);
+    frame[27] = (uint8_t)(flow->src_ip >> 16);
+    frame[28] = (uint8_t)(flow->src_ip >> 8);
+    frame[29] = (uint8_t)flow->src_ip;
+    frame[30] = (uint8_t)(flow->dst_ip >> 24);
+    frame[31] = (uint8_t)(flow->dst_ip >> 16);
+    frame[32] = (uint8_t)(flow->dst_ip >> 8);
+    frame[33] = (uint8_t)flow->dst_ip;
+
+    for (index = 14U; index != 34U; index += 2U)
+    {
+        checksum += ((uint32_t)frame[index] << 8) | frame[index + 1U];
+    }
+
+    checksum = (checksum & 0xFFFFU) + (checksum >> 16);
+    checksum = (checksum & 0xFFFFU) + (checksum >> 16);
+    checksum = ~checksum;
+    frame[24] = (uint8_t)(checksum >> 8);
+    frame[25] = (uint8_t)checksum;
+
+    /* UDP header, no checksum */
+    frame[34] = (uint8_t)(flow->src_port >> 8);
+    frame[35] = (uint8_t)flow->src_port;
+    frame[36] = (uint8_t)(flow->dst_port >> 8);
+    frame[37] = (uint8_t)flow->dst_port;
+    frame[38] = (uint8_t)((ip_length - 20U) >> 8);
+    frame[39] = (uint8_t)(ip_length - 20U);
+}
+
+static void
+flow_steering_benchmark(void)
+{
+    char info_string[200];
+    flow_5tuple_t flows[FLOW_BENCH_FLOWS];
+    uint32_t saved_nw_control;
+    int saved_loopback0 = g_loopback0;
+    int saved_loopback1 = g_loopback1;
+    uint64_t timeout;
+    uint64_t start_time;
+    uint64_t elapsed;
+    uint64_t rx_start;
+    uint64_t tx_start;
+    uint64_t total_packets;
+    uint64_t total_bytes;
+    uint32_t size_index;
+    uint32_t attached;
+    uint32_t index;
+    uint32_t flow;
+    int32_t queue_no;
+
+    if (0U != g_test_mac->use_local_ints)
+    {
+        PRINT_STRING("Flow steering needs the GEM queue interrupts routed via the PLIC\n\r");
+        return;
+    }
+
+    flow_steering_enable(g_test_mac);
+
+    for (index = 0U; index != FLOW_BENCH_FLOWS; index++)
+    {
+        flows[index].src_ip = 0x0A010102UL;
+        flows[index].dst_ip = 0x0A010103UL;
+        flows[index].src_port = (uint16_t)(5000U + index);
+        flows[index].dst_port = (uint16_t)(7000U + index);
+        flows[index].protocol = FLOW_PROTOCOL_UDP;
+
+        queue_no = flow_steering_add_flow(&flows[index]);
+        sprintf(info_string,
+                "Flow %u: UDP %u -> %u hash %08X ",
+                index,
+                flows[index].src_port,
+                flows[index].dst_port,
+                flow_steering_hash(&flows[index]));
+        PRINT_STRING(info_string);
+        if (FLOW_STEERING_NO_SCREENER == queue_no)
+        {
+            PRINT_STRING("no screener left - Q 0\n\r");
+        }
+        else
+        {
+            sprintf(info_string, "steered to Q %d\n\r", queue_no);
+            PRINT_STRING(info_string);
+        }
+    }
+
+    /* Release the U54s from WFI, they attach to their queues on the way out */
+    if (0U == g_flow_harts_started)
+    {
+        for (index = 1U; index != MSS_MAC_QUEUE_COUNT; index++)
+        {
+            raise_soft_interrupt(index);
+        }
+
+        g_flow_harts_started = 1U;
+    }
+
+    timeout = g_tick_counter + FLOW_BENCH_ATTACH_MS;
+    do
+    {
+        attached = 0U;
+        for (index = 1U; index != MSS_MAC_QUEUE_COUNT; index++)
+        {
+            attached += flow_steering_hart_attached(index);
+        }
+    } while ((attached != (MSS_MAC_QUEUE_COUNT - 1U)) && (g_tick_counter < timeout));
+
+    for (index = 1U; index != MSS_MAC_QUEUE_COUNT; index++)
+    {
+        if (0U == flow_steering_hart_attached(index))
+        {
+            sprintf(info_string, "Warning: hart %u is not servicing Q %u\n\r", index, index);
+            PRINT_STRING(info_string);
+        }
+    }
+
+    g_loopback0 = 0;
+    g_loopback1 = 0;
+
+    /* Note RX and TX must be disabled when changing loopback setting */
+    saved_nw_control = g_test_mac->mac_base->NETWORK_CONTROL;
+    g_test_mac->mac_base->NETWORK_CONTROL &=
+        (uint32_t)(~(GEM_ENABLE_TRANSMIT | GEM_ENABLE_RECEIVE));
+    g_test_mac->mac_base->NETWORK_CONTROL |= GEM_LOOPBACK_LOCAL | GEM_LOOPBACK;
+    g_test_mac->mac_base->NETWORK_CONTROL |= GEM_ENABLE_TRANSMIT | GEM_ENABLE_RECEIVE;
+
+    for (size_index = 0U;
+         size_index != (sizeof(g_flow_bench_sizes) / sizeof(g_flow_bench_sizes[0]));
+         size_index++)
+    {
+        for (index = 0U; index != FLOW_BENCH_FLOWS; index++)
+        {
+            flow_bench_build_frame(g_flow_frames[index],
+                                   &flows[index],
+                                   g_flow_bench_sizes[size_index]);
+        }
+
+        flow_steering_clear_stats();
+        rx_start = (&g_mac0 == g_test_mac) ? rx_count0 : rx_count1;
+        tx_start = (&g_mac0 == g_test_mac) ? tx_count0 : tx_count1;
+
+        start_time = g_tick_counter;
+        flow = 0U;
+        while ((g_tick_counter - start_time) < FLOW_BENCH_DURATION_MS)
+        {
+            if (MSS_MAC_SUCCESS == MSS_MAC_send_pkt(g_test_mac,
+                                                    0,
+                                                    g_flow_frames[flow],
+                                                    g_flow_bench_sizes[size_index],
+                                                    (void *)0))
+            {
+                flow = (flow + 1U) % FLOW_BENCH_FLOWS;
+            }
+        }
+
+        elapsed = g_tick_counter - start_time;
+
+        /* Let the last frames land before reading the counters */
+        timeout = g_tick_counter + FLOW_BENCH_DRAIN_MS;
+        while (g_tick_counter < timeout)
+        {
+            ;
+        }
+
+        sprintf(info_string,
+                "\n\r%u byte frames, %lu sent in %lu ms\n\r",
+                g_flow_bench_sizes[size_index] + 4U,
+                (unsigned long)(((&g_mac0 == g_test_mac) ? tx_count0 : tx_count1) - tx_start),
+                (unsigned long)elapsed);
+        PRINT_STRING(info_string);
+
+        sprintf(info_string,
+                "  Q 0 hart 0: %lu packets (unsteered)\n\r",
+                (unsigned long)(((&g_mac0 == g_test_mac) ? rx_count0 : rx_count1) - rx_start));
+        PRINT_STRING(info_string);
+
+        total_packets = 0U;
+        total_bytes = 0U;
+        for (index = 1U; index != MSS_MAC_QUEUE_COUNT; index++)
+        {
+            total_packets += g_flow_queue_stats[index].packets;
+            total_bytes += g_flow_queue_stats[index].bytes;
+            sprintf(info_string,
+                    "  Q %u hart %lu: %lu packets, %lu pps, %lu Mbps\n\r",
+                    index,
+                    (unsigned long)g_flow_queue_stats[index].hart_id,
+                    (unsigned long)g_flow_queue_stats[index].packets,
+                    (unsigned long)((g_flow_queue_stats[index].packets * 1000U) / elapsed),
+                    (unsigned long)((g_flow_queue_stats[index].bytes * 8U) / (elapsed * 1000U)));
+            PRINT_STRING(info_string);
+        }
+
+        sprintf(info_string,
+                "  Total     : %lu packets, %lu pps, %lu Mbps\n\r",
+                (unsigned long)total_packets,
+                (unsigned long)((total_packets * 1000U) / elapsed),
+                (unsigned long)((total_bytes * 8U) / (elapsed * 1000U)));
+        PRINT_STRING(info_string);
+    }
+
+    g_test_mac->mac_base->NETWORK_CONTROL &=
+        (uint32_t)(~(GEM_ENABLE_TRANSMIT | GEM_ENABLE_RECEIVE));
+    g_test_mac->mac_base->NETWORK_CONTROL =
+        saved_nw_control & (uint32_t)(~(GEM_ENABLE_TRANSMIT | GEM_ENABLE_RECEIVE));
+    g_test_mac->mac_base->NETWORK_CONTROL = saved_nw_control;
+
+    g_loopback0 = saved_loopback0;
+    g_loopback1 = saved_loopback1;
+
+    PRINT_STRING("\n\rFlow steering left enabled, queues 1 to 3 stay on their U54s\n\r");
+}
+
 /*==============================================================================
  *
  */
@@ -1437,6 +1693,8 @@ print_help(void)
     }
     sprintf(info_string, "r - Reset statistics counts\n\r");
     PRINT_STRING(info_string);
+    sprintf(info_string, "R - Run flow steering benchmark across U54s\n\r");
+    PRINT_STRING(info_string);
     sprintf(info_string, "s - Show statistics\n\r");
     PRINT_STRING(info_string);
     sprintf(info_string, "S - Show subset of statistics\n\r");
@@ -3743,6 +4001,10 @@ e51_task(void *pvParameters)
                                                       reset on read... */
                 }
             }
+            else if (rx_buff[0] == 'R')
+            {
+                flow_steering_benchmark();
+            }
             else if ((rx_buff[0] == 's') || (rx_buff[0] == 'S'))
             {
                 if (&g_mac0 == g_test_mac)
@@ -0,0 +1,369 @@
+/***********************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Receive side flow steering for the pMAC priority queues. See flow_steering.h.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mpfs_hal/mss_hal.h"
+
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_registers.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_sw_cfg.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_regs.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+
+#include "flow_steering.h"
+
+#define FLOW_ETHERTYPE_IPV4  0x0800U
+#define FLOW_ETHERTYPE_INDEX 0U /* Ethertype register used by the Type 2 filters */
+#define FLOW_COMPARERS_PER_FILTER 3U
+
+/* Offsets into the IPv4 and L4 headers */
+#define FLOW_IP_SRC_OFFSET    12U
+#define FLOW_IP_DST_OFFSET    16U
+#define FLOW_L4_PORTS_OFFSET  0U
+
+/* Standard RSS key as used by most NIC drivers */
+static const uint8_t g_rss_key[40] = {
+    0x6D, 0x5A, 0x56, 0xDA, 0x25, 0x5B, 0x0E, 0xC2, 0x41, 0x67, 0x25, 0x3D, 0x43, 0xA3,
+    0x8F, 0xB0, 0xD0, 0xCA, 0x2B, 0xCB, 0xAE, 0x7B, 0x30, 0xB4, 0x77, 0xCB, 0x2D, 0xA3,
+    0x80, 0x30, 0xF2, 0x0C, 0x6A, 0x42, 0xB7, 0x3B, 0xBE, 0xAC, 0x01, 0xFA};
+
+flow_queue_stats_t g_flow_queue_stats[MSS_MAC_QUEUE_COUNT];
+
+static mss_mac_instance_t *volatile g_flow_mac = 0;
+static volatile uint32_t g_flow_hart_attached[MSS_MAC_QUEUE_COUNT];
+
+static uint8_t g_indirection[FLOW_STEERING_INDIRECTION_SIZE];
+
+static uint32_t g_type_2_used = 0U;
+static uint32_t g_type_1_used = 0U;
+static uint16_t g_type_1_port[MSS_MAC_TYPE_1_SCREENERS];
+static uint8_t g_type_1_queue[MSS_MAC_TYPE_1_SCREENERS];
+
+/**=============================================================================
+ * Receive handler for the steered queues. Runs on the hart which owns the queue
+ * and hands the buffer straight back to the same ring.
+ */
+static void
+flow_steering_rx_callback(/* mss_mac_instance_t */ void *this_mac,
+                          uint32_t queue_no,
+                          uint8_t *p_rx_packet,
+                          uint32_t pckt_length,
+                          mss_mac_rx_desc_t *cdesc,
+                          void *caller_info)
+{
+    flow_queue_stats_t *stats = &g_flow_queue_stats[queue_no];
+
+    (void)cdesc;
+
+    stats->packets++;
+    stats->bytes += pckt_length;
+    stats->hart_id = read_csr(mhartid);
+
+    MSS_MAC_receive_pkt((mss_mac_instance_t *)this_mac,
+                        queue_no,
+                        p_rx_packet,
+                        caller_info,
+                        MSS_MAC_INT_ENABLE);
+}
+
+/**=============================================================================
+ *
+ */
+static void
+flow_steering_clear_screeners(mss_mac_instance_t *this_mac)
+{
+    mss_mac_type_1_filter_t filter1;
+    mss_mac_type_2_filter_t filter2;
+    mss_mac_type_2_compare_t compare;
+    uint32_t index;
+
+    memset(&filter1, 0, sizeof(filter1));
+    memset(&filter2, 0, sizeof(filter2));
+    memset(&compare, 0, sizeof(compare));
+
+    for (index = 0U; index != MSS_MAC_TYPE_1_SCREENERS; index++)
+    {
+        MSS_MAC_set_type_1_filter(this_mac, index, &filter1);
+    }
+
+    for (index = 0U; index != MSS_MAC_TYPE_2_SCREENERS; index++)
+    {
+        MSS_MAC_set_type_2_filter(this_mac, index, &filter2);
+    }
+
+    for (index = 0U; index != MSS_MAC_TYPE_2_COMPARERS; index++)
+    {
+        MSS_MAC_set_type_2_compare(this_mac, index, &compare);
+    }
+
+    for (index = 0U; index != MSS_MAC_TYPE_2_ETHERTYPES; index++)
+    {
+        MSS_MAC_set_type_2_ethertype(this_mac, index, 0x0000U);
+    }
+
+    g_type_1_used = 0U;
+    g_type_2_used = 0U;
+}
+
+/**=============================================================================
+ * Comparer data holds the byte at the offset in b0-b7 so the network order
+ * value is loaded little endian.
+ */
+static uint32_t
+flow_compare_data(uint32_t network_value)
+{
+    return (((network_value >> 24) & 0xFFU) | ((network_value >> 8) & 0xFF00U) |
+            ((network_value << 8) & 0xFF0000U) | ((network_value << 24) & 0xFF000000U));
+}
+
+/**=============================================================================
+ *
+ */
+void
+flow_steering_enable(mss_mac_instance_t *this_mac)
+{
+    uint32_t queue_no;
+    uint32_t index;
+
+    flow_steering_clear_screeners(this_mac);
+    MSS_MAC_set_type_2_ethertype(this_mac, FLOW_ETHERTYPE_INDEX, FLOW_ETHERTYPE_IPV4);
+
+    for (index = 0U; index != FLOW_STEERING_INDIRECTION_SIZE; index++)
+    {
+        g_indirection[index] = (uint8_t)(1U + (index % (MSS_MAC_QUEUE_COUNT - 1U)));
+    }
+
+    for (queue_no = 1U; queue_no != MSS_MAC_QUEUE_COUNT; queue_no++)
+    {
+        /* Stop servicing the queue here before handing it to its own hart */
+        PLIC_DisableIRQ(this_mac->mac_q_int[queue_no]);
+        MSS_MAC_set_rx_callback(this_mac, queue_no, flow_steering_rx_callback);
+    }
+
+    flow_steering_clear_stats();
+
+    g_flow_mac = this_mac;
+    mb();
+}
+
+/**=============================================================================
+ *
+ */
+void
+flow_steering_attach_hart(void)
+{
+    uint64_t hart_id = read_csr(mhartid);
+    mss_mac_instance_t *this_mac = g_flow_mac;
+
+    if ((0 == this_mac) || (0U == hart_id) || (hart_id >= MSS_MAC_QUEUE_COUNT))
+    {
+        return;
+    }
+
+    PLIC_init();
+    PLIC_EnableIRQ(this_mac->mac_q_int[hart_id]);
+    set_csr(mie, MIP_MEIP);
+
+    g_flow_hart_attached[hart_id] = 1U;
+    mb();
+}
+
+/**=============================================================================
+ *
+ */
+uint32_t
+flow_steering_hart_attached(uint64_t hart_id)
+{
+    if (hart_id >= MSS_MAC_QUEUE_COUNT)
+    {
+        return (0U);
+    }
+
+    return (g_flow_hart_attached[hart_id]);
+}
+
+/**=============================================================================
+ *
+ */
+void
+flow_steering_set_indirection(uint32_t index, uint32_t queue_no)
+{
+    if ((index < FLOW_STEERING_INDIRECTION_SIZE) && (0U != queue_no) &&
+        (queue_no < MSS_MAC_QUEUE_COUNT))
+    {
+        g_indirection[index] = (uint8_t)queue_no;
+    }
+}
+
+/**=============================================================================
+ * Toeplitz hash over src ip, dst ip, src port, dst port and protocol, all in
+ * network byte order.
+ */
+uint32_t
+flow_steering_hash(const flow_5tuple_t *flow)
+{
+    uint8_t input[13];
+    uint32_t result = 0U;
+    uint32_t window;
+    uint32_t key_index = 4U;
+    uint32_t byte_index;
+    int32_t bit;
+
+    input[0] = (uint8_t)(flow->src_ip >> 24);
+    input[1] = (uint8_t)(flow->src_ip >> 16);
+    input[2] = (uint8_t)(flow->src_ip >> 8);
+    input[3] = (uint8_t)flow->src_ip;
+    input[4] = (uint8_t)(flow->dst_ip >> 24);
+    input[5] = (uint8_t)(flow->dst_ip >> 16);
+    input[6] = (uint8_t)(flow->dst_ip >> 8);
+    input[7] = (uint8_t)flow->dst_ip;
+    input[8] = (uint8_t)(flow->src_port >> 8);
+    input[9] = (uint8_t)flow->src_port;
+    input[10] = (uint8_t)(flow->dst_port >> 8);
+    input[11] = (uint8_t)flow->dst_port;
+    input[12] = flow->protocol;
+
+    window = ((uint32_t)g_rss_key[0] << 24) | ((uint32_t)g_rss_key[1] << 16) |
+             ((uint32_t)g_rss_key[2] << 8) | (uint32_t)g_rss_key[3];
+
+    for (byte_index = 0U; byte_index != sizeof(input); byte_index++)
+    {
+        for (bit = 7; bit >= 0; bit--)
+        {
+            if (0U != (input[byte_index] & (1U << bit)))
+            {
+                result ^= window;
+            }
+
+            /* Slide the 32 bit key window along by one bit */
+            window = (window << 1) | ((g_rss_key[key_index] >> bit) & 1U);
+        }
+
+        key_index++;
+    }
+
+    return (result);
+}
+
+/**=============================================================================
+ *
+ */
+uint32_t
+flow_steering_queue(const flow_5tuple_t *flow)
+{
+    return ((uint32_t)
+                g_indirection[flow_steering_hash(flow) & (FLOW_STEERING_INDIRECTION_SIZE - 1U)]);
+}
+
+/**=============================================================================
+ *
+ */
+int32_t
+flow_steering_add_flow(const flow_5tuple_t *flow)
+{
+    mss_mac_instance_t *this_mac = g_flow_mac;
+    mss_mac_type_1_filter_t filter1;
+    mss_mac_type_2_filter_t filter2;
+    mss_mac_type_2_compare_t compare;
+    uint32_t queue_no;
+    uint32_t comparer_no;
+    uint32_t index;
+
+    if (0 == this_mac)
+    {
+        return (FLOW_STEERING_NO_SCREENER);
+    }
+
+    queue_no = flow_steering_queue(flow);
+
+    if (g_type_2_used < MSS_MAC_TYPE_2_SCREENERS)
+    {
+        comparer_no = g_type_2_used * FLOW_COMPARERS_PER_FILTER;
+
+        compare.disable_mask = 1;
+        compare.compare_vlan_c_id = 0;
+        compare.compare_vlan_s_id = 0;
+        compare.mask = 0;
+
+        compare.compare_offset = MSS_MAC_T2_OFFSET_IP;
+        compare.offset_value = FLOW_IP_SRC_OFFSET;
+        compare.data = flow_compare_data(flow->src_ip);
+        MSS_MAC_set_type_2_compare(this_mac, comparer_no, &compare);
+
+        compare.offset_value = FLOW_IP_DST_OFFSET;
+        compare.data = flow_compare_data(flow->dst_ip);
+        MSS_MAC_set_type_2_compare(this_mac, comparer_no + 1U, &compare);
+
+        compare.compare_offset = MSS_MAC_T2_OFFSET_TCP_UDP;
+        compare.offset_value = FLOW_L4_PORTS_OFFSET;
+        compare.data = flow_compare_data(((uint32_t)flow->src_port << 16) | flow->dst_port);
+        MSS_MAC_set_type_2_compare(this_mac, comparer_no + 2U, &compare);
+
+        memset(&filter2, 0, sizeof(filter2));
+        filter2.ethertype_enable = 1;
+        filter2.ethertype_index = FLOW_ETHERTYPE_INDEX;
+        filter2.compare_a_enable = 1;
+        filter2.compare_a_index = (uint8_t)comparer_no;
+        filter2.compare_b_enable = 1;
+        filter2.compare_b_index = (uint8_t)(comparer_no + 1U);
+        filter2.compare_c_enable = 1;
+        filter2.compare_c_index = (uint8_t)(comparer_no + 2U);
+        filter2.queue_no = (uint8_t)queue_no;
+        MSS_MAC_set_type_2_filter(this_mac, g_type_2_used, &filter2);
+
+        g_type_2_used++;
+        return ((int32_t)queue_no);
+    }
+
+    if (FLOW_PROTOCOL_UDP != flow->protocol)
+    {
+        return (FLOW_STEERING_NO_SCREENER);
+    }
+
+    /* Type 1 filters only see the destination port so reuse any existing one */
+    for (index = 0U; index != g_type_1_used; index++)
+    {
+        if (g_type_1_port[index] == flow->dst_port)
+        {
+            return ((int32_t)g_type_1_queue[index]);
+        }
+    }
+
+    if (g_type_1_used < MSS_MAC_TYPE_1_SCREENERS)
+    {
+        memset(&filter1, 0, sizeof(filter1));
+        filter1.udp_port = flow->dst_port;
+        filter1.udp_port_enable = 1;
+        filter1.queue_no = (uint8_t)queue_no;
+        MSS_MAC_set_type_1_filter(this_mac, g_type_1_used, &filter1);
+
+        g_type_1_port[g_type_1_used] = flow->dst_port;
+        g_type_1_queue[g_type_1_used] = (uint8_t)queue_no;
+        g_type_1_used++;
+        return ((int32_t)queue_no);
+    }
+
+    return (FLOW_STEERING_NO_SCREENER);
+}
+
+/**=============================================================================
+ *
+ */
+void
+flow_steering_clear_stats(void)
+{
+    uint32_t queue_no;
+
+    for (queue_no = 0U; queue_no != MSS_MAC_QUEUE_COUNT; queue_no++)
+    {
+        g_flow_queue_stats[queue_no].packets = 0U;
+        g_flow_queue_stats[queue_no].bytes = 0U;
+    }
+}
@@ -0,0 +1,91 @@
+/***********************************************************************************
+ * Copyright 2019 Microchip FPGA Embedded Systems Solutions.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * flow_steering.h
+ *
+ * Receive side flow steering for the pMAC priority queues.
+ *
+ * Each flow is identified by its IPv4 5-tuple. A Toeplitz hash of the tuple
+ * indexes an indirection table which picks one of the priority queues 1 to
+ * MSS_MAC_QUEUE_COUNT - 1. The GEM screeners are then programmed so that the
+ * flow is routed to that queue in hardware:
+ *
+ *  - Type 2 filters match Ethertype 0x0800 plus the source address,
+ *    destination address and L4 port pair of the flow. The pMAC has 4 filters
+ *    and 12 comparers so 4 flows can be matched exactly this way. The protocol
+ *    is part of the hash but is not matched by the screener.
+ *  - Once the Type 2 filters are used up, UDP flows fall back to a Type 1
+ *    filter on the destination port. Flows sharing a port share a queue.
+ *  - Anything else is left on queue 0.
+ *
+ * Queue n interrupts are serviced by hart n (U54_n). flow_steering_enable()
+ * takes the queue 1 to 3 interrupts away from the calling hart and each U54
+ * claims its own queue by calling flow_steering_attach_hart() once it has been
+ * released from WFI. The receive ring of each queue is then emptied and
+ * refilled entirely on its own hart. This relies on the MAC using PLIC
+ * interrupts (use_local_ints == 0) as the PLIC enables are per hart.
+ *
+ * Enabling flow steering replaces any screener setup made with the 'q' and 'Q'
+ * commands and the receive callbacks of queues 1 to 3.
+ */
+
+#ifndef FLOW_STEERING_H_
+#define FLOW_STEERING_H_
+
+#include <stdint.h>
+
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+
+#define FLOW_STEERING_INDIRECTION_SIZE 16U  /* Must be a power of 2 */
+#define FLOW_STEERING_NO_SCREENER      (-1) /* No screener left for the flow */
+
+#define FLOW_PROTOCOL_TCP 6U
+#define FLOW_PROTOCOL_UDP 17U
+
+/* Flow identifier - all fields in host byte order */
+typedef struct flow_5tuple
+{
+    uint32_t src_ip;
+    uint32_t dst_ip;
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint8_t protocol;
+} flow_5tuple_t;
+
+/* Per queue receive counters, one cache line each as they are updated by
+ * different harts */
+typedef struct flow_queue_stats
+{
+    volatile uint64_t packets;
+    volatile uint64_t bytes;
+    volatile uint64_t hart_id; /* Hart which last serviced the queue */
+} __attribute__((aligned(64))) flow_queue_stats_t;
+
+extern flow_queue_stats_t g_flow_queue_stats[MSS_MAC_QUEUE_COUNT];
+
+/* Clear the screeners, load the default indirection table and route the queue
+ * 1 to 3 interrupts away from the calling hart */
+void flow_steering_enable(mss_mac_instance_t *this_mac);
+
+/* Called by U54_n to take over the interrupt of queue n */
+void flow_steering_attach_hart(void);
+
+/* Non zero once hart_id has claimed its queue */
+uint32_t flow_steering_hart_attached(uint64_t hart_id);
+
+/* Replace one indirection table entry, queue_no must be 1 to 3 */
+void flow_steering_set_indirection(uint32_t index, uint32_t queue_no);
+
+uint32_t flow_steering_hash(const flow_5tuple_t *flow);
+
+uint32_t flow_steering_queue(const flow_5tuple_t *flow);
+
+/* Program a screener for the flow. Returns the queue the flow is steered to or
+ * FLOW_STEERING_NO_SCREENER */
+int32_t flow_steering_add_flow(const flow_5tuple_t *flow);
+
+void flow_steering_clear_stats(void);
+
+#endif /* FLOW_STEERING_H_ */
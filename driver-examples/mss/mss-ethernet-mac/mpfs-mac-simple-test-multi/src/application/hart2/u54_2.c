@@ -16,6 +16,7 @@
 #include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_sw_cfg.h"
 #include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_regs.h"
 #include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+#include "hart0/flow_steering.h"
 
 #if !(MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_EMUL_GMII_LOCAL)
 
@@ -59,6 +60,9 @@ u54_2(void)
      * application can enable and use any interrupts as required */
     clear_soft_interrupt();
 
+    /* Take over servicing of GEM queue 2 if flow steering has been enabled */
+    flow_steering_attach_hart();
+
     __enable_irq();
 
     MSS_UART_init(&g_mss_uart2_lo, MSS_UART_115200_BAUD, MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY);
@@ -11,6 +11,11 @@
 #include <string.h>
 #include "mpfs_hal/mss_hal.h"
 #include "drivers/mss/mss_mmuart/mss_uart.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_registers.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_sw_cfg.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac_regs.h"
+#include "drivers/mss/mss_ethernet_mac/mss_ethernet_mac.h"
+#include "hart0/flow_steering.h"
 
 volatile uint32_t count_sw_ints_h3 = 0U;
 
@@ -52,6 +57,9 @@ u54_3(void)
      * application can enable and use any interrupts as required */
     clear_soft_interrupt();
 
+    /* Take over servicing of GEM queue 3 if flow steering has been enabled */
+    flow_steering_attach_hart();
+
     __enable_irq();
 
     MSS_UART_init(&g_mss_uart3_lo, MSS_UART_115200_BAUD, MSS_UART_DATA_8_BITS | MSS_UART_NO_PARITY);
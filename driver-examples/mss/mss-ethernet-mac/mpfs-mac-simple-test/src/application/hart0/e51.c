@@ -1258,6 +1258,7 @@ print_help(void)
     PRINT_STRING(info_string);
     sprintf(info_string, "i - Increment all GEM stats counter registers\n\r");
     PRINT_STRING(info_string);
+    PRINT_STRING("I - Compare RX interrupt, moderated and adaptive poll modes\n\r");
     sprintf(info_string,
             "j - Toggle Jumbo Packet Mode---------------(%s)\n\r",
             0 != (g_test_mac->mac_base->NETWORK_CONFIG & GEM_JUMBO_FRAMES) ? "enabled" :
@@ -1329,6 +1330,7 @@ print_help(void)
     }
     sprintf(info_string, "q - Enter user mode loopback test\n\r");
     PRINT_STRING(info_string);
+    PRINT_STRING("Q - Measure TX packet rate for 64, 512 and 1518 byte packets\n\r");
     sprintf(info_string, "r - Reset statistics counts\n\r");
     PRINT_STRING(info_string);
     sprintf(info_string, "s - Show statistics\n\r");
@@ -2288,6 +2290,104 @@ display_clocks(void)
     PRINT_STRING(info_string);
 }
 
+/*==============================================================================
+ * Receive interrupt mode benchmark.
+ *
+ * Incoming traffic from an external generator is received for 2 seconds in
+ * each of three modes:
+ *  - One interrupt per receive complete event.
+ *  - Interrupt moderation of RX_BENCH_MODERATION * 800ns.
+ *  - Adaptive polling - the queue is polled from this loop once an interrupt
+ *    finds RX_BENCH_POLL_THRESHOLD or more packets waiting.
+ *
+ * The CPU load is estimated by counting iterations of this loop and comparing
+ * against a calibration pass made with the receive interrupts masked.
+ */
+#define RX_BENCH_MODERATION     25U  /* 20us */
+#define RX_BENCH_POLL_THRESHOLD 8U
+#define RX_BENCH_POLL_BUDGET    32U
+#define RX_BENCH_PERIOD_MS      2000U
+
+static uint64_t
+rx_bench_spin(uint32_t poll)
+{
+    volatile uint64_t loops = 0U;
+    uint64_t start_time = g_tick_counter;
+
+    while ((g_tick_counter - start_time) < RX_BENCH_PERIOD_MS)
+    {
+        if (0U != poll)
+        {
+            (void)MSS_MAC_rx_poll(g_test_mac, 0U, RX_BENCH_POLL_BUDGET);
+        }
+
+        loops++;
+    }
+
+    return (loops);
+}
+
+static void
+rx_mode_benchmark(char *info_string)
+{
+    static const char *mode_names[3] = {"interrupt", "moderated", "adaptive "};
+    uint32_t mode;
+    uint32_t old_rx_moderation;
+    uint32_t old_tx_moderation;
+    int old_loopback;
+    uint64_t idle_loops;
+    uint64_t loops;
+    uint64_t start_rx;
+    uint64_t start_interrupts;
+    uint64_t start_polls;
+    uint64_t pps;
+    uint64_t load;
+
+    MSS_MAC_get_int_moderation(g_test_mac, &old_rx_moderation, &old_tx_moderation);
+    old_loopback = g_loopback;
+    g_loopback = 0; /* Just count packets, don't echo them */
+
+    /* Calibrate with the receive interrupts masked */
+    g_test_mac->mac_base->INT_DISABLE = GEM_RECEIVE_COMPLETE | GEM_RX_USED_BIT_READ;
+    idle_loops = rx_bench_spin(0U);
+    g_test_mac->mac_base->INT_ENABLE = GEM_RECEIVE_COMPLETE | GEM_RX_USED_BIT_READ;
+
+    sprintf(info_string, "RX mode benchmark - %lu idle loops per %u ms\n\r",
+            idle_loops, RX_BENCH_PERIOD_MS);
+    PRINT_STRING(info_string);
+
+    for (mode = 0U; mode != 3U; mode++)
+    {
+        MSS_MAC_set_int_moderation(g_test_mac,
+                                   (1U == mode) ? RX_BENCH_MODERATION : 0U,
+                                   old_tx_moderation);
+        MSS_MAC_set_rx_poll_mode(g_test_mac, 0U,
+                                 (2U == mode) ? RX_BENCH_POLL_THRESHOLD : 0U);
+
+        start_rx = rx_count;
+        start_interrupts = g_test_mac->queue[0].rx_interrupts;
+        start_polls = g_test_mac->queue[0].rx_polls;
+
+        loops = rx_bench_spin(2U == mode);
+
+        pps = ((rx_count - start_rx) * 1000U) / RX_BENCH_PERIOD_MS;
+        load = (loops < idle_loops) ? (((idle_loops - loops) * 100U) / idle_loops) : 0U;
+
+        sprintf(info_string,
+                "%s: %lu pps, %lu interrupts, %lu polls, %lu%% CPU\n\r",
+                mode_names[mode],
+                pps,
+                g_test_mac->queue[0].rx_interrupts - start_interrupts,
+                g_test_mac->queue[0].rx_polls - start_polls,
+                load);
+        PRINT_STRING(info_string);
+    }
+
+    MSS_MAC_set_rx_poll_mode(g_test_mac, 0U, 0U);
+    MSS_MAC_set_int_moderation(g_test_mac, old_rx_moderation, old_tx_moderation);
+    g_loopback = old_loopback;
+}
+
 /*==============================================================================
  *
  */
@@ -3195,6 +3295,10 @@ mac_task(void *pvParameters)
                 PRINT_STRING("Incrementing stats counters\n\r");
                 g_test_mac->mac_base->NETWORK_CONTROL |= 0x40;
             }
+            else if (rx_buff[0] == 'I')
+            {
+                rx_mode_benchmark(info_string);
+            }
             else if (rx_buff[0] == 'j')
             {
                 if (0 == (g_test_mac->mac_base->NETWORK_CONFIG & GEM_JUMBO_FRAMES))
@@ -3663,6 +3767,87 @@ mac_task(void *pvParameters)
                 g_user_loopback = 0;
                 PRINT_STRING("User mode loopback disabled.\n\r");
             }
+            else if (rx_buff[0] == 'Q')
+            {
+                static uint8_t rate_pkt[1518];
+                static const uint32_t rate_sizes[3] = {64U, 512U, 1518U};
+                uint32_t size_index;
+                uint32_t packet_size;
+                int32_t tx_status;
+                uint64_t sent;
+                uint64_t done;
+                uint64_t start_count;
+                uint64_t start_time;
+                uint64_t elapsed;
+                uint64_t pps;
+
+#if defined(MSS_MAC_PIPELINED_TX_QUEUE)
+                sprintf(info_string,
+                        "TX packet rate test - pipelined queue, %u descriptors\n\r",
+                        (unsigned int)MSS_MAC_TX_RING_SIZE);
+#else
+                sprintf(info_string, "TX packet rate test - single packet queue\n\r");
+#endif
+                PRINT_STRING(info_string);
+
+                memset(rate_pkt, 0xFF, sizeof(rate_pkt));
+                memcpy(rate_pkt, tx_pak_arp, sizeof(tx_pak_arp));
+
+                for (size_index = 0; size_index != 3; size_index++)
+                {
+                    packet_size = rate_sizes[size_index];
+                    sent = 0;
+                    tx_status = MSS_MAC_ERR_OK;
+                    start_count = tx_count;
+                    start_time = g_tick_counter;
+
+                    /* Keep the queue topped up for 2 seconds */
+                    while ((g_tick_counter - start_time) < 2000U)
+                    {
+                        tx_status = MSS_MAC_send_pkt(g_test_mac,
+                                                     0,
+                                                     rate_pkt,
+                                                     packet_size | g_crc,
+                                                     (void *)0);
+                        if (MSS_MAC_ERR_OK == tx_status)
+                        {
+                            sent++;
+                        }
+                        else if (MSS_MAC_ERR_NOT_DONE != tx_status)
+                        {
+                            break;
+                        }
+                    }
+
+                    /* Wait for the packets still in the ring to go out */
+                    while (((tx_count - start_count) < sent) &&
+                           ((g_tick_counter - start_time) < 3000U))
+                    {
+                    }
+
+                    elapsed = g_tick_counter - start_time;
+                    done = tx_count - start_count;
+                    pps = (0U != elapsed) ? ((done * 1000U) / elapsed) : 0U;
+
+                    sprintf(info_string,
+                            "%4u bytes: %lu packets in %lu ms, %lu pps, %lu Mbps\n\r",
+                            (unsigned int)packet_size,
+                            done,
+                            elapsed,
+                            pps,
+                            (pps * packet_size * 8U) / 1000000U);
+                    PRINT_STRING(info_string);
+
+                    if ((MSS_MAC_ERR_OK != tx_status) && (MSS_MAC_ERR_NOT_DONE != tx_status))
+                    {
+                        sprintf(info_string,
+                                "Transmission error %d - exiting test\n\r",
+                                (int)tx_status);
+                        PRINT_STRING(info_string);
+                        break;
+                    }
+                }
+            }
             else if (rx_buff[0] == 'r')
             {
                 PRINT_STRING("Stats reset\n\r");
@@ -152,7 +152,7 @@ static void rx_desc_ring_init(mss_mac_instance_t *this_mac);
 static void assign_station_addr(mss_mac_instance_t *this_mac,
                                 const uint8_t mac_addr[MSS_MAC_MAC_LEN]);
 static void generic_mac_irq_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
-static void rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
+static uint32_t rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no, uint32_t budget);
 static void txpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
 static void update_mac_cfg(const mss_mac_instance_t *this_mac);
 static uint8_t probe_phy(const mss_mac_instance_t *this_mac);
@@ -350,11 +350,15 @@ MSS_MAC_init(mss_mac_instance_t *this_mac, mss_mac_cfg_t *cfg)
         {
             /* Initialize Tx descriptors related variables. */
             this_mac->queue[queue_no].nb_available_tx_desc = MSS_MAC_TX_RING_SIZE;
+            this_mac->queue[queue_no].current_tx_desc = 0U;
+            this_mac->queue[queue_no].next_tx_desc = 0U;
 
             /* Initialize Rx descriptors related variables. */
             this_mac->queue[queue_no].nb_available_rx_desc = MSS_MAC_RX_RING_SIZE;
             this_mac->queue[queue_no].next_free_rx_desc_index = 0U;
             this_mac->queue[queue_no].first_rx_desc_index = 0U;
+            this_mac->queue[queue_no].rx_poll_threshold = 0U;
+            this_mac->queue[queue_no].rx_polling = 0U;
 
             /* initialize default interrupt handlers */
             this_mac->queue[queue_no].pckt_tx_callback = (mss_mac_transmit_callback_t)NULL_POINTER;
@@ -1824,7 +1828,91 @@ MSS_MAC_send_pkt(mss_mac_instance_t *this_mac,
             p_tx_status = &this_mac->mac_base->TRANSMIT_STATUS;
         }
 
-#if defined(MSS_MAC_SIMPLE_TX_QUEUE)
+#if defined(MSS_MAC_PIPELINED_TX_QUEUE)
+        /*
+         * Pipelined transmit operation. Each packet is appended to the ring
+         * after the packets already queued and the GEM keeps transmitting
+         * until it reaches a descriptor with the USED bit set. One descriptor
+         * is always left free so the GEM has somewhere to stop. The queue
+         * pointer is only written when the ring is empty and the GEM is idle.
+         */
+        if (this_mac->queue[queue_no].nb_available_tx_desc > 1U)
+        {
+            mss_mac_queue_t *p_queue = &this_mac->queue[queue_no];
+            uint32_t desc_index;
+            uint32_t desc_status;
+
+            if ((p_queue->nb_available_tx_desc == (uint32_t)MSS_MAC_TX_RING_SIZE) &&
+                (0 == (*p_tx_status & GEM_TRANSMIT_GO)))
+            {
+                p_queue->tries = 0UL;
+
+                /* Make sure transmit is enabled */
+                if (0 == (*p_nw_control & GEM_ENABLE_TRANSMIT))
+                {
+                    *p_nw_control = *p_nw_control | GEM_ENABLE_TRANSMIT;
+                }
+
+                /* Restart the ring from the first descriptor */
+                p_queue->current_tx_desc = 0U;
+                p_queue->next_tx_desc = 0U;
+
+                *p_queue->transmit_q_ptr = (uint32_t)((uint64_t)p_queue->tx_desc_tab) | 1UL;
+                *p_queue->transmit_q_ptr = (uint32_t)((uint64_t)&p_queue->tx_desc_tab[0]);
+
+                /*
+                 * If not queue 0 then we need to write disabled value to queue 0
+                 * to get the DMA engine reloaded...
+                 */
+                if (0U != queue_no)
+                {
+                    *this_mac->queue[0].transmit_q_ptr =
+                        (uint32_t)((uint64_t)this_mac->queue[0].tx_desc_tab) | 1U;
+                }
+            }
+
+            desc_index = p_queue->next_tx_desc;
+
+            p_queue->tx_desc_tab[desc_index].addr_low = (uint32_t)((uint64_t)tx_buffer);
+#if defined(MSS_MAC_64_BIT_ADDRESS_MODE)
+            p_queue->tx_desc_tab[desc_index].addr_high = (uint32_t)((uint64_t)tx_buffer >> 32);
+            p_queue->tx_desc_tab[desc_index].unused = 0U;
+#endif
+            p_queue->tx_caller_info[desc_index] = p_user_data;
+
+            /* Mark as last buffer for frame */
+            desc_status = (tx_length & GEM_TX_DMA_BUFF_LEN) | GEM_TX_DMA_LAST;
+            if (0 != no_crc)
+            {
+                desc_status |= GEM_TX_DMA_NO_CRC;
+            }
+
+            if (((uint32_t)MSS_MAC_TX_RING_SIZE - 1U) == desc_index)
+            {
+                desc_status |= GEM_TX_DMA_WRAP;
+            }
+
+            /* Descriptor address must be visible before the GEM owns it */
+            mb();
+            p_queue->tx_desc_tab[desc_index].status = desc_status;
+            mb();
+
+            p_queue->next_tx_desc = (desc_index + 1U) % (uint32_t)MSS_MAC_TX_RING_SIZE;
+            p_queue->nb_available_tx_desc--;
+
+            /* Has no effect if the GEM is still working through the ring */
+            *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+
+            p_queue->egress += tx_length;
+            status = MSS_MAC_ERR_OK;
+        }
+        else
+        {
+            /* Ring full, kick the tx start bit in case we are stalled... */
+            this_mac->queue[queue_no].tx_restart++;
+            *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+        }
+#elif defined(MSS_MAC_SIMPLE_TX_QUEUE)
         if (this_mac->queue[queue_no].nb_available_tx_desc == (uint32_t)MSS_MAC_TX_RING_SIZE)
         {
             /* Queue is fully available for transmit so clear retry count */
@@ -3163,6 +3251,7 @@ generic_mac_irq_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
     uint32_t volatile *tx_status; /* Address of transmit status register */
     uint32_t volatile *int_status; /* Address of interrupt status register */
     mss_mac_queue_t *p_queue;
+    uint32_t rx_count;
 
     p_queue = &this_mac->queue[queue_no];
 
@@ -3200,8 +3289,20 @@ generic_mac_irq_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
 #else
         *int_status = (uint32_t)2U;
 #endif
-        rxpkt_handler(this_mac, queue_no);
+        p_queue->rx_interrupts++;
+        rx_count = rxpkt_handler(this_mac, queue_no, MSS_MAC_RX_RING_SIZE);
         p_queue->overflow_counter = 0U; /* Reset counter as we have received something */
+
+        /*
+         * A burst of frames in one interrupt means the queue is busy so stop
+         * taking receive interrupts and let MSS_MAC_rx_poll() empty the queue
+         * until it runs dry.
+         */
+        if ((0U != p_queue->rx_poll_threshold) && (rx_count >= p_queue->rx_poll_threshold))
+        {
+            *p_queue->int_disable = GEM_RECEIVE_COMPLETE;
+            p_queue->rx_polling = 1U;
+        }
 #endif
     }
 
@@ -3242,7 +3343,7 @@ generic_mac_irq_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
 #if !defined(GEM_FLAGS_CLR_ON_RD)
             *int_status = GEM_RX_USED_BIT_READ;
 #endif
-            rxpkt_handler(this_mac, queue_no);
+            (void)rxpkt_handler(this_mac, queue_no, MSS_MAC_RX_RING_SIZE);
             p_queue->rx_overflow++;
             p_queue->overflow_counter++;
         }
@@ -4927,6 +5028,171 @@ MSS_MAC_get_rx_cutthru(const mss_mac_instance_t *this_mac)
     return (temp_reg);
 }
 
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+void
+MSS_MAC_set_int_moderation(const mss_mac_instance_t *this_mac,
+                           uint32_t rx_moderation,
+                           uint32_t tx_moderation)
+{
+    volatile uint32_t *p_reg;
+
+    if (MSS_MAC_AVAILABLE == this_mac->mac_available)
+    {
+        p_reg = (0U != this_mac->is_emac) ? &this_mac->emac_base->INT_MODERATION :
+                                            &this_mac->mac_base->INT_MODERATION;
+
+        /* Clamp to the 8 bit fields rather than wrapping to a short time */
+        if (rx_moderation > BITS_08)
+        {
+            rx_moderation = BITS_08;
+        }
+
+        if (tx_moderation > BITS_08)
+        {
+            tx_moderation = BITS_08;
+        }
+
+        *p_reg = (rx_moderation & GEM_RX_INT_MODERATION) |
+                 ((tx_moderation << 16) & GEM_TX_INT_MODERATION);
+    }
+}
+
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+void
+MSS_MAC_get_int_moderation(const mss_mac_instance_t *this_mac,
+                           uint32_t *rx_moderation,
+                           uint32_t *tx_moderation)
+{
+    uint32_t temp_reg = 0U;
+
+    if (MSS_MAC_AVAILABLE == this_mac->mac_available)
+    {
+        temp_reg = (0U != this_mac->is_emac) ? this_mac->emac_base->INT_MODERATION :
+                                               this_mac->mac_base->INT_MODERATION;
+    }
+
+    *rx_moderation = temp_reg & GEM_RX_INT_MODERATION;
+    *tx_moderation = (temp_reg & GEM_TX_INT_MODERATION) >> 16;
+}
+
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+void
+MSS_MAC_set_rx_poll_mode(mss_mac_instance_t *this_mac, uint32_t queue_no, uint32_t threshold)
+{
+    mss_mac_queue_t *p_queue;
+
+    if (MSS_MAC_AVAILABLE == this_mac->mac_available)
+    {
+        p_queue = &this_mac->queue[queue_no];
+
+        if (0U != this_mac->use_local_ints)
+        {
+            __disable_local_irq(this_mac->mac_q_int[queue_no]);
+        }
+        else
+        {
+            PLIC_DisableIRQ(this_mac->mac_q_int[queue_no]);
+        }
+
+        p_queue->rx_poll_threshold = threshold;
+
+        /* Hand a queue which is being polled back to its interrupt */
+        if ((0U == threshold) && (0U != p_queue->rx_polling))
+        {
+            p_queue->rx_polling = 0U;
+            *p_queue->int_enable = GEM_RECEIVE_COMPLETE;
+        }
+
+        if (0U != this_mac->use_local_ints)
+        {
+            __enable_local_irq(this_mac->mac_q_int[queue_no]);
+        }
+        else
+        {
+            PLIC_EnableIRQ(this_mac->mac_q_int[queue_no]);
+        }
+    }
+}
+
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+
+uint32_t
+MSS_MAC_rx_poll(mss_mac_instance_t *this_mac, uint32_t queue_no, uint32_t budget)
+{
+    mss_mac_queue_t *p_queue = &this_mac->queue[queue_no];
+    uint32_t rx_count = 0U;
+
+    if ((MSS_MAC_AVAILABLE == this_mac->mac_available) && (0U != p_queue->rx_polling) &&
+        (0U != budget))
+    {
+        /*
+         * Keep the rest of the queue interrupt out of the way and mark the
+         * queue as in ISR so the receive call-back can hand buffers back
+         * without touching the interrupt enables.
+         */
+        if (0U != this_mac->use_local_ints)
+        {
+            __disable_local_irq(this_mac->mac_q_int[queue_no]);
+        }
+        else
+        {
+            PLIC_DisableIRQ(this_mac->mac_q_int[queue_no]);
+        }
+
+        p_queue->in_isr = 1U;
+
+        /* Clear the flags first so any frame arriving from now on is seen */
+        if (0U != this_mac->is_emac)
+        {
+            this_mac->emac_base->RECEIVE_STATUS = GEM_FRAME_RECEIVED;
+        }
+        else
+        {
+            this_mac->mac_base->RECEIVE_STATUS = GEM_FRAME_RECEIVED;
+        }
+
+        *p_queue->int_status = GEM_RECEIVE_COMPLETE;
+
+        rx_count = rxpkt_handler(this_mac, queue_no, budget);
+        p_queue->rx_polls++;
+
+        /*
+         * Queue ran dry within the budget so go back to interrupts. A frame
+         * which landed after the ring was emptied has already set the receive
+         * complete flag so the interrupt fires as soon as it is unmasked.
+         */
+        if (rx_count < budget)
+        {
+            p_queue->rx_polling = 0U;
+            *p_queue->int_enable = GEM_RECEIVE_COMPLETE;
+        }
+
+        p_queue->in_isr = 0U;
+
+        if (0U != this_mac->use_local_ints)
+        {
+            __enable_local_irq(this_mac->mac_q_int[queue_no]);
+        }
+        else
+        {
+            PLIC_EnableIRQ(this_mac->mac_q_int[queue_no]);
+        }
+    }
+
+    return (rx_count);
+}
+
 /******************************************************************************
  * See mss_ethernet_mac.h for details of how to use this function.
  */
@@ -5138,13 +5404,15 @@ MSS_MAC_get_pause_frame_copy_to_mem(const mss_mac_instance_t *this_mac)
  * descriptor that received the packet and caused the interrupt.
  * This informs the received packet size to the application and
  * relinquishes the packet buffer from the associated DMA descriptor.
+ *
+ * At most budget packets are handled and the number handled is returned.
  */
-static void
-rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
+static uint32_t
+rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no, uint32_t budget)
 {
     mss_mac_queue_t *this_queue = &this_mac->queue[queue_no];
     mss_mac_rx_desc_t *cdesc = &this_queue->rx_desc_tab[this_queue->first_rx_desc_index];
-    uint64_t burst = MSS_MAC_RX_RING_SIZE;
+    uint64_t burst = budget;
 
     if (0U != (cdesc->addr_low & GEM_RX_DMA_USED)) /* Check in case we already got it... */
     {
@@ -5223,6 +5491,8 @@ rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
     {
         this_mac->mac_base->NETWORK_CONTROL |= GEM_ENABLE_RECEIVE;
     }
+
+    return ((uint32_t)(budget - burst));
 }
 
 /******************************************************************************
@@ -5234,7 +5504,61 @@ rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
 static void
 txpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
 {
-#if defined(MSS_MAC_SIMPLE_TX_QUEUE)
+#if defined(MSS_MAC_PIPELINED_TX_QUEUE)
+    mss_mac_queue_t *this_queue = &this_mac->queue[queue_no];
+    mss_mac_tx_desc_t *p_current_desc;
+    volatile uint32_t *p_nw_control;
+    volatile uint32_t *p_tx_status;
+
+    /*
+     * Reclaim every descriptor the GEM has finished with in one pass. The GEM
+     * sets the USED bit of each descriptor once its frame has been sent.
+     */
+    while (this_queue->nb_available_tx_desc < (uint32_t)MSS_MAC_TX_RING_SIZE)
+    {
+        p_current_desc = &this_queue->tx_desc_tab[this_queue->current_tx_desc];
+
+        if (0U == (p_current_desc->status & GEM_TX_DMA_USED))
+        {
+            break;
+        }
+
+        if (NULL_POINTER != this_queue->pckt_tx_callback)
+        {
+            this_queue->pckt_tx_callback(this_mac,
+                                         (uint32_t)queue_no,
+                                         p_current_desc,
+                                         this_queue->tx_caller_info[this_queue->current_tx_desc]);
+        }
+
+        this_queue->current_tx_desc =
+            (this_queue->current_tx_desc + 1U) % (uint32_t)MSS_MAC_TX_RING_SIZE;
+        this_queue->nb_available_tx_desc++;
+    }
+
+    if (0U != this_mac->is_emac)
+    {
+        p_nw_control = &this_mac->emac_base->NETWORK_CONTROL;
+        p_tx_status = &this_mac->emac_base->TRANSMIT_STATUS;
+    }
+    else
+    {
+        p_nw_control = &this_mac->mac_base->NETWORK_CONTROL;
+        p_tx_status = &this_mac->mac_base->TRANSMIT_STATUS;
+    }
+
+    /*
+     * The GEM may have read the USED bit of a descriptor just before
+     * MSS_MAC_send_pkt() handed it over, in which case it has stopped with
+     * frames still queued. Restart it.
+     */
+    if ((this_queue->nb_available_tx_desc < (uint32_t)MSS_MAC_TX_RING_SIZE) &&
+        (0U == (*p_tx_status & GEM_TRANSMIT_GO)))
+    {
+        this_queue->tx_restart++;
+        *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+    }
+#elif defined(MSS_MAC_SIMPLE_TX_QUEUE)
     mss_mac_queue_t *this_queue = &this_mac->queue[queue_no];
     mss_mac_tx_desc_t *p_current_desc;
     uint32_t finished;
@@ -161,6 +161,18 @@
     by the application and can be used to, for example, release the memory used
     to store the packet that was sent.
     
+    By default (MSS_MAC_SIMPLE_TX_QUEUE) each queue has a single packet in
+    flight and _MSS_MAC_send_pkt()_ returns MSS_MAC_ERR_NOT_DONE until the
+    previous packet has been sent. If MSS_MAC_PIPELINED_TX_QUEUE is defined in
+    the project settings, the full MSS_MAC_TX_RING_SIZE descriptor ring is used
+    instead. Each call to _MSS_MAC_send_pkt()_ appends one packet to the ring
+    and the GEM works through the queued packets back to back. Up to
+    MSS_MAC_TX_RING_SIZE - 1 packets can be queued, as one descriptor is kept
+    with its USED bit set to stop the GEM. The transmit complete interrupt
+    handler reclaims all the descriptors that have been sent in one pass and
+    calls the transmit call-back function once for each packet.
+    MSS_MAC_PIPELINED_TX_QUEUE takes precedence over MSS_MAC_SIMPLE_TX_QUEUE.
+    
     The following functions are used as part of the transmit operations:
         - _MSS_MAC_send_pkt()_
         - _MSS_MAC_send_pkts()_
@@ -179,9 +191,25 @@
     MAC driver unless it is re-allocated to the driver by a call to
     _MSS_MAC_receive_pkt()_.
     
+    Under heavy receive load the cost of taking one interrupt per packet can
+    be reduced in two ways. _MSS_MAC_set_int_moderation()_ makes the GEM hold
+    off the receive and transmit complete interrupts for a set time so that
+    several packets are handled per interrupt. _MSS_MAC_set_rx_poll_mode()_
+    enables an adaptive polled mode for a queue. When a single receive
+    interrupt finds at least the given number of packets, the receive complete
+    interrupt for that queue is turned off and the application empties the
+    queue by calling _MSS_MAC_rx_poll()_ with a budget of packets to handle,
+    typically from its main loop. Once a poll finds fewer packets than its
+    budget the queue has gone idle and the receive interrupt is turned back on.
+    The receive call-back is called in the same way in both modes.
+
     The following functions are used as part of the receive operations:
         - _MSS_MAC_receive_pkt()_
         - _MSS_MAC_set_rx_callback()_
+        - _MSS_MAC_set_int_moderation()_
+        - _MSS_MAC_get_int_moderation()_
+        - _MSS_MAC_set_rx_poll_mode()_
+        - _MSS_MAC_rx_poll()_
         
     @subsection stats Reading Status and Statistics
     The MSS Ethernet MAC driver provides the following functions to retrieve the
@@ -293,6 +321,12 @@ extern "C" {
  */
 #define MSS_MAC_JUMBO_MAX (10240U)
 
+/***************************************************************************//**
+ * Interrupt moderation time unit in nanoseconds, see
+ * _MSS_MAC_set_int_moderation()_.
+ */
+#define MSS_MAC_INT_MODERATION_NS (800U)
+
 /***************************************************************************//**
  * Maximum MAC frame size (packet size)
  *
@@ -880,7 +914,8 @@ void MSS_MAC_change_speed
 
      - ___MSS_MAC_ERR_OK___ on successfully launching the packet.
      - ___MSS_MAC_ERR_NOT_DONE___ if the previous packet has not finished
-          sending.
+          sending. When MSS_MAC_PIPELINED_TX_QUEUE is defined this is only
+          returned when the transmit descriptor ring is full.
      - ___MSS_MAC_ERR_NOT_OK___ for general errors.
      - ___MSS_MAC_ERR_TX_TIMEOUT___ If the previous packet has not released the
           queue buffers after the MAC completes the send.
@@ -3403,6 +3438,165 @@ MSS_MAC_get_rx_cutthru
     const mss_mac_instance_t *this_mac
 );
 
+/***************************************************************************//**
+  The _MSS_MAC_set_int_moderation()_ function is used to set the interrupt
+  moderation times for the GEM. After a receive or transmit complete interrupt
+  is raised, the next one is held off for the moderation time so that a burst
+  of packets can be handled in one interrupt. The times are in units of
+  MSS_MAC_INT_MODERATION_NS (800ns) and a value of 0 disables moderation. Values
+  above 255 are limited to 255.
+
+  The setting applies to all the queues of the MAC.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param rx_moderation
+    This parameter is the receive complete interrupt moderation time in 800ns
+    units.
+
+  @param tx_moderation
+    This parameter is the transmit complete interrupt moderation time in 800ns
+    units.
+
+  @return
+    This function does not return a value.
+
+  Example:
+    This example limits the receive interrupt rate to roughly one every 20us.
+
+  @code
+    #include "mss_ethernet_mac.h"
+
+    MSS_MAC_set_int_moderation(&g_mac0, 20000U / MSS_MAC_INT_MODERATION_NS, 0U);
+  @endcode
+ */
+void
+MSS_MAC_set_int_moderation
+(
+    const mss_mac_instance_t *this_mac,
+    uint32_t rx_moderation,
+    uint32_t tx_moderation
+);
+
+/***************************************************************************//**
+  The _MSS_MAC_get_int_moderation()_ function is used to retrieve the current
+  interrupt moderation times for the GEM.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param rx_moderation
+    This parameter is a pointer to where the receive complete interrupt
+    moderation time in 800ns units is returned.
+
+  @param tx_moderation
+    This parameter is a pointer to where the transmit complete interrupt
+    moderation time in 800ns units is returned.
+
+  @return
+    This function does not return a value.
+ */
+void
+MSS_MAC_get_int_moderation
+(
+    const mss_mac_instance_t *this_mac,
+    uint32_t *rx_moderation,
+    uint32_t *tx_moderation
+);
+
+/***************************************************************************//**
+  The _MSS_MAC_set_rx_poll_mode()_ function is used to enable or disable the
+  adaptive polled receive mode for a queue.
+
+  When enabled, a receive interrupt which handles threshold or more packets
+  switches the queue to polled operation. The receive complete interrupt for
+  the queue is disabled and the application must then call _MSS_MAC_rx_poll()_
+  regularly until the queue goes idle and the interrupt is re-enabled. Setting
+  threshold to 0 disables the mode and re-enables the receive interrupt if the
+  queue is currently being polled.
+
+  This function must not be called from the receive call-back function.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param queue_no
+    This parameter identifies the queue which this function operates on.
+
+  @param threshold
+    This parameter is the number of packets handled in a single receive
+    interrupt which switches the queue to polled operation. 0 disables polled
+    operation.
+
+  @return
+    This function does not return a value.
+ */
+void
+MSS_MAC_set_rx_poll_mode
+(
+    mss_mac_instance_t *this_mac,
+    uint32_t queue_no,
+    uint32_t threshold
+);
+
+/***************************************************************************//**
+  The _MSS_MAC_rx_poll()_ function is used to empty a queue which has been
+  switched to polled operation. Up to budget received packets are passed to the
+  receive call-back function. If fewer than budget packets were waiting, the
+  queue is considered idle and its receive interrupt is re-enabled. Nothing is
+  done if the queue is not currently being polled.
+
+  This function must not be called from the receive call-back function.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param queue_no
+    This parameter identifies the queue which this function operates on.
+
+  @param budget
+    This parameter is the maximum number of packets to handle in this call.
+
+  @return
+    This function returns the number of packets handled.
+
+  Example:
+    This example switches queue 0 to polled operation after 8 packets in one
+    interrupt and services it from the main loop.
+
+  @code
+    #include "mss_ethernet_mac.h"
+
+    MSS_MAC_set_rx_poll_mode(&g_mac0, 0U, 8U);
+
+    while(1)
+    {
+        (void)MSS_MAC_rx_poll(&g_mac0, 0U, 64U);
+        do_other_work();
+    }
+  @endcode
+ */
+uint32_t
+MSS_MAC_rx_poll
+(
+    mss_mac_instance_t *this_mac,
+    uint32_t queue_no,
+    uint32_t budget
+);
+
 /***************************************************************************//**
   The _MSS_MAC_tx_enable()_ function is used to start or restart transmit
   operations. It can be used as part of recovery from errors which may have
@@ -1248,6 +1248,7 @@ typedef struct mss_mac_queue
     mss_mac_receive_callback_t   pckt_rx_callback; /*!< Pointer to receive handler call back function */
     volatile uint32_t            nb_available_tx_desc; /*!< Number of free TX descriptors available */
     volatile uint32_t            current_tx_desc; /*!< Oldest in the queue... */
+    volatile uint32_t            next_tx_desc; /*!< Next TX descriptor to fill when MSS_MAC_PIPELINED_TX_QUEUE is defined */
     volatile uint32_t            nb_available_rx_desc; /*!< Number of free RX descriptors available */
     volatile uint32_t            next_free_rx_desc_index; /*!< Next RX descriptor to allocate */
     volatile uint32_t            first_rx_desc_index; /*!< Descriptor to process next when receive handler called */
@@ -1255,6 +1256,8 @@ typedef struct mss_mac_queue
     uint32_t                     overflow_counter; /*!< Overflows since last normal receive operation */
     uint32_t                     tries;  /*!< Keeps track of failure to sends... */
     volatile int32_t             in_isr; /*!< Set when processing ISR so functions don't call PLIC enable/disable for protection */
+    volatile uint32_t            rx_poll_threshold; /*!< Frames per receive interrupt which switch the queue to polled receive, 0 to disable */
+    volatile uint32_t            rx_polling; /*!< Set while receive interrupts are off and the queue is emptied by MSS_MAC_rx_poll() */
 
     /* Queue specific register addresses to simplify the driver code */
     volatile uint32_t           *int_status;        /*!< interrupt status */
@@ -1275,6 +1278,8 @@ typedef struct mss_mac_queue
     volatile uint64_t tx_amba_errors; /*!< Number of receive amba error events on this queue */
     volatile uint64_t tx_restart; /*!< Number of times transmission has been restarted on this queue */
     volatile uint64_t tx_reenable; /*!< Number of times transmission has been reenabled on this queue */
+    volatile uint64_t rx_interrupts; /*!< Number of receive complete interrupts taken on this queue */
+    volatile uint64_t rx_polls; /*!< Number of MSS_MAC_rx_poll() calls which serviced this queue */
 } mss_mac_queue_t;
 
 
@@ -61,6 +61,7 @@ typedef socklen_t SOCKLEN_T;
 /* lwIP includes. */
 #include "lwip/tcpip.h"
 #include "lwip/dhcp.h"
+#include "lwip/api.h"
 
 #include "inc/common.h"
 
@@ -350,10 +351,133 @@ blinky_task(void *pvParameters)
     }
 }
 
+/*==============================================================================
+ * TCP throughput test.
+ *
+ * Port 5001 discards everything it receives so it can be used as the server
+ * for "iperf -c <address>" (iperf 2). Port 5002 sends data for
+ * TCP_PERF_TX_SECONDS to whoever connects, for example "nc <address> 5002 >
+ * /dev/null". The rate of the last connection in each direction is shown by
+ * the '4' command.
+ */
+#define TCP_PERF_RX_PORT    5001U
+#define TCP_PERF_TX_PORT    5002U
+#define TCP_PERF_TX_SECONDS 10U
+
+typedef struct tcp_perf_result
+{
+    volatile uint64_t bytes;
+    volatile uint32_t ms;
+} tcp_perf_result_t;
+
+static tcp_perf_result_t g_tcp_perf_rx;
+static tcp_perf_result_t g_tcp_perf_tx;
+static uint8_t g_tcp_perf_tx_data[4 * TCP_MSS];
+
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+extern uint32_t g_rx_checksum_hw;
+extern uint32_t g_rx_checksum_sw;
+extern uint32_t g_rx_checksum_bad;
+#endif
+
+static void
+tcp_perf_task(void *pvParameters)
+{
+    struct netconn *conn;
+    struct netconn *newconn;
+    struct netbuf *inbuf;
+    tcp_perf_result_t *result;
+    TickType_t start;
+    uint64_t bytes;
+    uint32_t port = (uint32_t)(uintptr_t)pvParameters;
+
+    result = (TCP_PERF_RX_PORT == port) ? &g_tcp_perf_rx : &g_tcp_perf_tx;
+
+    conn = netconn_new(NETCONN_TCP);
+    LWIP_ERROR("tcp_perf: invalid conn", (conn != NULL), vTaskDelete(NULL););
+    netconn_bind(conn, IP_ADDR_ANY, (u16_t)port);
+    netconn_listen(conn);
+
+    for (;;)
+    {
+        if (ERR_OK != netconn_accept(conn, &newconn))
+        {
+            continue;
+        }
+
+        bytes = 0U;
+        start = xTaskGetTickCount();
+
+        if (TCP_PERF_RX_PORT == port)
+        {
+            while (ERR_OK == netconn_recv(newconn, &inbuf))
+            {
+                bytes += netbuf_len(inbuf);
+                netbuf_delete(inbuf);
+            }
+        }
+        else
+        {
+            while ((xTaskGetTickCount() - start) <
+                   (TickType_t)(TCP_PERF_TX_SECONDS * configTICK_RATE_HZ))
+            {
+                if (ERR_OK != netconn_write(newconn,
+                                            g_tcp_perf_tx_data,
+                                            sizeof(g_tcp_perf_tx_data),
+                                            NETCONN_NOCOPY))
+                {
+                    break;
+                }
+
+                bytes += sizeof(g_tcp_perf_tx_data);
+            }
+        }
+
+        result->ms = (uint32_t)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
+        result->bytes = bytes;
+
+        netconn_close(newconn);
+        netconn_delete(newconn);
+    }
+}
+
+static void
+print_tcp_perf(void)
+{
+    int8_t info_string[120];
+    const tcp_perf_result_t *result;
+    uint32_t index;
+
+    for (index = 0U; index != 2U; index++)
+    {
+        result = (0U == index) ? &g_tcp_perf_rx : &g_tcp_perf_tx;
+        sprintf(info_string,
+                "TCP %s: %lu bytes in %u ms, %lu Mbps\n\r",
+                (0U == index) ? "RX (port 5001)" : "TX (port 5002)",
+                result->bytes,
+                result->ms,
+                (0U != result->ms) ? ((result->bytes * 8U) / (result->ms * 1000U)) : 0U);
+        MSS_UART_polled_tx_string(UART_DEMO, info_string);
+    }
+
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+    sprintf(info_string,
+            "Checksum offload on: %u checked by GEM, %u in software, %u bad\n\r",
+            g_rx_checksum_hw,
+            g_rx_checksum_sw,
+            g_rx_checksum_bad);
+#else
+    sprintf(info_string, "Checksum offload off\n\r");
+#endif
+    MSS_UART_polled_tx_string(UART_DEMO, info_string);
+}
+
 TaskHandle_t thandle_uart;
 TaskHandle_t thandle_link;
 TaskHandle_t thandle_web;
 TaskHandle_t thandle_blinky;
+TaskHandle_t thandle_perf_rx;
+TaskHandle_t thandle_perf_tx;
 
 void
 e51(void)
@@ -411,6 +535,32 @@ free_rtos(void)
             ix++;
     }
 
+    rtos_result = xTaskCreate(tcp_perf_task,
+                              (char *)"tcp_perf_rx",
+                              1000,
+                              (void *)(uintptr_t)TCP_PERF_RX_PORT,
+                              uartPRIMARY_PRIORITY + 3,
+                              &thandle_perf_rx);
+    if (1 != rtos_result)
+    {
+        int ix;
+        for (;;)
+            ix++;
+    }
+
+    rtos_result = xTaskCreate(tcp_perf_task,
+                              (char *)"tcp_perf_tx",
+                              1000,
+                              (void *)(uintptr_t)TCP_PERF_TX_PORT,
+                              uartPRIMARY_PRIORITY + 3,
+                              &thandle_perf_tx);
+    if (1 != rtos_result)
+    {
+        int ix;
+        for (;;)
+            ix++;
+    }
+
     /* Create the task the Ethernet link status. */
     rtos_result = xTaskCreate(prvLinkStatusTask,
                               (char *)"EthLinkStatus",
@@ -428,6 +578,8 @@ free_rtos(void)
     vTaskSuspend(thandle_blinky);
     vTaskSuspend(thandle_link);
     vTaskSuspend(thandle_web);
+    vTaskSuspend(thandle_perf_rx);
+    vTaskSuspend(thandle_perf_tx);
 
     /* Start the kernel.  From here on, only tasks and interrupts will run. */
     vTaskStartScheduler();
@@ -964,6 +1116,9 @@ e51_task(void *pvParameters)
     MSS_UART_polled_tx_string(
         UART_DEMO,
         "Adjust as required, modify #define MY_STATIC_IP_ADDRESS xx.xx.xx.xx etc\n\r");
+    MSS_UART_polled_tx_string(
+        UART_DEMO,
+        "TCP throughput: iperf -c <address> for RX, nc <address> 5002 for TX, 4 shows results\n\r");
 
     //    PRINT_STRING("PolarFire MSS Ethernet Dual eMAC/pMAC Test program\n\r");
 
@@ -1015,6 +1170,8 @@ e51_task(void *pvParameters)
     }
 
     vTaskResume(thandle_web);
+    vTaskResume(thandle_perf_rx);
+    vTaskResume(thandle_perf_tx);
     vTaskResume(thandle_link);
     vTaskResume(thandle_blinky);
 
@@ -1057,6 +1214,10 @@ e51_task(void *pvParameters)
                 raise_soft_interrupt((uint32_t)1);
                 MSS_UART_polled_tx_string(UART_DEMO, "Raise sw int hart 1\n\r");
             }
+            else if (rx_buff[0] == '4')
+            {
+                print_tcp_perf();
+            }
             else
             {
                 /* echo the rx char */
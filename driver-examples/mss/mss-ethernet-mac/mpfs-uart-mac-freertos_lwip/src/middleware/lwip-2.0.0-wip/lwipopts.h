@@ -1838,11 +1838,21 @@
 #define LWIP_CHECKSUM_CTRL_PER_NETIF    0
 #endif
 
+/**
+ * MPFS_ETHERNETIF_CHECKSUM_OFFLOAD==1: The GEM generates and checks the IPv4,
+ * TCP and UDP checksums so the matching CHECKSUM_GEN_* and CHECKSUM_CHECK_*
+ * options below are turned off. mpfs_ethernetif.c checks in software any
+ * received packet the GEM did not fully verify.
+ */
+#ifndef MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+#define MPFS_ETHERNETIF_CHECKSUM_OFFLOAD 1
+#endif
+
 /**
  * CHECKSUM_GEN_IP==1: Generate checksums in software for outgoing IP packets.
  */
 #ifndef CHECKSUM_GEN_IP
-#define CHECKSUM_GEN_IP                 1
+#define CHECKSUM_GEN_IP                 (!MPFS_ETHERNETIF_CHECKSUM_OFFLOAD)
 #endif
 
 /**
@@ -1856,7 +1866,7 @@
  * CHECKSUM_GEN_TCP==1: Generate checksums in software for outgoing TCP packets.
  */
 #ifndef CHECKSUM_GEN_TCP
-#define CHECKSUM_GEN_TCP                1
+#define CHECKSUM_GEN_TCP                (!MPFS_ETHERNETIF_CHECKSUM_OFFLOAD)
 #endif
 
 /**
@@ -1877,7 +1887,7 @@
  * CHECKSUM_CHECK_IP==1: Check checksums in software for incoming IP packets.
  */
 #ifndef CHECKSUM_CHECK_IP
-#define CHECKSUM_CHECK_IP               1
+#define CHECKSUM_CHECK_IP               (!MPFS_ETHERNETIF_CHECKSUM_OFFLOAD)
 #endif
 
 /**
@@ -1891,7 +1901,7 @@
  * CHECKSUM_CHECK_TCP==1: Check checksums in software for incoming TCP packets.
  */
 #ifndef CHECKSUM_CHECK_TCP
-#define CHECKSUM_CHECK_TCP              1
+#define CHECKSUM_CHECK_TCP              (!MPFS_ETHERNETIF_CHECKSUM_OFFLOAD)
 #endif
 
 /**
@@ -69,6 +69,8 @@
 #include "lwip/snmp.h"
 #include "lwip/ethip6.h"
 #include "lwip/etharp.h"
+#include "lwip/prot/ip.h"
+#include "lwip/prot/ip4.h"
 #include "netif/ppp/pppoe.h"
 
 const uint8_t * sys_cfg_get_mac_address(void);
@@ -82,13 +84,123 @@ const uint8_t * sys_cfg_get_mac_address(void);
 #define RX_BUFFER_COUNT MSS_MAC_RX_RING_SIZE
 #define TX_BUFFER_COUNT 1
 
+/*
+ * When MPFS_ETHERNETIF_RX_ZERO_COPY is 1, each received frame is passed to
+ * lwIP as a custom pbuf which points at the MAC receive buffer, instead of
+ * being copied into a PBUF_POOL chain. The ring slot is refilled straight away
+ * with a spare buffer from the receive buffer pool and the loaned buffer goes
+ * back to the pool when lwIP frees the pbuf. If the pool is empty the frame is
+ * copied as before so the ring never runs dry.
+ *
+ * This needs ETH_PAD_SIZE to be 0 as the GEM writes the frame to the start of
+ * the buffer.
+ */
+#ifndef MPFS_ETHERNETIF_RX_ZERO_COPY
+#if ETH_PAD_SIZE
+#define MPFS_ETHERNETIF_RX_ZERO_COPY 0
+#else
+#define MPFS_ETHERNETIF_RX_ZERO_COPY 1
+#endif
+#endif
+
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+#if ETH_PAD_SIZE
+#error "MPFS_ETHERNETIF_RX_ZERO_COPY requires ETH_PAD_SIZE to be 0"
+#endif
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "MPFS_ETHERNETIF_RX_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/* Number of receive buffers that can be held by lwIP at any one time */
+#ifndef RX_LOAN_BUFFER_COUNT
+#define RX_LOAN_BUFFER_COUNT RX_BUFFER_COUNT
+#endif
+
+#define RX_POOL_BUFFER_COUNT (RX_BUFFER_COUNT + RX_LOAN_BUFFER_COUNT)
+#else
+#define RX_POOL_BUFFER_COUNT RX_BUFFER_COUNT
+#endif
+
+/*
+ * When MPFS_ETHERNETIF_TX_ZERO_COPY is 1, each pbuf of an outgoing chain is
+ * given its own MAC transmit descriptor with MSS_MAC_send_pkt_gather() instead
+ * of being copied into g_mac_tx_buffer. The chain is held with pbuf_ref() until
+ * the next call to low_level_output() finds the transmit complete. Chains with
+ * more pbufs than there are spare descriptors are still copied.
+ */
+#ifndef MPFS_ETHERNETIF_TX_ZERO_COPY
+#if defined(MSS_MAC_USE_DDR)
+#define MPFS_ETHERNETIF_TX_ZERO_COPY 0
+#else
+#define MPFS_ETHERNETIF_TX_ZERO_COPY 1
+#endif
+#endif
+
+#if MPFS_ETHERNETIF_TX_ZERO_COPY
+#define TX_SEGMENT_COUNT (MSS_MAC_TX_RING_SIZE - 1)
+#endif
+
+/*
+ * When MPFS_ETHERNETIF_CHECKSUM_OFFLOAD is 1 (see lwipopts.h), the GEM inserts
+ * the IPv4, TCP and UDP checksums of outgoing frames and drops received frames
+ * with bad checksums. lwIP no longer checks these checksums so each received
+ * frame the GEM did not fully verify, such as one with IP options or a VLAN
+ * tag, is checked here before being passed up. The TCP/UDP checksum of an IP
+ * fragment cannot be checked until the datagram is reassembled and is not
+ * checked at all in this mode.
+ */
+#ifndef MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+#define MPFS_ETHERNETIF_CHECKSUM_OFFLOAD 0
+#endif
+
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+#if CHECKSUM_CHECK_IP || CHECKSUM_CHECK_TCP || CHECKSUM_GEN_IP || CHECKSUM_GEN_TCP
+#warning "MPFS_ETHERNETIF_CHECKSUM_OFFLOAD is set but lwIP still handles IP/TCP checksums"
+#endif
+
+#define RX_ETH_HDR_LEN 14u /* GEM receive buffers have no ETH_PAD_SIZE padding */
+#endif
+
 uint32_t get_user_eth_speed_choice(void);
 
 /* Buffers for Tx and Rx */
 static uint8_t g_mac_tx_buffer[TX_BUFFER_COUNT][MSS_MAC_MAX_TX_BUF_SIZE] __attribute__ ((aligned (4)));
-static uint8_t g_mac_rx_buffer[RX_BUFFER_COUNT][MSS_MAC_MAX_RX_BUF_SIZE] __attribute__ ((aligned (4)));
+static uint8_t g_mac_rx_buffer[RX_POOL_BUFFER_COUNT][MSS_MAC_MAX_RX_BUF_SIZE] __attribute__ ((aligned (4)));
+
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+/* Receive buffer pool entry. pc must be first so the pbuf can be cast back. */
+typedef struct rx_loan_buffer
+{
+    struct pbuf_custom pc;
+    struct rx_loan_buffer *next;
+    uint8_t *buffer;
+} rx_loan_buffer_t;
+
+static rx_loan_buffer_t g_rx_loan_buffer[RX_POOL_BUFFER_COUNT];
+static rx_loan_buffer_t *g_rx_loan_free_list = NULL;
+
+/* Frames passed up in a loaned buffer and frames copied as the pool was empty */
+uint32_t g_rx_loaned = 0u;
+uint32_t g_rx_copied = 0u;
+#endif
 
 static volatile uint8_t g_mac_tx_buffer_used[TX_BUFFER_COUNT];
+
+#if MPFS_ETHERNETIF_TX_ZERO_COPY
+static mss_mac_tx_segment_t g_mac_tx_segments[TX_SEGMENT_COUNT];
+static struct pbuf *g_mac_tx_pbuf = NULL;
+
+/* Frames sent from the pbuf chain and frames copied as the chain was too long */
+uint32_t g_tx_gathered = 0u;
+uint32_t g_tx_copied = 0u;
+#endif
+
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+/* Frames fully checked by the GEM, checked here and dropped here */
+uint32_t g_rx_checksum_hw = 0u;
+uint32_t g_rx_checksum_sw = 0u;
+uint32_t g_rx_checksum_bad = 0u;
+#endif
 static volatile uint8_t g_mac_rx_buffer_data_valid[RX_BUFFER_COUNT];
 
 struct netif * g_p_mac_netif = 0;
@@ -131,6 +243,22 @@ static struct pbuf * low_level_input
     uint32_t pckt_length
 );
 
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+static void rx_loan_pool_init(void);
+static struct pbuf * rx_loan_pbuf(uint8_t * p_rx_packet, uint16_t len);
+static void rx_loan_pbuf_free(struct pbuf *p);
+#endif
+
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+static uint32_t rx_checksum_ok
+(
+    const uint8_t * p_rx_packet,
+    uint32_t pckt_length,
+    mss_mac_rx_checksum_t hw_status
+);
+static uint32_t rx_sum16(const uint8_t * data, uint32_t length, uint32_t sum);
+#endif
+
 
 /**=============================================================================
  * Should be called at the beginning of the program to set up the
@@ -239,6 +367,9 @@ low_level_init(struct netif *netif)
     /*--------------------- Initialize packet containers ---------------------*/
     g_mac_tx_buffer_used[0] = RELEASE_BUFFER;
     g_mac_rx_buffer_data_valid[0] = RELEASE_BUFFER;
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+    rx_loan_pool_init();
+#endif
     
     /*-------------------------- Initialize the MAC --------------------------*/
     /*
@@ -275,6 +406,11 @@ low_level_init(struct netif *netif)
     g_mac_config.mac_addr[4] = netif->hwaddr[4];
     g_mac_config.mac_addr[5] = netif->hwaddr[5];
 
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+    g_mac_config.rx_checksum_offload = MSS_MAC_ENABLE;
+    g_mac_config.tx_checksum_offload = MSS_MAC_ENABLE;
+#endif
+
 #if (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_SGMII_GEM1) ||\
     (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_SGMII_GEM0) ||\
     (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_STD_GEM1)   ||\
@@ -566,6 +702,9 @@ low_level_output(struct netif *netif, struct pbuf *p)
     struct pbuf *q;
     uint16_t pckt_length = 0u;
     uint32_t pbuf_chain_end = 0u;
+#if MPFS_ETHERNETIF_TX_ZERO_COPY
+    uint32_t segment_count = 0u;
+#endif
     
     int32_t tx_status;
 
@@ -580,6 +719,53 @@ low_level_output(struct netif *netif, struct pbuf *p)
     // Block waiting for the semaphore to become available.
     if( xSemaphoreTake( xSemaphore, portMAX_DELAY ) == pdTRUE )
     {
+#if MPFS_ETHERNETIF_TX_ZERO_COPY
+        /* The previous frame has been sent so its pbuf chain can be released */
+        if(NULL != g_mac_tx_pbuf)
+        {
+            pbuf_free(g_mac_tx_pbuf);
+            g_mac_tx_pbuf = NULL;
+        }
+
+        /*--------------------------------------------------------------------------
+         * Map each pbuf in the chain onto its own transmit descriptor.
+         */
+        for(q = p; (q != NULL) && (segment_count <= TX_SEGMENT_COUNT); q = q->next)
+        {
+            if(0u != q->len)
+            {
+                if(segment_count < TX_SEGMENT_COUNT)
+                {
+                    g_mac_tx_segments[segment_count].buffer = (uint8_t const *)q->payload;
+                    g_mac_tx_segments[segment_count].length = q->len;
+                }
+                segment_count++;
+            }
+        }
+
+        if((0u != segment_count) && (segment_count <= TX_SEGMENT_COUNT))
+        {
+            /* Keep the chain until the MAC has finished with it */
+            pbuf_ref(p);
+            g_mac_tx_pbuf = p;
+            g_tx_gathered++;
+
+            do {
+#if defined(G5_SOC_EMU_USE_GEM0) && ((MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_SGMII_GEM0) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_STD_GEM0) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_STD_GEM0_LOCAL) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_BEAGLEV_FIRE_GEM0))
+                tx_status = MSS_MAC_send_pkt_gather(&g_mac0, 0, g_mac_tx_segments, segment_count, (void *)&g_mac_tx_buffer_used[0]);
+#else
+                tx_status = MSS_MAC_send_pkt_gather(&g_mac1, 0, g_mac_tx_segments, segment_count, (void *)&g_mac_tx_buffer_used[0]);
+#endif
+                if(MSS_MAC_SUCCESS != tx_status)
+                {
+                    vTaskDelay(1);
+                }
+            } while(MSS_MAC_SUCCESS != tx_status);
+        }
+        else
+        {
+            g_tx_copied++;
+#endif
 
         /*--------------------------------------------------------------------------
          * Copy pbuf chain into single buffer.
@@ -619,6 +805,9 @@ low_level_output(struct netif *netif, struct pbuf *p)
             	vTaskDelay(1);
             }
         } while(MSS_MAC_SUCCESS != tx_status);
+#if MPFS_ETHERNETIF_TX_ZERO_COPY
+        }
+#endif
     }
     
     MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
@@ -676,6 +865,18 @@ static void mac_rx_callback
 )
 {
     (void)caller_info;
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+    if(0u == rx_checksum_ok(p_rx_packet, pckt_length,
+                            MSS_MAC_get_rx_checksum_status((mss_mac_instance_t *)this_mac, cdesc)))
+    {
+        /* Drop the frame and reassign the packet buffer for reception */
+        MSS_MAC_receive_pkt((mss_mac_instance_t *)this_mac, queue_no, p_rx_packet, 0, 1);
+        g_rx_checksum_bad++;
+        LINK_STATS_INC(link.chkerr);
+        LINK_STATS_INC(link.drop);
+        return;
+    }
+#endif
     if(g_p_mac_netif != 0)
     {
         ethernetif_input(g_p_mac_netif, p_rx_packet, pckt_length);
@@ -683,6 +884,115 @@ static void mac_rx_callback
     _rx_counter++;
 }
 
+#if MPFS_ETHERNETIF_CHECKSUM_OFFLOAD
+/**=============================================================================
+ * Check the checksums of a received frame that the GEM did not verify. Returns
+ * 0 if a checksum is bad. Frames lwIP will reject anyway, such as truncated or
+ * non IPv4 frames, are passed without checking.
+ */
+static uint32_t
+rx_checksum_ok
+(
+    const uint8_t * p_rx_packet,
+    uint32_t pckt_length,
+    mss_mac_rx_checksum_t hw_status
+)
+{
+    const uint8_t *iphdr;
+    const uint8_t *l4hdr;
+    uint32_t offset = RX_ETH_HDR_LEN;
+    uint32_t ethtype;
+    uint32_t ip_hlen;
+    uint32_t ip_len;
+    uint32_t l4_len;
+    uint32_t proto;
+
+    if((MSS_MAC_RX_CHECKSUM_IP_TCP == hw_status) || (MSS_MAC_RX_CHECKSUM_IP_UDP == hw_status))
+    {
+        g_rx_checksum_hw++;
+        return 1u;
+    }
+
+    if(pckt_length < (RX_ETH_HDR_LEN + SIZEOF_VLAN_HDR + IP_HLEN))
+    {
+        return 1u;
+    }
+
+    ethtype = ((uint32_t)p_rx_packet[12] << 8) | p_rx_packet[13];
+    if(ETHTYPE_VLAN == ethtype)
+    {
+        ethtype = ((uint32_t)p_rx_packet[16] << 8) | p_rx_packet[17];
+        offset += SIZEOF_VLAN_HDR;
+    }
+
+    if(ETHTYPE_IP != ethtype)
+    {
+        return 1u;
+    }
+
+    iphdr = &p_rx_packet[offset];
+    ip_hlen = (uint32_t)(iphdr[0] & 0x0Fu) * 4u;
+    ip_len = ((uint32_t)iphdr[2] << 8) | iphdr[3];
+    if(((iphdr[0] >> 4) != 4u) || (ip_hlen < IP_HLEN) || (ip_len < ip_hlen) ||
+       ((offset + ip_len) > pckt_length))
+    {
+        return 1u;
+    }
+
+    if((MSS_MAC_RX_CHECKSUM_NONE == hw_status) && (0xFFFFu != rx_sum16(iphdr, ip_hlen, 0u)))
+    {
+        return 0u;
+    }
+
+    /* MF flag or fragment offset set */
+    if((0u != (iphdr[6] & 0x3Fu)) || (0u != iphdr[7]))
+    {
+        g_rx_checksum_sw++;
+        return 1u;
+    }
+
+    proto = iphdr[9];
+    l4hdr = &iphdr[ip_hlen];
+    l4_len = ip_len - ip_hlen;
+    if(((IP_PROTO_TCP == proto) && (l4_len >= 20u)) ||
+       ((IP_PROTO_UDP == proto) && (l4_len >= 8u) && (0u != (l4hdr[6] | l4hdr[7]))))
+    {
+        /* Pseudo header is the addresses, protocol and TCP/UDP length */
+        if(0xFFFFu != rx_sum16(l4hdr, l4_len, rx_sum16(&iphdr[12], 8u, proto + l4_len)))
+        {
+            return 0u;
+        }
+    }
+
+    g_rx_checksum_sw++;
+    return 1u;
+}
+
+/**=============================================================================
+ * One's complement sum of big endian 16 bit words, folded to 16 bits.
+ */
+static uint32_t
+rx_sum16(const uint8_t * data, uint32_t length, uint32_t sum)
+{
+    uint32_t index;
+
+    for(index = 0u; (index + 1u) < length; index += 2u)
+    {
+        sum += ((uint32_t)data[index] << 8) | data[index + 1u];
+    }
+
+    if(0u != (length & 1u))
+    {
+        sum += (uint32_t)data[length - 1u] << 8;
+    }
+
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+    sum = (sum & 0xFFFFu) + (sum >> 16);
+
+    return sum;
+}
+#endif
+
 /**=============================================================================
  * This function should be called when a packet is ready to be read
  * from the interface. It uses the function low_level_input() that
@@ -758,6 +1068,30 @@ low_level_input
         len += ETH_PAD_SIZE; /* allow room for Ethernet padding */
 #endif
 
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+        /* Hand the receive buffer itself to lwIP if a spare one is available */
+        p = rx_loan_pbuf(p_rx_packet, len);
+        if (p != NULL)
+        {
+            g_rx_loaned++;
+
+            MIB2_STATS_NETIF_ADD(netif, ifinoctets, p->tot_len);
+            if (((u8_t*)p->payload)[0] & 1) {
+              /* broadcast or multicast packet*/
+              MIB2_STATS_NETIF_INC(netif, ifinnucastpkts);
+            } else {
+              /* unicast packet*/
+              MIB2_STATS_NETIF_INC(netif, ifinucastpkts);
+            }
+            LINK_STATS_INC(link.recv);
+
+            return p;
+        }
+
+        /* Pool exhausted, fall back to copying the frame */
+        g_rx_copied++;
+#endif
+
         /* We allocate a pbuf chain of pbufs from the pool. */
         p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
         if (p != NULL)
@@ -818,6 +1152,99 @@ low_level_input
     return p;
 }
 
+#if MPFS_ETHERNETIF_RX_ZERO_COPY
+/**=============================================================================
+ * Set up the receive buffer pool. The first RX_BUFFER_COUNT buffers are given
+ * to the MAC by low_level_init() and the rest are kept as spares.
+ */
+static void
+rx_loan_pool_init(void)
+{
+    uint32_t count;
+
+    g_rx_loan_free_list = NULL;
+
+    for(count = 0; count < RX_POOL_BUFFER_COUNT; ++count)
+    {
+        g_rx_loan_buffer[count].pc.custom_free_function = rx_loan_pbuf_free;
+        g_rx_loan_buffer[count].buffer = g_mac_rx_buffer[count];
+        g_rx_loan_buffer[count].next = NULL;
+
+        if(count >= RX_BUFFER_COUNT)
+        {
+            g_rx_loan_buffer[count].next = g_rx_loan_free_list;
+            g_rx_loan_free_list = &g_rx_loan_buffer[count];
+        }
+    }
+
+    g_rx_loaned = 0u;
+    g_rx_copied = 0u;
+}
+
+/**=============================================================================
+ * Wrap a received frame in a custom pbuf and give the MAC a spare buffer in
+ * its place. Called from the MAC receive interrupt.
+ *
+ * @return the pbuf or NULL if there are no spare buffers
+ */
+static struct pbuf *
+rx_loan_pbuf(uint8_t * p_rx_packet, uint16_t len)
+{
+    rx_loan_buffer_t *loan;
+    rx_loan_buffer_t *spare;
+    struct pbuf *p;
+    uint64_t index;
+
+    index = (uint64_t)(p_rx_packet - g_mac_rx_buffer[0]) / MSS_MAC_MAX_RX_BUF_SIZE;
+    if((index >= RX_POOL_BUFFER_COUNT) || (len > MSS_MAC_MAX_RX_BUF_SIZE) ||
+       (NULL == g_rx_loan_free_list))
+    {
+        return NULL;
+    }
+
+    /* Interrupts are already disabled here so the free list is ours */
+    spare = g_rx_loan_free_list;
+    g_rx_loan_free_list = spare->next;
+    spare->next = NULL;
+
+    loan = &g_rx_loan_buffer[index];
+    p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &loan->pc,
+                            p_rx_packet, MSS_MAC_MAX_RX_BUF_SIZE);
+
+#if defined(G5_SOC_EMU_USE_GEM0) && ((MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_SGMII_GEM0) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_STD_GEM0) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_ICICLE_STD_GEM0_LOCAL) || (MSS_MAC_HW_PLATFORM == MSS_MAC_DESIGN_BEAGLEV_FIRE_GEM0))
+    MSS_MAC_receive_pkt(&g_mac0, 0, spare->buffer, 0, 1);
+#else
+    MSS_MAC_receive_pkt(&g_mac1, 0, spare->buffer, 0, 1);
+#endif
+
+    return p;
+}
+
+/**=============================================================================
+ * Custom pbuf free function, returns a loaned buffer to the pool. This is
+ * normally called from the lwIP thread but may also be called from the MAC
+ * interrupt if the frame is dropped, so the machine interrupt enable is saved
+ * and restored rather than going through the FreeRTOS critical section.
+ */
+static void
+rx_loan_pbuf_free(struct pbuf *p)
+{
+    rx_loan_buffer_t *loan = (rx_loan_buffer_t *)p;
+    uint64_t mstatus;
+
+    mstatus = read_csr(mstatus);
+    clear_csr(mstatus, MSTATUS_MIE);
+
+    loan->next = g_rx_loan_free_list;
+    g_rx_loan_free_list = loan;
+
+    if(0u != (mstatus & MSTATUS_MIE))
+    {
+        set_csr(mstatus, MSTATUS_MIE);
+    }
+}
+#endif
+
 /**************************************************************************//**
  *
  */
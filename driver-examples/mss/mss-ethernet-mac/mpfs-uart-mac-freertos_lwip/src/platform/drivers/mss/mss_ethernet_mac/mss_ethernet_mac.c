@@ -154,6 +154,11 @@ static void assign_station_addr(mss_mac_instance_t *this_mac,
 static void generic_mac_irq_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
 static void rxpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
 static void txpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no);
+#if defined(MSS_MAC_SIMPLE_TX_QUEUE)
+static int32_t tx_queue_busy(mss_mac_instance_t *this_mac,
+                             uint32_t queue_no,
+                             volatile uint32_t *p_nw_control);
+#endif
 static void update_mac_cfg(const mss_mac_instance_t *this_mac);
 static uint8_t probe_phy(const mss_mac_instance_t *this_mac);
 static void instances_init(mss_mac_instance_t *this_mac, mss_mac_cfg_t *cfg);
@@ -286,6 +291,7 @@ MSS_MAC_init(mss_mac_instance_t *this_mac, mss_mac_cfg_t *cfg)
         this_mac->phy_init = cfg->phy_init;
         this_mac->phy_set_link_speed = cfg->phy_set_link_speed;
         this_mac->append_CRC = cfg->append_CRC;
+        this_mac->rx_checksum_offload = cfg->rx_checksum_offload;
 #if defined(MSS_MAC_PHY_HW_RESET) || defined(MSS_MAC_PHY_HW_SRESET)
         this_mac->phy_soft_reset_gpio = cfg->phy_soft_reset_gpio;
         this_mac->phy_soft_reset_pin = cfg->phy_soft_reset_pin;
@@ -860,6 +866,8 @@ MSS_MAC_cfg_struct_def_init(mss_mac_cfg_t *cfg)
          */
         cfg->tsu_clock_select = 0U;
         cfg->amba_burst_length = MSS_MAC_AMBA_BURST_16;
+        cfg->rx_checksum_offload = MSS_MAC_DISABLE;
+        cfg->tx_checksum_offload = MSS_MAC_DISABLE;
 
         cfg->phy_extended_read = NULL_mmd_read_extended_regs;
         cfg->phy_extended_write = NULL_mmd_write_extended_regs;
@@ -1167,6 +1175,11 @@ config_mac_hw(mss_mac_instance_t *this_mac, const mss_mac_cfg_t *cfg)
         temp_net_config |= GEM_LENGTH_FIELD_ERROR_FRAME_DISCARD;
     }
 
+    if (MSS_MAC_ENABLE == cfg->rx_checksum_offload)
+    {
+        temp_net_config |= GEM_RECEIVE_CHECKSUM_OFFLOAD_ENABLE;
+    }
+
     if (MSS_MAC_IPG_DEFVAL !=
         cfg->ipg_multiplier) /* If we have a non zero value here then enable IPG stretching */
     {
@@ -1225,6 +1238,12 @@ config_mac_hw(mss_mac_instance_t *this_mac, const mss_mac_cfg_t *cfg)
     temp_dma_config |= GEM_DMA_ADDR_BUS_WIDTH_1;
 #endif
 
+    /* Checksum generation relies on the full size TX packet buffer selected above */
+    if (MSS_MAC_ENABLE == cfg->tx_checksum_offload)
+    {
+        temp_dma_config |= GEM_TX_PBUF_TCP_EN;
+    }
+
     if (0U != this_mac->is_emac)
     {
         this_mac->emac_base->DMA_CONFIG = temp_dma_config;
@@ -1898,72 +1917,185 @@ MSS_MAC_send_pkt(mss_mac_instance_t *this_mac,
         }
         else
         {
-            /*
-             * Queue not available so lets check some things...
-             */
-            if (0 == (*p_nw_control & GEM_ENABLE_TRANSMIT))
+            status = tx_queue_busy(this_mac, queue_no, p_nw_control);
+        }
+#else
+        /* TBD PMCS need to implement multi packet queuing... */
+#warning "Nothing implemented for multi packet tx yet"
+#endif
+        /* Ethernet Interrupt Enable function. */
+        /* PLIC_DisableIRQ() et al should not be called from the associated interrupt... */
+        if (0U == this_mac->queue[queue_no].in_isr)
+        {
+            if (0U != this_mac->use_local_ints)
             {
-                /*
-                 * TX is currently disabled so re-enable it and restart the last
-                 * operation on this queue to see if that gets us a completion.
-                 */
-                this_mac->queue[queue_no].tx_reenable++;
-                *p_nw_control = *p_nw_control | GEM_ENABLE_TRANSMIT;
-                *this_mac->queue[queue_no].transmit_q_ptr =
-                    (uint32_t)((uint64_t)&this_mac->queue[queue_no].tx_desc_tab[0]);
-                if (0U!= queue_no)
-                {
-                    *this_mac->queue[0].transmit_q_ptr =
-                        (uint32_t)((uint64_t)this_mac->queue[0].tx_desc_tab) | 1U;
-                }
+                __enable_local_irq(this_mac->mac_q_int[queue_no]);
+            }
+            else
+            {
+                PLIC_EnableIRQ(this_mac->mac_q_int[queue_no]); /* Single interrupt from GEM? */
+            }
+        }
+    }
+    return status;
+}
 
-                /* When transmitting at 10M, this delay is needed, 625MHz cpu clock - YMMV */
-                for (delay = 0; delay != 8; delay++)
-                {
-                }
+/*******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+int32_t
+MSS_MAC_send_pkt_gather(mss_mac_instance_t *this_mac,
+                        uint32_t queue_no,
+                        mss_mac_tx_segment_t const *p_segments,
+                        uint32_t segment_count,
+                        void *p_user_data)
+{
+    /*
+     * Gather transmit operation. This works the same way as the simplified
+     * MSS_MAC_send_pkt() except that the frame is spread over one descriptor
+     * per segment. The GEM only marks the first descriptor of the frame as
+     * used once it has been sent and txpkt_handler() skips over the rest.
+     *
+     * Unlike the receive buffers, the GEM transmit DMA does not need the
+     * buffers to be word aligned so segments may start at any byte address.
+     */
+    int32_t status = MSS_MAC_ERR_NOT_DONE;
+    int32_t no_crc = 0;
+    volatile int delay = 0;
+    volatile uint32_t *p_nw_control;
+    volatile uint32_t *p_tx_status;
+    mss_mac_queue_t *p_queue;
+    uint32_t tx_length = 0U;
+    uint32_t index;
 
-                *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+    if ((NULL_POINTER == p_segments) || (0U == segment_count) ||
+        (segment_count > ((uint32_t)MSS_MAC_TX_RING_SIZE - 1U)))
+    {
+        return MSS_MAC_ERR_TX_NOT_OK;
+    }
+
+    if (MSS_MAC_AVAILABLE == this_mac->mac_available)
+    {
+        p_queue = &this_mac->queue[queue_no];
+
+        if (MSS_MAC_CRC_DISABLE == this_mac->append_CRC)
+        {
+            no_crc = 1;
+        }
+
+        /* Make this function atomic w.r.to EMAC interrupt */
+        /* PLIC_DisableIRQ() et al should not be called from the associated interrupt... */
+        if (0U == p_queue->in_isr)
+        {
+            if (0U != this_mac->use_local_ints)
+            {
+                __disable_local_irq(this_mac->mac_q_int[queue_no]);
             }
             else
             {
-                /* Kick the tx start bit in case we are stalled... */
-                this_mac->queue[queue_no].tx_restart++;
-                *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+                PLIC_DisableIRQ(this_mac->mac_q_int[queue_no]); /* Single interrupt from GEM? */
+            }
+        }
+
+        if (0U != this_mac->is_emac)
+        {
+            p_nw_control = &this_mac->emac_base->NETWORK_CONTROL;
+            p_tx_status = &this_mac->emac_base->TRANSMIT_STATUS;
+        }
+        else
+        {
+            p_nw_control = &this_mac->mac_base->NETWORK_CONTROL;
+            p_tx_status = &this_mac->mac_base->TRANSMIT_STATUS;
+        }
+
+#if defined(MSS_MAC_SIMPLE_TX_QUEUE)
+        if (p_queue->nb_available_tx_desc == (uint32_t)MSS_MAC_TX_RING_SIZE)
+        {
+            /* Queue is fully available for transmit so clear retry count */
+            p_queue->tries = 0UL;
+
+            /* Make sure transmit is enabled */
+            if (0 == (*p_nw_control & GEM_ENABLE_TRANSMIT))
+            {
+                *p_nw_control = *p_nw_control | GEM_ENABLE_TRANSMIT;
             }
 
             /*
-             * TX might have completed since we entered the function but if we
-             * seem to be spinning on this and buffers haven't been returned to
-             * the queue then just give up and reset queue.
+             * Wait for pending transmits to complete as you cannot alter
+             * tx queue pointers while transmit is active...
              */
-            if (this_mac->queue[queue_no].tx_desc_tab[0].status & GEM_TX_DMA_USED)
+            while (0 != (*p_tx_status & GEM_TRANSMIT_GO))
             {
-                this_mac->queue[queue_no].tries++;
+                delay++; /* Empty loop will cause debug issues... */
+            }
 
-                if (this_mac->queue[queue_no].tries > 3) /* Been here too often? */
-                {
-                    /* Give up and reset FW queue count */
-                    this_mac->queue[queue_no].nb_available_tx_desc = (uint32_t)MSS_MAC_TX_RING_SIZE;
-                    status = MSS_MAC_ERR_TX_TIMEOUT;
-                }
+            /* Make sure queue is currently disabled */
+            *p_queue->transmit_q_ptr = (uint32_t)((uint64_t)p_queue->tx_desc_tab) | 1UL;
+
+            p_queue->nb_available_tx_desc -= segment_count;
+            p_queue->current_tx_desc = 0;
+
+            /* One descriptor per segment, only the final one is marked as last */
+            for (index = 0U; index != segment_count; index++)
+            {
+                ASSERT(NULL_POINTER != p_segments[index].buffer);
+                ASSERT(0U != p_segments[index].length);
+
+                p_queue->tx_desc_tab[index].addr_low =
+                    (uint32_t)((uint64_t)p_segments[index].buffer);
+#if defined(MSS_MAC_64_BIT_ADDRESS_MODE)
+                p_queue->tx_desc_tab[index].addr_high =
+                    (uint32_t)((uint64_t)p_segments[index].buffer >> 32);
+                p_queue->tx_desc_tab[index].unused = 0U;
+#endif
+                p_queue->tx_desc_tab[index].status =
+                    p_segments[index].length & GEM_TX_DMA_BUFF_LEN;
+                p_queue->tx_caller_info[index] = p_user_data;
+                tx_length += p_segments[index].length;
+            }
+
+            index--;
+            p_queue->tx_desc_tab[index].status |= GEM_TX_DMA_LAST;
+            if (0 != no_crc)
+            {
+                p_queue->tx_desc_tab[index].status |= GEM_TX_DMA_NO_CRC;
+            }
+
+            /* Dummy descriptor to stop the DMA engine after the frame */
+            p_queue->tx_desc_tab[index + 1U].status =
+                GEM_TX_DMA_WRAP | GEM_TX_DMA_LAST | GEM_TX_DMA_USED;
+
+            *p_queue->transmit_q_ptr = (uint32_t)((uint64_t)&p_queue->tx_desc_tab[0]);
+            /*
+             * If not queue 0 then we need to write disabled value to queue 0 to
+             * get the DMA engine reloaded...
+             */
+            if (0U != queue_no)
+            {
+                *this_mac->queue[0].transmit_q_ptr =
+                    (uint32_t)((uint64_t)this_mac->queue[0].tx_desc_tab) | 1U;
             }
 
-            if (this_mac->queue[queue_no].tx_desc_tab[0].status &
-                (GEM_TX_DMA_RETRY_ERROR | GEM_TX_DMA_UNDERRUN | GEM_TX_DMA_BUS_ERROR |
-                 GEM_TX_DMA_LATE_COL_ERROR | GEM_TX_DMA_OFFLOAD_ERRORS))
+            /* When transmitting at 10M, this delay is needed, 625MHz cpu clock - YMMV */
+            for (delay = 0; delay != 8; delay++)
             {
-                /* Give up and reset FW queue count */
-                this_mac->queue[queue_no].nb_available_tx_desc = (uint32_t)MSS_MAC_TX_RING_SIZE;
-                status = MSS_MAC_ERR_TX_FAIL;
             }
+
+            *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+
+            p_queue->egress += tx_length;
+            status = MSS_MAC_ERR_OK;
+        }
+        else
+        {
+            status = tx_queue_busy(this_mac, queue_no, p_nw_control);
         }
 #else
-        /* TBD PMCS need to implement multi packet queuing... */
 #warning "Nothing implemented for multi packet tx yet"
 #endif
         /* Ethernet Interrupt Enable function. */
         /* PLIC_DisableIRQ() et al should not be called from the associated interrupt... */
-        if (0U == this_mac->queue[queue_no].in_isr)
+        if (0U == p_queue->in_isr)
         {
             if (0U != this_mac->use_local_ints)
             {
@@ -1975,9 +2107,85 @@ MSS_MAC_send_pkt(mss_mac_instance_t *this_mac,
             }
         }
     }
+
     return status;
 }
 
+#if defined(MSS_MAC_SIMPLE_TX_QUEUE)
+/******************************************************************************
+ * Called by the transmit functions when the queue still has a packet in
+ * flight. Tries to get the transmitter moving again and gives up on the
+ * previous packet if it has been stuck for too long.
+ */
+static int32_t
+tx_queue_busy(mss_mac_instance_t *this_mac, uint32_t queue_no, volatile uint32_t *p_nw_control)
+{
+    mss_mac_queue_t *p_queue = &this_mac->queue[queue_no];
+    int32_t status = MSS_MAC_ERR_NOT_DONE;
+    volatile int delay = 0;
+
+    /*
+     * Queue not available so lets check some things...
+     */
+    if (0 == (*p_nw_control & GEM_ENABLE_TRANSMIT))
+    {
+        /*
+         * TX is currently disabled so re-enable it and restart the last
+         * operation on this queue to see if that gets us a completion.
+         */
+        p_queue->tx_reenable++;
+        *p_nw_control = *p_nw_control | GEM_ENABLE_TRANSMIT;
+        *p_queue->transmit_q_ptr = (uint32_t)((uint64_t)&p_queue->tx_desc_tab[0]);
+        if (0U!= queue_no)
+        {
+            *this_mac->queue[0].transmit_q_ptr =
+                (uint32_t)((uint64_t)this_mac->queue[0].tx_desc_tab) | 1U;
+        }
+
+        /* When transmitting at 10M, this delay is needed, 625MHz cpu clock - YMMV */
+        for (delay = 0; delay != 8; delay++)
+        {
+        }
+
+        *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+    }
+    else
+    {
+        /* Kick the tx start bit in case we are stalled... */
+        p_queue->tx_restart++;
+        *p_nw_control = *p_nw_control | GEM_TRANSMIT_START;
+    }
+
+    /*
+     * TX might have completed since we entered the function but if we
+     * seem to be spinning on this and buffers haven't been returned to
+     * the queue then just give up and reset queue.
+     */
+    if (p_queue->tx_desc_tab[0].status & GEM_TX_DMA_USED)
+    {
+        p_queue->tries++;
+
+        if (p_queue->tries > 3) /* Been here too often? */
+        {
+            /* Give up and reset FW queue count */
+            p_queue->nb_available_tx_desc = (uint32_t)MSS_MAC_TX_RING_SIZE;
+            status = MSS_MAC_ERR_TX_TIMEOUT;
+        }
+    }
+
+    if (p_queue->tx_desc_tab[0].status &
+        (GEM_TX_DMA_RETRY_ERROR | GEM_TX_DMA_UNDERRUN | GEM_TX_DMA_BUS_ERROR |
+         GEM_TX_DMA_LATE_COL_ERROR | GEM_TX_DMA_OFFLOAD_ERRORS))
+    {
+        /* Give up and reset FW queue count */
+        p_queue->nb_available_tx_desc = (uint32_t)MSS_MAC_TX_RING_SIZE;
+        status = MSS_MAC_ERR_TX_FAIL;
+    }
+
+    return status;
+}
+#endif
+
 /*******************************************************************************
  * See mss_ethernet_mac.h for details of how to use this function.
  */
@@ -3375,6 +3583,24 @@ MSS_MAC_set_tx_callback(mss_mac_instance_t *this_mac,
     }
 }
 
+/******************************************************************************
+ * See mss_ethernet_mac.h for details of how to use this function.
+ */
+mss_mac_rx_checksum_t
+MSS_MAC_get_rx_checksum_status(const mss_mac_instance_t *this_mac, const mss_mac_rx_desc_t *cdesc)
+{
+    mss_mac_rx_checksum_t ret_val = MSS_MAC_RX_CHECKSUM_NONE;
+
+    /* Without offload these status bits hold the type ID match instead */
+    if (MSS_MAC_ENABLE == this_mac->rx_checksum_offload)
+    {
+        ret_val = (mss_mac_rx_checksum_t)((cdesc->status & GEM_RX_DMA_CHECKSUM) >>
+                                          GEM_RX_DMA_CHECKSUM_SHIFT);
+    }
+
+    return (ret_val);
+}
+
 /******************************************************************************
  * See mss_ethernet_mac.h for details of how to use this function.
  */
@@ -5267,6 +5493,18 @@ txpkt_handler(mss_mac_instance_t *this_mac, uint64_t queue_no)
                         p_current_desc,
                         this_queue->tx_caller_info[this_queue->current_tx_desc]);
                 }
+
+                /*
+                 * The GEM only sets the used bit in the first descriptor of a
+                 * multi buffer frame so step over the rest of the frame too.
+                 */
+                while (0U == (p_current_desc->status & GEM_TX_DMA_LAST))
+                {
+                    this_queue->nb_available_tx_desc++;
+                    p_current_desc++;
+                    this_queue->current_tx_desc++;
+                }
+
                 this_queue->nb_available_tx_desc++;
                 p_current_desc++;
                 this_queue->current_tx_desc++;
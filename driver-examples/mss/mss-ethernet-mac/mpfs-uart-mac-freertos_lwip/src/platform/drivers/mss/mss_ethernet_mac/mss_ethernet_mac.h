@@ -164,6 +164,7 @@
     The following functions are used as part of the transmit operations:
         - _MSS_MAC_send_pkt()_
         - _MSS_MAC_send_pkts()_
+        - _MSS_MAC_send_pkt_gather()_
         - _MSS_MAC_set_tx_callback()_
         
     @subsection rx_ops Receive Operations
@@ -178,10 +179,17 @@
     for packet processing. This buffer will not be reused by the MSS Ethernet
     MAC driver unless it is re-allocated to the driver by a call to
     _MSS_MAC_receive_pkt()_.
+
+    When the _rx_checksum_offload_ configuration parameter is enabled, the
+    receive call-back can call _MSS_MAC_get_rx_checksum_status()_ with the
+    descriptor it is passed to find out which checksums the GEM has already
+    verified for the packet. Transmit checksums are generated by the GEM when
+    the _tx_checksum_offload_ configuration parameter is enabled.
     
     The following functions are used as part of the receive operations:
         - _MSS_MAC_receive_pkt()_
         - _MSS_MAC_set_rx_callback()_
+        - _MSS_MAC_get_rx_checksum_status()_
         
     @subsection stats Reading Status and Statistics
     The MSS Ethernet MAC driver provides the following functions to retrieve the
@@ -791,6 +799,57 @@ void MSS_MAC_set_rx_callback
     mss_mac_receive_callback_t rx_callback
 );
 
+/***************************************************************************//**
+  The _MSS_MAC_get_rx_checksum_status()_ function reports which checksums the
+  GEM verified for a received packet. It must be called from the receive
+  call-back function before the descriptor is handed back to the driver with
+  _MSS_MAC_receive_pkt()_.
+
+  Packets with a bad checksum are discarded by the GEM so a packet is never
+  reported as having a bad checksum. Checksums which were not checked, for
+  example the TCP or UDP checksum of an IP fragment, must be verified in
+  software if required.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+
+  @param cdesc
+    This parameter is the descriptor pointer passed to the receive call-back
+    function.
+
+  @return
+    This function returns one of the _mss_mac_rx_checksum_t_ values. If receive
+    checksum offload is not enabled, _MSS_MAC_RX_CHECKSUM_NONE_ is returned.
+
+  Example:
+  @code
+    void rx_callback
+    (
+        void *this_mac,
+        uint32_t queue_no,
+        uint8_t * p_rx_packet,
+        uint32_t pckt_length,
+        mss_mac_rx_desc_t *cdesc,
+        void * caller_info
+    )
+    {
+        if(MSS_MAC_RX_CHECKSUM_IP_TCP !=
+           MSS_MAC_get_rx_checksum_status((mss_mac_instance_t *)this_mac, cdesc))
+        {
+            check_tcp_in_software(p_rx_packet, pckt_length);
+        }
+        ...
+    }
+  @endcode
+ */
+mss_mac_rx_checksum_t
+MSS_MAC_get_rx_checksum_status
+(
+    const mss_mac_instance_t *this_mac,
+    const mss_mac_rx_desc_t *cdesc
+);
+
 /***************************************************************************//**
   The _MSS_MAC_change_speed()_ function sets the speed and duplex mode for the
   link and if autonegotiation is selected as the speed mode, also sets the speed
@@ -1040,6 +1099,87 @@ MSS_MAC_send_pkts
     mss_mac_tx_pkt_info_t *p_packets
 );
 
+/***************************************************************************//**
+  The _MSS_MAC_send_pkt_gather()_ function initiates the transmission of a
+  single packet which is held in several separate buffers, for example the
+  header and payload parts of a TCP segment. Each buffer is assigned its own
+  transmit descriptor so the packet does not need to be copied into one
+  contiguous buffer first. The buffers may start at any byte address.
+
+  This function is non-blocking and follows the same rules as
+  _MSS_MAC_send_pkt()_. The transmit completion handler registered by a call to
+  _MSS_MAC_set_tx_callback()_ is called once when the whole packet has been
+  sent, with _p_user_data_ as its _caller_info_ parameter. The buffers must not
+  be modified or released until then.
+
+  @param this_mac
+    This parameter is a pointer to one of the global _mss_mac_instance_t_
+    structures which identifies the MAC that the function is to operate on.
+    There are between 1 and 4 such structures identifying pMAC0, eMAC0, pMAC1
+    and eMAC1.
+
+  @param queue_no
+    This parameter identifies the queue to which this transmit operation
+    applies.
+
+  @param p_segments
+    This parameter is a pointer to an array of _mss_mac_tx_segment_t_
+    structures describing the buffers which make up the packet, in the order
+    they are to be sent.
+
+  @param segment_count
+    This parameter is the number of entries in the _p_segments_ array. At most
+    _MSS_MAC_TX_RING_SIZE_ - 1 segments can be sent as one descriptor is needed
+    to stop the transmit DMA engine after the packet.
+
+  @param p_user_data
+    This parameter is a pointer to an optional application defined data
+    structure which is passed back to the transmit completion handler.
+
+  @return
+    This function returns the following values:
+
+     - ___MSS_MAC_ERR_OK___ on successfully launching the packet.
+     - ___MSS_MAC_ERR_NOT_DONE___ if the previous packet has not finished
+          sending.
+     - ___MSS_MAC_ERR_TX_NOT_OK___ if _p_segments_ is NULL or
+          _segment_count_ is 0 or too large.
+     - ___MSS_MAC_ERR_TX_TIMEOUT___ If the previous packet has not released the
+          queue buffers after the MAC completes the send.
+     - ___MSS_MAC_ERR_TX_FAIL___ If the previous packet has not released the
+          queue buffers after the MAC completes the send and there is an error
+          flagged in the tx descriptor.
+
+  Example:
+  This example sends a packet whose Ethernet header and payload are held in
+  separate buffers.
+  @code
+
+    int32_t send_split_packet(uint8_t const *header, uint8_t const *payload,
+                              uint32_t payload_length)
+    {
+        mss_mac_tx_segment_t segments[2];
+
+        segments[0].buffer = header;
+        segments[0].length = 14;
+        segments[1].buffer = payload;
+        segments[1].length = payload_length;
+
+        return MSS_MAC_send_pkt_gather(g_test_mac, 0, segments, 2, (void *)0);
+    }
+
+  @endcode
+ */
+int32_t
+MSS_MAC_send_pkt_gather
+(
+    mss_mac_instance_t *this_mac,
+    uint32_t queue_no,
+    mss_mac_tx_segment_t const *p_segments,
+    uint32_t segment_count,
+    void *p_user_data
+);
+
 #if defined(MSS_MAC_SPEED_TEST)
 /***************************************************************************//**
  * Non standard function for network saturation speed tests. Not for normal use.
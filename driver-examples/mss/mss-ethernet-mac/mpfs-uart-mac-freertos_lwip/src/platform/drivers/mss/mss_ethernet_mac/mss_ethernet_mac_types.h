@@ -599,6 +599,26 @@ typedef void (*mss_mac_phy_extended_write_t)(/* mss_mac_instance_t */ const void
 
     The _MSS_MAC_cfg_struct_def_init()_ function sets this configuration parameter
     to 0x10 for bursts up to 16.
+
+  ___rx_checksum_offload___:
+    When set to _MSS_MAC_ENABLE_, the GEM checks the IPv4 header checksum and
+    the TCP and UDP checksums of received packets. Packets with a bad checksum
+    are discarded by the GEM and counted in the _MSS_MAC_RX_IP_CHECKSUM_ERRORS_,
+    _MSS_MAC_RX_TCP_CHECKSUM_ERRORS_ and _MSS_MAC_RX_UDP_CHECKSUM_ERRORS_
+    statistics. The checks made on each packet which is passed on can be found
+    with _MSS_MAC_get_rx_checksum_status()_.
+
+    The _MSS_MAC_cfg_struct_def_init()_ function sets this configuration
+    parameter to _MSS_MAC_DISABLE_.
+
+  ___tx_checksum_offload___:
+    When set to _MSS_MAC_ENABLE_, the GEM generates and inserts the IPv4 header
+    checksum and the TCP and UDP checksums of transmitted packets. The checksum
+    fields must be set to 0 in the packet buffer. IP fragments only have their
+    IPv4 header checksum generated.
+
+    The _MSS_MAC_cfg_struct_def_init()_ function sets this configuration
+    parameter to _MSS_MAC_DISABLE_.
  */
 
 typedef struct __mss_mac_cfg_t
@@ -650,6 +670,8 @@ typedef struct __mss_mac_cfg_t
     uint32_t mmsl_int_priority;         /*!< MMSL interrupt */
     uint32_t tsu_clock_select;          /*!< 0 for default TSU clock, 1 for fabric tsu clock */
     uint32_t amba_burst_length;         /*!< AXI burst length for DMA data transfers */
+    uint32_t rx_checksum_offload;       /*!< Enable / disable receive IP/TCP/UDP checksum checking */
+    uint32_t tx_checksum_offload;       /*!< Enable / disable transmit IP/TCP/UDP checksum generation */
 } mss_mac_cfg_t;
 
 /***************************************************************************//**
@@ -795,6 +817,23 @@ typedef enum __mss_mac_frag_size_t
 } mss_mac_frag_size_t;
 
 
+/***************************************************************************//**
+ * This enumeration indicates which checksums the GEM verified for a received
+ * packet when receive checksum offload is enabled. Packets which fail any of
+ * the checks are discarded by the GEM so only good or unchecked checksums are
+ * reported.
+ *
+ * This value is returned by _MSS_MAC_get_rx_checksum_status()_.
+ */
+typedef enum __mss_mac_rx_checksum_t
+{
+    MSS_MAC_RX_CHECKSUM_NONE,   /*!< Neither the IP header nor the TCP/UDP checksum was checked */
+    MSS_MAC_RX_CHECKSUM_IP,     /*!< IP header checksum good, TCP/UDP checksum not checked */
+    MSS_MAC_RX_CHECKSUM_IP_TCP, /*!< IP header and TCP checksums good */
+    MSS_MAC_RX_CHECKSUM_IP_UDP  /*!< IP header and UDP checksums good */
+} mss_mac_rx_checksum_t;
+
+
 /***************************************************************************//**
  * DMA Descriptor control and status bit field defines.
  *
@@ -863,6 +902,14 @@ typedef enum __mss_mac_frag_size_t
 #define GEM_RX_DMA_TYPE_ID        (BIT_22 | BIT_23) /*!< @brief Bitfield 
                                                       indicating which ID
                                                       register was matched. */
+#define GEM_RX_DMA_CHECKSUM       (BIT_22 | BIT_23) /*!< @brief Replaces
+                                                      GEM_RX_DMA_TYPE_ID when
+                                                      receive checksum offload
+                                                      is enabled. Indicates
+                                                      which checksums were
+                                                      verified, see
+                                                      mss_mac_rx_checksum_t. */
+#define GEM_RX_DMA_CHECKSUM_SHIFT 22
 #define GEM_RX_DMA_VLAN_TAG       BIT_21 /*!< @brief Set if a VLAN tag was
                                            detected in the packet. */
 #define GEM_RX_DMA_PRIORITY_TAG   BIT_20 /*!< @brief Priority tag detected — 
@@ -1222,6 +1269,21 @@ struct mss_mac_tx_pkt_info
     void     *p_user_data; /*!< Pointer to user data for this packet */
 };
 
+/***************************************************************************//**
+ * Gather transmit segment structure
+ *
+ * This structure is used with the _MSS_MAC_send_pkt_gather()_ function to
+ * describe one piece of a frame which is spread over several buffers. The
+ * buffer may start at any byte address.
+ */
+typedef struct mss_mac_tx_segment mss_mac_tx_segment_t;
+
+struct mss_mac_tx_segment
+{
+    uint8_t const *buffer; /*!< Pointer to the segment data */
+    uint32_t       length; /*!< Length of this segment in bytes */
+};
+
 
 /***************************************************************************//**
  * Per queue specific info for device management structure.
@@ -1306,6 +1368,7 @@ typedef struct mss_mac_instance
 
     uint32_t jumbo_frame_enable;        /*!< Enable / disable jumbo frame support: */
     uint32_t append_CRC;                /*!< Enable / disable GEM CRC calculation */
+    uint32_t rx_checksum_offload;       /*!< Enable / disable receive checksum checking */
     uint32_t interface_type;            /*!< Type of network interface associated with this GEM */
     uint32_t phy_type;                  /*!< PHY device type associated with this GEM */
     uint32_t phy_addr;                  /*!< Address of Ethernet PHY on MII management interface. */